@@ -321,51 +321,27 @@ Field CellColumns::createField( const Field& other, const eckit::Configuration&
 }
 
 
-namespace {
+void CellColumns::haloExchange( const FieldSet& fieldset, bool on_device ) const {
+    parallel::HaloExchangeHandle handle = haloExchangeStart( fieldset, on_device );
+    haloExchangeFinish( fieldset, handle );
+}
 
-template <int RANK>
-void dispatch_haloExchange( Field& field, const parallel::HaloExchange& halo_exchange, bool on_device ) {
-    if ( field.datatype() == array::DataType::kind<int>() ) {
-        halo_exchange.template execute<int, RANK>( field.array(), on_device );
-    }
-    else if ( field.datatype() == array::DataType::kind<long>() ) {
-        halo_exchange.template execute<long, RANK>( field.array(), on_device );
-    }
-    else if ( field.datatype() == array::DataType::kind<float>() ) {
-        halo_exchange.template execute<float, RANK>( field.array(), on_device );
-    }
-    else if ( field.datatype() == array::DataType::kind<double>() ) {
-        halo_exchange.template execute<double, RANK>( field.array(), on_device );
-    }
-    else {
-        throw_Exception( "datatype not supported", Here() );
+parallel::HaloExchangeHandle CellColumns::haloExchangeStart( const FieldSet& fieldset, bool on_device ) const {
+    std::vector<array::Array*> arrays;
+    arrays.reserve( fieldset.size() );
+    for ( idx_t f = 0; f < fieldset.size(); ++f ) {
+        arrays.push_back( &const_cast<FieldSet&>( fieldset )[f].array() );
     }
-    field.set_dirty( false );
+    return halo_exchange().start( arrays, on_device );
 }
-}  // namespace
 
-void CellColumns::haloExchange( const FieldSet& fieldset, bool on_device ) const {
+void CellColumns::haloExchangeFinish( const FieldSet& fieldset, parallel::HaloExchangeHandle& handle ) const {
+    halo_exchange().finish( handle );
     for ( idx_t f = 0; f < fieldset.size(); ++f ) {
-        Field& field = const_cast<FieldSet&>( fieldset )[f];
-        switch ( field.rank() ) {
-            case 1:
-                dispatch_haloExchange<1>( field, halo_exchange(), on_device );
-                break;
-            case 2:
-                dispatch_haloExchange<2>( field, halo_exchange(), on_device );
-                break;
-            case 3:
-                dispatch_haloExchange<3>( field, halo_exchange(), on_device );
-                break;
-            case 4:
-                dispatch_haloExchange<4>( field, halo_exchange(), on_device );
-                break;
-            default:
-                throw_Exception( "Rank not supported", Here() );
-        }
-        field.set_dirty( false );
+        const_cast<FieldSet&>( fieldset )[f].set_dirty( false );
     }
 }
+
 void CellColumns::haloExchange( const Field& field, bool on_device ) const {
     FieldSet fieldset;
     fieldset.add( field );
@@ -62,6 +62,14 @@ void FunctionSpace::haloExchange( const FieldSet& fields, bool on_device ) const
     return get()->haloExchange( fields, on_device );
 }
 
+parallel::HaloExchangeHandle FunctionSpace::haloExchangeStart( const FieldSet& fields, bool on_device ) const {
+    return get()->haloExchangeStart( fields, on_device );
+}
+
+void FunctionSpace::haloExchangeFinish( const FieldSet& fields, parallel::HaloExchangeHandle& handle ) const {
+    get()->haloExchangeFinish( fields, handle );
+}
+
 const util::PartitionPolygon& FunctionSpace::polygon( idx_t halo ) const {
     return get()->polygon( halo );
 }
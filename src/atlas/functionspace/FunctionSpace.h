@@ -13,6 +13,7 @@
 #include <string>
 
 #include "atlas/library/config.h"
+#include "atlas/parallel/HaloExchangeHandle.h"
 #include "atlas/util/ObjectHandle.h"
 
 namespace eckit {
@@ -58,6 +59,16 @@ public:
     void haloExchange( const FieldSet&, bool on_device = false ) const;
     void haloExchange( const Field&, bool on_device = false ) const;
 
+    /// @brief Start a halo exchange of the fields, without waiting for its completion
+    ///
+    /// Computations that do not involve halo values of the fields, e.g. on interior points, can be performed
+    /// while the halo values are communicated. The fields must not be modified until haloExchangeFinish()
+    /// has been called with the returned handle.
+    parallel::HaloExchangeHandle haloExchangeStart( const FieldSet&, bool on_device = false ) const;
+
+    /// @brief Complete a halo exchange started with haloExchangeStart()
+    void haloExchangeFinish( const FieldSet&, parallel::HaloExchangeHandle& ) const;
+
     const util::PartitionPolygon& polygon( idx_t halo = 0 ) const;
 
     idx_t nb_partitions() const;
@@ -83,8 +83,12 @@ public:
         creator_type creator = std::bind( &NodeColumnsHaloExchangeCache::create, mesh, halo );
         return Base::get_or_create( key( *mesh.get(), halo ), creator );
     }
+    void insert( const Mesh& mesh, long halo, const util::ObjectHandle<value_type>& value ) {
+        mesh.get()->attachObserver( instance() );
+        Base::get_or_create( key( *mesh.get(), halo ), [value]() { return const_cast<value_type*>( value.get() ); } );
+    }
     void onMeshDestruction( mesh::detail::MeshImpl& mesh ) override {
-        for ( long jhalo = 1; jhalo < mesh::Halo( mesh ).size(); ++jhalo ) {
+        for ( long jhalo = 0; jhalo <= mesh::Halo( mesh ).size(); ++jhalo ) {
             remove( key( mesh, jhalo ) );
         }
     }
@@ -343,48 +347,24 @@ Field NodeColumns::createField( const Field& other, const eckit::Configuration&
                         option::variables( other.variables() ) | config );
 }
 
-namespace {
+void NodeColumns::haloExchange( const FieldSet& fieldset, bool on_device ) const {
+    parallel::HaloExchangeHandle handle = haloExchangeStart( fieldset, on_device );
+    haloExchangeFinish( fieldset, handle );
+}
 
-template <int RANK>
-void dispatch_haloExchange( Field& field, const parallel::HaloExchange& halo_exchange, bool on_device ) {
-    if ( field.datatype() == array::DataType::kind<int>() ) {
-        halo_exchange.template execute<int, RANK>( field.array(), on_device );
-    }
-    else if ( field.datatype() == array::DataType::kind<long>() ) {
-        halo_exchange.template execute<long, RANK>( field.array(), on_device );
-    }
-    else if ( field.datatype() == array::DataType::kind<float>() ) {
-        halo_exchange.template execute<float, RANK>( field.array(), on_device );
-    }
-    else if ( field.datatype() == array::DataType::kind<double>() ) {
-        halo_exchange.template execute<double, RANK>( field.array(), on_device );
-    }
-    else {
-        throw_Exception( "datatype not supported", Here() );
+parallel::HaloExchangeHandle NodeColumns::haloExchangeStart( const FieldSet& fieldset, bool on_device ) const {
+    std::vector<array::Array*> arrays;
+    arrays.reserve( fieldset.size() );
+    for ( idx_t f = 0; f < fieldset.size(); ++f ) {
+        arrays.push_back( &const_cast<FieldSet&>( fieldset )[f].array() );
     }
-    field.set_dirty( false );
+    return halo_exchange().start( arrays, on_device );
 }
-}  // namespace
 
-void NodeColumns::haloExchange( const FieldSet& fieldset, bool on_device ) const {
+void NodeColumns::haloExchangeFinish( const FieldSet& fieldset, parallel::HaloExchangeHandle& handle ) const {
+    halo_exchange().finish( handle );
     for ( idx_t f = 0; f < fieldset.size(); ++f ) {
-        Field& field = const_cast<FieldSet&>( fieldset )[f];
-        switch ( field.rank() ) {
-            case 1:
-                dispatch_haloExchange<1>( field, halo_exchange(), on_device );
-                break;
-            case 2:
-                dispatch_haloExchange<2>( field, halo_exchange(), on_device );
-                break;
-            case 3:
-                dispatch_haloExchange<3>( field, halo_exchange(), on_device );
-                break;
-            case 4:
-                dispatch_haloExchange<4>( field, halo_exchange(), on_device );
-                break;
-            default:
-                throw_Exception( "Rank not supported", Here() );
-        }
+        const_cast<FieldSet&>( fieldset )[f].set_dirty( false );
     }
 }
 
@@ -401,6 +381,11 @@ const parallel::HaloExchange& NodeColumns::halo_exchange() const {
     return *halo_exchange_;
 }
 
+void NodeColumns::set_halo_exchange( const Mesh& mesh, idx_t halo, parallel::HaloExchange* halo_exchange ) {
+    NodeColumnsHaloExchangeCache::instance().insert( mesh, halo,
+                                                     util::ObjectHandle<parallel::HaloExchange>( halo_exchange ) );
+}
+
 void NodeColumns::gather( const FieldSet& local_fieldset, FieldSet& global_fieldset ) const {
     ATLAS_ASSERT( local_fieldset.size() == global_fieldset.size() );
 
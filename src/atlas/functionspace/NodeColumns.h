@@ -84,8 +84,14 @@ public:
 
     void haloExchange( const FieldSet&, bool on_device = false ) const override;
     void haloExchange( const Field&, bool on_device = false ) const override;
+    parallel::HaloExchangeHandle haloExchangeStart( const FieldSet&, bool on_device = false ) const override;
+    void haloExchangeFinish( const FieldSet&, parallel::HaloExchangeHandle& ) const override;
     const parallel::HaloExchange& halo_exchange() const;
 
+    /// @brief Use a HaloExchange that is already set up, e.g. restored from a mesh::MeshCheckpoint,
+    /// for every NodeColumns of given mesh and halo size
+    static void set_halo_exchange( const Mesh&, idx_t halo, parallel::HaloExchange* );
+
     void gather( const FieldSet&, FieldSet& ) const;
     void gather( const Field&, Field& ) const;
     const parallel::GatherScatter& gather() const;
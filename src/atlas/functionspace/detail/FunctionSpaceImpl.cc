@@ -37,6 +37,13 @@ void FunctionSpaceImpl::haloExchange( const Field&, bool ) const {
     ATLAS_NOTIMPLEMENTED;
 }
 
+parallel::HaloExchangeHandle FunctionSpaceImpl::haloExchangeStart( const FieldSet& fieldset, bool on_device ) const {
+    haloExchange( fieldset, on_device );
+    return parallel::HaloExchangeHandle();
+}
+
+void FunctionSpaceImpl::haloExchangeFinish( const FieldSet&, parallel::HaloExchangeHandle& ) const {}
+
 Field NoFunctionSpace::createField( const eckit::Configuration& ) const {
     ATLAS_NOTIMPLEMENTED;
 }
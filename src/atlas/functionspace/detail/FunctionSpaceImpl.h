@@ -16,6 +16,7 @@
 #include "atlas/util/Object.h"
 
 #include "atlas/library/config.h"
+#include "atlas/parallel/HaloExchangeHandle.h"
 
 namespace eckit {
 class Configuration;
@@ -72,6 +73,12 @@ public:
     virtual void haloExchange( const FieldSet&, bool /*on_device*/ = false ) const;
     virtual void haloExchange( const Field&, bool /* on_device*/ = false ) const;
 
+    /// @brief Start a halo exchange, to be completed with haloExchangeFinish()
+    ///
+    /// The default implementation completes the exchange immediately.
+    virtual parallel::HaloExchangeHandle haloExchangeStart( const FieldSet&, bool on_device = false ) const;
+    virtual void haloExchangeFinish( const FieldSet&, parallel::HaloExchangeHandle& ) const;
+
     virtual idx_t size() const = 0;
 
     virtual idx_t nb_partitions() const;
@@ -701,22 +701,18 @@ struct FixupHaloForVectors<3> {
 
 
 template <int RANK>
-void dispatch_haloExchange( Field& field, const parallel::HaloExchange& halo_exchange, const StructuredColumns& fs ) {
+void dispatch_fixupHalo( Field& field, const StructuredColumns& fs ) {
     FixupHaloForVectors<RANK> fixup_halos( fs );
     if ( field.datatype() == array::DataType::kind<int>() ) {
-        halo_exchange.template execute<int, RANK>( field.array(), false );
         fixup_halos.template apply<int>( field );
     }
     else if ( field.datatype() == array::DataType::kind<long>() ) {
-        halo_exchange.template execute<long, RANK>( field.array(), false );
         fixup_halos.template apply<long>( field );
     }
     else if ( field.datatype() == array::DataType::kind<float>() ) {
-        halo_exchange.template execute<float, RANK>( field.array(), false );
         fixup_halos.template apply<float>( field );
     }
     else if ( field.datatype() == array::DataType::kind<double>() ) {
-        halo_exchange.template execute<double, RANK>( field.array(), false );
         fixup_halos.template apply<double>( field );
     }
     else {
@@ -726,21 +722,37 @@ void dispatch_haloExchange( Field& field, const parallel::HaloExchange& halo_exc
 }
 }  // namespace
 
-void StructuredColumns::haloExchange( const FieldSet& fieldset, bool ) const {
+void StructuredColumns::haloExchange( const FieldSet& fieldset, bool on_device ) const {
+    parallel::HaloExchangeHandle handle = haloExchangeStart( fieldset, on_device );
+    haloExchangeFinish( fieldset, handle );
+}
+
+parallel::HaloExchangeHandle StructuredColumns::haloExchangeStart( const FieldSet& fieldset, bool ) const {
+    std::vector<array::Array*> arrays;
+    arrays.reserve( fieldset.size() );
+    for ( idx_t f = 0; f < fieldset.size(); ++f ) {
+        arrays.push_back( &const_cast<FieldSet&>( fieldset )[f].array() );
+    }
+    return halo_exchange().start( arrays, false );
+}
+
+void StructuredColumns::haloExchangeFinish( const FieldSet& fieldset, parallel::HaloExchangeHandle& handle ) const {
+    halo_exchange().finish( handle );
+
     for ( idx_t f = 0; f < fieldset.size(); ++f ) {
         Field& field = const_cast<FieldSet&>( fieldset )[f];
         switch ( field.rank() ) {
             case 1:
-                dispatch_haloExchange<1>( field, halo_exchange(), *this );
+                dispatch_fixupHalo<1>( field, *this );
                 break;
             case 2:
-                dispatch_haloExchange<2>( field, halo_exchange(), *this );
+                dispatch_fixupHalo<2>( field, *this );
                 break;
             case 3:
-                dispatch_haloExchange<3>( field, halo_exchange(), *this );
+                dispatch_fixupHalo<3>( field, *this );
                 break;
             case 4:
-                dispatch_haloExchange<4>( field, halo_exchange(), *this );
+                dispatch_fixupHalo<4>( field, *this );
                 break;
             default:
                 throw_Exception( "Rank not supported", Here() );
@@ -92,6 +92,8 @@ public:
 
     virtual void haloExchange( const FieldSet&, bool on_device = false ) const override;
     virtual void haloExchange( const Field&, bool on_device = false ) const override;
+    virtual parallel::HaloExchangeHandle haloExchangeStart( const FieldSet&, bool on_device = false ) const override;
+    virtual void haloExchangeFinish( const FieldSet&, parallel::HaloExchangeHandle& ) const override;
 
     idx_t sizeOwned() const { return size_owned_; }
     idx_t sizeHalo() const { return size_halo_; }
@@ -15,16 +15,26 @@
 #include "atlas/grid/Grid.h"
 #include "atlas/grid/Partitioner.h"
 #include "atlas/grid/detail/distribution/DistributionImpl.h"
+#include "atlas/grid/detail/distribution/EqualRegionsDistribution.h"
 #include "atlas/parallel/mpi/mpi.h"
 #include "atlas/runtime/Log.h"
 
 namespace atlas {
 namespace grid {
 
+namespace {
+DistributionImpl* create_distribution( const Grid& grid, const Partitioner& partitioner ) {
+    if ( EqualRegionsDistribution::supports( grid, partitioner ) ) {
+        return new EqualRegionsDistribution( grid, partitioner );
+    }
+    return new DistributionImpl( grid, partitioner );
+}
+}  // namespace
+
 Distribution::Distribution( const Grid& grid ) : Handle( new Implementation( grid ) ) {}
 
 Distribution::Distribution( const Grid& grid, const Partitioner& partitioner ) :
-    Handle( new Implementation( grid, partitioner ) ) {}
+    Handle( create_distribution( grid, partitioner ) ) {}
 
 Distribution::Distribution( int nb_partitions, idx_t npts, int part[], int part0 ) :
     Handle( new Implementation( nb_partitions, npts, part, part0 ) ) {}
@@ -38,6 +48,14 @@ int Distribution::partition( const gidx_t gidx ) const {
     return get()->partition( gidx );
 }
 
+bool Distribution::functional() const {
+    return get()->functional();
+}
+
+gidx_t Distribution::size() const {
+    return get()->size();
+}
+
 const Distribution::partition_t& Distribution::partition() const {
     return get()->partition();
 }
@@ -72,7 +90,7 @@ std::ostream& operator<<( std::ostream& os, const Distribution& distribution ) {
 }
 
 Distribution::operator const partition_t&() const {
-    return *get();
+    return get()->partition();
 }
 
 }  // namespace grid
@@ -49,8 +49,16 @@ public:
 
     int partition( const gidx_t gidx ) const;
 
+    /// @brief Partition of every grid point
+    /// @note Prefer partition( gidx ): for a functional distribution this array is computed on first use
     const partition_t& partition() const;
 
+    /// @brief True when partition( gidx ) is computed rather than looked up in a stored array
+    bool functional() const;
+
+    /// @brief Number of grid points
+    gidx_t size() const;
+
     idx_t nb_partitions() const;
 
     operator const partition_t&() const;
@@ -18,6 +18,7 @@
 #include "atlas/grid/Partitioner.h"
 #include "atlas/parallel/mpi/mpi.h"
 #include "atlas/parallel/omp/omp.h"
+#include "atlas/runtime/Trace.h"
 
 namespace atlas {
 namespace grid {
@@ -129,6 +130,18 @@ DistributionImpl::DistributionImpl( int nb_partitions, partition_t&& part ) :
 
 DistributionImpl::~DistributionImpl() = default;
 
+const DistributionImpl::partition_t& DistributionImpl::partition() const {
+    if ( functional() ) {
+        std::call_once( materialise_, [this]() {
+            ATLAS_TRACE( "DistributionImpl::partition() materialise" );
+            const gidx_t npts = size();
+            part_.resize( npts );
+            atlas_omp_parallel_for( gidx_t n = 0; n < npts; ++n ) { part_[n] = partition( n ); }
+        } );
+    }
+    return part_;
+}
+
 void DistributionImpl::print( std::ostream& s ) const {
     s << "Distribution( "
       << "type: " << type_ << ", nb_points: " << part_.size() << ", nb_partitions: " << nb_pts_.size() << ", parts : [";
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -44,15 +45,23 @@ public:
 
     virtual ~DistributionImpl();
 
-    int partition( const gidx_t gidx ) const { return part_[gidx]; }
+    virtual int partition( const gidx_t gidx ) const { return part_[gidx]; }
 
-    const partition_t& partition() const { return part_; }
+    /// @brief Partition of every grid point
+    /// @note For a functional distribution this array is computed on first use
+    const partition_t& partition() const;
+
+    /// @brief True when partition(gidx) is computed rather than looked up in a stored array
+    virtual bool functional() const { return false; }
+
+    /// @brief Number of grid points
+    virtual gidx_t size() const { return part_.size(); }
 
     idx_t nb_partitions() const { return nb_partitions_; }
 
-    operator const partition_t&() const { return part_; }
+    operator const partition_t&() const { return partition(); }
 
-    const int* data() const { return part_.data(); }
+    const int* data() const { return partition().data(); }
 
     const std::vector<idx_t>& nb_pts() const { return nb_pts_; }
 
@@ -61,15 +70,20 @@ public:
 
     const std::string& type() const { return type_; }
 
-    void print( std::ostream& ) const;
+    virtual void print( std::ostream& ) const;
+
+protected:
+    DistributionImpl() = default;
 
-private:
     idx_t nb_partitions_;
-    partition_t part_;
+    mutable partition_t part_;
     std::vector<idx_t> nb_pts_;
     idx_t max_pts_;
     idx_t min_pts_;
     std::string type_;
+
+private:
+    mutable std::once_flag materialise_;
 };
 
 extern "C" {
@@ -0,0 +1,212 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <ostream>
+
+#include "EqualRegionsDistribution.h"
+
+#include "atlas/grid/Partitioner.h"
+#include "atlas/grid/StructuredGrid.h"
+#include "atlas/grid/detail/partitioner/EqualRegionsPartitioner.h"
+#include "atlas/parallel/omp/omp.h"
+#include "atlas/projection/Projection.h"
+#include "atlas/runtime/Exception.h"
+#include "atlas/runtime/Trace.h"
+#include "atlas/util/MicroDeg.h"
+
+using atlas::util::microdeg;
+
+namespace atlas {
+namespace grid {
+
+namespace {
+const detail::partitioner::EqualRegionsPartitioner* equal_regions( const Partitioner& partitioner ) {
+    return dynamic_cast<const detail::partitioner::EqualRegionsPartitioner*>( partitioner.get() );
+}
+}  // namespace
+
+bool EqualRegionsDistribution::supports( const Grid& grid, const Partitioner& partitioner ) {
+    if ( not partitioner || not equal_regions( partitioner ) || partitioner.nb_partitions() < 2 ) {
+        return false;
+    }
+    StructuredGrid structured_grid( grid );
+    if ( not structured_grid || grid.projection().units() != "degrees" ) {
+        return false;
+    }
+    // Same preconditions as the shortcut for structured grids in EqualRegionsPartitioner::partition
+    return structured_grid.ny() > 1 && structured_grid.nx( 0 ) > 1 &&
+           structured_grid.y( 1 ) < structured_grid.y( 0 ) && structured_grid.x( 1, 0 ) > structured_grid.x( 0, 0 );
+}
+
+EqualRegionsDistribution::EqualRegionsDistribution( const Grid& grid, const Partitioner& partitioner ) {
+    ATLAS_TRACE( "EqualRegionsDistribution" );
+    ATLAS_ASSERT( supports( grid, partitioner ) );
+
+    const auto& eqregions = *equal_regions( partitioner );
+    StructuredGrid structured_grid( grid );
+    const idx_t ny       = structured_grid.ny();
+    const idx_t nb_bands = eqregions.nb_bands();
+
+    size_          = grid.size();
+    nb_partitions_ = partitioner.nb_partitions();
+    type_          = partitioner.type();
+
+    row_begin_.resize( ny + 1 );
+    row_begin_[0] = 0;
+    for ( idx_t j = 0; j < ny; ++j ) {
+        row_begin_[j + 1] = row_begin_[j] + structured_grid.nx( j );
+    }
+
+    // Same chunking of points over partitions as EqualRegionsPartitioner::partition
+    const gidx_t chunk_size = size_ / nb_partitions_;
+    const gidx_t remainder  = size_ - chunk_size * nb_partitions_;
+    nb_pts_.resize( nb_partitions_ );
+    for ( idx_t p = 0; p < nb_partitions_; ++p ) {
+        nb_pts_[p] = chunk_size + ( p < remainder ? 1 : 0 );
+    }
+    max_pts_ = *std::max_element( nb_pts_.begin(), nb_pts_.end() );
+    min_pts_ = *std::min_element( nb_pts_.begin(), nb_pts_.end() );
+
+    auto row_of = [this]( gidx_t gidx ) -> idx_t {
+        return idx_t( std::upper_bound( row_begin_.begin(), row_begin_.end(), gidx ) - row_begin_.begin() ) - 1;
+    };
+
+    band_begin_.resize( nb_bands + 1 );
+    band_part_.resize( nb_bands + 1 );
+    band_row_.resize( nb_bands, 0 );
+    band_split_.resize( nb_bands + 1 );
+    band_begin_[0] = 0;
+    band_part_[0]  = 0;
+    band_split_[0] = 0;
+    for ( idx_t b = 0; b < nb_bands; ++b ) {
+        const int nb_sectors = eqregions.nb_regions( b );
+        band_part_[b + 1]    = band_part_[b] + nb_sectors;
+        band_begin_[b + 1]   = band_begin_[b];
+        for ( int p = band_part_[b]; p < band_part_[b + 1]; ++p ) {
+            band_begin_[b + 1] += nb_pts_[p];
+        }
+        idx_t nb_rows = 0;
+        if ( band_begin_[b + 1] > band_begin_[b] ) {
+            band_row_[b] = row_of( band_begin_[b] );
+            nb_rows      = row_of( band_begin_[b + 1] - 1 ) - band_row_[b] + 1;
+        }
+        band_split_[b + 1] = band_split_[b] + size_t( nb_rows ) * size_t( nb_sectors + 1 );
+    }
+    split_.resize( band_split_[nb_bands] );
+
+    // Within a band, points are ordered west to east, then north to south, and cut in sectors of nb_pts_ points.
+    // As x increases with i in every row, each sector is a contiguous range of i in every row of the band.
+    // Sector boundaries are found by bisection on the (integer micro-degree) longitude, which avoids sorting.
+    atlas_omp_parallel_for( idx_t b = 0; b < nb_bands; ++b ) {
+        const gidx_t begin = band_begin_[b];
+        const gidx_t end   = band_begin_[b + 1];
+        if ( end == begin ) {
+            continue;
+        }
+        const int nb_sectors = band_part_[b + 1] - band_part_[b];
+        const idx_t j0       = band_row_[b];
+        const idx_t nb_rows  = idx_t( ( band_split_[b + 1] - band_split_[b] ) / size_t( nb_sectors + 1 ) );
+
+        std::vector<idx_t> i_begin( nb_rows );
+        std::vector<idx_t> i_end( nb_rows );
+        long x_min = std::numeric_limits<long>::max();
+        long x_max = std::numeric_limits<long>::min();
+        for ( idx_t r = 0; r < nb_rows; ++r ) {
+            const idx_t j = j0 + r;
+            i_begin[r]    = idx_t( std::max( begin, row_begin_[j] ) - row_begin_[j] );
+            i_end[r]      = idx_t( std::min( end, row_begin_[j + 1] ) - row_begin_[j] );
+            x_min         = std::min<long>( x_min, microdeg( structured_grid.x( i_begin[r], j ) ) );
+            x_max         = std::max<long>( x_max, microdeg( structured_grid.x( i_end[r] - 1, j ) ) );
+        }
+
+        // Number of points in row r of the band with micro-degree longitude smaller than X
+        auto count_west_of = [&]( idx_t r, long X ) -> idx_t {
+            const idx_t j = j0 + r;
+            idx_t lo      = i_begin[r];
+            idx_t hi      = i_end[r];
+            while ( lo < hi ) {
+                idx_t mid = lo + ( hi - lo ) / 2;
+                if ( microdeg( structured_grid.x( mid, j ) ) < X ) {
+                    lo = mid + 1;
+                }
+                else {
+                    hi = mid;
+                }
+            }
+            return lo - i_begin[r];
+        };
+        auto count_west = [&]( long X ) -> gidx_t {
+            gidx_t n = 0;
+            for ( idx_t r = 0; r < nb_rows; ++r ) {
+                n += count_west_of( r, X );
+            }
+            return n;
+        };
+
+        idx_t* split = split_.data() + band_split_[b];
+        gidx_t nb_before( 0 );
+        for ( int s = 0; s <= nb_sectors; ++s ) {
+            const gidx_t n = nb_before;
+            if ( s < nb_sectors ) {
+                nb_before += nb_pts_[band_part_[b] + s];
+            }
+            if ( n == 0 || n == end - begin ) {
+                for ( idx_t r = 0; r < nb_rows; ++r ) {
+                    split[r * ( nb_sectors + 1 ) + s] = ( n == 0 ? i_begin[r] : i_end[r] );
+                }
+                continue;
+            }
+            // Largest X with count_west( X ) <= n < count_west( X + 1 )
+            long lo = x_min;
+            long hi = x_max + 1;
+            while ( hi - lo > 1 ) {
+                long mid = lo + ( hi - lo ) / 2;
+                if ( count_west( mid ) <= n ) {
+                    lo = mid;
+                }
+                else {
+                    hi = mid;
+                }
+            }
+            // Points on meridian X are taken from north to south
+            gidx_t remaining = n;
+            for ( idx_t r = 0; r < nb_rows; ++r ) {
+                remaining -= count_west_of( r, lo );
+            }
+            for ( idx_t r = 0; r < nb_rows; ++r ) {
+                const idx_t west = count_west_of( r, lo );
+                const idx_t take = idx_t( std::min<gidx_t>( remaining, count_west_of( r, lo + 1 ) - west ) );
+                remaining -= take;
+                split[r * ( nb_sectors + 1 ) + s] = i_begin[r] + west + take;
+            }
+        }
+    }
+}
+
+int EqualRegionsDistribution::partition( const gidx_t gidx ) const {
+    const idx_t j = idx_t( std::upper_bound( row_begin_.begin(), row_begin_.end(), gidx ) - row_begin_.begin() ) - 1;
+    const idx_t b = idx_t( std::upper_bound( band_begin_.begin(), band_begin_.end(), gidx ) - band_begin_.begin() ) - 1;
+    const idx_t i = idx_t( gidx - row_begin_[j] );
+    const int nb_sectors = band_part_[b + 1] - band_part_[b];
+    const idx_t* split   = split_.data() + band_split_[b] + size_t( j - band_row_[b] ) * size_t( nb_sectors + 1 );
+    return band_part_[b] + int( std::upper_bound( split, split + nb_sectors + 1, i ) - split ) - 1;
+}
+
+void EqualRegionsDistribution::print( std::ostream& s ) const {
+    s << "Distribution( "
+      << "type: " << type_ << ", nb_points: " << size_ << ", nb_partitions: " << nb_pts_.size()
+      << ", nb_bands: " << band_begin_.size() - 1 << " )";
+}
+
+}  // namespace grid
+}  // namespace atlas
@@ -0,0 +1,55 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "atlas/grid/detail/distribution/DistributionImpl.h"
+
+namespace atlas {
+namespace grid {
+
+/// @brief Compact description of the "equal_regions" partitioning of a StructuredGrid
+///
+/// Instead of storing the partition of every grid point, the distribution stores for every band of
+/// the EqualRegionsPartitioner, and for every grid row within that band, the index i where each sector
+/// begins. Memory scales with the number of partitions times the number of rows per band, and
+/// partition(gidx) is answered with binary searches in O(log P).
+/// The result is identical to the one of EqualRegionsPartitioner::partition( grid, part[] ).
+class EqualRegionsDistribution : public DistributionImpl {
+public:
+    /// @brief True if a compact distribution can be created for this grid and partitioner
+    static bool supports( const Grid&, const Partitioner& );
+
+    EqualRegionsDistribution( const Grid&, const Partitioner& );
+
+    virtual int partition( const gidx_t gidx ) const override;
+
+    using DistributionImpl::partition;
+
+    virtual bool functional() const override { return true; }
+
+    virtual gidx_t size() const override { return size_; }
+
+    virtual void print( std::ostream& ) const override;
+
+private:
+    gidx_t size_;
+    std::vector<gidx_t> row_begin_;   // global index of first point of every row, size ny+1
+    std::vector<gidx_t> band_begin_;  // global index of first point of every band, size nb_bands+1
+    std::vector<int> band_part_;      // first partition of every band, size nb_bands+1
+    std::vector<idx_t> band_row_;     // first row of every band
+    std::vector<size_t> band_split_;  // offset of every band in split_
+    std::vector<idx_t> split_;        // per band, per row: begin of every sector, and end of last sector
+};
+
+}  // namespace grid
+}  // namespace atlas
@@ -10,17 +10,20 @@
 
 #include "atlas/grid/detail/partitioner/MatchingMeshPartitionerLonLatPolygon.h"
 
+#include <algorithm>
+#include <string>
 #include <vector>
 
-#include "eckit/config/Resource.h"
-#include "eckit/log/ProgressTimer.h"
-
 #include "atlas/grid/Grid.h"
 #include "atlas/grid/Iterator.h"
+#include "atlas/grid/StructuredGrid.h"
 #include "atlas/mesh/Nodes.h"
 #include "atlas/parallel/mpi/mpi.h"
+#include "atlas/parallel/omp/fill.h"
+#include "atlas/parallel/omp/omp.h"
 #include "atlas/runtime/Exception.h"
 #include "atlas/runtime/Log.h"
+#include "atlas/runtime/Trace.h"
 #include "atlas/util/CoordinateEnums.h"
 #include "atlas/util/LonLatPolygon.h"
 
@@ -51,22 +54,80 @@ void MatchingMeshPartitionerLonLatPolygon::partition( const Grid& grid, int part
 
     const util::LonLatPolygon poly( prePartitionedMesh_.polygon( 0 ), prePartitionedMesh_.nodes().lonlat() );
 
-    {
-        eckit::ProgressTimer timer( "Partitioning", grid.size(), "point", double( 10 ), atlas::Log::trace() );
-        size_t i = 0;
+    const double lat_max = poly.coordinatesMax()[LAT];
+    const double lat_min = poly.coordinatesMin()[LAT];
 
-        for ( const PointLonLat& P : grid.lonlat() ) {
-            ++timer;
-            const bool atThePole = ( includesNorthPole && P[LAT] >= poly.coordinatesMax()[LAT] ) ||
-                                   ( includesSouthPole && P[LAT] < poly.coordinatesMin()[LAT] );
+    auto contains = [&]( const PointLonLat& P ) {
+        const bool atThePole = ( includesNorthPole && P[LAT] >= lat_max ) || ( includesSouthPole && P[LAT] < lat_min );
+        return atThePole || poly.contains( P );
+    };
 
-            partitioning[i++] = atThePole || poly.contains( P ) ? mpi_rank : -1;
+    const gidx_t size = grid.size();
+    {
+        ATLAS_TRACE( "point-in-polygon check for entire grid (" + std::to_string( size ) + " points)" );
+        StructuredGrid structured( grid );
+        if ( structured && not grid.projection() ) {
+            // Rows are latitudes: skip rows outside the latitude range of the polygon at once
+            const idx_t ny = structured.ny();
+            std::vector<gidx_t> row_begin( ny + 1, 0 );
+            for ( idx_t j = 0; j < ny; ++j ) {
+                row_begin[j + 1] = row_begin[j] + structured.nx( j );
+            }
+            atlas_omp_pragma( omp parallel for schedule( dynamic, 1 ) )
+            for ( idx_t j = 0; j < ny; ++j ) {
+                const double lat = structured.y( j );
+                int* row         = partitioning + row_begin[j];
+                const bool skip =
+                    ( lat > lat_max && not includesNorthPole ) || ( lat < lat_min && not includesSouthPole );
+                for ( idx_t i = 0; i < structured.nx( j ); ++i ) {
+                    row[i] = not skip && contains( structured.lonlat( i, j ) ) ? mpi_rank : -1;
+                }
+            }
+        }
+        else {
+            const size_t num_threads = atlas_omp_get_max_threads();
+            const size_t chunks      = std::max( size_t( 1 ), std::min( size_t( size ), 1000 * num_threads ) );
+            atlas_omp_pragma( omp parallel for schedule( dynamic, 1 ) )
+            for ( size_t chunk = 0; chunk < chunks; ++chunk ) {
+                const gidx_t begin = gidx_t( chunk * size_t( size ) / chunks );
+                const gidx_t end   = gidx_t( ( chunk + 1 ) * size_t( size ) / chunks );
+                auto it            = grid.lonlat().begin();
+                it += begin;
+                for ( gidx_t n = begin; n < end; ++n, ++it ) {
+                    partitioning[n] = contains( *it ) ? mpi_rank : -1;
+                }
+            }
+        }
+    }
+
+    // Synchronize partitioning: partitions are contiguous ranges of the grid for most grids and partitioners,
+    // so exchange [begin,end) ranges rather than reducing a global array. As with a max-reduction, the highest
+    // rank wins for points contained in several partitions.
+    std::vector<gidx_t> ranges;
+    for ( gidx_t n = 0; n < size; ++n ) {
+        if ( partitioning[n] == mpi_rank ) {
+            if ( ranges.empty() || ranges.back() != n ) {
+                ranges.push_back( n );
+                ranges.push_back( n + 1 );
+            }
+            else {
+                ranges.back() = n + 1;
+            }
+        }
+    }
+    eckit::mpi::Buffer<gidx_t> recv_ranges( mpi_size );
+    ATLAS_TRACE_MPI( ALLGATHER ) { comm.allGatherv( ranges.begin(), ranges.end(), recv_ranges ); }
+
+    omp::fill( partitioning, partitioning + size, -1 );
+    for ( int p = 0; p < mpi_size; ++p ) {
+        const gidx_t* range = recv_ranges.buffer.data() + recv_ranges.displs[p];
+        for ( int r = 0; r < recv_ranges.counts[p]; r += 2 ) {
+            std::fill( partitioning + range[r], partitioning + range[r + 1], p );
         }
     }
 
-    // Synchronize partitioning, do a sanity check
-    comm.allReduceInPlace( partitioning, grid.size(), eckit::mpi::Operation::MAX );
-    const int min = *std::min_element( partitioning, partitioning + grid.size() );
+    // Sanity check
+    const int min = *std::min_element( partitioning, partitioning + size );
     if ( min < 0 ) {
         throw_Exception(
             "Could not find partition for target node (source "
@@ -12,25 +12,29 @@
 /// @author Willem Deconinck
 /// @date   Jan 2014
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
+#include <sstream>
+#include <vector>
 
-#include "atlas/array.h"
 #include "atlas/grid/detail/spacing/gaussian/Latitudes.h"
 #include "atlas/grid/detail/spacing/gaussian/N.h"
 #include "atlas/library/config.h"
+#include "atlas/parallel/omp/omp.h"
 #include "atlas/runtime/Exception.h"
 #include "atlas/runtime/Log.h"
+#include "atlas/runtime/Trace.h"
 #include "atlas/util/Constants.h"
 #include "atlas/util/CoordinateEnums.h"
+#include "atlas/util/Object.h"
+#include "atlas/util/ObjectHandle.h"
+#include "atlas/util/detail/Cache.h"
 
 //using eckit::ConcreteBuilderT0;
 //using eckit::Factory;
 
-using atlas::array::Array;
-using atlas::array::ArrayView;
-using atlas::array::make_view;
-
 namespace atlas {
 namespace grid {
 namespace spacing {
@@ -42,6 +46,27 @@ void compute_gaussian_quadrature_npole_equator( const size_t N, double lat[], do
 
 //-----------------------------------------------------------------------------
 
+namespace {
+
+/// Computed latitudes and weights for one N, kept for the lifetime of the program
+class GaussianQuadrature : public util::Object {
+public:
+    GaussianQuadrature( size_t N ) : lats( N ), weights( N ) {
+        compute_gaussian_quadrature_npole_equator( N, lats.data(), weights.data() );
+    }
+    std::vector<double> lats;
+    std::vector<double> weights;
+};
+
+util::ObjectHandle<GaussianQuadrature> cached_gaussian_quadrature( size_t N ) {
+    static util::Cache<size_t, GaussianQuadrature> cache( "GaussianQuadrature" );
+    return cache.get_or_create( N, [N]() { return new GaussianQuadrature( N ); } );
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+
 void gaussian_latitudes_npole_equator( const size_t N, double lats[] ) {
     std::stringstream Nstream;
     Nstream << N;
@@ -55,8 +80,8 @@ void gaussian_latitudes_npole_equator( const size_t N, double lats[] ) {
     //        gl->assign( lats, N );
     //    }
     else {
-        std::vector<double> weights( N );
-        compute_gaussian_quadrature_npole_equator( N, lats, weights.data() );
+        auto quadrature = cached_gaussian_quadrature( N );
+        std::copy( quadrature->lats.begin(), quadrature->lats.end(), lats );
     }
 }
 
@@ -73,7 +98,9 @@ void gaussian_latitudes_npole_spole( const size_t N, double lats[] ) {
 //-----------------------------------------------------------------------------
 
 void gaussian_quadrature_npole_equator( const size_t N, double lats[], double weights[] ) {
-    compute_gaussian_quadrature_npole_equator( N, lats, weights );
+    auto quadrature = cached_gaussian_quadrature( N );
+    std::copy( quadrature->lats.begin(), quadrature->lats.end(), lats );
+    std::copy( quadrature->weights.begin(), quadrature->weights.end(), weights );
 }
 
 //-----------------------------------------------------------------------------
@@ -170,7 +197,7 @@ void legpol_weight( const int kn, const double pfn[], const double px, double& p
 
 //-----------------------------------------------------------------------------
 
-void legpol_quadrature( const int kn, const double pfn[], double& pl, double& pw, int& kiter, double& pmod ) {
+bool legpol_quadrature( const int kn, const double pfn[], double& pl, double& pw, int& kiter, double& pmod ) {
     //**** *GAWL * - Routine to perform the Newton loop
 
     //     Purpose.
@@ -189,6 +216,7 @@ void legpol_quadrature( const int kn, const double pfn[], double& pl, double& pw
     // KN     Truncation                                (in)
     // KITER  Number of iterations                      (out)
     // PMOD   Last modification                         (inout)
+    // Returns false if the iteration did not converge
 
     int iflag, itemax;
 
@@ -222,14 +250,12 @@ void legpol_quadrature( const int kn, const double pfn[], double& pl, double& pw
         }
     }
     if ( iflag != 1 ) {
-        std::stringstream s;
-        s << "Could not converge gaussian latitude to accuracy [" << zeps * 1000 << "]\n";
-        s << "after " << itemax << " iterations. Consequently also failed to compute quadrature weight.";
-        throw_Exception( s.str(), Here() );
+        return false;
     }
 
     pl = zxn;
     pw = zw;
+    return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -239,56 +265,59 @@ void legpol_quadrature( const int kn, const double pfn[], double& pl, double& pw
 //-----------------------------------------------------------------------------
 
 void compute_gaussian_quadrature_npole_equator( const size_t N, double lats[], double weights[] ) {
+    ATLAS_TRACE( "compute_gaussian_quadrature_npole_equator" );
     Log::debug() << "Atlas computing Gaussian latitudes for N " << N << "\n";
 
-    // Compute first guess for colatitudes in radians
-    double z;
-    for ( size_t i = 0; i < N; ++i ) {
-        z       = ( 4. * ( i + 1. ) - 1. ) * M_PI / ( 4. * 2. * N + 2. );
-        lats[i] = ( z + 1. / ( tan( z ) * ( 8. * ( 2. * N ) * ( 2. * N ) ) ) );
-    }
-
-    int kdgl = 2 * N;
-    array::ArrayT<double> zfn_( kdgl + 1, kdgl + 1 );
-    ArrayView<double, 2> zfn = make_view<double, 2>( zfn_ );
-
-    int iodd;
+    const int kdgl = 2 * N;
+    const int iodd = kdgl % 2;
 
+    // Fourier coefficients of the series expansion of the normalised Legendre polynomial of degree kdgl.
     // Belousov, Swarztrauber use zfn(0,0)=std::sqrt(2.)
     // IFS normalisation chosen to be 0.5*Integral(Pnm**2) = 1
-    zfn( 0, 0 ) = 2.;
-    for ( int jn = 1; jn <= kdgl; ++jn ) {
-        double zfnn = zfn( 0, 0 );
-        for ( int jgl = 1; jgl <= jn; ++jgl ) {
-            zfnn *= std::sqrt( 1. - 0.25 / ( static_cast<double>( jgl * jgl ) ) );
-        }
-        iodd          = jn % 2;
-        zfn( jn, jn ) = zfnn;
-        for ( int jgl = 2; jgl <= jn - iodd; jgl += 2 ) {
-            zfn( jn, jn - jgl ) = zfn( jn, jn - jgl + 2 ) * static_cast<double>( ( jgl - 1 ) * ( 2 * jn - jgl + 2 ) ) /
-                                  static_cast<double>( jgl * ( 2 * jn - jgl + 1 ) );
-        }
+    // Only row kdgl of the triangle zfn(jn,jgl) is needed, which is computed directly in O(N) memory.
+    std::vector<double> zfn( kdgl + 1 );
+    double zfnn = 2.;
+    for ( int jgl = 1; jgl <= kdgl; ++jgl ) {
+        zfnn *= std::sqrt( 1. - 0.25 / ( static_cast<double>( jgl * jgl ) ) );
+    }
+    zfn[kdgl] = zfnn;
+    for ( int jgl = 2; jgl <= kdgl - iodd; jgl += 2 ) {
+        zfn[kdgl - jgl] = zfn[kdgl - jgl + 2] * static_cast<double>( ( jgl - 1 ) * ( 2 * kdgl - jgl + 2 ) ) /
+                          static_cast<double>( jgl * ( 2 * kdgl - jgl + 1 ) );
     }
-
-    iodd   = kdgl % 2;
-    int ik = iodd;
 
     std::vector<double> zzfn( N + 1 );
-    std::vector<double> zmod( kdgl );
-    std::vector<int> iter( kdgl );
-
+    int ik = iodd;
     for ( int jgl = iodd; jgl <= kdgl; jgl += 2 ) {
-        zzfn[ik] = zfn( kdgl, jgl );
+        zzfn[ik] = zfn[jgl];
         ++ik;
     }
 
+    // Every root is refined independently, on OpenMP threads
     const double pole = 90.;
+    size_t nb_failed  = 0;
+    atlas_omp_pragma( omp parallel for schedule( static ) reduction( + : nb_failed ) )
     for ( size_t jgl = 0; jgl < N; ++jgl ) {
+        // First guess for colatitude in radians
+        const double z = ( 4. * ( jgl + 1. ) - 1. ) * M_PI / ( 4. * 2. * N + 2. );
+        double colat   = ( z + 1. / ( tan( z ) * ( 8. * ( 2. * N ) * ( 2. * N ) ) ) );
+
         // refine colat first guess here via Newton's method
-        legpol_quadrature( kdgl, zzfn.data(), lats[jgl], weights[jgl], iter[jgl], zmod[jgl] );
+        int iter;
+        double zmod;
+        if ( not legpol_quadrature( kdgl, zzfn.data(), colat, weights[jgl], iter, zmod ) ) {
+            ++nb_failed;
+        }
 
         // Convert colat to lat, in degrees
-        lats[jgl] = pole - lats[jgl] * util::Constants::radiansToDegrees();
+        lats[jgl] = pole - colat * util::Constants::radiansToDegrees();
+    }
+    if ( nb_failed ) {
+        std::stringstream s;
+        s << "Could not converge " << nb_failed << " gaussian latitudes for N " << N << " to accuracy ["
+          << std::numeric_limits<double>::epsilon() * 1000 << "]\n";
+        s << "after 20 iterations. Consequently also failed to compute quadrature weights.";
+        throw_Exception( s.str(), Here() );
     }
 }
 
@@ -0,0 +1,469 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include "atlas/interpolation/Cache.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "eckit/config/Configuration.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/linalg/SparseMatrix.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/Mutex.h"
+#include "eckit/utils/MD5.h"
+#include "eckit/utils/Translator.h"
+
+#include "atlas/array/Array.h"
+#include "atlas/field/Field.h"
+#include "atlas/functionspace/NodeColumns.h"
+#include "atlas/functionspace/PointCloud.h"
+#include "atlas/functionspace/StructuredColumns.h"
+#include "atlas/grid/Grid.h"
+#include "atlas/mesh/Elements.h"
+#include "atlas/mesh/HybridElements.h"
+#include "atlas/mesh/Mesh.h"
+#include "atlas/mesh/Nodes.h"
+#include "atlas/parallel/mpi/mpi.h"
+#include "atlas/runtime/Exception.h"
+#include "atlas/runtime/Log.h"
+#include "atlas/runtime/Trace.h"
+
+namespace atlas {
+namespace interpolation {
+
+namespace {
+
+constexpr std::uint64_t FORMAT_VERSION  = 1;
+constexpr std::uint64_t BYTE_ORDER_MARK = 0x0102030405060708;
+constexpr size_t ALIGNMENT              = 64;
+
+/// First 64 bytes of a cache file, followed by the 64-byte aligned arrays outer, inner and data
+struct Header {
+    char magic[16];
+    std::uint64_t version;
+    std::uint64_t byte_order;
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint64_t nonZeros;
+    char reserved[8];
+};
+static_assert( sizeof( Header ) == ALIGNMENT, "Header should fill the first aligned block" );
+
+const char* magic() {
+    return "atlas-matrix";
+}
+
+size_t aligned( size_t bytes ) {
+    return ( bytes + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT;
+}
+
+/// Offsets of the arrays in a cache file, and its size
+struct Layout {
+    Layout( size_t rows, size_t nonZeros ) {
+        using Index = MatrixCacheEntry::Index;
+        outer       = sizeof( Header );
+        inner       = aligned( outer + ( rows + 1 ) * sizeof( Index ) );
+        data        = aligned( inner + nonZeros * sizeof( Index ) );
+        size        = data + nonZeros * sizeof( double );
+    }
+    size_t outer;
+    size_t inner;
+    size_t data;
+    size_t size;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class OwnedMatrixCacheEntry final : public MatrixCacheEntry {
+public:
+    OwnedMatrixCacheEntry( const Cache::Matrix& matrix ) {
+        rows_     = matrix.rows();
+        cols_     = matrix.cols();
+        nonZeros_ = matrix.nonZeros();
+        ATLAS_ASSERT( cols_ <= size_t( std::numeric_limits<Index>::max() ) );
+        ATLAS_ASSERT( nonZeros_ <= size_t( std::numeric_limits<Index>::max() ) );
+        if ( matrix.empty() ) {
+            outer_vector_.assign( rows_ + 1, 0 );
+        }
+        else {
+            outer_vector_.assign( matrix.outer(), matrix.outer() + rows_ + 1 );
+            inner_vector_.assign( matrix.inner(), matrix.inner() + nonZeros_ );
+            data_vector_.assign( matrix.data(), matrix.data() + nonZeros_ );
+        }
+        outer_ = outer_vector_.data();
+        inner_ = inner_vector_.data();
+        data_  = data_vector_.data();
+    }
+
+private:
+    std::vector<Index> outer_vector_;
+    std::vector<Index> inner_vector_;
+    std::vector<double> data_vector_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Read-only memory mapping of a cache file
+class MappedMatrixCacheEntry final : public MatrixCacheEntry {
+public:
+    MappedMatrixCacheEntry( const eckit::PathName& path ) : path_( path ) {
+        int fd = ::open( path.localPath(), O_RDONLY );
+        if ( fd < 0 ) {
+            throw_CantOpenFile( path_, Here() );
+        }
+        struct stat st;
+        if ( ::fstat( fd, &st ) != 0 ) {
+            ::close( fd );
+            throw_CantOpenFile( path_, Here() );
+        }
+        size_ = size_t( st.st_size );
+        map_  = size_ ? ::mmap( nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0 ) : MAP_FAILED;
+        ::close( fd );
+        if ( map_ == MAP_FAILED ) {
+            throw_Exception( "Could not map interpolation cache file " + std::string( path_ ), Here() );
+        }
+        try {
+            read_header();
+        }
+        catch ( ... ) {
+            ::munmap( map_, size_ );
+            throw;
+        }
+    }
+
+    ~MappedMatrixCacheEntry() override { ::munmap( map_, size_ ); }
+
+private:
+    void read_header() {
+        if ( size_ < sizeof( Header ) ) {
+            invalid( "file too small" );
+        }
+        const Header& header = *static_cast<const Header*>( map_ );
+        if ( std::strncmp( header.magic, magic(), sizeof( header.magic ) ) != 0 ) {
+            invalid( "not an interpolation matrix" );
+        }
+        if ( header.byte_order != BYTE_ORDER_MARK ) {
+            invalid( "written with different byte order" );
+        }
+        if ( header.version != FORMAT_VERSION ) {
+            invalid( "unsupported version " + std::to_string( header.version ) );
+        }
+        rows_     = size_t( header.rows );
+        cols_     = size_t( header.cols );
+        nonZeros_ = size_t( header.nonZeros );
+        const Layout layout( rows_, nonZeros_ );
+        if ( layout.size != size_ ) {
+            invalid( "unexpected file size" );
+        }
+        const char* begin = static_cast<const char*>( map_ );
+        outer_            = reinterpret_cast<const Index*>( begin + layout.outer );
+        inner_            = reinterpret_cast<const Index*>( begin + layout.inner );
+        data_             = reinterpret_cast<const double*>( begin + layout.data );
+        if ( outer_[0] != 0 || size_t( outer_[rows_] ) != nonZeros_ ) {
+            invalid( "corrupt row offsets" );
+        }
+    }
+
+    [[noreturn]] void invalid( const std::string& reason ) const {
+        throw_Exception( "Invalid interpolation cache file " + std::string( path_ ) + ": " + reason, Here() );
+    }
+
+    eckit::PathName path_;
+    void* map_;
+    size_t size_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void write( const eckit::PathName& path, const MatrixCacheEntry& matrix ) {
+    using Index = MatrixCacheEntry::Index;
+    const Layout layout( matrix.rows(), matrix.nonZeros() );
+
+    Header header{};
+    std::strncpy( header.magic, magic(), sizeof( header.magic ) );
+    header.version    = FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.rows       = matrix.rows();
+    header.cols       = matrix.cols();
+    header.nonZeros   = matrix.nonZeros();
+
+    // Written under a temporary name, so that a partially written file is never read
+    // Unique per process and per call, so that threads storing the same key do not write the same file
+    static std::atomic<unsigned long> counter{0};
+    const eckit::PathName tmp = path + ".tmp" + std::to_string( ::getpid() ) + "." + std::to_string( counter++ );
+    {
+        std::ofstream out( tmp.localPath(), std::ios::binary );
+        if ( not out ) {
+            throw_CantOpenFile( tmp, Here() );
+        }
+        static const char zeros[ALIGNMENT] = {};
+        auto write_at                      = [&]( size_t offset, const void* data, size_t bytes ) {
+            out.write( zeros, std::streamsize( offset - size_t( out.tellp() ) ) );
+            out.write( static_cast<const char*>( data ), std::streamsize( bytes ) );
+        };
+        write_at( 0, &header, sizeof( Header ) );
+        write_at( layout.outer, matrix.outer(), ( matrix.rows() + 1 ) * sizeof( Index ) );
+        write_at( layout.inner, matrix.inner(), matrix.nonZeros() * sizeof( Index ) );
+        write_at( layout.data, matrix.data(), matrix.nonZeros() * sizeof( double ) );
+        out.close();
+        if ( not out ) {
+            throw_Exception( "Could not write interpolation cache file " + std::string( tmp ), Here() );
+        }
+    }
+    eckit::PathName::rename( tmp, path );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool hash_config( const eckit::Parametrisation& config, eckit::Hash& h ) {
+    const auto* configuration = dynamic_cast<const eckit::Configuration*>( &config );
+    if ( configuration == nullptr ) {
+        return false;
+    }
+    configuration->hash( h );
+    return true;
+}
+
+bool hash_field( const Field& field, eckit::Hash& h ) {
+    if ( not field.contiguous() ) {
+        return false;
+    }
+    h.add( field.datatype().str() );
+    h.add( long( field.size() ) );
+    h.add( field.array().storage(), long( size_t( field.size() ) * field.datatype().size() ) );
+    return true;
+}
+
+/// Element types and element-node connectivity, on which the finite-element weights depend
+void hash_cells( const mesh::HybridElements& cells, eckit::Hash& h ) {
+    h.add( long( cells.nb_types() ) );
+    for ( idx_t t = 0; t < cells.nb_types(); ++t ) {
+        h.add( cells.elements( t ).name() );
+        h.add( long( cells.elements( t ).size() ) );
+    }
+    const mesh::MultiBlockConnectivity& node_connectivity = cells.node_connectivity();
+    std::vector<idx_t> values;
+    values.reserve( size_t( node_connectivity.rows() ) * 5 );
+    for ( idx_t r = 0; r < node_connectivity.rows(); ++r ) {
+        values.push_back( node_connectivity.cols( r ) );
+        for ( idx_t c = 0; c < node_connectivity.cols( r ); ++c ) {
+            values.push_back( node_connectivity( r, c ) );
+        }
+    }
+    h.add( values.data(), long( values.size() * sizeof( idx_t ) ) );
+}
+
+bool hash_functionspace( const FunctionSpace& functionspace, eckit::Hash& h ) {
+    h.add( functionspace.type() );
+    if ( functionspace::NodeColumns fs = functionspace ) {
+        h.add( long( fs.size() ) );
+        h.add( fs.halo().size() );
+        hash_cells( fs.mesh().cells(), h );
+        return hash_field( fs.nodes().lonlat(), h ) && hash_field( fs.nodes().ghost(), h );
+    }
+    if ( functionspace::StructuredColumns fs = functionspace ) {
+        fs.grid().hash( h );
+        return hash_field( fs.xy(), h ) && hash_field( fs.ghost(), h );
+    }
+    if ( functionspace::PointCloud fs = functionspace ) {
+        return hash_field( fs.lonlat(), h ) && hash_field( fs.ghost(), h );
+    }
+    return false;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+size_t MatrixCacheEntry::footprint() const {
+    return ( rows_ + 1 + nonZeros_ ) * sizeof( Index ) + nonZeros_ * sizeof( double );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Cache::Implementation {
+public:
+    Implementation( const eckit::PathName& directory, size_t max_memory ) :
+        directory_( directory ),
+        max_memory_( max_memory ) {}
+
+    std::shared_ptr<const MatrixCacheEntry> get( const std::string& key ) {
+        eckit::AutoLock<eckit::Mutex> lock( mutex_ );
+        auto found = index_.find( key );
+        if ( found != index_.end() ) {
+            entries_.splice( entries_.begin(), entries_, found->second );
+            return found->second->second;
+        }
+        if ( directory_.asString().empty() || not file( key ).exists() ) {
+            return nullptr;
+        }
+        std::shared_ptr<const MatrixCacheEntry> entry;
+        try {
+            entry = std::make_shared<MappedMatrixCacheEntry>( file( key ) );
+        }
+        catch ( const eckit::Exception& e ) {
+            Log::warning() << e.what() << std::endl;
+            return nullptr;
+        }
+        keep( key, entry );
+        return entry;
+    }
+
+    void insert( const std::string& key, const Matrix& matrix ) {
+        std::shared_ptr<const MatrixCacheEntry> entry = std::make_shared<OwnedMatrixCacheEntry>( matrix );
+        if ( not directory_.asString().empty() ) {
+            // Failing to store the matrix on disk must not fail the interpolation
+            try {
+                if ( not directory_.exists() ) {
+                    directory_.mkdir();
+                }
+                write( file( key ), *entry );
+
+                // Keep the mapped file rather than a second copy of the matrix in memory
+                entry = std::make_shared<MappedMatrixCacheEntry>( file( key ) );
+            }
+            catch ( const eckit::Exception& e ) {
+                Log::warning() << "Interpolation matrix not stored in cache: " << e.what() << std::endl;
+            }
+        }
+        eckit::AutoLock<eckit::Mutex> lock( mutex_ );
+        keep( key, entry );
+    }
+
+    size_t footprint() {
+        eckit::AutoLock<eckit::Mutex> lock( mutex_ );
+        return footprint_;
+    }
+
+    void clear() {
+        eckit::AutoLock<eckit::Mutex> lock( mutex_ );
+        entries_.clear();
+        index_.clear();
+        footprint_ = 0;
+    }
+
+    const eckit::PathName& directory() const { return directory_; }
+
+private:
+    eckit::PathName file( const std::string& key ) const {
+        return directory_ / ( key + "." + std::to_string( mpi::comm().rank() ) + ".matrix" );
+    }
+
+    /// Keep entry in memory as most recently used, and evict the least recently used entries beyond max_memory_
+    void keep( const std::string& key, const std::shared_ptr<const MatrixCacheEntry>& entry ) {
+        erase( key );
+        if ( entry->footprint() > max_memory_ ) {
+            return;
+        }
+        entries_.emplace_front( key, entry );
+        index_[key] = entries_.begin();
+        footprint_ += entry->footprint();
+        while ( footprint_ > max_memory_ ) {
+            erase( entries_.back().first );
+        }
+    }
+
+    void erase( const std::string& key ) {
+        auto found = index_.find( key );
+        if ( found != index_.end() ) {
+            footprint_ -= found->second->second->footprint();
+            entries_.erase( found->second );
+            index_.erase( found );
+        }
+    }
+
+    using Entries = std::list<std::pair<std::string, std::shared_ptr<const MatrixCacheEntry>>>;
+
+    eckit::Mutex mutex_;
+    eckit::PathName directory_;
+    size_t max_memory_;
+    size_t footprint_{0};
+    Entries entries_;
+    std::unordered_map<std::string, Entries::iterator> index_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::string Cache::key( const eckit::Parametrisation& config, const Grid& source, const Grid& target ) {
+    eckit::MD5 md5;
+    md5.add( "grids" );
+    if ( not hash_config( config, md5 ) ) {
+        return std::string();
+    }
+    source.hash( md5 );
+    target.hash( md5 );
+    md5.add( long( mpi::comm().size() ) );
+    return md5.digest();
+}
+
+std::string Cache::key( const eckit::Parametrisation& config, const FunctionSpace& source,
+                        const FunctionSpace& target ) {
+    ATLAS_TRACE( "interpolation::Cache::key" );
+    eckit::MD5 md5;
+    md5.add( "functionspaces" );
+    if ( not hash_config( config, md5 ) || not hash_functionspace( source, md5 ) ||
+         not hash_functionspace( target, md5 ) ) {
+        return std::string();
+    }
+    md5.add( long( mpi::comm().size() ) );
+    return md5.digest();
+}
+
+size_t Cache::default_max_memory() {
+    const char* env = ::getenv( "ATLAS_INTERPOLATION_CACHE_MEMORY" );
+    if ( env ) {
+        return size_t( eckit::Translator<std::string, unsigned long long>()( env ) );
+    }
+    return size_t( 1 ) << 30;
+}
+
+Cache::Cache( size_t max_memory ) : impl_( std::make_shared<Implementation>( eckit::PathName(), max_memory ) ) {}
+
+Cache::Cache( const eckit::PathName& directory, size_t max_memory ) :
+    impl_( std::make_shared<Implementation>( directory, max_memory ) ) {}
+
+std::shared_ptr<const MatrixCacheEntry> Cache::get( const std::string& key ) const {
+    return impl_->get( key );
+}
+
+void Cache::insert( const std::string& key, const Matrix& matrix ) const {
+    ATLAS_TRACE( "interpolation::Cache::insert" );
+    impl_->insert( key, matrix );
+}
+
+size_t Cache::footprint() const {
+    return impl_->footprint();
+}
+
+void Cache::clear() const {
+    impl_->clear();
+}
+
+const eckit::PathName& Cache::directory() const {
+    return impl_->directory();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace interpolation
+}  // namespace atlas
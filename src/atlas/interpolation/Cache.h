@@ -0,0 +1,128 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "eckit/filesystem/PathName.h"
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+
+namespace eckit {
+class Parametrisation;
+namespace linalg {
+class SparseMatrix;
+}
+}  // namespace eckit
+
+namespace atlas {
+class FunctionSpace;
+class Grid;
+}  // namespace atlas
+
+//-----------------------------------------------------------------------------
+
+namespace atlas {
+namespace interpolation {
+
+//-----------------------------------------------------------------------------
+
+/// @brief Interpolation matrix of one MPI task in compressed row storage, as held by an interpolation::Cache
+///
+/// The arrays are either owned by the entry, or point into a memory-mapped cache file.
+class MatrixCacheEntry {
+public:
+    using Index = std::int32_t;
+
+    virtual ~MatrixCacheEntry() = default;
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t nonZeros() const { return nonZeros_; }
+    bool empty() const { return nonZeros_ == 0; }
+
+    const Index* outer() const { return outer_; }
+    const Index* inner() const { return inner_; }
+    const double* data() const { return data_; }
+
+    /// @brief Number of bytes of the matrix
+    size_t footprint() const;
+
+protected:
+    size_t rows_{0};
+    size_t cols_{0};
+    size_t nonZeros_{0};
+    const Index* outer_{nullptr};
+    const Index* inner_{nullptr};
+    const double* data_{nullptr};
+};
+
+//-----------------------------------------------------------------------------
+
+/// @brief Cache of interpolation matrices, shared by all copies of the Cache
+///
+/// Matrices are looked up by a key that identifies the interpolation method and its source and target.
+/// The most recently used matrices are kept in memory, up to a maximum footprint. When a directory is given,
+/// every matrix is also stored there in a compact binary file per MPI task, and memory-mapped when it is
+/// requested again, e.g. by another process:
+///
+///     interpolation::Cache cache( "interpolation-cache" );
+///     Interpolation interpolation( util::Config( "type", "finite-element" ), source, target, cache );
+class Cache {
+public:
+    using Matrix = eckit::linalg::SparseMatrix;
+
+    /// @brief Key of the matrix that interpolates with given method configuration between two grids
+    /// Returns an empty key if the configuration cannot be hashed.
+    static std::string key( const eckit::Parametrisation& config, const Grid& source, const Grid& target );
+
+    /// @brief Key of the matrix that interpolates with given method configuration between two function spaces
+    /// Function spaces are identified by their point coordinates on this MPI task, and NodeColumns also by the
+    /// halo and mesh elements. Returns an empty key if the configuration cannot be hashed, or a function space has
+    /// no coordinates (Spectral, ...).
+    static std::string key( const eckit::Parametrisation& config, const FunctionSpace& source,
+                            const FunctionSpace& target );
+
+    /// @brief Cache in memory only
+    explicit Cache( size_t max_memory = default_max_memory() );
+
+    /// @brief Cache in memory, and on disk in given directory
+    explicit Cache( const eckit::PathName& directory, size_t max_memory = default_max_memory() );
+
+    /// @brief Matrix stored under key, from memory or else from disk, or nullptr if not present
+    std::shared_ptr<const MatrixCacheEntry> get( const std::string& key ) const;
+
+    /// @brief Store matrix under key, in memory and on disk
+    void insert( const std::string& key, const Matrix& ) const;
+
+    /// @brief Number of bytes of matrices held in memory
+    size_t footprint() const;
+
+    /// @brief Remove all matrices from memory (files on disk are kept)
+    void clear() const;
+
+    const eckit::PathName& directory() const;
+
+    /// 1 GiB, or value of environment variable ATLAS_INTERPOLATION_CACHE_MEMORY in bytes
+    static size_t default_max_memory();
+
+private:
+    class Implementation;
+    std::shared_ptr<Implementation> impl_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace interpolation
+}  // namespace atlas
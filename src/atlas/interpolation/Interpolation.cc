@@ -49,6 +49,40 @@ Interpolation::Interpolation( const Config& config, const Grid& source, const Gr
     }
 }
 
+Interpolation::Interpolation( const Config& config, const FunctionSpace& source, const FunctionSpace& target,
+                              const interpolation::Cache& cache ) :
+    Handle( [&]() -> Implementation* {
+        std::string type;
+        ATLAS_ASSERT( config.get( "type", type ) );
+        Implementation* impl = interpolation::MethodFactory::build( type, config );
+        impl->cache( cache, interpolation::Cache::key( config, source, target ) );
+        impl->setup( source, target );
+        return impl;
+    }() ) {
+    std::string path;
+    if ( config.get( "output", path ) ) {
+        std::ofstream file( path );
+        print( file );
+    }
+}
+
+Interpolation::Interpolation( const Config& config, const Grid& source, const Grid& target,
+                              const interpolation::Cache& cache ) :
+    Handle( [&]() -> Implementation* {
+        std::string type;
+        ATLAS_ASSERT( config.get( "type", type ) );
+        Implementation* impl = interpolation::MethodFactory::build( type, config );
+        impl->cache( cache, interpolation::Cache::key( config, source, target ) );
+        impl->setup( source, target );
+        return impl;
+    }() ) {
+    std::string path;
+    if ( config.get( "output", path ) ) {
+        std::ofstream file( path );
+        print( file );
+    }
+}
+
 Interpolation::Interpolation( const Config& config, const FunctionSpace& source, const Field& target ) :
     Handle( [&]() -> Implementation* {
         std::string type;
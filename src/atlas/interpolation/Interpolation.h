@@ -49,6 +49,14 @@ public:
     // Setup Interpolation from source grid to target grid
     Interpolation( const Config&, const Grid& source, const Grid& target ) noexcept( false );
 
+    // Setup Interpolation from source to target function space, reusing the matrix stored in cache
+    Interpolation( const Config&, const FunctionSpace& source, const FunctionSpace& target,
+                   const interpolation::Cache& ) noexcept( false );
+
+    // Setup Interpolation from source grid to target grid, reusing the matrix stored in cache
+    Interpolation( const Config&, const Grid& source, const Grid& target,
+                   const interpolation::Cache& ) noexcept( false );
+
     void execute( const FieldSet& source, FieldSet& target ) const;
 
     void execute( const Field& source, Field& target ) const;
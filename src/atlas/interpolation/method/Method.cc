@@ -10,6 +10,12 @@
 
 #include "atlas/interpolation/method/Method.h"
 
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+
 #include "eckit/linalg/LinearAlgebra.h"
 #include "eckit/linalg/Vector.h"
 #include "eckit/log/Timer.h"
@@ -22,6 +28,7 @@
 #include "atlas/field/FieldSet.h"
 #include "atlas/functionspace/NodeColumns.h"
 #include "atlas/mesh/Nodes.h"
+#include "atlas/parallel/mpi/mpi.h"
 #include "atlas/runtime/Exception.h"
 #include "atlas/runtime/Log.h"
 #include "atlas/runtime/Trace.h"
@@ -29,71 +36,175 @@
 namespace atlas {
 namespace interpolation {
 
+namespace {
+
+/// Storage of an eckit SparseMatrix taken from a cache entry, which is kept alive as long as the matrix.
+/// The arrays of the entry are used directly when eckit's index types have the same size, and copied otherwise.
+/// They may be memory-mapped read-only, so the matrix must not be modified.
+class CacheEntryAllocator : public eckit::linalg::SparseMatrix::Allocator {
+    using SparseMatrix = eckit::linalg::SparseMatrix;
+    using Layout       = SparseMatrix::Layout;
+    using Shape        = SparseMatrix::Shape;
+    using Scalar       = eckit::linalg::Scalar;
+    using OuterIndex   = std::remove_pointer<decltype( Layout::outer_ )>::type;
+    using InnerIndex   = std::remove_pointer<decltype( Layout::inner_ )>::type;
+
+public:
+    CacheEntryAllocator( const std::shared_ptr<const MatrixCacheEntry>& entry ) : entry_( entry ) {}
+
+    static constexpr bool wraps = sizeof( OuterIndex ) == sizeof( MatrixCacheEntry::Index ) &&
+                                  sizeof( InnerIndex ) == sizeof( MatrixCacheEntry::Index );
+
+    Layout allocate( Shape& shape ) override {
+        shape.size_ = eckit::linalg::Size( entry_->nonZeros() );
+        shape.rows_ = eckit::linalg::Size( entry_->rows() );
+        shape.cols_ = eckit::linalg::Size( entry_->cols() );
+
+        Layout layout;
+        if ( wraps ) {
+            layout.outer_ = reinterpret_cast<OuterIndex*>( const_cast<MatrixCacheEntry::Index*>( entry_->outer() ) );
+            layout.inner_ = reinterpret_cast<InnerIndex*>( const_cast<MatrixCacheEntry::Index*>( entry_->inner() ) );
+            layout.data_  = const_cast<Scalar*>( entry_->data() );
+            return layout;
+        }
+        layout.outer_ = new OuterIndex[entry_->rows() + 1];
+        layout.inner_ = new InnerIndex[entry_->nonZeros()];
+        layout.data_  = new Scalar[entry_->nonZeros()];
+        std::copy( entry_->outer(), entry_->outer() + entry_->rows() + 1, layout.outer_ );
+        std::copy( entry_->inner(), entry_->inner() + entry_->nonZeros(), layout.inner_ );
+        std::copy( entry_->data(), entry_->data() + entry_->nonZeros(), layout.data_ );
+        entry_.reset();
+        return layout;
+    }
+
+    void deallocate( Layout layout, Shape ) override {
+        if ( not wraps ) {
+            delete[] layout.outer_;
+            delete[] layout.inner_;
+            delete[] layout.data_;
+        }
+        entry_.reset();
+    }
+
+    bool inSharedMemory() const override { return false; }
+
+    void print( std::ostream& out ) const override { out << "CacheEntryAllocator[wraps=" << wraps << "]"; }
+
+private:
+    std::shared_ptr<const MatrixCacheEntry> entry_;
+};
+constexpr bool CacheEntryAllocator::wraps;
+
+}  // namespace
+
+template <typename CompressedRowMatrix>
+void Method::MatrixSinglePrecision::assign( const CompressedRowMatrix& matrix ) {
+    rows_ = matrix.rows();
+    cols_ = matrix.cols();
+    ATLAS_ASSERT( cols_ <= size_t( std::numeric_limits<Index>::max() ) );
+    ATLAS_ASSERT( matrix.nonZeros() <= size_t( std::numeric_limits<Index>::max() ) );
+    if ( matrix.empty() ) {
+        return;
+    }
+    outer_.assign( matrix.outer(), matrix.outer() + rows_ + 1 );
+    inner_.assign( matrix.inner(), matrix.inner() + matrix.nonZeros() );
+    data_.assign( matrix.data(), matrix.data() + matrix.nonZeros() );
+}
+
+Method::MatrixSinglePrecision::MatrixSinglePrecision( const Matrix& matrix ) {
+    assign( matrix );
+}
+
+Method::MatrixSinglePrecision::MatrixSinglePrecision( const MatrixCacheEntry& matrix ) {
+    assign( matrix );
+}
+
+void Method::MatrixSinglePrecision::swap( MatrixSinglePrecision& other ) {
+    std::swap( rows_, other.rows_ );
+    std::swap( cols_, other.cols_ );
+    outer_.swap( other.outer_ );
+    inner_.swap( other.inner_ );
+    data_.swap( other.data_ );
+}
+
 void Method::check_compatibility( const Field& src, const Field& tgt ) const {
     ATLAS_ASSERT( src.datatype() == tgt.datatype() );
     ATLAS_ASSERT( src.rank() == tgt.rank() );
     ATLAS_ASSERT( src.levels() == tgt.levels() );
     ATLAS_ASSERT( src.variables() == tgt.variables() );
 
-    ATLAS_ASSERT( !matrix_.empty() );
-    ATLAS_ASSERT( tgt.shape( 0 ) >= static_cast<idx_t>( matrix_.rows() ) );
-    ATLAS_ASSERT( src.shape( 0 ) >= static_cast<idx_t>( matrix_.cols() ) );
+    const size_t rows = single_precision_weights_ ? matrix_single_.rows() : matrix_.rows();
+    const size_t cols = single_precision_weights_ ? matrix_single_.cols() : matrix_.cols();
+    ATLAS_ASSERT( single_precision_weights_ ? !matrix_single_.empty() : !matrix_.empty() );
+    ATLAS_ASSERT( tgt.shape( 0 ) >= static_cast<idx_t>( rows ) );
+    ATLAS_ASSERT( src.shape( 0 ) >= static_cast<idx_t>( cols ) );
 }
 
 template <typename Value>
 void Method::interpolate_field( const Field& src, Field& tgt ) const {
     check_compatibility( src, tgt );
+    if ( single_precision_weights_ ) {
+        // The eckit backend requires double precision weights, so the native kernels are used
+        interpolate_field<Value>( matrix_single_, src, tgt );
+    }
+    else if ( use_eckit_linalg_spmv_ && src.rank() == 1 && std::is_same<Value, double>::value ) {
+        // The eckit backend only operates in double precision; other fields use the native kernels
+        // rather than converted copies
+        interpolate_field_eckit( src, tgt );
+    }
+    else {
+        interpolate_field<Value>( matrix_, src, tgt );
+    }
+}
+
+void Method::interpolate_field_eckit( const Field& src, Field& tgt ) const {
+    ATLAS_ASSERT( src.contiguous() );
+    ATLAS_ASSERT( tgt.contiguous() );
+
+    eckit::linalg::Vector v_src( array::make_view<double, 1>( src ).data(), src.shape( 0 ) );
+    eckit::linalg::Vector v_tgt( array::make_view<double, 1>( tgt ).data(), tgt.shape( 0 ) );
+    eckit::linalg::LinearAlgebra::backend().spmv( matrix_, v_src, v_tgt );
+}
+
+template <typename Value, typename MatrixType>
+void Method::interpolate_field( const MatrixType& matrix, const Field& src, Field& tgt ) const {
     if ( src.rank() == 1 ) {
-        interpolate_field_rank1<Value>( src, tgt );
+        interpolate_field_rank1<Value>( matrix, src, tgt );
     }
     if ( src.rank() == 2 ) {
-        interpolate_field_rank2<Value>( src, tgt );
+        interpolate_field_rank2<Value>( matrix, src, tgt );
     }
     if ( src.rank() == 3 ) {
-        interpolate_field_rank3<Value>( src, tgt );
+        interpolate_field_rank3<Value>( matrix, src, tgt );
     }
 }
 
-template <typename Value>
-void Method::interpolate_field_rank1( const Field& src, Field& tgt ) const {
-    const auto outer  = matrix_.outer();
-    const auto index  = matrix_.inner();
-    const auto weight = matrix_.data();
-    idx_t rows        = static_cast<idx_t>( matrix_.rows() );
-
-    if ( use_eckit_linalg_spmv_ ) {
-        if ( src.datatype() != array::make_datatype<double>() ) {
-            throw_NotImplemented( "Only double precision interpolation is currently implemented with eckit backend",
-                                  Here() );
-        }
-        ATLAS_ASSERT( src.contiguous() );
-        ATLAS_ASSERT( tgt.contiguous() );
+template <typename Value, typename MatrixType>
+void Method::interpolate_field_rank1( const MatrixType& matrix, const Field& src, Field& tgt ) const {
+    const auto outer  = matrix.outer();
+    const auto index  = matrix.inner();
+    const auto weight = matrix.data();
+    idx_t rows        = static_cast<idx_t>( matrix.rows() );
 
-        eckit::linalg::Vector v_src( array::make_view<double, 1>( src ).data(), src.shape( 0 ) );
-        eckit::linalg::Vector v_tgt( array::make_view<double, 1>( tgt ).data(), tgt.shape( 0 ) );
-        eckit::linalg::LinearAlgebra::backend().spmv( matrix_, v_src, v_tgt );
-    }
-    else {
-        auto v_src = array::make_view<Value, 1>( src );
-        auto v_tgt = array::make_view<Value, 1>( tgt );
-
-        atlas_omp_parallel_for( idx_t r = 0; r < rows; ++r ) {
-            v_tgt( r ) = 0.;
-            for ( idx_t c = outer[r]; c < outer[r + 1]; ++c ) {
-                idx_t n = index[c];
-                Value w = static_cast<Value>( weight[c] );
-                v_tgt( r ) += w * v_src( n );
-            }
+    auto v_src = array::make_view<Value, 1>( src );
+    auto v_tgt = array::make_view<Value, 1>( tgt );
+
+    atlas_omp_parallel_for( idx_t r = 0; r < rows; ++r ) {
+        v_tgt( r ) = 0.;
+        for ( idx_t c = outer[r]; c < outer[r + 1]; ++c ) {
+            idx_t n = index[c];
+            Value w = static_cast<Value>( weight[c] );
+            v_tgt( r ) += w * v_src( n );
         }
     }
 }
 
-template <typename Value>
-void Method::interpolate_field_rank2( const Field& src, Field& tgt ) const {
-    const auto outer  = matrix_.outer();
-    const auto index  = matrix_.inner();
-    const auto weight = matrix_.data();
-    idx_t rows        = static_cast<idx_t>( matrix_.rows() );
+template <typename Value, typename MatrixType>
+void Method::interpolate_field_rank2( const MatrixType& matrix, const Field& src, Field& tgt ) const {
+    const auto outer  = matrix.outer();
+    const auto index  = matrix.inner();
+    const auto weight = matrix.data();
+    idx_t rows        = static_cast<idx_t>( matrix.rows() );
 
     auto v_src = array::make_view<Value, 2>( src );
     auto v_tgt = array::make_view<Value, 2>( tgt );
@@ -115,12 +226,12 @@ void Method::interpolate_field_rank2( const Field& src, Field& tgt ) const {
 }
 
 
-template <typename Value>
-void Method::interpolate_field_rank3( const Field& src, Field& tgt ) const {
-    const auto outer  = matrix_.outer();
-    const auto index  = matrix_.inner();
-    const auto weight = matrix_.data();
-    idx_t rows        = static_cast<idx_t>( matrix_.rows() );
+template <typename Value, typename MatrixType>
+void Method::interpolate_field_rank3( const MatrixType& matrix, const Field& src, Field& tgt ) const {
+    const auto outer  = matrix.outer();
+    const auto index  = matrix.inner();
+    const auto weight = matrix.data();
+    idx_t rows        = static_cast<idx_t>( matrix.rows() );
 
     auto v_src = array::make_view<Value, 3>( src );
     auto v_tgt = array::make_view<Value, 3>( tgt );
@@ -146,11 +257,77 @@ void Method::interpolate_field_rank3( const Field& src, Field& tgt ) const {
     }
 }
 
+template <typename Value>
+void Method::interpolate_fields( const FieldSet& src, FieldSet& tgt ) const {
+    if ( single_precision_weights_ ) {
+        interpolate_fields<Value>( matrix_single_, src, tgt );
+    }
+    else {
+        interpolate_fields<Value>( matrix_, src, tgt );
+    }
+}
+
+template <typename Value, typename MatrixType>
+void Method::interpolate_fields( const MatrixType& matrix, const FieldSet& src, FieldSet& tgt ) const {
+    // Each contiguous field is seen as a row-major matrix with one row per point, so that all fields are
+    // interpolated together (SpMM) while the sparse matrix is traversed only once
+    struct Block {
+        const Value* src;
+        Value* tgt;
+        idx_t src_stride;
+        idx_t tgt_stride;
+        idx_t size;
+    };
+    std::vector<Block> blocks;
+    blocks.reserve( src.size() );
+    for ( idx_t f = 0; f < src.size(); ++f ) {
+        if ( !src[f].contiguous() || !tgt[f].contiguous() ) {
+            interpolate_field<Value>( matrix, src[f], tgt[f] );
+            continue;
+        }
+        idx_t size = 1;
+        for ( idx_t d = 1; d < src[f].rank(); ++d ) {
+            size *= src[f].shape( d );
+        }
+        blocks.emplace_back( Block{src[f].array().host_data<Value>(), tgt[f].array().host_data<Value>(),
+                                   src[f].stride( 0 ), tgt[f].stride( 0 ), size} );
+    }
+    if ( blocks.empty() ) {
+        return;
+    }
+
+    const auto outer  = matrix.outer();
+    const auto index  = matrix.inner();
+    const auto weight = matrix.data();
+    idx_t rows        = static_cast<idx_t>( matrix.rows() );
+
+    atlas_omp_parallel_for( idx_t r = 0; r < rows; ++r ) {
+        for ( const Block& b : blocks ) {
+            Value* t = b.tgt + r * b.tgt_stride;
+            std::fill( t, t + b.size, Value( 0 ) );
+        }
+        for ( idx_t c = outer[r]; c < outer[r + 1]; ++c ) {
+            idx_t n = index[c];
+            Value w = static_cast<Value>( weight[c] );
+            for ( const Block& b : blocks ) {
+                const Value* s = b.src + n * b.src_stride;
+                Value* t       = b.tgt + r * b.tgt_stride;
+                for ( idx_t k = 0; k < b.size; ++k ) {
+                    t[k] += w * s[k];
+                }
+            }
+        }
+    }
+}
 
 Method::Method( const Method::Config& config ) {
     std::string spmv = "";
     config.get( "spmv", spmv );
     use_eckit_linalg_spmv_ = ( spmv == "eckit" );
+
+    std::string weights_datatype = array::DataType::str<double>();
+    config.get( "weights_datatype", weights_datatype );
+    single_precision_weights_ = ( array::DataType::str_to_kind( weights_datatype ) == array::DataType::KIND_REAL32 );
 }
 
 void Method::setup( const FunctionSpace& /*source*/, const Field& /*target*/ ) {
@@ -167,9 +344,34 @@ void Method::execute( const FieldSet& fieldsSource, FieldSet& fieldsTarget ) con
     const idx_t N = fieldsSource.size();
     ATLAS_ASSERT( N == fieldsTarget.size() );
 
-    for ( idx_t i = 0; i < fieldsSource.size(); ++i ) {
-        Log::debug() << "Method::execute() on field " << ( i + 1 ) << '/' << N << "..." << std::endl;
-        Method::execute( fieldsSource[i], fieldsTarget[i] );
+    haloExchange( fieldsSource );
+
+    if ( use_eckit_linalg_spmv_ && !single_precision_weights_ ) {
+        for ( idx_t i = 0; i < fieldsSource.size(); ++i ) {
+            Log::debug() << "Method::execute() on field " << ( i + 1 ) << '/' << N << "..." << std::endl;
+            Method::execute( fieldsSource[i], fieldsTarget[i] );
+        }
+        return;
+    }
+
+    // Batch fields by precision, so each batch traverses the matrix once
+    FieldSet source_double, target_double, source_float, target_float;
+    for ( idx_t i = 0; i < N; ++i ) {
+        check_compatibility( fieldsSource[i], fieldsTarget[i] );
+        if ( fieldsSource[i].datatype().kind() == array::DataType::KIND_REAL64 ) {
+            source_double.add( fieldsSource[i] );
+            target_double.add( fieldsTarget[i] );
+        }
+        if ( fieldsSource[i].datatype().kind() == array::DataType::KIND_REAL32 ) {
+            source_float.add( fieldsSource[i] );
+            target_float.add( fieldsTarget[i] );
+        }
+    }
+    interpolate_fields<double>( source_double, target_double );
+    interpolate_fields<float>( source_float, target_float );
+
+    for ( idx_t i = 0; i < N; ++i ) {
+        fieldsTarget[i].set_dirty();
     }
 }
 
@@ -188,6 +390,48 @@ void Method::execute( const Field& src, Field& tgt ) const {
     tgt.set_dirty();
 }
 
+void Method::cache( const Cache& cache, const std::string& key ) {
+    cache_.reset( new Cache( cache ) );
+    cache_key_ = key;
+}
+
+bool Method::matrixFromCache() {
+    if ( not cache_ || cache_key_.empty() ) {
+        return false;
+    }
+    ATLAS_TRACE( "atlas::interpolation::method::Method::matrixFromCache()" );
+
+    // All tasks must agree, as computing the matrix involves communication
+    std::shared_ptr<const MatrixCacheEntry> entry = cache_->get( cache_key_ );
+    int found                                     = entry ? 1 : 0;
+    ATLAS_TRACE_MPI( ALLREDUCE ) { mpi::comm().allReduceInPlace( found, eckit::mpi::min() ); }
+    if ( not found ) {
+        return false;
+    }
+
+    if ( single_precision_weights_ ) {
+        MatrixSinglePrecision( *entry ).swap( matrix_single_ );
+        return true;
+    }
+
+    // The matrix takes the arrays of the entry, without rebuilding it
+    Matrix( new CacheEntryAllocator( entry ) ).swap( matrix_ );
+    return true;
+}
+
+void Method::setMatrix( Matrix& matrix ) {
+    if ( cache_ && not cache_key_.empty() ) {
+        cache_->insert( cache_key_, matrix );
+    }
+    if ( single_precision_weights_ ) {
+        MatrixSinglePrecision( matrix ).swap( matrix_single_ );
+        Matrix().swap( matrix );
+    }
+    else {
+        matrix_.swap( matrix );
+    }
+}
+
 void Method::normalise( Triplets& triplets ) {
     // sum all calculated weights for normalisation
     double sum = 0.0;
@@ -204,8 +448,15 @@ void Method::normalise( Triplets& triplets ) {
 }
 
 void Method::haloExchange( const FieldSet& fields ) const {
+    // Exchange all dirty fields together, with one message per neighbouring partition
+    FieldSet dirty;
     for ( auto& field : fields ) {
-        haloExchange( field );
+        if ( field.dirty() ) {
+            dirty.add( field );
+        }
+    }
+    if ( dirty.size() ) {
+        source().haloExchange( dirty );
     }
 }
 void Method::haloExchange( const Field& field ) const {
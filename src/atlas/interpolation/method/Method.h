@@ -10,10 +10,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iosfwd>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "atlas/interpolation/Cache.h"
 #include "atlas/util/Object.h"
 #include "eckit/config/Configuration.h"
 #include "eckit/linalg/SparseMatrix.h"
@@ -45,6 +48,10 @@ public:
     virtual void setup( const FunctionSpace& source, const Field& target );
     virtual void setup( const FunctionSpace& source, const FieldSet& target );
 
+    /// @brief Reuse the matrix stored in cache under key in the next setup, or else store the computed matrix there
+    /// The cached matrix is only used if it is found on all MPI tasks. An empty key disables caching.
+    void cache( const Cache&, const std::string& key );
+
     virtual void execute( const FieldSet& source, FieldSet& target ) const;
     virtual void execute( const Field& source, Field& target ) const;
 
@@ -58,8 +65,47 @@ protected:
     using Triplets = std::vector<Triplet>;
     using Matrix   = eckit::linalg::SparseMatrix;
 
+    /// Sparse matrix in compressed row storage with single precision weights and 32-bit indices
+    class MatrixSinglePrecision {
+    public:
+        using Index = std::int32_t;
+
+        MatrixSinglePrecision() = default;
+        explicit MatrixSinglePrecision( const Matrix& );
+        explicit MatrixSinglePrecision( const MatrixCacheEntry& );
+
+        size_t rows() const { return rows_; }
+        size_t cols() const { return cols_; }
+        size_t nonZeros() const { return data_.size(); }
+        bool empty() const { return nonZeros() == 0; }
+
+        const Index* outer() const { return outer_.data(); }
+        const Index* inner() const { return inner_.data(); }
+        const float* data() const { return data_.data(); }
+
+        void swap( MatrixSinglePrecision& );
+
+    private:
+        template <typename CompressedRowMatrix>
+        void assign( const CompressedRowMatrix& );
+
+        size_t rows_{0};
+        size_t cols_{0};
+        std::vector<Index> outer_;
+        std::vector<Index> inner_;
+        std::vector<float> data_;
+    };
+
     static void normalise( Triplets& triplets );
 
+    /// @brief Take over the interpolation matrix, leaving the argument empty
+    /// With configuration "weights_datatype" = "real32" the weights are stored in single precision.
+    void setMatrix( Matrix& );
+
+    /// @brief Set the interpolation matrix from the cache, if it is found there on all MPI tasks (collective)
+    /// Methods call this in setup before computing the matrix, and skip the computation if it returns true.
+    bool matrixFromCache();
+
     void haloExchange( const FieldSet& ) const;
     void haloExchange( const Field& ) const;
 
@@ -70,21 +116,37 @@ protected:
     //        so do not expose here, even though only linear operators are now
     //        implemented.
     Matrix matrix_;
+    MatrixSinglePrecision matrix_single_;  // used instead of matrix_ if single_precision_weights_
 
     bool use_eckit_linalg_spmv_;
+    bool single_precision_weights_;
+
+    std::unique_ptr<Cache> cache_;
+    std::string cache_key_;
 
 private:
     template <typename Value>
     void interpolate_field( const Field& src, Field& tgt ) const;
 
-    template <typename Value>
-    void interpolate_field_rank1( const Field& src, Field& tgt ) const;
+    void interpolate_field_eckit( const Field& src, Field& tgt ) const;
 
-    template <typename Value>
-    void interpolate_field_rank2( const Field& src, Field& tgt ) const;
+    template <typename Value, typename MatrixType>
+    void interpolate_field( const MatrixType&, const Field& src, Field& tgt ) const;
+
+    template <typename Value, typename MatrixType>
+    void interpolate_field_rank1( const MatrixType&, const Field& src, Field& tgt ) const;
+
+    template <typename Value, typename MatrixType>
+    void interpolate_field_rank2( const MatrixType&, const Field& src, Field& tgt ) const;
+
+    template <typename Value, typename MatrixType>
+    void interpolate_field_rank3( const MatrixType&, const Field& src, Field& tgt ) const;
 
     template <typename Value>
-    void interpolate_field_rank3( const Field& src, Field& tgt ) const;
+    void interpolate_fields( const FieldSet& src, FieldSet& tgt ) const;
+
+    template <typename Value, typename MatrixType>
+    void interpolate_fields( const MatrixType&, const FieldSet& src, FieldSet& tgt ) const;
 
     void check_compatibility( const Field& src, const Field& tgt ) const;
 };
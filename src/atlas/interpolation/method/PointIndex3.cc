@@ -9,18 +9,74 @@
  * nor does it submit to any jurisdiction.
  */
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
 #include "eckit/config/Resource.h"
 
 #include "atlas/array/ArrayView.h"
 #include "atlas/array/MakeView.h"
 #include "atlas/interpolation/method/PointIndex3.h"
 #include "atlas/mesh/HybridElements.h"
+#include "atlas/parallel/omp/sort.h"
 #include "atlas/runtime/Trace.h"
 
 namespace atlas {
 namespace interpolation {
 namespace method {
 
+namespace {
+/// Spread the lowest 21 bits of x over every third bit
+uint64_t spread_bits( uint64_t x ) {
+    x &= 0x1fffff;
+    x = ( x | x << 32 ) & 0x1f00000000ffff;
+    x = ( x | x << 16 ) & 0x1f0000ff0000ff;
+    x = ( x | x << 8 ) & 0x100f00f00f00f00f;
+    x = ( x | x << 4 ) & 0x10c30c30c30c30c3;
+    x = ( x | x << 2 ) & 0x1249249249249249;
+    return x;
+}
+}  // namespace
+
+std::vector<size_t> space_filling_curve_order( const array::ArrayView<double, 2>& points ) {
+    ATLAS_TRACE();
+    const size_t n = size_t( points.shape( 0 ) );
+
+    double min[3];
+    double max[3];
+    for ( int d = 0; d < 3; ++d ) {
+        min[d] = std::numeric_limits<double>::max();
+        max[d] = std::numeric_limits<double>::lowest();
+    }
+    for ( size_t ip = 0; ip < n; ++ip ) {
+        for ( int d = 0; d < 3; ++d ) {
+            min[d] = std::min( min[d], points( ip, d ) );
+            max[d] = std::max( max[d], points( ip, d ) );
+        }
+    }
+    double scale[3];
+    for ( int d = 0; d < 3; ++d ) {
+        scale[d] = max[d] > min[d] ? double( ( 1 << 21 ) - 1 ) / ( max[d] - min[d] ) : 0.;
+    }
+
+    // Sort by Morton code, ties by index to be deterministic
+    std::vector<std::pair<uint64_t, size_t>> codes( n );
+    atlas_omp_parallel_for( size_t ip = 0; ip < n; ++ip ) {
+        uint64_t code = 0;
+        for ( int d = 0; d < 3; ++d ) {
+            code |= spread_bits( uint64_t( ( points( ip, d ) - min[d] ) * scale[d] ) ) << d;
+        }
+        codes[ip] = std::make_pair( code, ip );
+    }
+    omp::sort( codes.begin(), codes.end() );
+
+    std::vector<size_t> order( n );
+    atlas_omp_parallel_for( size_t i = 0; i < n; ++i ) { order[i] = codes[i].second; }
+    return order;
+}
+
 ElemIndex3* create_element_kdtree( const Field& field_centres ) {
     ATLAS_TRACE();
     const array::ArrayView<double, 2> centres = array::make_view<double, 2>( field_centres );
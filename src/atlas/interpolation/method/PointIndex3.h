@@ -10,13 +10,17 @@
 
 #pragma once
 
+#include <vector>
+
 #include "eckit/container/KDMapped.h"
 #include "eckit/container/KDMemory.h"
 #include "eckit/container/KDTree.h"
 #include "eckit/geometry/Point3.h"
 
+#include "atlas/array/ArrayView.h"
 #include "atlas/field/Field.h"
 #include "atlas/mesh/Mesh.h"
+#include "atlas/parallel/omp/omp.h"
 #include "atlas/util/CoordinateEnums.h"
 
 namespace atlas {
@@ -25,6 +29,11 @@ namespace method {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+/// @brief Order of points ( shape( 0 ) x 3 ) along a Morton space-filling curve through their bounding box
+std::vector<size_t> space_filling_curve_order( const array::ArrayView<double, 2>& points );
+
+//----------------------------------------------------------------------------------------------------------------------
+
 template <class Traits>
 class PointKdTree : public eckit::KDTreeMemory<Traits> {
 public:
@@ -47,6 +56,38 @@ public:
     using Tree::findInSphereBruteForce;
     using Tree::kNearestNeighboursBruteForce;
     using Tree::nearestNeighbourBruteForce;
+
+    /// @brief k nearest neighbours of many points ( shape( 0 ) x 3 ), queried on OpenMP threads
+    ///
+    /// Points are queried in space_filling_curve_order(), so that consecutive queries visit the same branches
+    /// of the tree. Neighbour j of point n is payloads[n * k + j], at squared distance distances2[n * k + j].
+    /// @return number of neighbours per point: k, unless the tree holds fewer points
+    size_t kNearestNeighbours( const array::ArrayView<double, 2>& points, size_t k, std::vector<Payload>& payloads,
+                               std::vector<double>& distances2 ) {
+        const size_t n = size_t( points.shape( 0 ) );
+        auto point     = [&]( size_t ip ) { return Point( points( ip, 0 ), points( ip, 1 ), points( ip, 2 ) ); };
+        payloads.clear();
+        distances2.clear();
+        if ( n == 0 ) {
+            return k;
+        }
+        k = Tree::kNearestNeighbours( point( 0 ), k ).size();
+        payloads.resize( n * k );
+        distances2.resize( n * k );
+
+        const std::vector<size_t> order = space_filling_curve_order( points );
+        atlas_omp_pragma( omp parallel for schedule( dynamic, 256 ) )
+        for ( size_t i = 0; i < n; ++i ) {
+            const size_t ip   = order[i];
+            const Point p     = point( ip );
+            const NodeList nn = Tree::kNearestNeighbours( p, k );
+            for ( size_t j = 0; j < k; ++j ) {
+                payloads[ip * k + j]   = nn[j].payload();
+                distances2[ip * k + j] = Point::distance2( p, nn[j].point() );
+            }
+        }
+        return k;
+    }
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -8,14 +8,17 @@
  * nor does it submit to any jurisdiction. and Interpolation
  */
 
+#include <algorithm>
 #include <cmath>
+#include <exception>
 #include <iomanip>
+#include <iterator>
 #include <limits>
+#include <utility>
 
 #include "FiniteElement.h"
 
 #include "eckit/log/Plural.h"
-#include "eckit/log/ProgressTimer.h"
 #include "eckit/log/Seconds.h"
 
 #include "atlas/functionspace/NodeColumns.h"
@@ -33,6 +36,7 @@
 #include "atlas/parallel/GatherScatter.h"
 #include "atlas/parallel/mpi/Buffer.h"
 #include "atlas/parallel/mpi/mpi.h"
+#include "atlas/parallel/omp/omp.h"
 #include "atlas/runtime/Exception.h"
 #include "atlas/runtime/Log.h"
 #include "atlas/runtime/Trace.h"
@@ -52,6 +56,27 @@ MethodBuilder<FiniteElement> __builder( "finite-element" );
 // epsilon used to scale edge tolerance when projecting ray to intesect element
 static const double parametricEpsilon = 1e-15;
 
+/// Number of nearest elements to search first for a target point, adapted to the preceding points of a thread:
+/// the largest number that was needed recently, halved after a run of points that all needed no more.
+class NeighbourCount {
+public:
+    idx_t operator()() const { return k_; }
+    void found( idx_t k ) {
+        if ( k > k_ ) {
+            k_   = k;
+            run_ = 0;
+        }
+        else if ( ++run_ == 16 ) {
+            k_   = std::max<idx_t>( 1, k_ / 2 );
+            run_ = 0;
+        }
+    }
+
+private:
+    idx_t k_{1};
+    idx_t run_{0};
+};
+
 }  // namespace
 
 
@@ -127,7 +152,8 @@ void FiniteElement::print( std::ostream& out ) const {
     }
     auto gidx_src = array::make_view<gidx_t, 1>( src.nodes().global_index() );
 
-    ATLAS_ASSERT( tgt.nodes().size() == idx_t( matrix_.rows() ) );
+    const size_t rows = single_precision_weights_ ? matrix_single_.rows() : matrix_.rows();
+    ATLAS_ASSERT( tgt.nodes().size() == idx_t( rows ) );
 
 
     auto field_stencil_points_loc  = tgt.createField<gidx_t>( option::variables( Stencil::max_stencil_size ) );
@@ -139,12 +165,23 @@ void FiniteElement::print( std::ostream& out ) const {
     auto stencil_size_loc    = array::make_view<int, 1>( field_stencil_size_loc );
     stencil_size_loc.assign( 0 );
 
-    for ( Matrix::const_iterator it = matrix_.begin(); it != matrix_.end(); ++it ) {
-        idx_t p                     = idx_t( it.row() );
+    auto add_weight = [&]( idx_t p, idx_t col, double weight ) {
         idx_t& i                    = stencil_size_loc( p );
-        stencil_points_loc( p, i )  = gidx_src( it.col() );
-        stencil_weights_loc( p, i ) = *it;
+        stencil_points_loc( p, i )  = gidx_src( col );
+        stencil_weights_loc( p, i ) = weight;
         ++i;
+    };
+    if ( single_precision_weights_ ) {
+        for ( idx_t p = 0; p < idx_t( rows ); ++p ) {
+            for ( auto c = matrix_single_.outer()[p]; c < matrix_single_.outer()[p + 1]; ++c ) {
+                add_weight( p, matrix_single_.inner()[c], matrix_single_.data()[c] );
+            }
+        }
+    }
+    else {
+        for ( Matrix::const_iterator it = matrix_.begin(); it != matrix_.end(); ++it ) {
+            add_weight( idx_t( it.row() ), idx_t( it.col() ), *it );
+        }
     }
 
 
@@ -188,6 +225,10 @@ void FiniteElement::setup( const FunctionSpace& source ) {
     const functionspace::NodeColumns src = source;
     ATLAS_ASSERT( src );
 
+    if ( matrixFromCache() ) {
+        return;
+    }
+
     Mesh meshSource = src.mesh();
 
 
@@ -226,54 +267,111 @@ void FiniteElement::setup( const FunctionSpace& source ) {
 
     // weights -- one per vertex of element, triangles (3) or quads (4)
 
-    Triplets weights_triplets;                 // structure to fill-in sparse matrix
-    weights_triplets.reserve( out_npts * 4 );  // preallocate space as if all elements where quads
-
     // search nearest k cell centres
 
     const idx_t maxNbElemsToTry = std::max<idx_t>( 64, idx_t( Nelements * maxFractionElemsToTry ) );
     idx_t max_neighbours        = 0;
 
-    std::vector<size_t> failures;
+    // Target points are processed on OpenMP threads in space-filling curve order, so that consecutive searches
+    // visit the same branches of the element tree. Every thread collects the triplets of its points, which are
+    // merged in point order afterwards, so the matrix does not depend on the number of threads.
+    const int nb_threads = atlas_omp_get_max_threads();
+    std::vector<Triplets> thread_triplets( nb_threads );
+    std::vector<std::vector<std::pair<size_t, std::string>>> thread_failures( nb_threads );
+    std::vector<idx_t> row_offset( out_npts + 1, 0 );
+    for ( auto& collected : thread_triplets ) {
+        collected.reserve( 4 * size_t( out_npts ) / size_t( nb_threads ) );
+    }
+
+    // An exception cannot leave an OpenMP region, so every thread keeps the exception of its first failing point,
+    // and the one of the lowest point is rethrown after the region
+    std::vector<std::pair<idx_t, std::exception_ptr>> thread_exceptions( nb_threads );
 
     ATLAS_TRACE_SCOPE( "Computing interpolation matrix" ) {
-        eckit::ProgressTimer progress( "Computing interpolation weights", out_npts, "point", double( 5 ),
-                                       Log::debug() );
-        for ( idx_t ip = 0; ip < out_npts; ++ip, ++progress ) {
-            if ( out_ghosts( ip ) ) {
-                continue;
-            }
+        const std::vector<size_t> order = space_filling_curve_order( *ocoords_ );
+        atlas_omp_parallel {
+            const int thread    = atlas_omp_get_thread_num();
+            Triplets& collected = thread_triplets[thread];
+            NeighbourCount first_kpts;
+
+            atlas_omp_pragma( omp for schedule( dynamic, 256 ) reduction( max : max_neighbours ) )
+            for ( idx_t i = 0; i < out_npts; ++i ) {
+                const idx_t ip = idx_t( order[i] );
+                if ( out_ghosts( ip ) || thread_exceptions[thread].second ) {
+                    continue;
+                }
+                try {
+                    PointXYZ p{( *ocoords_ )( ip, 0 ), ( *ocoords_ )( ip, 1 ), ( *ocoords_ )( ip, 2 )};  // lookup point
 
-            PointXYZ p{( *ocoords_ )( ip, 0 ), ( *ocoords_ )( ip, 1 ), ( *ocoords_ )( ip, 2 )};  // lookup point
+                    bool success = false;
+                    std::ostringstream failures_log;
 
-            idx_t kpts   = 1;
-            bool success = false;
-            std::ostringstream failures_log;
+                    for ( idx_t kpts = first_kpts(); !success && kpts <= maxNbElemsToTry; kpts *= 2 ) {
+                        max_neighbours = std::max( kpts, max_neighbours );
 
-            while ( !success && kpts <= maxNbElemsToTry ) {
-                max_neighbours = std::max( kpts, max_neighbours );
+                        ElemIndex3::NodeList cs = eTree->kNearestNeighbours( p, kpts );
+                        Triplets triplets       = projectPointToElements( ip, cs, failures_log );
 
-                ElemIndex3::NodeList cs = eTree->kNearestNeighbours( p, kpts );
-                Triplets triplets       = projectPointToElements( ip, cs, failures_log );
+                        if ( triplets.size() ) {
+                            collected.insert( collected.end(), triplets.begin(), triplets.end() );
+                            row_offset[ip + 1] = idx_t( triplets.size() );
+                            first_kpts.found( kpts );
+                            success = true;
+                        }
+                    }
 
-                if ( triplets.size() ) {
-                    std::copy( triplets.begin(), triplets.end(), std::back_inserter( weights_triplets ) );
-                    success = true;
+                    if ( !success ) {
+                        thread_failures[thread].emplace_back( ip, failures_log.str() );
+                    }
+                }
+                catch ( ... ) {
+                    thread_exceptions[thread] = std::make_pair( ip, std::current_exception() );
                 }
-                kpts *= 2;
             }
+        }
+    }
+    Log::debug() << "Maximum neighbours searched was " << eckit::Plural( max_neighbours, "element" ) << std::endl;
+
+    const std::pair<idx_t, std::exception_ptr>* first_exception = nullptr;
+    for ( const auto& exception : thread_exceptions ) {
+        if ( exception.second && ( not first_exception || exception.first < first_exception->first ) ) {
+            first_exception = &exception;
+        }
+    }
+    if ( first_exception ) {
+        std::rethrow_exception( first_exception->second );
+    }
 
-            if ( !success ) {
-                failures.push_back( ip );
-                Log::debug() << "------------------------------------------------------"
-                                "---------------------\n";
-                const PointLonLat pll{out_lonlat( ip, 0 ), out_lonlat( ip, 1 )};
-                Log::debug() << "Failed to project point (lon,lat)=" << pll << '\n';
-                Log::debug() << failures_log.str();
+    std::vector<std::pair<size_t, std::string>> failure_logs;
+    for ( auto& thread : thread_failures ) {
+        std::move( thread.begin(), thread.end(), std::back_inserter( failure_logs ) );
+    }
+    std::sort( failure_logs.begin(), failure_logs.end() );
+    std::vector<size_t> failures;
+    for ( const auto& failure : failure_logs ) {
+        failures.push_back( failure.first );
+        Log::debug() << "------------------------------------------------------"
+                        "---------------------\n";
+        const PointLonLat pll{out_lonlat( failure.first, 0 ), out_lonlat( failure.first, 1 )};
+        Log::debug() << "Failed to project point (lon,lat)=" << pll << '\n';
+        Log::debug() << failure.second;
+    }
+
+    // Merge the triplets of all threads in point order
+    Triplets weights_triplets;
+    ATLAS_TRACE_SCOPE( "Merging interpolation weights" ) {
+        for ( idx_t ip = 0; ip < out_npts; ++ip ) {
+            row_offset[ip + 1] += row_offset[ip];
+        }
+        weights_triplets.resize( size_t( row_offset[out_npts] ) );
+        atlas_omp_parallel_for( int thread = 0; thread < nb_threads; ++thread ) {
+            // Every row was collected by a single thread, which alone advances its offset
+            for ( const Triplet& triplet : thread_triplets[thread] ) {
+                weights_triplets[size_t( row_offset[triplet.row()]++ )] = triplet;
             }
+            Triplets().swap( thread_triplets[thread] );
         }
     }
-    Log::debug() << "Maximum neighbours searched was " << eckit::Plural( max_neighbours, "element" ) << std::endl;
 
     eckit::mpi::comm().barrier();
     if ( failures.size() ) {
@@ -291,7 +389,7 @@ void FiniteElement::setup( const FunctionSpace& source ) {
 
     // fill sparse matrix and return
     Matrix A( out_npts, inp_npts, weights_triplets );
-    matrix_.swap( A );
+    setMatrix( A );
 }
 
 struct ElementEdge {
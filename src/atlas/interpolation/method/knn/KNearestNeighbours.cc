@@ -10,14 +10,14 @@
 
 #include "atlas/interpolation/method/knn/KNearestNeighbours.h"
 
-#include "eckit/log/Plural.h"
-#include "eckit/log/Timer.h"
-
 #include "atlas/array.h"
 #include "atlas/functionspace/NodeColumns.h"
+#include "atlas/functionspace/PointCloud.h"
+#include "atlas/functionspace/StructuredColumns.h"
 #include "atlas/grid/Grid.h"
 #include "atlas/grid/StructuredGrid.h"
 #include "atlas/interpolation/method/MethodFactory.h"
+#include "atlas/interpolation/method/knn/StructuredNeighbourSearch.h"
 #include "atlas/mesh/Nodes.h"
 #include "atlas/mesh/actions/BuildXYZField.h"
 #include "atlas/meshgenerator.h"
@@ -46,6 +46,13 @@ void KNearestNeighbours::setup( const Grid& source, const Grid& target ) {
     if ( mpi::comm().size() > 1 ) {
         ATLAS_NOTIMPLEMENTED;
     }
+    if ( StructuredNeighbourSearch::supports( source ) ) {
+        functionspace::PointCloud tgt( target );
+        source_ = functionspace::StructuredColumns( source );
+        target_ = tgt;
+        setupStructured( source, tgt.lonlat(), k_ );
+        return;
+    }
     auto functionspace = []( const Grid& grid ) -> FunctionSpace {
         Mesh mesh;
         if ( StructuredGrid( grid ) ) {
@@ -68,6 +75,10 @@ void KNearestNeighbours::setup( const FunctionSpace& source, const FunctionSpace
     ATLAS_ASSERT( src );
     ATLAS_ASSERT( tgt );
 
+    if ( matrixFromCache() ) {
+        return;
+    }
+
     Mesh meshSource = src.mesh();
     Mesh meshTarget = tgt.mesh();
 
@@ -82,43 +93,33 @@ void KNearestNeighbours::setup( const FunctionSpace& source, const FunctionSpace
     size_t inp_npts = meshSource.nodes().size();
     size_t out_npts = meshTarget.nodes().size();
 
+    // find the closest input points to the output points
+    std::vector<size_t> neighbours;
+    std::vector<double> distances2;
+    const size_t npts = pTree_->kNearestNeighbours( coords, k_, neighbours, distances2 );
+    ATLAS_ASSERT( npts );
+
     // fill the sparse matrix
     std::vector<Triplet> weights_triplets;
-    weights_triplets.reserve( out_npts * k_ );
+    weights_triplets.reserve( out_npts * npts );
     {
-        Trace timer( Here(), "atlas::interpolation::method::NearestNeighbour::setup()" );
+        ATLAS_TRACE( "atlas::interpolation::method::KNearestNeighbours::setup() weights" );
 
-        std::vector<double> weights;
+        std::vector<double> weights( npts );
 
         for ( size_t ip = 0; ip < out_npts; ++ip ) {
-            if ( ip && ( ip % 1000 == 0 ) ) {
-                double rate = ip / timer.elapsed();
-                Log::debug() << eckit::BigNum( ip ) << " (at " << rate << " points/s)..." << std::endl;
-            }
-
-            // find the closest input points to the output point
-            PointIndex3::Point p{coords( ip, 0 ), coords( ip, 1 ), coords( ip, 2 )};
-            PointIndex3::NodeList nn = pTree_->kNearestNeighbours( p, k_ );
-
             // calculate weights (individual and total, to normalise) using distance
             // squared
-            const size_t npts = nn.size();
-            ATLAS_ASSERT( npts );
-            weights.resize( npts, 0 );
-
             double sum = 0;
             for ( size_t j = 0; j < npts; ++j ) {
-                PointIndex3::Point np = nn[j].point();
-                const double d2       = eckit::geometry::Point3::distance2( p, np );
-
-                weights[j] = 1. / ( 1. + d2 );
+                weights[j] = 1. / ( 1. + distances2[ip * npts + j] );
                 sum += weights[j];
             }
             ATLAS_ASSERT( sum > 0 );
 
             // insert weights into the matrix
             for ( size_t j = 0; j < npts; ++j ) {
-                size_t jp = nn[j].payload();
+                size_t jp = neighbours[ip * npts + j];
                 ATLAS_ASSERT( jp < inp_npts );
                 weights_triplets.emplace_back( ip, jp, weights[j] / sum );
             }
@@ -127,7 +128,7 @@ void KNearestNeighbours::setup( const FunctionSpace& source, const FunctionSpace
 
     // fill sparse matrix and return
     Matrix A( out_npts, inp_npts, weights_triplets );
-    matrix_.swap( A );
+    setMatrix( A );
 }
 
 }  // namespace method
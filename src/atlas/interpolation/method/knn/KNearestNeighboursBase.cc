@@ -8,15 +8,23 @@
  * nor does it submit to any jurisdiction. and Interpolation
  */
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "eckit/config/Resource.h"
 #include "eckit/log/TraceTimer.h"
 
 #include "atlas/array.h"
+#include "atlas/grid/StructuredGrid.h"
 #include "atlas/interpolation/method/knn/KNearestNeighboursBase.h"
+#include "atlas/interpolation/method/knn/StructuredNeighbourSearch.h"
 #include "atlas/library/Library.h"
 #include "atlas/mesh/Nodes.h"
 #include "atlas/mesh/actions/BuildXYZField.h"
+#include "atlas/parallel/omp/omp.h"
 #include "atlas/runtime/Trace.h"
+#include "atlas/util/CoordinateEnums.h"
 
 namespace atlas {
 namespace interpolation {
@@ -52,6 +60,43 @@ void KNearestNeighboursBase::buildPointSearchTree( Mesh& meshSource ) {
     }
 }
 
+void KNearestNeighboursBase::setupStructured( const StructuredGrid& source, const Field& target_lonlat, size_t k ) {
+    ATLAS_TRACE( "atlas::interpolation::method::KNearestNeighboursBase::setupStructured()" );
+
+    if ( matrixFromCache() ) {
+        return;
+    }
+
+    const StructuredNeighbourSearch search( source );
+    const auto lonlat = array::make_view<double, 2>( target_lonlat );
+
+    const size_t inp_npts = size_t( source.size() );
+    const size_t out_npts = size_t( lonlat.shape( 0 ) );
+    k                     = std::min( k, inp_npts );
+    ATLAS_ASSERT( k );
+
+    // Every target point is independent, and owns the rows [ip*k, (ip+1)*k) of the triplets
+    Triplets triplets( out_npts * k );
+    atlas_omp_parallel {
+        std::vector<std::pair<double, gidx_t>> nearest;
+        atlas_omp_for( size_t ip = 0; ip < out_npts; ++ip ) {
+            search.kNearestNeighbours( PointLonLat( lonlat( ip, LON ), lonlat( ip, LAT ) ), k, nearest );
+
+            // calculate weights (individual and total, to normalise) using distance squared
+            double sum = 0;
+            for ( size_t j = 0; j < k; ++j ) {
+                sum += 1. / ( 1. + nearest[j].first );
+            }
+            for ( size_t j = 0; j < k; ++j ) {
+                triplets[ip * k + j] = Triplet( ip, size_t( nearest[j].second ), 1. / ( 1. + nearest[j].first ) / sum );
+            }
+        }
+    }
+
+    Matrix A( out_npts, inp_npts, triplets );
+    setMatrix( A );
+}
+
 }  // namespace method
 }  // namespace interpolation
 }  // namespace atlas
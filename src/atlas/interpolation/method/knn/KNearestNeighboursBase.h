@@ -15,6 +15,10 @@
 #include "atlas/interpolation/method/Method.h"
 #include "atlas/interpolation/method/PointIndex3.h"
 
+namespace atlas {
+class StructuredGrid;
+}  // namespace atlas
+
 namespace atlas {
 namespace interpolation {
 namespace method {
@@ -27,6 +31,10 @@ public:
 protected:
     void buildPointSearchTree( Mesh& meshSource );
 
+    /// @brief Build the matrix from the k nearest points of a StructuredGrid source to every (lon,lat) target point,
+    /// located without a k-d tree (see StructuredNeighbourSearch)
+    void setupStructured( const StructuredGrid& source, const Field& target_lonlat, size_t k );
+
     std::unique_ptr<PointIndex3> pTree_;
 };
 
@@ -8,13 +8,14 @@
  * nor does it submit to any jurisdiction. and Interpolation
  */
 
-#include "eckit/log/Plural.h"
-
 #include "atlas/array.h"
 #include "atlas/functionspace/NodeColumns.h"
+#include "atlas/functionspace/PointCloud.h"
+#include "atlas/functionspace/StructuredColumns.h"
 #include "atlas/grid.h"
 #include "atlas/interpolation/method/MethodFactory.h"
 #include "atlas/interpolation/method/knn/NearestNeighbour.h"
+#include "atlas/interpolation/method/knn/StructuredNeighbourSearch.h"
 #include "atlas/mesh/Nodes.h"
 #include "atlas/mesh/actions/BuildXYZField.h"
 #include "atlas/meshgenerator.h"
@@ -37,6 +38,13 @@ void NearestNeighbour::setup( const Grid& source, const Grid& target ) {
     if ( mpi::comm().size() > 1 ) {
         ATLAS_NOTIMPLEMENTED;
     }
+    if ( StructuredNeighbourSearch::supports( source ) ) {
+        functionspace::PointCloud tgt( target );
+        source_ = functionspace::StructuredColumns( source );
+        target_ = tgt;
+        setupStructured( source, tgt.lonlat(), 1 );
+        return;
+    }
     auto functionspace = []( const Grid& grid ) -> FunctionSpace {
         Mesh mesh;
         if ( StructuredGrid( grid ) ) {
@@ -59,6 +67,10 @@ void NearestNeighbour::setup( const FunctionSpace& source, const FunctionSpace&
     ATLAS_ASSERT( src );
     ATLAS_ASSERT( tgt );
 
+    if ( matrixFromCache() ) {
+        return;
+    }
+
     Mesh meshSource = src.mesh();
     Mesh meshTarget = tgt.mesh();
 
@@ -73,31 +85,26 @@ void NearestNeighbour::setup( const FunctionSpace& source, const FunctionSpace&
     size_t inp_npts = meshSource.nodes().size();
     size_t out_npts = meshTarget.nodes().size();
 
+    // find the closest input point to the output points
+    std::vector<size_t> neighbours;
+    std::vector<double> distances2;
+    const size_t npts = pTree_->kNearestNeighbours( coords, 1, neighbours, distances2 );
+    ATLAS_ASSERT( npts == 1 );
+
     // fill the sparse matrix
     std::vector<Triplet> weights_triplets;
     weights_triplets.reserve( out_npts );
-    {
-        Trace timer( Here(), "atlas::interpolation::method::NearestNeighbour::setup()" );
-        for ( size_t ip = 0; ip < out_npts; ++ip ) {
-            if ( ip && ( ip % 1000 == 0 ) ) {
-                double rate = ip / timer.elapsed();
-                Log::debug() << eckit::BigNum( ip ) << " (at " << rate << " points/s)..." << std::endl;
-            }
-
-            // find the closest input point to the output point
-            PointIndex3::Point p{coords( ip, 0 ), coords( ip, 1 ), coords( ip, 2 )};
-            PointIndex3::NodeInfo nn = pTree_->nearestNeighbour( p );
-            size_t jp                = nn.payload();
-
-            // insert the weights into the interpolant matrix
-            ATLAS_ASSERT( jp < inp_npts );
-            weights_triplets.emplace_back( ip, jp, 1 );
-        }
+    for ( size_t ip = 0; ip < out_npts; ++ip ) {
+        size_t jp = neighbours[ip];
+
+        // insert the weights into the interpolant matrix
+        ATLAS_ASSERT( jp < inp_npts );
+        weights_triplets.emplace_back( ip, jp, 1 );
     }
 
     // fill sparse matrix and return
     Matrix A( out_npts, inp_npts, weights_triplets );
-    matrix_.swap( A );
+    setMatrix( A );
 }
 
 }  // namespace method
@@ -0,0 +1,110 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "atlas/interpolation/method/knn/StructuredNeighbourSearch.h"
+
+#include "atlas/domain/Domain.h"
+#include "atlas/projection/Projection.h"
+#include "atlas/runtime/Exception.h"
+#include "atlas/util/Constants.h"
+#include "atlas/util/Earth.h"
+
+namespace atlas {
+namespace interpolation {
+namespace method {
+
+bool StructuredNeighbourSearch::supports( const Grid& grid ) {
+    StructuredGrid structured( grid );
+    return structured && structured.domain().global() && not structured.projection() && structured.ny() > 1;
+}
+
+StructuredNeighbourSearch::StructuredNeighbourSearch( const StructuredGrid& grid ) :
+    grid_( grid ),
+    compute_north_( grid, 1 ),
+    compute_west_( grid, 1 ) {
+    ATLAS_ASSERT( supports( grid ) );
+    row_begin_.resize( grid.ny() + 1 );
+    row_begin_[0] = 0;
+    for ( idx_t j = 0; j < grid.ny(); ++j ) {
+        row_begin_[j + 1] = row_begin_[j] + grid.nx( j );
+    }
+}
+
+void StructuredNeighbourSearch::kNearestNeighbours( const PointLonLat& P, size_t k,
+                                                    std::vector<std::pair<double, gidx_t>>& nearest ) const {
+    nearest.clear();
+    if ( k == 0 ) {
+        return;
+    }
+    const double R = util::Earth::radius();
+    PointXYZ Pxyz;
+    util::Earth::convertSphericalToCartesian( P, Pxyz );
+
+    // Keep the k nearest candidates sorted, nearest first
+    auto insert = [&]( double d2, gidx_t n ) {
+        const auto candidate = std::make_pair( d2, n );
+        if ( nearest.size() == k && not( candidate < nearest.back() ) ) {
+            return;
+        }
+        nearest.insert( std::upper_bound( nearest.begin(), nearest.end(), candidate ), candidate );
+        if ( nearest.size() > k ) {
+            nearest.pop_back();
+        }
+    };
+
+    // Within a row, distance increases with longitude difference, so the k nearest points of a row are among
+    // the k points on either side of P (with one more on each side to absorb the tolerance of ComputeWest)
+    auto visit_row = [&]( idx_t j ) {
+        const idx_t nx = grid_.nx( j );
+        const idx_t i0 = compute_west_( P.lon(), j );
+        idx_t i_begin  = i0 - idx_t( k );
+        idx_t i_end    = i0 + idx_t( k ) + 2;
+        if ( i_end - i_begin >= nx ) {
+            i_begin = 0;
+            i_end   = nx;
+        }
+        for ( idx_t i = i_begin; i < i_end; ++i ) {
+            const idx_t ii = ( ( i % nx ) + nx ) % nx;
+            PointXYZ Q;
+            util::Earth::convertSphericalToCartesian( grid_.lonlat( ii, j ), Q );
+            insert( PointXYZ::distance2( Pxyz, Q ), row_begin_[j] + ii );
+        }
+    };
+
+    // Every point of row j is at least as far as the latitude difference with P
+    auto min_distance2 = [&]( idx_t j ) {
+        const double dlat  = util::Constants::degreesToRadians() * ( grid_.y( j ) - P.lat() );
+        const double chord = 2. * R * std::sin( 0.5 * dlat );
+        return chord * chord;
+    };
+    auto done = [&]( idx_t j ) { return nearest.size() == k && min_distance2( j ) > nearest.back().first; };
+
+    // Visit rows outwards from the rows enclosing P, nearest latitude first
+    const idx_t ny = grid_.ny();
+    idx_t north    = compute_north_( P.lat() );
+    idx_t south    = north + 1;
+    while ( ( north >= 0 && not done( north ) ) || ( south < ny && not done( south ) ) ) {
+        const bool north_valid = north >= 0 && not done( north );
+        const bool south_valid = south < ny && not done( south );
+        if ( north_valid && ( not south_valid || P.lat() - grid_.y( south ) >= grid_.y( north ) - P.lat() ) ) {
+            visit_row( north-- );
+        }
+        else {
+            visit_row( south++ );
+        }
+    }
+}
+
+}  // namespace method
+}  // namespace interpolation
+}  // namespace atlas
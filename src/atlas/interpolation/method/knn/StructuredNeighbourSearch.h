@@ -0,0 +1,49 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "atlas/grid/StencilComputer.h"
+#include "atlas/grid/StructuredGrid.h"
+#include "atlas/library/config.h"
+#include "atlas/util/Point.h"
+
+namespace atlas {
+namespace interpolation {
+namespace method {
+
+/// @brief Nearest points of a global StructuredGrid, located analytically from its rows instead of with a k-d tree
+///
+/// The rows enclosing a point are found with grid::ComputeNorth, and the points west of it within a row with
+/// grid::ComputeWest. Rows are then visited outwards for as long as their latitude alone does not rule them
+/// out. Distances are chordal distances on the Earth, as for the k-d tree based methods.
+class StructuredNeighbourSearch {
+public:
+    /// @brief True for global StructuredGrids in (lon,lat), with points equally spaced in every row
+    static bool supports( const Grid& );
+
+    StructuredNeighbourSearch( const StructuredGrid& );
+
+    /// @brief k nearest grid points to P, nearest first, as pairs of squared distance and grid index
+    void kNearestNeighbours( const PointLonLat& P, size_t k, std::vector<std::pair<double, gidx_t>>& nearest ) const;
+
+private:
+    StructuredGrid grid_;
+    grid::ComputeNorth compute_north_;
+    grid::ComputeWest compute_west_;
+    std::vector<gidx_t> row_begin_;
+};
+
+}  // namespace method
+}  // namespace interpolation
+}  // namespace atlas
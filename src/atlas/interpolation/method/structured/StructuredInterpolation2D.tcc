@@ -133,7 +133,7 @@ void StructuredInterpolation2D<Kernel>::setup( const FunctionSpace& source ) {
         throw_Exception( "The source functionspace must have (halo >= 1) for pole treatment" );
     }
 
-    if ( not matrix_free_ ) {
+    if ( not matrix_free_ && not matrixFromCache() ) {
         ATLAS_ASSERT( target_lonlat_ );  // TODO: implement setup with target_lonlat_fields_ as well (see execute_impl)
 
         idx_t inp_npts = source.size();
@@ -175,7 +175,7 @@ void StructuredInterpolation2D<Kernel>::setup( const FunctionSpace& source ) {
             }
             // fill sparse matrix and return
             Matrix A( out_npts, inp_npts, triplets );
-            matrix_.swap( A );
+            setMatrix( A );
         }
     }
 }
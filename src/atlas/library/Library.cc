@@ -70,6 +70,13 @@ int getEnv( const std::string& env, int default_value ) {
     return default_value;
 }
 
+std::string getEnv( const std::string& env, const std::string& default_value ) {
+    if ( ::getenv( env.c_str() ) ) {
+        return ::getenv( env.c_str() );
+    }
+    return default_value;
+}
+
 }  // namespace
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -82,7 +89,8 @@ Library::Library() :
     info_( getEnv( "ATLAS_INFO", true ) ),
     trace_( getEnv( "ATLAS_TRACE", false ) ),
     trace_barriers_( getEnv( "ATLAS_TRACE_BARRIERS", false ) ),
-    trace_report_( getEnv( "ATLAS_TRACE_REPORT", false ) ) {}
+    trace_report_( getEnv( "ATLAS_TRACE_REPORT", false ) ),
+    trace_chrome_( getEnv( "ATLAS_TRACE_CHROME", std::string() ) ) {}
 
 Library& Library::instance() {
     return libatlas;
@@ -128,6 +136,10 @@ void Library::initialise( const eckit::Parametrisation& config ) {
     if ( config.has( "trace" ) ) {
         config.get( "trace.barriers", trace_barriers_ );
         config.get( "trace.report", trace_report_ );
+        config.get( "trace.chrome", trace_chrome_ );
+    }
+    if ( trace_chrome_.size() ) {
+        runtime::trace::Timings::recordEvents( true );
     }
 
     if ( not debug_ ) {
@@ -157,6 +169,7 @@ void Library::initialise( const eckit::Parametrisation& config ) {
         out << "  log.debug       [" << str( debug() ) << "] \n";
         out << "  trace.barriers  [" << str( traceBarriers() ) << "] \n";
         out << "  trace.report    [" << str( trace_report_ ) << "] \n";
+        out << "  trace.chrome    [" << trace_chrome_ << "] \n";
         out << " \n";
         out << atlas::Library::instance().information();
         out << std::flush;
@@ -171,6 +184,9 @@ void Library::finalise() {
     if ( ATLAS_HAVE_TRACE && trace_report_ ) {
         Log::info() << atlas::Trace::report() << std::endl;
     }
+    if ( ATLAS_HAVE_TRACE && trace_chrome_.size() ) {
+        atlas::Trace::exportChromeTrace( trace_chrome_ );
+    }
 
     if ( getEnv( "ATLAS_FINALISES_MPI", false ) ) {
         Log::debug() << "ATLAS_FINALISES_MPI is set: calling eckit::mpi::finaliseAllComms()" << std::endl;
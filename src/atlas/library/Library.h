@@ -65,6 +65,7 @@ protected:
     bool trace_{false};
     bool trace_barriers_{false};
     bool trace_report_{false};
+    std::string trace_chrome_;  // file to export Chrome trace events to
     mutable std::unique_ptr<eckit::Channel> info_channel_;
     mutable std::unique_ptr<eckit::Channel> trace_channel_;
     mutable std::unique_ptr<eckit::Channel> debug_channel_;
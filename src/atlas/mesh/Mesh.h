@@ -33,6 +33,7 @@ namespace atlas {
 namespace mesh {
 class Nodes;
 class HybridElements;
+class MeshCheckpoint;
 typedef HybridElements Edges;
 typedef HybridElements Cells;
 }  // namespace mesh
@@ -127,6 +128,7 @@ private:  // methods
     }
 
     friend class meshgenerator::MeshGeneratorImpl;
+    friend class mesh::MeshCheckpoint;
     void setProjection( const Projection& p ) { get()->setProjection( p ); }
     void setGrid( const Grid& p ) { get()->setGrid( p ); }
 };
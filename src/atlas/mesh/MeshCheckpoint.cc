@@ -0,0 +1,553 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "eckit/log/JSON.h"
+#include "eckit/utils/MD5.h"
+
+#include "atlas/array.h"
+#include "atlas/field/Field.h"
+#include "atlas/functionspace/NodeColumns.h"
+#include "atlas/grid/Grid.h"
+#include "atlas/grid/Partitioner.h"
+#include "atlas/library/config.h"
+#include "atlas/mesh/Connectivity.h"
+#include "atlas/mesh/ElementType.h"
+#include "atlas/mesh/Elements.h"
+#include "atlas/mesh/Halo.h"
+#include "atlas/mesh/HybridElements.h"
+#include "atlas/mesh/Mesh.h"
+#include "atlas/mesh/MeshCheckpoint.h"
+#include "atlas/mesh/Nodes.h"
+#include "atlas/meshgenerator/MeshGenerator.h"
+#include "atlas/option.h"
+#include "atlas/parallel/HaloExchange.h"
+#include "atlas/parallel/mpi/mpi.h"
+#include "atlas/runtime/Exception.h"
+#include "atlas/runtime/Log.h"
+#include "atlas/runtime/Trace.h"
+#include "atlas/util/Metadata.h"
+
+namespace atlas {
+namespace mesh {
+
+namespace {
+
+constexpr std::uint64_t FORMAT_VERSION  = 1;
+constexpr std::uint64_t BYTE_ORDER_MARK = 0x0102030405060708;
+constexpr size_t ALIGNMENT              = 64;
+
+/// First 64 bytes of a checkpoint file. The description of the contents is stored as JSON at the end of the file,
+/// and refers to the aligned blocks of data in between by offset and size.
+struct Header {
+    char magic[16];
+    std::uint64_t version;
+    std::uint64_t byte_order;
+    std::uint64_t description_offset;
+    std::uint64_t description_size;
+    char reserved[16];
+};
+static_assert( sizeof( Header ) == ALIGNMENT, "Header should fill the first aligned block" );
+
+const char* magic() {
+    return "atlas-mesh";
+}
+
+/// Index types and base of the build, which determine the layout of stored indices
+util::Config build_config() {
+    util::Config config;
+    config.set( "idx_t", int( sizeof( idx_t ) ) );
+    config.set( "gidx_t", int( sizeof( gidx_t ) ) );
+    config.set( "fortran", bool( ATLAS_HAVE_FORTRAN ) );
+    return config;
+}
+
+class Writer {
+public:
+    Writer( const eckit::PathName& path ) : path_( path ), out_( path.localPath(), std::ios::binary ) {
+        if ( not out_ ) {
+            throw_CantOpenFile( path_, Here() );
+        }
+        const Header empty{};
+        out_.write( reinterpret_cast<const char*>( &empty ), sizeof( Header ) );
+        offset_ = sizeof( Header );
+    }
+
+    /// Append an aligned block of data, and return its offset and size
+    util::Config write( const void* data, size_t bytes ) {
+        align();
+        util::Config block;
+        block.set( "offset", long( offset_ ) );
+        block.set( "bytes", long( bytes ) );
+        out_.write( static_cast<const char*>( data ), bytes );
+        offset_ += bytes;
+        return block;
+    }
+
+    template <typename T>
+    util::Config write( const std::vector<T>& values ) {
+        return write( values.data(), values.size() * sizeof( T ) );
+    }
+
+    void close( const util::Config& description ) {
+        std::stringstream s;
+        eckit::JSON json( s );
+        json.precision( 17 );
+        json << description;
+        const std::string str = s.str();
+
+        align();
+        Header header{};
+        std::strncpy( header.magic, magic(), sizeof( header.magic ) );
+        header.version            = FORMAT_VERSION;
+        header.byte_order         = BYTE_ORDER_MARK;
+        header.description_offset = offset_;
+        header.description_size   = str.size();
+        out_.write( str.data(), str.size() );
+        out_.seekp( 0 );
+        out_.write( reinterpret_cast<const char*>( &header ), sizeof( Header ) );
+        out_.close();
+        if ( not out_ ) {
+            throw_Exception( "Could not write mesh checkpoint " + std::string( path_ ), Here() );
+        }
+    }
+
+private:
+    void align() {
+        static const char zeros[ALIGNMENT] = {};
+        const size_t padding               = ( ALIGNMENT - offset_ % ALIGNMENT ) % ALIGNMENT;
+        out_.write( zeros, padding );
+        offset_ += padding;
+    }
+
+    eckit::PathName path_;
+    std::ofstream out_;
+    size_t offset_;
+};
+
+/// Read-only memory mapping of a checkpoint file
+class MappedFile {
+public:
+    MappedFile( const eckit::PathName& path ) : path_( path ) {
+        int fd = ::open( path.localPath(), O_RDONLY );
+        if ( fd < 0 ) {
+            throw_CantOpenFile( path_, Here() );
+        }
+        struct stat st;
+        if ( ::fstat( fd, &st ) != 0 ) {
+            ::close( fd );
+            throw_CantOpenFile( path_, Here() );
+        }
+        size_ = size_t( st.st_size );
+        data_ = size_ ? ::mmap( nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0 ) : MAP_FAILED;
+        ::close( fd );
+        if ( data_ == MAP_FAILED ) {
+            throw_Exception( "Could not map mesh checkpoint " + std::string( path_ ), Here() );
+        }
+        ::madvise( data_, size_, MADV_SEQUENTIAL | MADV_WILLNEED );
+        try {
+            read_description();
+        }
+        catch ( ... ) {
+            ::munmap( data_, size_ );
+            throw;
+        }
+    }
+
+    ~MappedFile() { ::munmap( data_, size_ ); }
+
+    const util::Config& description() const { return description_; }
+
+    /// Pointer to a block of data written with Writer::write
+    template <typename T>
+    const T* data( const eckit::Configuration& block ) const {
+        const size_t offset = size_t( block.getLong( "offset" ) );
+        const size_t bytes  = size_t( block.getLong( "bytes" ) );
+        if ( offset + bytes > size_ || bytes % sizeof( T ) ) {
+            invalid( "corrupt block at offset " + std::to_string( offset ) );
+        }
+        return reinterpret_cast<const T*>( static_cast<const char*>( data_ ) + offset );
+    }
+
+    size_t bytes( const eckit::Configuration& block ) const { return size_t( block.getLong( "bytes" ) ); }
+
+private:
+    void read_description() {
+        if ( size_ < sizeof( Header ) ) {
+            invalid( "file too small" );
+        }
+        const Header& header = *static_cast<const Header*>( data_ );
+        if ( std::strncmp( header.magic, magic(), sizeof( header.magic ) ) != 0 ) {
+            invalid( "not a mesh checkpoint" );
+        }
+        if ( header.byte_order != BYTE_ORDER_MARK ) {
+            invalid( "written with different byte order" );
+        }
+        if ( header.version != FORMAT_VERSION ) {
+            invalid( "unsupported version " + std::to_string( header.version ) );
+        }
+        util::Config location;
+        location.set( "offset", long( header.description_offset ) );
+        location.set( "bytes", long( header.description_size ) );
+        std::istringstream s( std::string( data<char>( location ), header.description_size ) );
+        description_ = util::Config( s );
+    }
+
+    [[noreturn]] void invalid( const std::string& reason ) const {
+        throw_Exception( "Invalid mesh checkpoint " + std::string( path_ ) + ": " + reason, Here() );
+    }
+
+    eckit::PathName path_;
+    void* data_;
+    size_t size_;
+    util::Config description_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+util::Config encode_field( Writer& out, const Field& field ) {
+    ATLAS_ASSERT( field.array().contiguous() );
+    util::Config config;
+    config.set( "name", field.name() );
+    config.set( "datatype", field.datatype().str() );
+    config.set( "shape", std::vector<idx_t>( field.shape().begin(), field.shape().end() ) );
+    config.set( "metadata", field.metadata() );
+    config.set( "data", out.write( field.array().storage(), size_t( field.size() ) * field.datatype().size() ) );
+    return config;
+}
+
+/// Fields are added to Nodes or HybridElements if not yet present
+template <typename FieldContainer>
+void decode_field( const MappedFile& in, const eckit::Configuration& config, FieldContainer& container ) {
+    const std::string name = config.getString( "name" );
+    const array::DataType datatype( config.getString( "datatype" ) );
+    std::vector<idx_t> shape_vector;
+    config.get( "shape", shape_vector );
+    const array::ArrayShape shape( shape_vector.data(), shape_vector.size() );
+
+    if ( not container.has_field( name ) ) {
+        container.add( Field( name, datatype, shape ) );
+    }
+    Field& field = container.field( name );
+    if ( field.datatype() != datatype || field.shape() != shape ) {
+        throw_Exception( "Field " + name + " in mesh checkpoint does not match the mesh", Here() );
+    }
+    field.metadata() = util::Metadata( config.getSubConfiguration( "metadata" ) );
+
+    const eckit::LocalConfiguration data = config.getSubConfiguration( "data" );
+    ATLAS_ASSERT( in.bytes( data ) == size_t( field.size() ) * datatype.size() );
+    std::memcpy( field.storage(), in.data<char>( data ), in.bytes( data ) );
+}
+
+/// Connectivities are stored with base 0, independent of ATLAS_HAVE_FORTRAN
+template <typename Connectivity>
+util::Config encode_connectivity( Writer& out, const Connectivity& connectivity ) {
+    std::vector<idx_t> counts( connectivity.rows() );
+    std::vector<idx_t> values;
+    values.reserve( connectivity.size() );
+    for ( idx_t r = 0; r < connectivity.rows(); ++r ) {
+        counts[r] = connectivity.cols( r );
+        for ( idx_t c = 0; c < counts[r]; ++c ) {
+            values.push_back( connectivity( r, c ) );
+        }
+    }
+    util::Config config;
+    config.set( "rows", connectivity.rows() );
+    config.set( "counts", out.write( counts ) );
+    config.set( "values", out.write( values ) );
+    return config;
+}
+
+util::Config encode_connectivity( Writer& out, const MultiBlockConnectivity& connectivity ) {
+    std::vector<idx_t> block_rows( connectivity.blocks() );
+    std::vector<idx_t> block_cols( connectivity.blocks() );
+    for ( idx_t b = 0; b < connectivity.blocks(); ++b ) {
+        block_rows[b] = connectivity.block( b ).rows();
+        block_cols[b] = connectivity.block( b ).cols();
+    }
+    util::Config config = encode_connectivity<MultiBlockConnectivity>( out, connectivity );
+    config.set( "block_rows", block_rows );
+    config.set( "block_cols", block_cols );
+    return config;
+}
+
+void decode_connectivity( const MappedFile& in, const eckit::Configuration& config,
+                          IrregularConnectivity& connectivity ) {
+    const idx_t rows = config.getInt( "rows" );
+    if ( rows == 0 ) {
+        return;
+    }
+    const idx_t* counts = in.data<idx_t>( config.getSubConfiguration( "counts" ) );
+    const idx_t* values = in.data<idx_t>( config.getSubConfiguration( "values" ) );
+    connectivity.clear();
+    connectivity.add( rows, counts );
+    for ( idx_t r = 0; r < rows; ++r ) {
+        connectivity.set( r, values );
+        values += counts[r];
+    }
+}
+
+void decode_connectivity( const MappedFile& in, const eckit::Configuration& config,
+                          MultiBlockConnectivity& connectivity ) {
+    const idx_t rows = config.getInt( "rows" );
+    if ( rows == 0 ) {
+        return;
+    }
+    std::vector<idx_t> block_rows;
+    std::vector<idx_t> block_cols;
+    config.get( "block_rows", block_rows );
+    config.get( "block_cols", block_cols );
+    const idx_t* values = in.data<idx_t>( config.getSubConfiguration( "values" ) );
+    connectivity.clear();
+    for ( size_t b = 0; b < block_rows.size(); ++b ) {
+        connectivity.add( block_rows[b], block_cols[b], values );
+        values += block_rows[b] * block_cols[b];
+    }
+    ATLAS_ASSERT( connectivity.rows() == rows );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+util::Config encode_nodes( Writer& out, const Nodes& nodes ) {
+    std::vector<util::Config> fields;
+    for ( idx_t f = 0; f < nodes.nb_fields(); ++f ) {
+        fields.emplace_back( encode_field( out, nodes.field( f ) ) );
+    }
+    util::Config config;
+    config.set( "size", nodes.size() );
+    config.set( "metadata", nodes.metadata() );
+    config.set( "fields", fields );
+    config.set( "edge_connectivity", encode_connectivity( out, nodes.edge_connectivity() ) );
+    config.set( "cell_connectivity", encode_connectivity( out, nodes.cell_connectivity() ) );
+    return config;
+}
+
+void decode_nodes( const MappedFile& in, const eckit::Configuration& config, Nodes& nodes ) {
+    nodes.resize( config.getInt( "size" ) );
+    nodes.metadata() = util::Metadata( config.getSubConfiguration( "metadata" ) );
+    for ( const auto& field : config.getSubConfigurations( "fields" ) ) {
+        decode_field( in, field, nodes );
+    }
+    decode_connectivity( in, config.getSubConfiguration( "edge_connectivity" ), nodes.edge_connectivity() );
+    decode_connectivity( in, config.getSubConfiguration( "cell_connectivity" ), nodes.cell_connectivity() );
+}
+
+util::Config encode_elements( Writer& out, const HybridElements& elements ) {
+    std::vector<util::Config> types;
+    for ( idx_t t = 0; t < elements.nb_types(); ++t ) {
+        const Elements& elems                      = elements.elements( t );
+        const BlockConnectivity& node_connectivity = elems.node_connectivity();
+        std::vector<idx_t> values( size_t( node_connectivity.rows() ) * size_t( node_connectivity.cols() ) );
+        for ( idx_t r = 0, i = 0; r < node_connectivity.rows(); ++r ) {
+            for ( idx_t c = 0; c < node_connectivity.cols(); ++c, ++i ) {
+                values[i] = node_connectivity( r, c );
+            }
+        }
+        util::Config type;
+        type.set( "name", elems.element_type().name() );
+        type.set( "size", elems.size() );
+        type.set( "node_connectivity", out.write( values ) );
+        types.emplace_back( type );
+    }
+    std::vector<util::Config> fields;
+    for ( idx_t f = 0; f < elements.nb_fields(); ++f ) {
+        fields.emplace_back( encode_field( out, elements.field( f ) ) );
+    }
+    util::Config config;
+    config.set( "types", types );
+    config.set( "metadata", elements.metadata() );
+    config.set( "fields", fields );
+    config.set( "edge_connectivity", encode_connectivity( out, elements.edge_connectivity() ) );
+    config.set( "cell_connectivity", encode_connectivity( out, elements.cell_connectivity() ) );
+    return config;
+}
+
+void decode_elements( const MappedFile& in, const eckit::Configuration& config, HybridElements& elements ) {
+    for ( const auto& type : config.getSubConfigurations( "types" ) ) {
+        const idx_t size    = type.getInt( "size" );
+        const idx_t* values = in.data<idx_t>( type.getSubConfiguration( "node_connectivity" ) );
+        elements.add( ElementType::create( type.getString( "name" ) ), size, values );
+    }
+    elements.metadata() = util::Metadata( config.getSubConfiguration( "metadata" ) );
+    for ( const auto& field : config.getSubConfigurations( "fields" ) ) {
+        decode_field( in, field, elements );
+    }
+    decode_connectivity( in, config.getSubConfiguration( "edge_connectivity" ), elements.edge_connectivity() );
+    decode_connectivity( in, config.getSubConfiguration( "cell_connectivity" ), elements.cell_connectivity() );
+}
+
+util::Config encode_halo_exchange( Writer& out, idx_t halo, const parallel::HaloExchange& halo_exchange ) {
+    const parallel::HaloExchange::Pattern pattern = halo_exchange.pattern();
+    util::Config config;
+    config.set( "halo", halo );
+    config.set( "parsize", pattern.parsize );
+    config.set( "send_procs", pattern.send_procs );
+    config.set( "send_counts", pattern.send_counts );
+    config.set( "send_map", out.write( pattern.send_map ) );
+    config.set( "recv_procs", pattern.recv_procs );
+    config.set( "recv_counts", pattern.recv_counts );
+    config.set( "recv_map", out.write( pattern.recv_map ) );
+    return config;
+}
+
+parallel::HaloExchange* decode_halo_exchange( const MappedFile& in, const eckit::Configuration& config ) {
+    parallel::HaloExchange::Pattern pattern;
+    pattern.parsize = config.getInt( "parsize" );
+    config.get( "send_procs", pattern.send_procs );
+    config.get( "send_counts", pattern.send_counts );
+    config.get( "recv_procs", pattern.recv_procs );
+    config.get( "recv_counts", pattern.recv_counts );
+    auto read_map = [&]( const std::string& name, std::vector<int>& map ) {
+        const eckit::LocalConfiguration block = config.getSubConfiguration( name );
+        const int* values                     = in.data<int>( block );
+        map.assign( values, values + in.bytes( block ) / sizeof( int ) );
+    };
+    read_map( "send_map", pattern.send_map );
+    read_map( "recv_map", pattern.recv_map );
+
+    auto* halo_exchange = new parallel::HaloExchange();
+    halo_exchange->setup( pattern );
+    return halo_exchange;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::string MeshCheckpoint::key( const Grid& grid, const grid::Partitioner& partitioner,
+                                 const MeshGenerator& meshgenerator, const eckit::Configuration& setup ) {
+    eckit::MD5 md5;
+    grid.hash( md5 );
+    md5.add( partitioner.type() );
+    md5.add( partitioner.nb_partitions() );
+    meshgenerator.hash( md5 );
+    setup.hash( md5 );
+    return md5.digest();
+}
+
+MeshCheckpoint::MeshCheckpoint( const eckit::PathName& directory, const std::string& key ) :
+    directory_( directory ),
+    key_( key ) {}
+
+eckit::PathName MeshCheckpoint::path() const {
+    return directory_ / key_ / ( std::to_string( mpi::comm().rank() ) + ".mesh" );
+}
+
+bool MeshCheckpoint::exists() const {
+    int exists = path().exists() ? 1 : 0;
+    ATLAS_TRACE_MPI( ALLREDUCE ) { mpi::comm().allReduceInPlace( exists, eckit::mpi::min() ); }
+    return exists;
+}
+
+void MeshCheckpoint::write( const Mesh& mesh ) const {
+    ATLAS_TRACE( "MeshCheckpoint::write" );
+    const auto& comm = mpi::comm();
+
+    // Set up the halo exchanges first, as NodeColumns completes the parallel fields of the mesh if needed
+    std::vector<util::ObjectHandle<parallel::HaloExchange>> halo_exchanges;
+    for ( idx_t halo = 0; halo <= Halo( mesh ).size(); ++halo ) {
+        functionspace::NodeColumns fs( mesh, option::halo( halo ) );
+        halo_exchanges.emplace_back( const_cast<parallel::HaloExchange*>( &fs.halo_exchange() ) );
+    }
+
+    const eckit::PathName dir = directory_ / key_;
+    if ( comm.rank() == 0 && not dir.exists() ) {
+        dir.mkdir();
+    }
+    ATLAS_TRACE_MPI( BARRIER ) { comm.barrier(); }
+
+    // Written under a temporary name, so that a partially written checkpoint is never read
+    const eckit::PathName file = path();
+    const eckit::PathName tmp  = file + ".tmp";
+    {
+        Writer out( tmp );
+        util::Config description;
+        description.set( "key", key_ );
+        description.set( "build", build_config() );
+        description.set( "rank", idx_t( comm.rank() ) );
+        description.set( "nb_partitions", idx_t( comm.size() ) );
+        description.set( "metadata", mesh.metadata() );
+        description.set( "nodes", encode_nodes( out, mesh.nodes() ) );
+        description.set( "cells", encode_elements( out, mesh.cells() ) );
+        description.set( "facets", encode_elements( out, mesh.facets() ) );
+        description.set( "ridges", encode_elements( out, mesh.ridges() ) );
+        description.set( "peaks", encode_elements( out, mesh.peaks() ) );
+        std::vector<util::Config> halo_exchange_configs;
+        for ( size_t halo = 0; halo < halo_exchanges.size(); ++halo ) {
+            halo_exchange_configs.emplace_back( encode_halo_exchange( out, idx_t( halo ), *halo_exchanges[halo] ) );
+        }
+        description.set( "halo_exchanges", halo_exchange_configs );
+        out.close( description );
+    }
+    eckit::PathName::rename( tmp, file );
+    ATLAS_TRACE_MPI( BARRIER ) { comm.barrier(); }
+    Log::debug() << "Mesh checkpoint written to " << dir << std::endl;
+}
+
+Mesh MeshCheckpoint::read( const Grid& grid ) const {
+    ATLAS_TRACE( "MeshCheckpoint::read" );
+    const MappedFile in( path() );
+    const util::Config& description = in.description();
+    if ( description.getInt( "nb_partitions" ) != int( mpi::comm().size() ) ||
+         description.getInt( "rank" ) != int( mpi::comm().rank() ) ) {
+        throw_Exception( "Mesh checkpoint " + std::string( path() ) + " was written with " +
+                             std::to_string( description.getInt( "nb_partitions" ) ) + " MPI tasks",
+                         Here() );
+    }
+
+    const util::Config build                   = build_config();
+    const eckit::LocalConfiguration written_by = description.getSubConfiguration( "build" );
+    if ( written_by.getInt( "idx_t" ) != build.getInt( "idx_t" ) ||
+         written_by.getInt( "gidx_t" ) != build.getInt( "gidx_t" ) ||
+         written_by.getBool( "fortran" ) != build.getBool( "fortran" ) ) {
+        throw_Exception( "Mesh checkpoint " + std::string( path() ) + " was written by an incompatible build of atlas",
+                         Here() );
+    }
+
+    Mesh mesh;
+    mesh.metadata() = util::Metadata( description.getSubConfiguration( "metadata" ) );
+    decode_nodes( in, description.getSubConfiguration( "nodes" ), mesh.nodes() );
+    decode_elements( in, description.getSubConfiguration( "cells" ), mesh.cells() );
+    decode_elements( in, description.getSubConfiguration( "facets" ), mesh.facets() );
+    decode_elements( in, description.getSubConfiguration( "ridges" ), mesh.ridges() );
+    decode_elements( in, description.getSubConfiguration( "peaks" ), mesh.peaks() );
+    mesh.setGrid( grid );
+
+    for ( const auto& config : description.getSubConfigurations( "halo_exchanges" ) ) {
+        functionspace::detail::NodeColumns::set_halo_exchange( mesh, config.getInt( "halo" ),
+                                                               decode_halo_exchange( in, config ) );
+    }
+    return mesh;
+}
+
+Mesh MeshCheckpoint::read_or_create( const Grid& grid, const std::function<Mesh()>& create ) const {
+    if ( exists() ) {
+        return read( grid );
+    }
+    Mesh mesh = create();
+    write( mesh );
+    return mesh;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace mesh
+}  // namespace atlas
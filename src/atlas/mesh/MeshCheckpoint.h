@@ -0,0 +1,85 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "eckit/filesystem/PathName.h"
+
+#include "atlas/util/Config.h"
+
+namespace eckit {
+class Configuration;
+}
+
+namespace atlas {
+class Grid;
+class Mesh;
+class MeshGenerator;
+namespace grid {
+class Partitioner;
+}
+}  // namespace atlas
+
+namespace atlas {
+namespace mesh {
+
+/// @brief Per-rank binary checkpoint of a partitioned Mesh, including the setup of its NodeColumns halo exchanges
+///
+/// Every MPI task stores its part of the mesh in "<directory>/<key>/<rank>.mesh": the fields, connectivities
+/// and metadata of nodes, cells and edges, the metadata of the mesh (halo sizes, ...), and the halo exchange
+/// pattern of NodeColumns for every halo size up to the halo of the mesh.
+/// All arrays are stored contiguously and 64-byte aligned, and the file is memory-mapped when it is read,
+/// so that neither the mesh generator, nor mesh actions, nor the halo exchange setup are run again.
+///
+/// The key identifies the mesh by its grid, partitioner, mesh generator and any further configuration,
+/// e.g. the mesh actions that were applied:
+///
+///     MeshCheckpoint checkpoint( "checkpoints", MeshCheckpoint::key( grid, partitioner, meshgenerator,
+///                                                                    util::Config( "halo", 2 ) ) );
+///     Mesh mesh = checkpoint.read_or_create( grid, [&]() {
+///         Mesh mesh = meshgenerator.generate( grid, partitioner );
+///         mesh::actions::build_halo( mesh, 2 );
+///         return mesh;
+///     } );
+///
+/// A checkpoint can only be read with the same number of MPI tasks it was written with.
+class MeshCheckpoint {
+public:
+    /// @brief Key that identifies a mesh by its grid, partitioner, mesh generator and further setup
+    static std::string key( const Grid&, const grid::Partitioner&, const MeshGenerator&,
+                            const eckit::Configuration& setup = util::NoConfig() );
+
+    MeshCheckpoint( const eckit::PathName& directory, const std::string& key );
+
+    /// @brief File of this MPI task
+    eckit::PathName path() const;
+
+    /// @brief True if the checkpoint is present for every MPI task (collective)
+    bool exists() const;
+
+    /// @brief Write the part of the mesh of this MPI task (collective)
+    void write( const Mesh& ) const;
+
+    /// @brief Read the part of the mesh of this MPI task
+    Mesh read( const Grid& ) const;
+
+    /// @brief Read the checkpoint if it exists, otherwise create the mesh and write it (collective)
+    Mesh read_or_create( const Grid&, const std::function<Mesh()>& create ) const;
+
+private:
+    eckit::PathName directory_;
+    std::string key_;
+};
+
+}  // namespace mesh
+}  // namespace atlas
@@ -18,6 +18,7 @@
 #include "atlas/mesh/Mesh.h"
 #include "atlas/mesh/Nodes.h"
 #include "atlas/mesh/actions/BuildCellCentres.h"
+#include "atlas/parallel/omp/omp.h"
 #include "atlas/runtime/Trace.h"
 #include "atlas/util/CoordinateEnums.h"
 
@@ -58,7 +59,7 @@ Field& BuildCellCentres::operator()( Mesh& mesh ) const {
         auto centroids = array::make_view<double, 2>( mesh.cells().field( field_name_ ) );
         const mesh::HybridElements::Connectivity& cell_node_connectivity = mesh.cells().node_connectivity();
 
-        for ( idx_t e = 0; e < nb_cells; ++e ) {
+        atlas_omp_parallel_for( idx_t e = 0; e < nb_cells; ++e ) {
             centroids( e, XX ) = 0.;
             centroids( e, YY ) = 0.;
             centroids( e, ZZ ) = 0.;
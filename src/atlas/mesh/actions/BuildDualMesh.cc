@@ -26,7 +26,10 @@
 #include "atlas/mesh/Mesh.h"
 #include "atlas/mesh/Nodes.h"
 #include "atlas/mesh/actions/BuildDualMesh.h"
+#include "atlas/mesh/detail/GroupByTarget.h"
 #include "atlas/parallel/Checksum.h"
+#include "atlas/parallel/omp/omp.h"
+#include "atlas/parallel/omp/sort.h"
 #include "atlas/runtime/Exception.h"
 #include "atlas/runtime/Trace.h"
 #include "atlas/util/CoordinateEnums.h"
@@ -51,12 +54,22 @@ void global_bounding_box( const mesh::Nodes& nodes, double min[2], double max[2]
     max[XX]                        = -std::numeric_limits<double>::max();
     max[YY]                        = -std::numeric_limits<double>::max();
 
+    double min_x = min[XX];
+    double min_y = min[YY];
+    double max_x = max[XX];
+    double max_y = max[YY];
+    atlas_omp_pragma( omp parallel for schedule( static ) reduction( min : min_x, min_y )
+                      reduction( max : max_x, max_y ) )
     for ( int node = 0; node < nb_nodes; ++node ) {
-        min[XX] = std::min( min[XX], xy( node, XX ) );
-        min[YY] = std::min( min[YY], xy( node, YY ) );
-        max[XX] = std::max( max[XX], xy( node, XX ) );
-        max[YY] = std::max( max[YY], xy( node, YY ) );
+        min_x = std::min( min_x, xy( node, XX ) );
+        min_y = std::min( min_y, xy( node, YY ) );
+        max_x = std::max( max_x, xy( node, XX ) );
+        max_y = std::max( max_y, xy( node, YY ) );
     }
+    min[XX] = min_x;
+    min[YY] = min_y;
+    max[XX] = max_x;
+    max[YY] = max_y;
 
     ATLAS_TRACE_MPI( ALLREDUCE ) {
         mpi::comm().allReduceInPlace( min, 2, eckit::mpi::min() );
@@ -73,9 +86,30 @@ struct Node {
     gidx_t g;
     idx_t i;
 
-    bool operator<( const Node& other ) const { return ( g < other.g ); }
+    bool operator<( const Node& other ) const { return ( g < other.g ) || ( g == other.g && i < other.i ); }
 };
 
+/// Boundary edges (edges with only one cell) of node jnode are bdry_edges[displs[jnode]], ...,
+/// bdry_edges[displs[jnode+1]-1], in increasing order
+void group_boundary_edges_by_node( const mesh::HybridElements& edges, idx_t nb_nodes, std::vector<idx_t>& displs,
+                                   std::vector<idx_t>& bdry_edges ) {
+    const mesh::HybridElements::Connectivity& edge_node_connectivity = edges.node_connectivity();
+    const mesh::HybridElements::Connectivity& edge_cell_connectivity = edges.cell_connectivity();
+
+    const idx_t nb_edges = edges.size();
+    std::vector<idx_t> edge_node( 2 * nb_edges );
+    atlas_omp_parallel_for( idx_t jedge = 0; jedge < nb_edges; ++jedge ) {
+        const bool bdry = edge_cell_connectivity( jedge, 0 ) != edge_cell_connectivity.missing_value() &&
+                          edge_cell_connectivity( jedge, 1 ) == edge_cell_connectivity.missing_value();
+        for ( idx_t n = 0; n < 2; ++n ) {
+            edge_node[2 * jedge + n] = bdry ? edge_node_connectivity( jedge, n ) : -1;
+        }
+    }
+    mesh::detail::group_by_target( edge_node, nb_nodes, displs, bdry_edges );
+    const idx_t nb_bdry_entries = static_cast<idx_t>( bdry_edges.size() );
+    atlas_omp_parallel_for( idx_t j = 0; j < nb_bdry_entries; ++j ) { bdry_edges[j] /= 2; }
+}
+
 }  // namespace
 
 array::Array* build_centroids_xy( const mesh::HybridElements&, const Field& xy );
@@ -139,7 +173,7 @@ array::Array* build_centroids_xy( const mesh::HybridElements& elements, const Fi
     array::ArrayView<double, 2> centroids = array::make_view<double, 2>( *array_centroids );
     idx_t nb_elems                        = elements.size();
     const mesh::HybridElements::Connectivity& elem_nodes = elements.node_connectivity();
-    for ( idx_t e = 0; e < nb_elems; ++e ) {
+    atlas_omp_parallel_for( idx_t e = 0; e < nb_elems; ++e ) {
         centroids( e, XX )               = 0.;
         centroids( e, YY )               = 0.;
         const idx_t nb_nodes_per_elem    = elem_nodes.cols( e );
@@ -175,13 +209,26 @@ void add_median_dual_volume_contribution_cells( const mesh::HybridElements& cell
     // special ordering for bit-identical results
     idx_t nb_cells = cells.size();
     std::vector<Node> ordering( nb_cells );
-    for ( idx_t jcell = 0; jcell < nb_cells; ++jcell ) {
+    atlas_omp_parallel_for( idx_t jcell = 0; jcell < nb_cells; ++jcell ) {
         ordering[jcell] =
             Node( util::unique_lonlat( cell_centroids( jcell, XX ), cell_centroids( jcell, YY ) ), jcell );
     }
-    std::sort( ordering.data(), ordering.data() + nb_cells );
+    omp::sort( ordering.begin(), ordering.end() );
 
+    // Contributions are computed per cell, and then added to every node in the same order as a sequential
+    // loop over the ordered cells would, so that results do not depend on the number of threads
+    std::vector<idx_t> contribution_offset( nb_cells + 1 );
+    contribution_offset[0] = 0;
     for ( idx_t jcell = 0; jcell < nb_cells; ++jcell ) {
+        const idx_t icell = ordering[jcell].i;
+        contribution_offset[jcell + 1] =
+            contribution_offset[jcell] + ( patch( icell ) ? 0 : 2 * cell_edge_connectivity.cols( icell ) );
+    }
+    const idx_t nb_contributions = contribution_offset[nb_cells];
+    std::vector<idx_t> contribution_node( nb_contributions );
+    std::vector<double> contribution_area( nb_contributions );
+
+    atlas_omp_parallel_for( idx_t jcell = 0; jcell < nb_cells; ++jcell ) {
         idx_t icell = ordering[jcell].i;
         if ( patch( icell ) ) {
             continue;
@@ -189,19 +236,30 @@ void add_median_dual_volume_contribution_cells( const mesh::HybridElements& cell
         double x0 = cell_centroids( icell, XX );
         double y0 = cell_centroids( icell, YY );
 
+        idx_t c = contribution_offset[jcell];
         for ( idx_t jedge = 0; jedge < cell_edge_connectivity.cols( icell ); ++jedge ) {
             idx_t iedge = cell_edge_connectivity( icell, jedge );
             double x1   = edge_centroids( iedge, XX );
             double y1   = edge_centroids( iedge, YY );
             for ( idx_t jnode = 0; jnode < 2; ++jnode ) {
-                idx_t inode       = edge_node_connectivity( iedge, jnode );
-                double x2         = xy( inode, XX );
-                double y2         = xy( inode, YY );
-                double triag_area = std::abs( x0 * ( y1 - y2 ) + x1 * ( y2 - y0 ) + x2 * ( y0 - y1 ) ) * 0.5;
-                dual_volumes( inode ) += triag_area;
+                idx_t inode            = edge_node_connectivity( iedge, jnode );
+                double x2              = xy( inode, XX );
+                double y2              = xy( inode, YY );
+                contribution_node[c]   = inode;
+                contribution_area[c++] = std::abs( x0 * ( y1 - y2 ) + x1 * ( y2 - y0 ) + x2 * ( y0 - y1 ) ) * 0.5;
             }
         }
     }
+
+    const idx_t nb_nodes = nodes.size();
+    std::vector<idx_t> displs;
+    std::vector<idx_t> entries;
+    mesh::detail::group_by_target( contribution_node, nb_nodes, displs, entries );
+    atlas_omp_parallel_for( idx_t inode = 0; inode < nb_nodes; ++inode ) {
+        for ( idx_t j = displs[inode]; j < displs[inode + 1]; ++j ) {
+            dual_volumes( inode ) += contribution_area[entries[j]];
+        }
+    }
 }
 
 void add_median_dual_volume_contribution_poles( const mesh::HybridElements& edges, const mesh::Nodes& nodes,
@@ -211,31 +269,20 @@ void add_median_dual_volume_contribution_poles( const mesh::HybridElements& edge
     array::ArrayView<double, 1> dual_volumes         = array::make_view<double, 1>( array_dual_volumes );
     const array::ArrayView<double, 2> xy             = array::make_view<double, 2>( nodes.xy() );
     const array::ArrayView<double, 2> edge_centroids = array::make_view<double, 2>( edges.field( "centroids_xy" ) );
-    const mesh::HybridElements::Connectivity& edge_node_connectivity = edges.node_connectivity();
-    const mesh::HybridElements::Connectivity& edge_cell_connectivity = edges.cell_connectivity();
-
-    const idx_t nb_edges = edges.size();
-    std::map<idx_t, std::vector<idx_t>> node_to_bdry_edge;
-    for ( idx_t jedge = 0; jedge < nb_edges; ++jedge ) {
-        if ( edge_cell_connectivity( jedge, 0 ) != edge_cell_connectivity.missing_value() &&
-             edge_cell_connectivity( jedge, 1 ) == edge_cell_connectivity.missing_value() ) {
-            node_to_bdry_edge[edge_node_connectivity( jedge, 0 )].push_back( jedge );
-            node_to_bdry_edge[edge_node_connectivity( jedge, 1 )].push_back( jedge );
-        }
-    }
+    const idx_t nb_nodes = nodes.size();
+    std::vector<idx_t> displs;
+    std::vector<idx_t> bdry_edges;
+    group_boundary_edges_by_node( edges, nb_nodes, displs, bdry_edges );
 
     const double tol = 1.e-6;
     double min[2], max[2];
     global_bounding_box( nodes, min, max );
 
-    std::map<idx_t, std::vector<idx_t>>::iterator it;
-    for ( it = node_to_bdry_edge.begin(); it != node_to_bdry_edge.end(); ++it ) {
-        const idx_t jnode              = ( *it ).first;
-        std::vector<idx_t>& bdry_edges = ( *it ).second;
-        const double x0                = xy( jnode, XX );
-        const double y0                = xy( jnode, YY );
+    atlas_omp_parallel_for( idx_t jnode = 0; jnode < nb_nodes; ++jnode ) {
+        const double x0 = xy( jnode, XX );
+        const double y0 = xy( jnode, YY );
         double x1, y1, y2;
-        for ( idx_t jedge = 0; jedge < static_cast<idx_t>( bdry_edges.size() ); ++jedge ) {
+        for ( idx_t jedge = displs[jnode]; jedge < displs[jnode + 1]; ++jedge ) {
             const idx_t iedge = bdry_edges[jedge];
             x1                = edge_centroids( iedge, XX );
             y1                = edge_centroids( iedge, YY );
@@ -270,7 +317,6 @@ void build_dual_normals( Mesh& mesh ) {
     global_bounding_box( nodes, min, max );
     double tol = 1.e-6;
 
-    double xl, yl, xr, yr;
     array::ArrayView<double, 2> edge_centroids = array::make_view<double, 2>( edges.field( "centroids_xy" ) );
     array::ArrayView<double, 2> dual_normals   = array::make_view<double, 2>(
         edges.add( Field( "dual_normals", array::make_datatype<double>(), array::make_shape( nb_edges, 2 ) ) ) );
@@ -278,26 +324,20 @@ void build_dual_normals( Mesh& mesh ) {
     const mesh::HybridElements::Connectivity& edge_node_connectivity = edges.node_connectivity();
     const mesh::HybridElements::Connectivity& edge_cell_connectivity = edges.cell_connectivity();
 
-    std::map<idx_t, std::vector<idx_t>> node_to_bdry_edge;
-    for ( idx_t jedge = 0; jedge < nb_edges; ++jedge ) {
-        if ( edge_cell_connectivity( jedge, 0 ) != edge_cell_connectivity.missing_value() &&
-             edge_cell_connectivity( jedge, 1 ) == edge_cell_connectivity.missing_value() ) {
-            node_to_bdry_edge[edge_node_connectivity( jedge, 0 )].push_back( jedge );
-            node_to_bdry_edge[edge_node_connectivity( jedge, 1 )].push_back( jedge );
-        }
-    }
+    std::vector<idx_t> displs;
+    std::vector<idx_t> bdry_edges;
+    group_boundary_edges_by_node( edges, nodes.size(), displs, bdry_edges );
 
-    for ( idx_t edge = 0; edge < nb_edges; ++edge ) {
+    // Pole edges only modify their own centroid, and boundary edges are never pole edges
+    atlas_omp_parallel_for( idx_t edge = 0; edge < nb_edges; ++edge ) {
         if ( edge_cell_connectivity( edge, 0 ) == edge_cell_connectivity.missing_value() ) {
             // this is a pole edge
             // only compute for one node
             for ( idx_t n = 0; n < 2; ++n ) {
-                idx_t node                     = edge_node_connectivity( edge, n );
-                std::vector<idx_t>& bdry_edges = node_to_bdry_edge[node];
+                idx_t node = edge_node_connectivity( edge, n );
                 double x[2];
-                idx_t cnt                 = 0;
-                const idx_t nb_bdry_edges = static_cast<idx_t>( bdry_edges.size() );
-                for ( idx_t jedge = 0; jedge < nb_bdry_edges; ++jedge ) {
+                idx_t cnt = 0;
+                for ( idx_t jedge = displs[node]; jedge < displs[node + 1]; ++jedge ) {
                     idx_t bdry_edge = bdry_edges[jedge];
                     if ( std::abs( edge_centroids( bdry_edge, YY ) - max[YY] ) < tol ) {
                         edge_centroids( edge, YY ) = 90.;
@@ -326,6 +366,7 @@ void build_dual_normals( Mesh& mesh ) {
             }
         }
         else {
+            double xl, yl, xr, yr;
             idx_t left_elem  = edge_cell_connectivity( edge, 0 );
             idx_t right_elem = edge_cell_connectivity( edge, 1 );
             xl               = elem_centroids( left_elem, XX );
@@ -363,7 +404,7 @@ void make_dual_normals_outward( Mesh& mesh ) {
     array::ArrayView<double, 2> dual_normals = array::make_view<double, 2>( edges.field( "dual_normals" ) );
     const idx_t nb_edges                     = edges.size();
 
-    for ( idx_t edge = 0; edge < nb_edges; ++edge ) {
+    atlas_omp_parallel_for( idx_t edge = 0; edge < nb_edges; ++edge ) {
         if ( edge_cell_connectivity( edge, 0 ) != edge_cell_connectivity.missing_value() ) {
             // Make normal point from node 1 to node 2
             const idx_t ip1 = edge_node_connectivity( edge, 0 );
@@ -29,7 +29,10 @@
 #include "atlas/mesh/Mesh.h"
 #include "atlas/mesh/Nodes.h"
 #include "atlas/mesh/detail/AccumulateFacets.h"
+#include "atlas/mesh/detail/GroupByTarget.h"
 #include "atlas/parallel/mpi/mpi.h"
+#include "atlas/parallel/omp/omp.h"
+#include "atlas/parallel/omp/sort.h"
 #include "atlas/runtime/Exception.h"
 #include "atlas/runtime/Log.h"
 #include "atlas/util/CoordinateEnums.h"
@@ -57,8 +60,25 @@ struct Sort {
     }
     gidx_t g;
     idx_t i;
-    bool operator<( const Sort& other ) const { return ( g < other.g ); }
+    bool operator<( const Sort& other ) const { return ( g < other.g ) || ( g == other.g && i < other.i ); }
 };
+
+/// Edge indices ordered by unique id of the edge, for bit-reproducibility
+std::vector<idx_t> edges_sorted_by_uid( const Mesh& mesh ) {
+    const idx_t nb_edges                                             = mesh.edges().size();
+    const mesh::HybridElements::Connectivity& edge_node_connectivity = mesh.edges().node_connectivity();
+
+    std::vector<Sort> edge_sort( nb_edges );
+    UniqueLonLat compute_uid( mesh );
+    atlas_omp_parallel_for( idx_t jedge = 0; jedge < nb_edges; ++jedge ) {
+        edge_sort[jedge] = Sort( compute_uid( edge_node_connectivity.row( jedge ) ), jedge );
+    }
+    omp::sort( edge_sort.begin(), edge_sort.end() );
+
+    std::vector<idx_t> order( nb_edges );
+    atlas_omp_parallel_for( idx_t jedge = 0; jedge < nb_edges; ++jedge ) { order[jedge] = edge_sort[jedge].i; }
+    return order;
+}
 }  // anonymous namespace
 
 void build_element_to_edge_connectivity( Mesh& mesh ) {
@@ -75,7 +95,8 @@ void build_element_to_edge_connectivity( Mesh& mesh ) {
         cell_edge_connectivity.add( nb_elements, nb_edges_per_elem, init.data() );
     }
 
-    idx_t nb_edges                                                   = mesh.edges().size();
+    const idx_t nb_edges                                             = mesh.edges().size();
+    const idx_t nb_cells                                             = mesh.cells().size();
     const mesh::HybridElements::Connectivity& edge_cell_connectivity = mesh.edges().cell_connectivity();
     const mesh::HybridElements::Connectivity& edge_node_connectivity = mesh.edges().node_connectivity();
 
@@ -83,44 +104,56 @@ void build_element_to_edge_connectivity( Mesh& mesh ) {
     auto is_pole_edge = [&]( idx_t e ) { return Topology::check( edge_flags( e ), Topology::POLE ); };
 
     // Sort edges for bit-reproducibility
-    std::vector<Sort> edge_sort;
-    edge_sort.reserve( nb_edges );
-    {
-        UniqueLonLat compute_uid( mesh );
+    const std::vector<idx_t> edge_order = edges_sorted_by_uid( mesh );
 
-        for ( idx_t jedge = 0; jedge < nb_edges; ++jedge ) {
-            edge_sort.emplace_back( Sort( compute_uid( edge_node_connectivity.row( jedge ) ), jedge ) );
-        }
-
-        std::sort( edge_sort.data(), edge_sort.data() + nb_edges );
-    }
-
-    // Fill in cell_edge_connectivity
-    std::vector<idx_t> edge_cnt( mesh.cells().size() );
+    // Entry 2*jedge+j connects the sorted edge jedge to its j-th cell. Grouping the entries by cell
+    // keeps the order in which the edges of every cell were filled in by a sequential loop over sorted edges.
+    std::vector<idx_t> edge_cell( 2 * nb_edges );
+    idx_t edge_without_cell = nb_edges;
+    atlas_omp_pragma( omp parallel for schedule( static ) reduction( min : edge_without_cell ) )
     for ( idx_t jedge = 0; jedge < nb_edges; ++jedge ) {
-        int iedge = edge_sort[jedge].i;
+        const idx_t iedge = edge_order[jedge];
         for ( idx_t j = 0; j < 2; ++j ) {
-            idx_t elem = edge_cell_connectivity( iedge, j );
-
+            const idx_t elem = edge_cell_connectivity( iedge, j );
             if ( elem != edge_cell_connectivity.missing_value() ) {
-                ATLAS_ASSERT( edge_cnt[elem] < cell_edge_connectivity.cols( elem ) );
-                cell_edge_connectivity.set( elem, edge_cnt[elem]++, iedge );
+                edge_cell[2 * jedge + j] = elem;
             }
             else {
-                if ( not is_pole_edge( iedge ) ) {
-                    if ( j == 0 ) {
-                        auto node_gidx = array::make_view<gidx_t, 1>( mesh.nodes().global_index() );
-                        std::stringstream ss;
-                        ss << "Edge [" << node_gidx( edge_node_connectivity( jedge, 0 ) ) << ", "
-                           << node_gidx( edge_node_connectivity( jedge, 1 ) ) << "] "
-                           << "has no element connected.";
-                        Log::error() << ss.str() << std::endl;
-                        throw_Exception( ss.str(), Here() );
-                    }
+                edge_cell[2 * jedge + j] = -1;
+                if ( j == 0 && not is_pole_edge( iedge ) ) {
+                    edge_without_cell = std::min( edge_without_cell, jedge );
                 }
             }
         }
     }
+    if ( edge_without_cell < nb_edges ) {
+        const idx_t iedge = edge_order[edge_without_cell];
+        auto node_gidx    = array::make_view<gidx_t, 1>( mesh.nodes().global_index() );
+        std::stringstream ss;
+        ss << "Edge [" << node_gidx( edge_node_connectivity( iedge, 0 ) ) << ", "
+           << node_gidx( edge_node_connectivity( iedge, 1 ) ) << "] "
+           << "has no element connected.";
+        Log::error() << ss.str() << std::endl;
+        throw_Exception( ss.str(), Here() );
+    }
+
+    // Fill in cell_edge_connectivity
+    std::vector<idx_t> cell_displs;
+    std::vector<idx_t> cell_entries;
+    mesh::detail::group_by_target( edge_cell, nb_cells, cell_displs, cell_entries );
+    idx_t cell_with_too_many_edges = nb_cells;
+    atlas_omp_pragma( omp parallel for schedule( static ) reduction( min : cell_with_too_many_edges ) )
+    for ( idx_t jcell = 0; jcell < nb_cells; ++jcell ) {
+        const idx_t nb_cell_edges = cell_displs[jcell + 1] - cell_displs[jcell];
+        if ( nb_cell_edges > cell_edge_connectivity.cols( jcell ) ) {
+            cell_with_too_many_edges = std::min( cell_with_too_many_edges, jcell );
+            continue;
+        }
+        for ( idx_t jcol = 0; jcol < nb_cell_edges; ++jcol ) {
+            cell_edge_connectivity.set( jcell, jcol, edge_order[cell_entries[cell_displs[jcell] + jcol] / 2] );
+        }
+    }
+    ATLAS_ASSERT( cell_with_too_many_edges == nb_cells );
 
 
     // Verify that all edges have been found
@@ -130,28 +163,40 @@ void build_element_to_edge_connectivity( Mesh& mesh ) {
         return Topology::check( field_flags( e ), Topology::PATCH );
     };
 
-    for ( idx_t jcell = 0; jcell < mesh.cells().size(); ++jcell ) {
+    idx_t cell_with_missing_edge = nb_cells;
+    atlas_omp_pragma( omp parallel for schedule( static ) reduction( min : cell_with_missing_edge ) )
+    for ( idx_t jcell = 0; jcell < nb_cells; ++jcell ) {
         if ( patch( jcell ) ) {
             continue;
         }
         for ( idx_t jcol = 0; jcol < cell_edge_connectivity.cols( jcell ); ++jcol ) {
             if ( cell_edge_connectivity( jcell, jcol ) == cell_edge_connectivity.missing_value() ) {
-                const array::ArrayView<gidx_t, 1> gidx = array::make_view<gidx_t, 1>( mesh.nodes().global_index() );
-                std::stringstream msg;
-                msg << "Could not find edge " << jcol << " for " << mesh.cells().name( jcell ) << " elem " << jcell
-                    << " with nodes ( ";
-                for ( idx_t jnode = 0; jnode < mesh.cells().node_connectivity().cols( jcell ); ++jnode ) {
-                    msg << gidx( mesh.cells().node_connectivity()( jcell, jnode ) ) << " ";
-                }
-                msg << ")";
-                throw_Exception( msg.str(), Here() );
+                cell_with_missing_edge = std::min( cell_with_missing_edge, jcell );
             }
         }
     }
+    if ( cell_with_missing_edge < nb_cells ) {
+        const idx_t jcell = cell_with_missing_edge;
+        idx_t jcol        = 0;
+        while ( cell_edge_connectivity( jcell, jcol ) != cell_edge_connectivity.missing_value() ) {
+            ++jcol;
+        }
+        const array::ArrayView<gidx_t, 1> gidx = array::make_view<gidx_t, 1>( mesh.nodes().global_index() );
+        std::stringstream msg;
+        msg << "Could not find edge " << jcol << " for " << mesh.cells().name( jcell ) << " elem " << jcell
+            << " with nodes ( ";
+        for ( idx_t jnode = 0; jnode < mesh.cells().node_connectivity().cols( jcell ); ++jnode ) {
+            msg << gidx( mesh.cells().node_connectivity()( jcell, jnode ) ) << " ";
+        }
+        msg << ")";
+        throw_Exception( msg.str(), Here() );
+    }
 }
 
 void build_node_to_edge_connectivity( Mesh& mesh ) {
+    ATLAS_TRACE();
     mesh::Nodes& nodes   = mesh.nodes();
+    const idx_t nb_nodes = nodes.size();
     const idx_t nb_edges = mesh.edges().size();
 
     mesh::Nodes::Connectivity& node_to_edge = nodes.edge_connectivity();
@@ -159,32 +204,28 @@ void build_node_to_edge_connectivity( Mesh& mesh ) {
 
     const mesh::HybridElements::Connectivity& edge_node_connectivity = mesh.edges().node_connectivity();
 
-    std::vector<idx_t> to_edge_size( nodes.size(), 0 );
-    for ( idx_t jedge = 0; jedge < nb_edges; ++jedge ) {
+    // Entry 2*jedge+j connects the sorted edge jedge to its j-th node
+    const std::vector<idx_t> edge_order = edges_sorted_by_uid( mesh );
+    std::vector<idx_t> edge_node( 2 * nb_edges );
+    atlas_omp_parallel_for( idx_t jedge = 0; jedge < nb_edges; ++jedge ) {
         for ( idx_t j = 0; j < 2; ++j ) {
-            ++to_edge_size[edge_node_connectivity( jedge, j )];
+            edge_node[2 * jedge + j] = edge_node_connectivity( edge_order[jedge], j );
         }
     }
 
-    node_to_edge.add( nodes.size(), to_edge_size.data() );
+    std::vector<idx_t> node_displs;
+    std::vector<idx_t> node_entries;
+    mesh::detail::group_by_target( edge_node, nb_nodes, node_displs, node_entries );
 
-    for ( idx_t jnode = 0; jnode < nodes.size(); ++jnode ) {
-        to_edge_size[jnode] = 0;
-    }
-
-    UniqueLonLat compute_uid( mesh );
-    std::vector<Sort> edge_sort( nb_edges );
-    for ( idx_t jedge = 0; jedge < nb_edges; ++jedge ) {
-        edge_sort[jedge] = Sort( compute_uid( edge_node_connectivity.row( jedge ) ), jedge );
+    std::vector<idx_t> to_edge_size( nb_nodes );
+    atlas_omp_parallel_for( idx_t jnode = 0; jnode < nb_nodes; ++jnode ) {
+        to_edge_size[jnode] = node_displs[jnode + 1] - node_displs[jnode];
     }
-    std::stable_sort( edge_sort.data(), edge_sort.data() + nb_edges );
+    node_to_edge.add( nb_nodes, to_edge_size.data() );
 
-    for ( idx_t jedge = 0; jedge < nb_edges; ++jedge ) {
-        idx_t iedge = edge_sort[jedge].i;
-        ATLAS_ASSERT( iedge < nb_edges );
-        for ( idx_t j = 0; j < 2; ++j ) {
-            idx_t node = edge_node_connectivity( iedge, j );
-            node_to_edge.set( node, to_edge_size[node]++, iedge );
+    atlas_omp_parallel_for( idx_t jnode = 0; jnode < nb_nodes; ++jnode ) {
+        for ( idx_t jcol = 0; jcol < to_edge_size[jnode]; ++jcol ) {
+            node_to_edge.set( jnode, jcol, edge_order[node_entries[node_displs[jnode] + jcol] / 2] );
         }
     }
 }
@@ -511,6 +552,8 @@ void build_edges( Mesh& mesh, const eckit::Configuration& config ) {
         auto edge_flags   = array::make_view<int, 1>( mesh.edges().flags() );
 
         ATLAS_ASSERT( cell_nodes.missing_value() == missing_value );
+        idx_t nb_invalid_edges{0};
+        atlas_omp_pragma( omp parallel for schedule( static ) reduction( + : nb_invalid_edges ) )
         for ( idx_t edge = edge_start; edge < edge_end; ++edge ) {
             const idx_t iedge = edge_halo_offsets[halo] + ( edge - edge_start );
             const int ip1     = edge_nodes( edge, 0 );
@@ -520,8 +563,7 @@ void build_edges( Mesh& mesh, const eckit::Configuration& config ) {
                 edge_nodes.set( edge, swapped );
             }
 
-            ATLAS_ASSERT( idx_t( edge_nodes( edge, 0 ) ) < nb_nodes );
-            ATLAS_ASSERT( idx_t( edge_nodes( edge, 1 ) ) < nb_nodes );
+            nb_invalid_edges += ( ip1 >= nb_nodes || ip2 >= nb_nodes );
             edge_glb_idx( edge ) = compute_uid( edge_nodes.row( edge ) );
             edge_part( edge )    = std::min( node_part( edge_nodes( edge, 0 ) ), node_part( edge_nodes( edge, 1 ) ) );
             edge_ridx( edge )    = edge;
@@ -531,8 +573,8 @@ void build_edges( Mesh& mesh, const eckit::Configuration& config ) {
             const idx_t e1 = edge_to_elem_data[2 * iedge + 0];
             const idx_t e2 = edge_to_elem_data[2 * iedge + 1];
 
-            ATLAS_ASSERT( e1 != cell_nodes.missing_value() );
-            if ( e2 == cell_nodes.missing_value() ) {
+            nb_invalid_edges += ( e1 == cell_nodes.missing_value() );
+            if ( e1 == cell_nodes.missing_value() || e2 == cell_nodes.missing_value() ) {
                 // do nothing
             }
             else if ( compute_uid( cell_nodes.row( e1 ) ) > compute_uid( cell_nodes.row( e2 ) ) ) {
@@ -540,6 +582,7 @@ void build_edges( Mesh& mesh, const eckit::Configuration& config ) {
                 edge_to_elem_data[iedge * 2 + 1] = e1;
             }
         }
+        ATLAS_ASSERT( nb_invalid_edges == 0 );
 
         mesh.edges().cell_connectivity().add( ( edge_end - edge_start ), 2,
                                               edge_to_elem_data.data() + edge_halo_offsets[halo] * 2 );
@@ -26,8 +26,10 @@
 #include "atlas/mesh/actions/BuildHalo.h"
 #include "atlas/mesh/actions/BuildParallelFields.h"
 #include "atlas/mesh/detail/AccumulateFacets.h"
+#include "atlas/parallel/DistributedRenumbering.h"
 #include "atlas/parallel/mpi/Buffer.h"
 #include "atlas/parallel/mpi/mpi.h"
+#include "atlas/parallel/omp/omp.h"
 #include "atlas/runtime/Exception.h"
 #include "atlas/runtime/Log.h"
 #include "atlas/runtime/Trace.h"
@@ -35,6 +37,7 @@
 #include "atlas/util/LonLatMicroDeg.h"
 #include "atlas/util/MicroDeg.h"
 #include "atlas/util/PeriodicTransform.h"
+#include "atlas/util/UidHashMap.h"
 #include "atlas/util/Unique.h"
 
 //#define DEBUG_OUTPUT
@@ -58,16 +61,6 @@ namespace atlas {
 namespace mesh {
 namespace actions {
 
-struct Entity {
-    Entity( gidx_t gid, idx_t idx ) {
-        g = gid;
-        i = idx;
-    }
-    gidx_t g;
-    idx_t i;
-    bool operator<( const Entity& other ) const { return ( g < other.g ); }
-};
-
 void make_nodes_global_index_human_readable( const mesh::actions::BuildHalo& build_halo, mesh::Nodes& nodes,
                                              bool do_all ) {
     ATLAS_TRACE();
@@ -76,10 +69,6 @@ void make_nodes_global_index_human_readable( const mesh::actions::BuildHalo& bui
     // uid,
     //     and could receive different gidx for different tasks
 
-    // unused // int mypart = mpi::comm().rank();
-    int nparts = static_cast<int>( mpi::comm().size() );
-    idx_t root = 0;
-
     array::ArrayView<gidx_t, 1> nodes_glb_idx = array::make_view<gidx_t, 1>( nodes.global_index() );
     // nodes_glb_idx.dump( Log::info() );
     //  ATLAS_DEBUG( "min = " << nodes.global_index().metadata().getLong("min") );
@@ -129,50 +118,8 @@ void make_nodes_global_index_human_readable( const mesh::actions::BuildHalo& bui
     //    }
     //  }
 
-    // 1) Gather all global indices, together with location
-
-    std::vector<int> recvcounts( mpi::comm().size() );
-    std::vector<int> recvdispls( mpi::comm().size() );
-
-    ATLAS_TRACE_MPI( GATHER ) { mpi::comm().gather( nb_nodes, recvcounts, root ); }
-    int glb_nb_nodes = std::accumulate( recvcounts.begin(), recvcounts.end(), 0 );
-
-    recvdispls[0] = 0;
-    for ( int jpart = 1; jpart < nparts; ++jpart ) {  // start at 1
-        recvdispls[jpart] = recvcounts[jpart - 1] + recvdispls[jpart - 1];
-    }
-
-    std::vector<gidx_t> glb_idx_gathered( glb_nb_nodes );
-    ATLAS_TRACE_MPI( GATHER ) {
-        mpi::comm().gatherv( glb_idx.data(), glb_idx.size(), glb_idx_gathered.data(), recvcounts.data(),
-                             recvdispls.data(), root );
-    }
-
-    // 2) Sort all global indices, and renumber from 1 to glb_nb_edges
-    std::vector<Entity> node_sort;
-    node_sort.reserve( glb_nb_nodes );
-    const idx_t nb_glb_idx_gathered = static_cast<idx_t>( glb_idx_gathered.size() );
-    for ( idx_t jnode = 0; jnode < nb_glb_idx_gathered; ++jnode ) {
-        node_sort.emplace_back( glb_idx_gathered[jnode], jnode );
-    }
-
-    ATLAS_TRACE_SCOPE( "sort on rank 0" ) { std::sort( node_sort.begin(), node_sort.end() ); }
-
-    gidx_t gid               = glb_idx_max + 1;
-    const idx_t nb_node_sort = static_cast<idx_t>( node_sort.size() );
-    for ( idx_t jnode = 0; jnode < nb_node_sort; ++jnode ) {
-        if ( jnode > 0 && node_sort[jnode].g != node_sort[jnode - 1].g ) {
-            ++gid;
-        }
-        int inode               = node_sort[jnode].i;
-        glb_idx_gathered[inode] = gid;
-    }
-
-    // 3) Scatter renumbered back
-    ATLAS_TRACE_MPI( SCATTER ) {
-        mpi::comm().scatterv( glb_idx_gathered.data(), recvcounts.data(), recvdispls.data(), glb_idx.data(),
-                              static_cast<int>( glb_idx.size() ), root );
-    }
+    // Renumber following the order of the global indices, after the existing ones
+    parallel::renumber_distributed( glb_idx.data(), glb_idx.size(), glb_idx_max + 1 );
 
     for ( int jnode = 0; jnode < nb_nodes; ++jnode ) {
         nodes_glb_idx( points_to_edit[jnode] ) = glb_idx[jnode];
@@ -189,9 +136,6 @@ void make_cells_global_index_human_readable( const mesh::actions::BuildHalo& bui
                                              bool do_all ) {
     ATLAS_TRACE();
 
-    int nparts = static_cast<idx_t>( mpi::comm().size() );
-    idx_t root = 0;
-
     array::ArrayView<gidx_t, 1> cells_glb_idx = array::make_view<gidx_t, 1>( cells.global_index() );
     //  ATLAS_DEBUG( "min = " << cells.global_index().metadata().getLong("min") );
     //  ATLAS_DEBUG( "max = " << cells.global_index().metadata().getLong("max") );
@@ -230,48 +174,8 @@ void make_cells_global_index_human_readable( const mesh::actions::BuildHalo& bui
         glb_idx[i] = cells_glb_idx( cells_to_edit[i] );
     }
 
-    // 1) Gather all global indices, together with location
-
-    std::vector<int> recvcounts( mpi::comm().size() );
-    std::vector<int> recvdispls( mpi::comm().size() );
-
-    ATLAS_TRACE_MPI( GATHER ) { mpi::comm().gather( nb_cells, recvcounts, root ); }
-    idx_t glb_nb_cells = std::accumulate( recvcounts.begin(), recvcounts.end(), 0 );
-
-    recvdispls[0] = 0;
-    for ( int jpart = 1; jpart < nparts; ++jpart ) {  // start at 1
-        recvdispls[jpart] = recvcounts[jpart - 1] + recvdispls[jpart - 1];
-    }
-
-    std::vector<gidx_t> glb_idx_gathered( glb_nb_cells );
-    ATLAS_TRACE_MPI( GATHER ) {
-        mpi::comm().gatherv( glb_idx.data(), glb_idx.size(), glb_idx_gathered.data(), recvcounts.data(),
-                             recvdispls.data(), root );
-    }
-
-    // 2) Sort all global indices, and renumber from 1 to glb_nb_edges
-    std::vector<Entity> cell_sort;
-    cell_sort.reserve( glb_nb_cells );
-    for ( idx_t jcell = 0; jcell < glb_nb_cells; ++jcell ) {
-        cell_sort.emplace_back( glb_idx_gathered[jcell], jcell );
-    }
-
-    ATLAS_TRACE_SCOPE( "sort on rank 0" ) { std::sort( cell_sort.begin(), cell_sort.end() ); }
-
-    gidx_t gid = glb_idx_max + 1;
-    for ( idx_t jcell = 0; jcell < glb_nb_cells; ++jcell ) {
-        if ( jcell > 0 && cell_sort[jcell].g != cell_sort[jcell - 1].g ) {
-            ++gid;
-        }
-        idx_t icell             = cell_sort[jcell].i;
-        glb_idx_gathered[icell] = gid;
-    }
-
-    // 3) Scatter renumbered back
-    ATLAS_TRACE_MPI( SCATTER ) {
-        mpi::comm().scatterv( glb_idx_gathered.data(), recvcounts.data(), recvdispls.data(), glb_idx.data(),
-                              static_cast<int>( glb_idx.size() ), root );
-    }
+    // Renumber following the order of the global indices, after the existing ones
+    parallel::renumber_distributed( glb_idx.data(), glb_idx.size(), glb_idx_max + 1 );
 
     for ( int jcell = 0; jcell < nb_cells; ++jcell ) {
         cells_glb_idx( cells_to_edit[jcell] ) = glb_idx[jcell];
@@ -428,7 +332,7 @@ private:
     std::vector<std::string> notes;
 };
 
-using Uid2Node = std::map<uid_t, idx_t>;
+using Uid2Node = util::UidHashMap<idx_t>;
 void build_lookup_uid2node( Mesh& mesh, Uid2Node& uid2node ) {
     ATLAS_TRACE();
     Notification notes;
@@ -439,12 +343,17 @@ void build_lookup_uid2node( Mesh& mesh, Uid2Node& uid2node ) {
 
     UniqueLonLat compute_uid( mesh );
 
-    uid2node.clear();
+    std::vector<uid_t> node_uid( nb_nodes );
+    atlas_omp_parallel_for( idx_t jnode = 0; jnode < nb_nodes; ++jnode ) { node_uid[jnode] = compute_uid( jnode ); }
+
+    uid2node.build( node_uid.size(), [&]( size_t jnode ) { return node_uid[jnode]; },
+                    []( size_t jnode ) { return idx_t( jnode ); } );
+
+    // Nodes that were not inserted have the same uid as a node before them
     for ( idx_t jnode = 0; jnode < nb_nodes; ++jnode ) {
-        uid_t uid     = compute_uid( jnode );
-        bool inserted = uid2node.insert( std::make_pair( uid, jnode ) ).second;
-        if ( not inserted ) {
-            int other = uid2node[uid];
+        uid_t uid = node_uid[jnode];
+        int other = uid2node.find( uid )->second;
+        if ( other != jnode ) {
             std::stringstream msg;
             msg << "Node uid: " << uid << "   " << glb_idx( jnode ) << " (" << xy( jnode, XX ) << "," << xy( jnode, YY )
                 << ")  has already been added as node " << glb_idx( other ) << " (" << xy( other, XX ) << ","
@@ -459,7 +368,7 @@ void build_lookup_uid2node( Mesh& mesh, Uid2Node& uid2node ) {
 
 void accumulate_elements( const Mesh& mesh, const mpi::BufferView<uid_t>& request_node_uid, const Uid2Node& uid2node,
                           const Node2Elem& node2elem, std::vector<idx_t>& found_elements,
-                          std::set<uid_t>& new_nodes_uid ) {
+                          std::vector<uid_t>& new_nodes_uid ) {
     // ATLAS_TRACE();
     const mesh::HybridElements::Connectivity& elem_nodes = mesh.cells().node_connectivity();
     const auto elem_part                                 = array::make_view<int, 1>( mesh.cells().partition() );
@@ -468,7 +377,7 @@ void accumulate_elements( const Mesh& mesh, const mpi::BufferView<uid_t>& reques
     const idx_t nb_request_nodes = static_cast<idx_t>( request_node_uid.size() );
     const int mpi_rank           = static_cast<int>( mpi::comm().rank() );
 
-    std::set<idx_t> found_elements_set;
+    found_elements.clear();
 
     for ( idx_t jnode = 0; jnode < nb_request_nodes; ++jnode ) {
         uid_t uid = request_node_uid( jnode );
@@ -482,30 +391,34 @@ void accumulate_elements( const Mesh& mesh, const mpi::BufferView<uid_t>& reques
         if ( inode != -1 && inode < nb_nodes ) {
             for ( const idx_t e : node2elem[inode] ) {
                 if ( elem_part( e ) == mpi_rank ) {
-                    found_elements_set.insert( e );
+                    found_elements.push_back( e );
                 }
             }
         }
     }
 
-    // found_bdry_elements_set now contains elements for the nodes
-    found_elements = std::vector<idx_t>( found_elements_set.begin(), found_elements_set.end() );
+    // found_elements now contains elements for the nodes, sorted and unique
+    std::sort( found_elements.begin(), found_elements.end() );
+    found_elements.erase( std::unique( found_elements.begin(), found_elements.end() ), found_elements.end() );
 
     UniqueLonLat compute_uid( mesh );
 
-    // Collect all nodes
+    util::UidHashSet requested;
+    requested.build( size_t( nb_request_nodes ), [&]( size_t jnode ) { return request_node_uid( jnode ); } );
+
+    // Collect all nodes, except nodes we already have in the request-buffer, sorted and unique
     new_nodes_uid.clear();
     for ( const idx_t e : found_elements ) {
         idx_t nb_elem_nodes = elem_nodes.cols( e );
         for ( idx_t n = 0; n < nb_elem_nodes; ++n ) {
-            new_nodes_uid.insert( compute_uid( elem_nodes( e, n ) ) );
+            uid_t uid = compute_uid( elem_nodes( e, n ) );
+            if ( not requested.count( uid ) ) {
+                new_nodes_uid.push_back( uid );
+            }
         }
     }
-
-    // Remove nodes we already have in the request-buffer
-    for ( idx_t jnode = 0; jnode < nb_request_nodes; ++jnode ) {
-        new_nodes_uid.erase( request_node_uid( jnode ) );
-    }
+    std::sort( new_nodes_uid.begin(), new_nodes_uid.end() );
+    new_nodes_uid.erase( std::unique( new_nodes_uid.begin(), new_nodes_uid.end() ), new_nodes_uid.end() );
 }
 
 class BuildHaloHelper {
@@ -683,7 +596,7 @@ public:
         buf.node_xy[p].resize( 2 * nb_nodes );
 
         idx_t jnode = 0;
-        typename NodeContainer::iterator it;
+        typename NodeContainer::const_iterator it;
         for ( it = nodes_uid.begin(); it != nodes_uid.end(); ++it, ++jnode ) {
             uid_t uid = *it;
 
@@ -749,7 +662,7 @@ public:
         buf.node_xy[p].resize( 2 * nb_nodes );
 
         int jnode = 0;
-        typename NodeContainer::iterator it;
+        typename NodeContainer::const_iterator it;
         for ( it = nodes_uid.begin(); it != nodes_uid.end(); ++it, ++jnode ) {
             uid_t uid = *it;
 
@@ -820,25 +733,17 @@ public:
 
         // Nodes might be duplicated from different Tasks. We need to identify
         // unique entries
-        std::vector<uid_t> node_uid( nb_nodes );
-        std::set<uid_t> new_node_uid;
-        {
-            ATLAS_TRACE( "compute node_uid" );
-            for ( int jnode = 0; jnode < nb_nodes; ++jnode ) {
-                node_uid[jnode] = compute_uid( jnode );
-            }
-            std::sort( node_uid.begin(), node_uid.end() );
+        util::UidHashSet node_uid;
+        util::UidHashSet new_node_uid;
+        ATLAS_TRACE_SCOPE( "compute node_uid" ) {
+            node_uid.build( size_t( nb_nodes ), [&]( size_t jnode ) { return compute_uid( int( jnode ) ); } );
         }
         auto node_already_exists = [&node_uid, &new_node_uid]( uid_t uid ) {
-            std::vector<uid_t>::iterator it = std::lower_bound( node_uid.begin(), node_uid.end(), uid );
-            bool not_found                  = ( it == node_uid.end() || uid < *it );
-            if ( not_found ) {
-                bool inserted = new_node_uid.insert( uid ).second;
-                return not inserted;
-            }
-            else {
+            if ( node_uid.count( uid ) ) {
                 return true;
             }
+            bool inserted = new_node_uid.insert( uid );
+            return not inserted;
         };
 
         std::vector<std::vector<int>> rfn_idx( mpi_size );
@@ -924,27 +829,20 @@ public:
         // Elements might be duplicated from different Tasks. We need to identify
         // unique entries
         int nb_elems = mesh.cells().size();
-        //    std::set<uid_t> elem_uid;
-        std::vector<uid_t> elem_uid( 2 * nb_elems );
-        std::set<uid_t> new_elem_uid;
-        {
-            ATLAS_TRACE( "compute elem_uid" );
-            for ( int jelem = 0; jelem < nb_elems; ++jelem ) {
-                elem_uid[jelem * 2 + 0] = -compute_uid( elem_nodes->row( jelem ) );
-                elem_uid[jelem * 2 + 1] = cell_gidx( jelem );
-            }
-            std::sort( elem_uid.begin(), elem_uid.end() );
+        util::UidHashSet elem_uid;
+        util::UidHashSet new_elem_uid;
+        ATLAS_TRACE_SCOPE( "compute elem_uid" ) {
+            elem_uid.build( 2 * size_t( nb_elems ), [&]( size_t j ) -> uid_t {
+                const idx_t jelem = idx_t( j / 2 );
+                return ( j % 2 == 0 ) ? -compute_uid( elem_nodes->row( jelem ) ) : cell_gidx( jelem );
+            } );
         }
         auto element_already_exists = [&elem_uid, &new_elem_uid]( uid_t uid ) -> bool {
-            std::vector<uid_t>::iterator it = std::lower_bound( elem_uid.begin(), elem_uid.end(), uid );
-            bool not_found                  = ( it == elem_uid.end() || uid < *it );
-            if ( not_found ) {
-                bool inserted = new_elem_uid.insert( uid ).second;
-                return not inserted;
-            }
-            else {
+            if ( elem_uid.count( uid ) ) {
                 return true;
             }
+            bool inserted = new_elem_uid.insert( uid );
+            return not inserted;
         };
 
         if ( not status.new_periodic_ghost_cells.size() ) {
@@ -1155,7 +1053,7 @@ void increase_halo_interior( BuildHaloHelper& helper ) {
         mpi::BufferView<uid_t> recv_bdry_nodes_uid = recv_bdry_nodes_uid_from_parts[jpart];
 
         std::vector<idx_t> found_bdry_elems;
-        std::set<uid_t> found_bdry_nodes_uid;
+        std::vector<uid_t> found_bdry_nodes_uid;
 
         accumulate_elements( helper.mesh, recv_bdry_nodes_uid, helper.uid2node, helper.node_to_elem, found_bdry_elems,
                              found_bdry_nodes_uid );
@@ -1267,7 +1165,7 @@ void increase_halo_periodic( BuildHaloHelper& helper, const PeriodicPoints& peri
         atlas::mpi::BufferView<uid_t> recv_bdry_nodes_uid = recv_bdry_nodes_uid_from_parts[jpart];
 
         std::vector<idx_t> found_bdry_elems;
-        std::set<uid_t> found_bdry_nodes_uid;
+        std::vector<uid_t> found_bdry_nodes_uid;
 
         accumulate_elements( helper.mesh, recv_bdry_nodes_uid, helper.uid2node, helper.node_to_elem, found_bdry_elems,
                              found_bdry_nodes_uid );
@@ -31,9 +31,13 @@
 #include "atlas/mesh/Nodes.h"
 #include "atlas/mesh/actions/BuildEdges.h"
 #include "atlas/mesh/detail/AccumulateFacets.h"
+#include "atlas/mesh/detail/GroupByTarget.h"
 #include "atlas/parallel/mpi/mpi.h"
+#include "atlas/parallel/omp/omp.h"
+#include "atlas/parallel/omp/sort.h"
 #include "atlas/runtime/Exception.h"
 #include "atlas/runtime/Log.h"
+#include "atlas/runtime/Trace.h"
 #include "atlas/util/CoordinateEnums.h"
 #include "atlas/util/LonLatMicroDeg.h"
 #include "atlas/util/MicroDeg.h"
@@ -59,12 +63,14 @@ struct Sort {
     }
     gidx_t g;
     idx_t i;
-    bool operator<( const Sort& other ) const { return ( g < other.g ); }
+    bool operator<( const Sort& other ) const { return ( g < other.g ) || ( g == other.g && i < other.i ); }
 };
 }  // anonymous namespace
 
 void BuildNode2CellConnectivity::operator()() {
+    ATLAS_TRACE( "BuildNode2CellConnectivity" );
     mesh::Nodes& nodes   = mesh_.nodes();
+    const idx_t nb_nodes = nodes.size();
     const idx_t nb_cells = mesh_.cells().size();
 
     mesh::Nodes::Connectivity& node_to_cell = nodes.cell_connectivity();
@@ -72,34 +78,43 @@ void BuildNode2CellConnectivity::operator()() {
 
     const mesh::HybridElements::Connectivity& cell_node_connectivity = mesh_.cells().node_connectivity();
 
-    std::vector<idx_t> to_cell_size( nodes.size(), 0 );
-    for ( idx_t jcell = 0; jcell < nb_cells; ++jcell ) {
-        for ( idx_t j = 0; j < cell_node_connectivity.cols( jcell ); ++j ) {
-            ++to_cell_size[cell_node_connectivity( jcell, j )];
-        }
-    }
-
-    node_to_cell.add( nodes.size(), to_cell_size.data() );
-
-    for ( idx_t jnode = 0; jnode < nodes.size(); ++jnode ) {
-        to_cell_size[jnode] = 0;
-    }
-
+    // Sort cells for bit-reproducibility
     UniqueLonLat compute_uid( mesh_ );
     std::vector<Sort> cell_sort( nb_cells );
-    for ( idx_t jcell = 0; jcell < nb_cells; ++jcell ) {
+    atlas_omp_parallel_for( idx_t jcell = 0; jcell < nb_cells; ++jcell ) {
         cell_sort[jcell] = Sort( compute_uid( cell_node_connectivity.row( jcell ) ), jcell );
     }
+    omp::sort( cell_sort.begin(), cell_sort.end() );
 
-
-    std::stable_sort( cell_sort.data(), cell_sort.data() + nb_cells );
-
+    // One entry per node of every sorted cell, in the order a sequential loop over sorted cells would visit them
+    std::vector<idx_t> cell_offset( nb_cells + 1 );
+    cell_offset[0] = 0;
     for ( idx_t jcell = 0; jcell < nb_cells; ++jcell ) {
-        idx_t icell = cell_sort[jcell].i;
-        ATLAS_ASSERT( icell < nb_cells );
+        cell_offset[jcell + 1] = cell_offset[jcell] + cell_node_connectivity.cols( cell_sort[jcell].i );
+    }
+    std::vector<idx_t> entry_node( cell_offset[nb_cells] );
+    std::vector<idx_t> entry_cell( cell_offset[nb_cells] );
+    atlas_omp_parallel_for( idx_t jcell = 0; jcell < nb_cells; ++jcell ) {
+        const idx_t icell = cell_sort[jcell].i;
         for ( idx_t j = 0; j < cell_node_connectivity.cols( icell ); ++j ) {
-            idx_t node = cell_node_connectivity( icell, j );
-            node_to_cell.set( node, to_cell_size[node]++, icell );
+            entry_node[cell_offset[jcell] + j] = cell_node_connectivity( icell, j );
+            entry_cell[cell_offset[jcell] + j] = icell;
+        }
+    }
+
+    std::vector<idx_t> node_displs;
+    std::vector<idx_t> node_entries;
+    mesh::detail::group_by_target( entry_node, nb_nodes, node_displs, node_entries );
+
+    std::vector<idx_t> to_cell_size( nb_nodes );
+    atlas_omp_parallel_for( idx_t jnode = 0; jnode < nb_nodes; ++jnode ) {
+        to_cell_size[jnode] = node_displs[jnode + 1] - node_displs[jnode];
+    }
+    node_to_cell.add( nb_nodes, to_cell_size.data() );
+
+    atlas_omp_parallel_for( idx_t jnode = 0; jnode < nb_nodes; ++jnode ) {
+        for ( idx_t jcol = 0; jcol < to_cell_size[jnode]; ++jcol ) {
+            node_to_cell.set( jnode, jcol, entry_cell[node_entries[node_displs[jnode] + jcol]] );
         }
     }
 }
@@ -21,6 +21,7 @@
 #include "atlas/mesh/Mesh.h"
 #include "atlas/mesh/Nodes.h"
 #include "atlas/mesh/actions/BuildParallelFields.h"
+#include "atlas/parallel/DistributedRenumbering.h"
 #include "atlas/parallel/GatherScatter.h"
 #include "atlas/parallel/mpi/Buffer.h"
 #include "atlas/parallel/mpi/mpi.h"
@@ -29,6 +30,7 @@
 #include "atlas/runtime/Trace.h"
 #include "atlas/util/CoordinateEnums.h"
 #include "atlas/util/PeriodicTransform.h"
+#include "atlas/util/UidHashMap.h"
 #include "atlas/util/Unique.h"
 
 #define EDGE( jedge )                                                                                     \
@@ -75,20 +77,6 @@ Field& build_edges_global_idx( Mesh& mesh );
 
 using uid_t = gidx_t;
 
-namespace {
-
-struct Node {
-    Node( gidx_t gid, idx_t idx ) {
-        g = gid;
-        i = idx;
-    }
-    gidx_t g;
-    idx_t i;
-    bool operator<( const Node& other ) const { return ( g < other.g ); }
-};
-
-}  // namespace
-
 //----------------------------------------------------------------------------------------------------------------------
 
 void build_parallel_fields( Mesh& mesh ) {
@@ -158,10 +146,6 @@ void renumber_nodes_glb_idx( mesh::Nodes& nodes ) {
 
     UniqueLonLat compute_uid( nodes );
 
-    // unused // int mypart = mpi::comm().rank();
-    int nparts = mpi::comm().size();
-    idx_t root = 0;
-
     array::ArrayView<gidx_t, 1> glb_idx = array::make_view<gidx_t, 1>( nodes.global_index() );
 
     /*
@@ -177,64 +161,9 @@ void renumber_nodes_glb_idx( mesh::Nodes& nodes ) {
         }
     }
 
-    // 1) Gather all global indices, together with location
-    array::ArrayT<uid_t> loc_id_arr( nb_nodes );
-    array::ArrayView<uid_t, 1> loc_id = array::make_view<uid_t, 1>( loc_id_arr );
-
-    for ( int jnode = 0; jnode < nb_nodes; ++jnode ) {
-        loc_id( jnode ) = glb_idx( jnode );
-    }
-
-    std::vector<int> recvcounts( mpi::comm().size() );
-    std::vector<int> recvdispls( mpi::comm().size() );
-
-    ATLAS_TRACE_MPI( GATHER ) { mpi::comm().gather( nb_nodes, recvcounts, root ); }
-
-    recvdispls[0] = 0;
-    for ( int jpart = 1; jpart < nparts; ++jpart ) {  // start at 1
-        recvdispls[jpart] = recvcounts[jpart - 1] + recvdispls[jpart - 1];
-    }
-    int glb_nb_nodes = std::accumulate( recvcounts.begin(), recvcounts.end(), 0 );
-
-    array::ArrayT<uid_t> glb_id_arr( glb_nb_nodes );
-    array::ArrayView<uid_t, 1> glb_id = array::make_view<uid_t, 1>( glb_id_arr );
+    // Renumber from 1 to the global number of nodes, following the order of the unique ids
+    parallel::renumber_distributed( glb_idx.data(), size_t( nb_nodes ), 1 );
 
-    ATLAS_TRACE_MPI( GATHER ) {
-        mpi::comm().gatherv( loc_id.data(), loc_id.size(), glb_id.data(), recvcounts.data(), recvdispls.data(), root );
-    }
-
-    // 2) Sort all global indices, and renumber from 1 to glb_nb_edges
-    std::vector<Node> node_sort;
-    node_sort.reserve( glb_nb_nodes );
-    ATLAS_TRACE_SCOPE( "sort global indices" ) {
-        for ( idx_t jnode = 0; jnode < glb_id.shape( 0 ); ++jnode ) {
-            node_sort.emplace_back( glb_id( jnode ), jnode );
-        }
-        std::sort( node_sort.begin(), node_sort.end() );
-    }
-
-    // Assume edge gid start
-    uid_t gid                   = 0;
-    const idx_t nb_sorted_nodes = static_cast<idx_t>( node_sort.size() );
-    for ( idx_t jnode = 0; jnode < nb_sorted_nodes; ++jnode ) {
-        if ( jnode == 0 ) {
-            ++gid;
-        }
-        else if ( node_sort[jnode].g != node_sort[jnode - 1].g ) {
-            ++gid;
-        }
-        idx_t inode     = node_sort[jnode].i;
-        glb_id( inode ) = gid;
-    }
-
-    // 3) Scatter renumbered back
-    ATLAS_TRACE_MPI( SCATTER ) {
-        mpi::comm().scatterv( glb_id.data(), recvcounts.data(), recvdispls.data(), loc_id.data(), loc_id.size(), root );
-    }
-
-    for ( int jnode = 0; jnode < nb_nodes; ++jnode ) {
-        glb_idx( jnode ) = loc_id( jnode );
-    }
     nodes.global_index().metadata().set( "human_readable", true );
 }
 
@@ -264,7 +193,7 @@ Field& build_nodes_remote_idx( mesh::Nodes& nodes ) {
     std::vector<std::vector<uid_t>> send_needed( mpi::comm().size() );
     std::vector<std::vector<uid_t>> recv_needed( mpi::comm().size() );
     int sendcnt = 0;
-    std::map<uid_t, int> lookup;
+    util::UidHashMap<int> lookup( nb_nodes );
     for ( idx_t jnode = 0; jnode < nb_nodes; ++jnode ) {
         uid_t uid = compute_uid( jnode );
 
@@ -409,7 +338,7 @@ Field& build_edges_partition( Mesh& mesh ) {
 
     std::vector<gidx_t> bdry_edges;
     bdry_edges.reserve( nb_edges );
-    std::map<gidx_t, idx_t> global_to_local;
+    util::UidHashMap<idx_t> global_to_local( nb_edges );
 
 
     PeriodicTransform transform_periodic_east( -360. );
@@ -761,7 +690,7 @@ Field& build_edges_remote_idx( Mesh& mesh ) {
     std::vector<std::vector<uid_t>> send_needed( mpi::comm().size() );
     std::vector<std::vector<uid_t>> recv_needed( mpi::comm().size() );
     int sendcnt = 0;
-    std::map<uid_t, int> lookup;
+    util::UidHashMap<int> lookup( nb_edges );
 
     PeriodicTransform transform;
 
@@ -832,7 +761,7 @@ Field& build_edges_remote_idx( Mesh& mesh ) {
     std::vector<std::vector<int>> send_found( mpi::comm().size() );
     std::vector<std::vector<int>> recv_found( mpi::comm().size() );
 
-    std::map<uid_t, int>::iterator found;
+    util::UidHashMap<int>::iterator found;
     for ( idx_t jpart = 0; jpart < nparts; ++jpart ) {
         const std::vector<uid_t>& recv_edge = recv_needed[jpart];
         const idx_t nb_recv_edges           = idx_t( recv_edge.size() ) / varsize;
@@ -883,9 +812,6 @@ Field& build_edges_global_idx( Mesh& mesh ) {
 
     UniqueLonLat compute_uid( mesh );
 
-    int nparts = mpi::comm().size();
-    idx_t root = 0;
-
     mesh::HybridElements& edges = mesh.edges();
 
     array::make_view<gidx_t, 1>( edges.global_index() ).assign( -1 );
@@ -921,64 +847,8 @@ Field& build_edges_global_idx( Mesh& mesh ) {
  * REMOTE INDEX BASE = 1
  */
 
-    // 1) Gather all global indices, together with location
-    array::ArrayT<uid_t> loc_edge_id_arr( nb_edges );
-    array::ArrayView<uid_t, 1> loc_edge_id = array::make_view<uid_t, 1>( loc_edge_id_arr );
-
-    for ( int jedge = 0; jedge < nb_edges; ++jedge ) {
-        loc_edge_id( jedge ) = edge_gidx( jedge );
-    }
-
-    std::vector<int> recvcounts( mpi::comm().size() );
-    std::vector<int> recvdispls( mpi::comm().size() );
-
-    ATLAS_TRACE_MPI( GATHER ) { mpi::comm().gather( nb_edges, recvcounts, root ); }
-
-    recvdispls[0] = 0;
-    for ( int jpart = 1; jpart < nparts; ++jpart )  // start at 1
-    {
-        recvdispls[jpart] = recvcounts[jpart - 1] + recvdispls[jpart - 1];
-    }
-    int glb_nb_edges = std::accumulate( recvcounts.begin(), recvcounts.end(), 0 );
-
-    array::ArrayT<uid_t> glb_edge_id_arr( glb_nb_edges );
-    array::ArrayView<uid_t, 1> glb_edge_id = array::make_view<uid_t, 1>( glb_edge_id_arr );
-
-    ATLAS_TRACE_MPI( GATHER ) {
-        mpi::comm().gatherv( loc_edge_id.data(), loc_edge_id.size(), glb_edge_id.data(), recvcounts.data(),
-                             recvdispls.data(), root );
-    }
-
-    // 2) Sort all global indices, and renumber from 1 to glb_nb_edges
-    std::vector<Node> edge_sort;
-    edge_sort.reserve( glb_nb_edges );
-    for ( idx_t jedge = 0; jedge < glb_edge_id.shape( 0 ); ++jedge ) {
-        edge_sort.emplace_back( Node( glb_edge_id( jedge ), jedge ) );
-    }
-    std::sort( edge_sort.begin(), edge_sort.end() );
-
-    // Assume edge gid start
-    uid_t gid( 0 );
-    for ( size_t jedge = 0; jedge < edge_sort.size(); ++jedge ) {
-        if ( jedge == 0 ) {
-            ++gid;
-        }
-        else if ( edge_sort[jedge].g != edge_sort[jedge - 1].g ) {
-            ++gid;
-        }
-        int iedge            = edge_sort[jedge].i;
-        glb_edge_id( iedge ) = gid;
-    }
-
-    // 3) Scatter renumbered back
-    ATLAS_TRACE_MPI( SCATTER ) {
-        mpi::comm().scatterv( glb_edge_id.data(), recvcounts.data(), recvdispls.data(), loc_edge_id.data(),
-                              loc_edge_id.size(), root );
-    }
-
-    for ( int jedge = 0; jedge < nb_edges; ++jedge ) {
-        edge_gidx( jedge ) = loc_edge_id( jedge );
-    }
+    // Renumber from 1 to the global number of edges, following the order of the unique ids
+    parallel::renumber_distributed( edge_gidx.data(), size_t( nb_edges ), 1 );
 
     return edges.global_index();
 }
@@ -1010,7 +880,7 @@ Field& build_cells_remote_idx( mesh::Cells& cells, const mesh::Nodes& nodes ) {
     std::vector<std::vector<uid_t>> send_needed( mpi::comm().size() );
     std::vector<std::vector<uid_t>> recv_needed( mpi::comm().size() );
     int sendcnt = 0;
-    std::map<uid_t, int> lookup;
+    util::UidHashMap<int> lookup( nb_cells );
     for ( idx_t jcell = 0; jcell < nb_cells; ++jcell ) {
         uid_t uid = compute_uid( element_nodes.row( jcell ) );
 
@@ -23,6 +23,7 @@
 #include "atlas/util/CoordinateEnums.h"
 #include "atlas/util/LonLatMicroDeg.h"
 #include "atlas/util/PeriodicTransform.h"
+#include "atlas/util/UidHashMap.h"
 
 using Topology = atlas::mesh::Nodes::Topology;
 using atlas::util::LonLatMicroDeg;
@@ -56,8 +57,8 @@ void build_periodic_boundaries( Mesh& mesh ) {
 
         // Identify my master and slave nodes on own partition
         // master nodes are at x=0,  slave nodes are at x=2pi
-        std::map<uid_t, int> master_lookup;
-        std::map<uid_t, int> slave_lookup;
+        util::UidHashMap<int> master_lookup;
+        util::UidHashMap<int> slave_lookup;
         std::vector<int> master_nodes;
         master_nodes.reserve( 3 * nb_nodes );
         std::vector<int> slave_nodes;
@@ -9,9 +9,15 @@
  */
 
 #include "atlas/mesh/detail/AccumulateFacets.h"
+
+#include <algorithm>
+#include <limits>
+
 #include "atlas/mesh/Elements.h"
 #include "atlas/mesh/HybridElements.h"
 #include "atlas/mesh/Nodes.h"
+#include "atlas/parallel/omp/omp.h"
+#include "atlas/parallel/omp/sort.h"
 #include "atlas/runtime/Exception.h"
 #include "atlas/runtime/Trace.h"
 
@@ -19,225 +25,171 @@ namespace atlas {
 namespace mesh {
 namespace detail {
 
-void accumulate_facets( const mesh::HybridElements& cells, const mesh::Nodes& nodes,
-                        std::vector<idx_t>& facet_nodes_data,  // shape(nb_facets,nb_nodes_per_facet)
-                        std::vector<idx_t>& connectivity_facet_to_elem, idx_t& nb_facets, idx_t& nb_inner_facets,
-                        idx_t& missing_value ) {
-    ATLAS_TRACE();
-    missing_value = -1;
-    std::vector<std::vector<idx_t>> node_to_facet( nodes.size() );
-    for ( auto& facet : node_to_facet ) {
-        facet.reserve( 6 );
-    }
-    nb_facets       = 0;
-    nb_inner_facets = 0;
-    if ( connectivity_facet_to_elem.size() == 0 ) {
-        connectivity_facet_to_elem.reserve( 6 * cells.size() );
-    }
-    if ( facet_nodes_data.size() == 0 ) {
-        facet_nodes_data.reserve( 6 * cells.size() );
-    }
-    for ( idx_t t = 0; t < cells.nb_types(); ++t ) {
-        const mesh::Elements& elements            = cells.elements( t );
-        const mesh::BlockConnectivity& elem_nodes = elements.node_connectivity();
-        auto elem_flags                           = elements.view<int, 1>( elements.flags() );
-
-        auto patch = [&elem_flags]( idx_t e ) {
-            using Topology = atlas::mesh::Nodes::Topology;
-            return Topology::check( elem_flags( e ), Topology::PATCH );
-        };
+namespace {
 
-        idx_t nb_elems          = elements.size();
-        idx_t nb_nodes_in_facet = 2;
+const int quadrilateral_facet_nodes[4][2] = {{0, 1}, {1, 2}, {2, 3}, {3, 0}};
+const int triangle_facet_nodes[3][2]      = {{0, 1}, {1, 2}, {2, 0}};
 
-        std::vector<std::vector<int>> facet_node_numbering;
-        idx_t nb_facets_in_elem;
-        if ( elements.name() == "Quadrilateral" ) {
+/// Elements [begin,end) of one type, of which the facets are accumulated
+struct ElementRange {
+    ElementRange( const mesh::Elements& _elements, idx_t _begin, idx_t _end ) :
+        elements( &_elements ),
+        begin( _begin ),
+        end( _end ) {
+        if ( elements->name() == "Quadrilateral" ) {
             nb_facets_in_elem = 4;
-            facet_node_numbering.resize( nb_facets_in_elem, std::vector<int>( nb_nodes_in_facet ) );
-            facet_node_numbering[0][0] = 0;
-            facet_node_numbering[0][1] = 1;
-            facet_node_numbering[1][0] = 1;
-            facet_node_numbering[1][1] = 2;
-            facet_node_numbering[2][0] = 2;
-            facet_node_numbering[2][1] = 3;
-            facet_node_numbering[3][0] = 3;
-            facet_node_numbering[3][1] = 0;
+            facet_nodes       = quadrilateral_facet_nodes;
         }
-        else if ( elements.name() == "Triangle" ) {
+        else if ( elements->name() == "Triangle" ) {
             nb_facets_in_elem = 3;
-            facet_node_numbering.resize( nb_facets_in_elem, std::vector<int>( nb_nodes_in_facet ) );
-            facet_node_numbering[0][0] = 0;
-            facet_node_numbering[0][1] = 1;
-            facet_node_numbering[1][0] = 1;
-            facet_node_numbering[1][1] = 2;
-            facet_node_numbering[2][0] = 2;
-            facet_node_numbering[2][1] = 0;
+            facet_nodes       = triangle_facet_nodes;
         }
         else {
-            throw_Exception( elements.name() + " is not \"Quadrilateral\" or \"Triangle\"", Here() );
+            throw_Exception( elements->name() + " is not \"Quadrilateral\" or \"Triangle\"", Here() );
         }
-
-        std::vector<idx_t> facet_nodes( nb_nodes_in_facet );
-
-        for ( idx_t e = 0; e < nb_elems; ++e ) {
-            if ( patch( e ) ) {
-                continue;
-            }
-            for ( idx_t f = 0; f < nb_facets_in_elem; ++f ) {
-                bool found_face = false;
-
-                for ( idx_t jnode = 0; jnode < nb_nodes_in_facet; ++jnode ) {
-                    facet_nodes[jnode] = elem_nodes( e, facet_node_numbering[f][jnode] );
-                }
-
-                idx_t node = facet_nodes[0];
-                for ( const idx_t face : node_to_facet[node] ) {
-                    idx_t nb_matched_nodes = 0;
-                    if ( nb_nodes_in_facet > 1 )  // 2D or 3D
-                    {
-                        for ( idx_t jnode = 0; jnode < nb_nodes_in_facet; ++jnode ) {
-                            idx_t other_node = facet_nodes[jnode];
-                            for ( const idx_t other_face : node_to_facet[other_node] ) {
-                                if ( other_face == face ) {
-                                    ++nb_matched_nodes;
-                                    break;
-                                }
-                            }
-                        }
-                        if ( nb_matched_nodes == nb_nodes_in_facet ) {
-                            connectivity_facet_to_elem[2 * face + 1] = e + elements.begin();
-                            ++nb_inner_facets;
-                            found_face = true;
-                            break;
-                        }
-                    }
-                }
-
-                if ( found_face == false ) {
-                    connectivity_facet_to_elem.emplace_back( elements.begin() + e );
-                    // if 2nd element stays missing_value, it is a bdry face
-                    connectivity_facet_to_elem.emplace_back( missing_value );
-                    for ( idx_t n = 0; n < nb_nodes_in_facet; ++n ) {
-                        node_to_facet[facet_nodes[n]].emplace_back( nb_facets );
-                        facet_nodes_data.emplace_back( facet_nodes[n] );
-                    }
-                    ++nb_facets;
-                }
-            }
+    }
+    const mesh::Elements* elements;
+    idx_t begin;
+    idx_t end;
+    idx_t nb_facets_in_elem;
+    const int ( *facet_nodes )[2];
+};
+
+/// Facet of one element: its nodes in increasing order, and its position in the order of accumulation
+struct ElementFacet {
+    idx_t lo;
+    idx_t hi;
+    idx_t s;
+    bool same_nodes( const ElementFacet& other ) const { return lo == other.lo && hi == other.hi; }
+    bool operator<( const ElementFacet& other ) const {
+        return lo != other.lo ? lo < other.lo : hi != other.hi ? hi < other.hi : s < other.s;
+    }
+};
+
+/// Calls f( s, e, facet_nodes ) for every facet of every non-patch element e of the range on OpenMP threads,
+/// where s = offset + ( e - range.begin ) * range.nb_facets_in_elem + jfacet
+template <typename Functor>
+void for_each_element_facet( const ElementRange& range, idx_t offset, const Functor& f ) {
+    using Topology                            = atlas::mesh::Nodes::Topology;
+    const mesh::BlockConnectivity& elem_nodes = range.elements->node_connectivity();
+    auto elem_flags                           = range.elements->view<int, 1>( range.elements->flags() );
+    atlas_omp_parallel_for( idx_t e = range.begin; e < range.end; ++e ) {
+        if ( Topology::check( elem_flags( e ), Topology::PATCH ) ) {
+            continue;
+        }
+        for ( idx_t jfacet = 0; jfacet < range.nb_facets_in_elem; ++jfacet ) {
+            const idx_t nodes[2] = {elem_nodes( e, range.facet_nodes[jfacet][0] ),
+                                    elem_nodes( e, range.facet_nodes[jfacet][1] )};
+            f( offset + ( e - range.begin ) * range.nb_facets_in_elem + jfacet, e, nodes );
         }
     }
 }
 
-void accumulate_facets_in_range( std::vector<array::Range>& range, const mesh::HybridElements& cells,
-                                 const mesh::Nodes& /*nodes*/,
-                                 std::vector<idx_t>& facet_nodes_data,  // shape(nb_facets,nb_nodes_per_facet)
+/// Accumulate the facets of the elements in all ranges, in order.
+///
+/// The result is that of visiting all element facets one by one, creating a facet when its nodes are seen for
+/// the first time, and connecting the element to the existing facet otherwise. Instead of looking up every facet
+/// in a node-to-facet table, element facets are sorted by their nodes (on OpenMP threads): the first element
+/// facet of every group creates the facet, and facets are numbered with a prefix sum in the order of accumulation.
+void accumulate_facets_in_order( const std::vector<ElementRange>& ranges, std::vector<idx_t>& facet_nodes_data,
                                  std::vector<idx_t>& connectivity_facet_to_elem, idx_t& nb_facets,
-                                 idx_t& nb_inner_facets, idx_t& missing_value,
-                                 std::vector<std::vector<idx_t>>& node_to_facet ) {
-    ATLAS_TRACE();
-    if ( connectivity_facet_to_elem.size() == 0 ) {
-        connectivity_facet_to_elem.reserve( 6 * cells.size() );
+                                 idx_t& nb_inner_facets, idx_t missing_value,
+                                 std::vector<idx_t>& nb_facets_after_range ) {
+    const idx_t nb_ranges = static_cast<idx_t>( ranges.size() );
+    std::vector<idx_t> range_offset( nb_ranges + 1, 0 );
+    for ( idx_t r = 0; r < nb_ranges; ++r ) {
+        range_offset[r + 1] = range_offset[r] + ( ranges[r].end - ranges[r].begin ) * ranges[r].nb_facets_in_elem;
     }
-    if ( facet_nodes_data.size() == 0 ) {
-        facet_nodes_data.reserve( 6 * cells.size() );
+    const idx_t nb_element_facets = range_offset[nb_ranges];
+    const idx_t invalid           = std::numeric_limits<idx_t>::max();
+
+    std::vector<ElementFacet> element_facets( nb_element_facets, ElementFacet{invalid, invalid, invalid} );
+    for ( idx_t r = 0; r < nb_ranges; ++r ) {
+        for_each_element_facet( ranges[r], range_offset[r], [&]( idx_t s, idx_t, const idx_t nodes[] ) {
+            element_facets[s] = ElementFacet{std::min( nodes[0], nodes[1] ), std::max( nodes[0], nodes[1] ), s};
+        } );
     }
-    for ( idx_t t = 0; t < cells.nb_types(); ++t ) {
-        const mesh::Elements& elements            = cells.elements( t );
-        const mesh::BlockConnectivity& elem_nodes = elements.node_connectivity();
-        auto elem_flags                           = elements.view<int, 1>( elements.flags() );
-
-        auto patch = [&elem_flags]( idx_t e ) {
-            using Topology = atlas::mesh::Nodes::Topology;
-            return Topology::check( elem_flags( e ), Topology::PATCH );
-        };
-
-        idx_t nb_nodes_in_facet = 2;
-
-        std::vector<std::vector<int>> facet_node_numbering;
-        idx_t nb_facets_in_elem;
-        if ( elements.name() == "Quadrilateral" ) {
-            nb_facets_in_elem = 4;
-            facet_node_numbering.resize( nb_facets_in_elem, std::vector<int>( nb_nodes_in_facet ) );
-            facet_node_numbering[0][0] = 0;
-            facet_node_numbering[0][1] = 1;
-            facet_node_numbering[1][0] = 1;
-            facet_node_numbering[1][1] = 2;
-            facet_node_numbering[2][0] = 2;
-            facet_node_numbering[2][1] = 3;
-            facet_node_numbering[3][0] = 3;
-            facet_node_numbering[3][1] = 0;
+    omp::sort( element_facets.begin(), element_facets.end() );
+
+    // For the element facet that creates a facet, the last other element facet with the same nodes, or -1
+    const idx_t not_first = -2;
+    std::vector<idx_t> partner( nb_element_facets, not_first );
+    idx_t nb_inner{0};
+    atlas_omp_pragma( omp parallel for schedule( static ) reduction( + : nb_inner ) )
+    for ( idx_t k = 0; k < nb_element_facets; ++k ) {
+        const ElementFacet& facet = element_facets[k];
+        if ( facet.s == invalid || ( k > 0 && element_facets[k - 1].same_nodes( facet ) ) ) {
+            continue;
         }
-        else if ( elements.name() == "Triangle" ) {
-            nb_facets_in_elem = 3;
-            facet_node_numbering.resize( nb_facets_in_elem, std::vector<int>( nb_nodes_in_facet ) );
-            facet_node_numbering[0][0] = 0;
-            facet_node_numbering[0][1] = 1;
-            facet_node_numbering[1][0] = 1;
-            facet_node_numbering[1][1] = 2;
-            facet_node_numbering[2][0] = 2;
-            facet_node_numbering[2][1] = 0;
+        idx_t last = k;
+        while ( last + 1 < nb_element_facets && element_facets[last + 1].same_nodes( facet ) ) {
+            ++last;
         }
-        else {
-            throw_Exception( elements.name() + " is not \"Quadrilateral\" or \"Triangle\"", Here() );
+        partner[facet.s] = ( last > k ) ? element_facets[last].s : -1;
+        nb_inner += last - k;
+    }
+    element_facets.clear();
+    element_facets.shrink_to_fit();
+
+    // Number facets in the order of accumulation
+    std::vector<idx_t> facet_number( nb_element_facets, -1 );
+    nb_facets_after_range.resize( nb_ranges );
+    idx_t nb_created{0};
+    for ( idx_t r = 0; r < nb_ranges; ++r ) {
+        for ( idx_t s = range_offset[r]; s < range_offset[r + 1]; ++s ) {
+            if ( partner[s] != not_first ) {
+                facet_number[s] = nb_created++;
+            }
         }
+        nb_facets_after_range[r] = nb_created;
+    }
 
-        std::vector<idx_t> facet_nodes( nb_nodes_in_facet );
-
-        const idx_t e_start = range[t].start();
-        const idx_t e_end   = range[t].end();
-
-        for ( idx_t e = e_start; e < e_end; ++e ) {
-            if ( patch( e ) ) {
-                continue;
+    auto element_of = [&]( idx_t s ) {
+        const idx_t r =
+            idx_t( std::upper_bound( range_offset.begin(), range_offset.end(), s ) - range_offset.begin() ) - 1;
+        return ranges[r].elements->begin() + ranges[r].begin + ( s - range_offset[r] ) / ranges[r].nb_facets_in_elem;
+    };
+
+    nb_facets       = nb_created;
+    nb_inner_facets = nb_inner;
+    facet_nodes_data.assign( 2 * nb_facets, missing_value );
+    connectivity_facet_to_elem.assign( 2 * nb_facets, missing_value );
+    for ( idx_t r = 0; r < nb_ranges; ++r ) {
+        const idx_t elements_begin = ranges[r].elements->begin();
+        for_each_element_facet( ranges[r], range_offset[r], [&]( idx_t s, idx_t e, const idx_t nodes[] ) {
+            const idx_t facet = facet_number[s];
+            if ( facet >= 0 ) {
+                facet_nodes_data[2 * facet + 0]           = nodes[0];
+                facet_nodes_data[2 * facet + 1]           = nodes[1];
+                connectivity_facet_to_elem[2 * facet + 0] = elements_begin + e;
+                // if 2nd element stays missing_value, it is a bdry face
+                if ( partner[s] >= 0 ) {
+                    connectivity_facet_to_elem[2 * facet + 1] = element_of( partner[s] );
+                }
             }
+        } );
+    }
+}
 
-            for ( idx_t f = 0; f < nb_facets_in_elem; ++f ) {
-                bool found_face = false;
-
-                for ( idx_t jnode = 0; jnode < nb_nodes_in_facet; ++jnode ) {
-                    facet_nodes[jnode] = elem_nodes( e, facet_node_numbering[f][jnode] );
-                }
+}  // namespace
 
-                int node = facet_nodes[0];
-                for ( idx_t face : node_to_facet[node] ) {
-                    idx_t nb_matched_nodes = 0;
-                    if ( nb_nodes_in_facet > 1 )  // 2D or 3D
-                    {
-                        for ( idx_t jnode = 0; jnode < nb_nodes_in_facet; ++jnode ) {
-                            idx_t other_node = facet_nodes[jnode];
-                            for ( idx_t other_face : node_to_facet[other_node] ) {
-                                if ( other_face == face ) {
-                                    ++nb_matched_nodes;
-                                    break;
-                                }
-                            }
-                        }
-                        if ( nb_matched_nodes == nb_nodes_in_facet ) {
-                            connectivity_facet_to_elem[2 * face + 1] = e + elements.begin();
-                            ++nb_inner_facets;
-                            found_face = true;
-                            break;
-                        }
-                    }
-                }
+void accumulate_facets( const mesh::HybridElements& cells, const mesh::Nodes& /*nodes*/,
+                        std::vector<idx_t>& facet_nodes_data,  // shape(nb_facets,nb_nodes_per_facet)
+                        std::vector<idx_t>& connectivity_facet_to_elem, idx_t& nb_facets, idx_t& nb_inner_facets,
+                        idx_t& missing_value ) {
+    ATLAS_TRACE();
+    missing_value = -1;
 
-                if ( found_face == false ) {
-                    connectivity_facet_to_elem.emplace_back( elements.begin() + e );
-                    // if 2nd element stays missing_value, it is a bdry face
-                    connectivity_facet_to_elem.emplace_back( missing_value );
-                    for ( idx_t n = 0; n < nb_nodes_in_facet; ++n ) {
-                        node_to_facet[facet_nodes[n]].emplace_back( nb_facets );
-                        facet_nodes_data.emplace_back( facet_nodes[n] );
-                    }
-                    ++nb_facets;
-                }
-            }
-        }
+    std::vector<ElementRange> ranges;
+    for ( idx_t t = 0; t < cells.nb_types(); ++t ) {
+        ranges.emplace_back( cells.elements( t ), 0, cells.elements( t ).size() );
     }
+    std::vector<idx_t> nb_facets_after_range;
+    accumulate_facets_in_order( ranges, facet_nodes_data, connectivity_facet_to_elem, nb_facets, nb_inner_facets,
+                                missing_value, nb_facets_after_range );
 }
 
-void accumulate_facets_ordered_by_halo( const mesh::HybridElements& cells, const mesh::Nodes& nodes,
+void accumulate_facets_ordered_by_halo( const mesh::HybridElements& cells, const mesh::Nodes& /*nodes*/,
                                         std::vector<idx_t>& facet_nodes_data,  // shape(nb_facets,nb_nodes_per_facet)
                                         std::vector<idx_t>& connectivity_facet_to_elem, idx_t& nb_facets,
                                         idx_t& nb_inner_facets, idx_t& missing_value,
@@ -270,21 +222,22 @@ void accumulate_facets_ordered_by_halo( const mesh::HybridElements& cells, const
         maxhalo         = std::max( halo, maxhalo );
     }
 
-
     missing_value = -1;
-    std::vector<std::vector<idx_t>> node_to_facet( nodes.size() );
-    for ( auto& facets : node_to_facet ) {
-        facets.reserve( 6 );
-    }
-    nb_facets       = 0;
-    nb_inner_facets = 0;
 
+    // Facets of halo h are accumulated after those of halo h-1
+    std::vector<ElementRange> element_ranges;
+    for ( int h = 0; h <= maxhalo; ++h ) {
+        for ( idx_t t = 0; t < cells.nb_types(); ++t ) {
+            element_ranges.emplace_back( cells.elements( t ), ranges[h][t].start(), ranges[h][t].end() );
+        }
+    }
+    std::vector<idx_t> nb_facets_after_range;
+    accumulate_facets_in_order( element_ranges, facet_nodes_data, connectivity_facet_to_elem, nb_facets,
+                                nb_inner_facets, missing_value, nb_facets_after_range );
 
     halo_offsets = std::vector<idx_t>{0};
     for ( int h = 0; h <= maxhalo; ++h ) {
-        accumulate_facets_in_range( ranges[h], cells, nodes, facet_nodes_data, connectivity_facet_to_elem, nb_facets,
-                                    nb_inner_facets, missing_value, node_to_facet );
-        halo_offsets.emplace_back( nb_facets );
+        halo_offsets.emplace_back( cells.nb_types() ? nb_facets_after_range[( h + 1 ) * cells.nb_types() - 1] : 0 );
     }
 }
 
@@ -0,0 +1,53 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include "atlas/mesh/detail/GroupByTarget.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "atlas/parallel/omp/omp.h"
+#include "atlas/parallel/omp/sort.h"
+#include "atlas/runtime/Exception.h"
+#include "atlas/runtime/Trace.h"
+
+namespace atlas {
+namespace mesh {
+namespace detail {
+
+void group_by_target( const std::vector<idx_t>& target, idx_t nb_targets, std::vector<idx_t>& displs,
+                      std::vector<idx_t>& entries ) {
+    ATLAS_TRACE();
+    const idx_t nb_entries = static_cast<idx_t>( target.size() );
+
+    // Sorting ( target, entry ) pairs keeps the entries of every target in order; skipped entries go last
+    std::vector<std::pair<idx_t, idx_t>> pairs( nb_entries );
+    idx_t nb_invalid{0};
+    atlas_omp_pragma( omp parallel for schedule( static ) reduction( + : nb_invalid ) )
+    for ( idx_t k = 0; k < nb_entries; ++k ) {
+        nb_invalid += ( target[k] >= nb_targets );
+        pairs[k] = std::make_pair( target[k] < 0 ? nb_targets : target[k], k );
+    }
+    ATLAS_ASSERT( nb_invalid == 0 );
+    omp::sort( pairs.begin(), pairs.end() );
+
+    displs.resize( nb_targets + 1 );
+    atlas_omp_parallel_for( idx_t t = 0; t <= nb_targets; ++t ) {
+        displs[t] = idx_t( std::lower_bound( pairs.begin(), pairs.end(), std::make_pair( t, idx_t( 0 ) ) ) -
+                           pairs.begin() );
+    }
+
+    entries.resize( displs[nb_targets] );
+    atlas_omp_parallel_for( idx_t k = 0; k < displs[nb_targets]; ++k ) { entries[k] = pairs[k].second; }
+}
+
+}  // namespace detail
+}  // namespace mesh
+}  // namespace atlas
@@ -0,0 +1,32 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "atlas/library/config.h"
+
+namespace atlas {
+namespace mesh {
+namespace detail {
+
+/// @brief Group entries by their target, keeping the order of the entries within every target
+///
+/// This inverts a connectivity, e.g. with entry 2*jedge+j connecting edge jedge to node target[2*jedge+j],
+/// the entries of node jnode are entries[displs[jnode]], ..., entries[displs[jnode+1]-1], in increasing order.
+/// Entries with a negative target are skipped. The grouping runs on OpenMP threads, and its result does not
+/// depend on the number of threads, unlike a scatter with per-target counters.
+void group_by_target( const std::vector<idx_t>& target, idx_t nb_targets, std::vector<idx_t>& displs,
+                      std::vector<idx_t>& entries );
+
+}  // namespace detail
+}  // namespace mesh
+}  // namespace atlas
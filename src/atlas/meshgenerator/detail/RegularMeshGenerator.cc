@@ -144,12 +144,12 @@ void RegularMeshGenerator::generate( const Grid& grid, const grid::Distribution&
 
     ATLAS_ASSERT( !mesh.generated() );
 
-    if ( grid.size() != static_cast<idx_t>( distribution.partition().size() ) ) {
+    if ( grid.size() != static_cast<idx_t>( distribution.size() ) ) {
         std::stringstream msg;
         msg << "Number of points in grid (" << grid.size()
             << ") different from "
                "number of points in grid distribution ("
-            << distribution.partition().size() << ")";
+            << distribution.size() << ")";
         throw_AssertionFailed( msg.str(), Here() );
     }
 
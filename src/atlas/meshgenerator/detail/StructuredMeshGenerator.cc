@@ -34,6 +34,7 @@
 #include "atlas/meshgenerator/detail/MeshGeneratorFactory.h"
 #include "atlas/meshgenerator/detail/StructuredMeshGenerator.h"
 #include "atlas/parallel/mpi/mpi.h"
+#include "atlas/parallel/omp/omp.h"
 #include "atlas/runtime/Log.h"
 #include "atlas/runtime/Trace.h"
 #include "atlas/util/CoordinateEnums.h"
@@ -59,9 +60,11 @@ struct Region {
     int ntriags;
     int nquads;
     int nnodes;
+    int elems_north;  // latitude of the first row of elems
     std::vector<idx_t> lat_begin;
     std::vector<idx_t> lat_end;
     std::vector<idx_t> nb_lat_elems;
+    std::vector<idx_t> nb_lat_quads;
 };
 
 StructuredMeshGenerator::StructuredMeshGenerator( const eckit::Parametrisation& p ) {
@@ -219,12 +222,12 @@ void StructuredMeshGenerator::generate( const Grid& grid, const grid::Distributi
 
     ATLAS_ASSERT( !mesh.generated() );
 
-    if ( grid.size() != idx_t( distribution.partition().size() ) ) {
+    if ( grid.size() != idx_t( distribution.size() ) ) {
         std::stringstream msg;
         msg << "Number of points in grid (" << grid.size()
             << ") different from "
                "number of points in grid distribution ("
-            << distribution.partition().size() << ")";
+            << distribution.size() << ")";
         throw_AssertionFailed( msg.str(), Here() );
     }
 
@@ -233,7 +236,7 @@ void StructuredMeshGenerator::generate( const Grid& grid, const grid::Distributi
 // show distribution
 #if DEBUG_OUTPUT
     int inode                = 0;
-    atlas::vector<int> parts = distribution;
+    const auto& parts = distribution.partition();
     Log::info() << "Partition : " << std::endl;
     for ( size_t ilat = 0; ilat < rg.ny(); ilat++ ) {
         for ( size_t ilon = 0; ilon < rg.nx( ilat ); ilon++ ) {
@@ -253,8 +256,8 @@ void StructuredMeshGenerator::generate( const Grid& grid, const grid::Distributi
     generate_mesh( rg, distribution, region, mesh );
 }
 
-void StructuredMeshGenerator::generate_region( const StructuredGrid& rg, const atlas::vector<int>& parts, int mypart,
-                                               Region& region ) const {
+void StructuredMeshGenerator::generate_region( const StructuredGrid& rg, const grid::Distribution& distribution,
+                                               int mypart, Region& region ) const {
     ATLAS_TRACE();
 
     double max_angle       = options.get<double>( "angle" );
@@ -265,43 +268,36 @@ void StructuredMeshGenerator::generate_region( const StructuredGrid& rg, const a
     bool unique_pole = options.get<bool>( "unique_pole" ) && three_dimensional && has_north_pole && has_south_pole;
     bool periodic_east_west = rg.periodic();
 
-    int n;
     /*
 Find min and max latitudes used by this part.
 */
-    n               = 0;
-    idx_t lat_north = -1;
+    std::vector<idx_t> offset( rg.ny(), 0 );
+
+    int n = 0;
     for ( idx_t jlat = 0; jlat < rg.ny(); ++jlat ) {
+        offset.at( jlat ) = n;
+        n += rg.nx( jlat );
+    };
+
+    std::vector<char> lat_has_part( rg.ny(), 0 );
+    atlas_omp_parallel_for( idx_t jlat = 0; jlat < rg.ny(); ++jlat ) {
         for ( idx_t jlon = 0; jlon < rg.nx( jlat ); ++jlon ) {
-            if ( parts.at( n ) == mypart ) {
-                lat_north = jlat;
-                goto end_north;
+            if ( distribution.partition( offset[jlat] + jlon ) == mypart ) {
+                lat_has_part[jlat] = 1;
+                break;
             }
-            ++n;
         }
     }
-end_north:
-
-    n               = rg.size() - 1;
+    idx_t lat_north = -1;
     idx_t lat_south = -1;
-    for ( idx_t jlat = rg.ny() - 1; jlat >= 0; --jlat ) {
-        for ( idx_t jlon = rg.nx( jlat ) - 1; jlon >= 0; --jlon ) {
-            if ( parts.at( n ) == mypart ) {
-                lat_south = jlat;
-                goto end_south;
+    for ( idx_t jlat = 0; jlat < rg.ny(); ++jlat ) {
+        if ( lat_has_part[jlat] ) {
+            if ( lat_north == -1 ) {
+                lat_north = jlat;
             }
-            --n;
+            lat_south = jlat;
         }
     }
-end_south:
-
-    std::vector<idx_t> offset( rg.ny(), 0 );
-
-    n = 0;
-    for ( idx_t jlat = 0; jlat < rg.ny(); ++jlat ) {
-        offset.at( jlat ) = n;
-        n += rg.nx( jlat );
-    };
 
     /*
 We need to connect to next region
@@ -315,24 +311,36 @@ We need to connect to next region
     region.lat_begin.resize( rg.ny(), -1 );
     region.lat_end.resize( rg.ny(), -1 );
     region.nb_lat_elems.resize( rg.ny(), 0 );
-    region.north = lat_north;
-    region.south = lat_south;
+    region.nb_lat_quads.resize( rg.ny(), 0 );
+    region.north       = lat_north;
+    region.south       = lat_south;
+    region.elems_north = lat_north;
 
     array::ArrayShape shape = array::make_shape( region.south - region.north, 4 * rg.nxmax(), 4 );
 
     region.elems.reset( array::Array::create<int>( shape ) );
 
-    int nelems     = 0;
     region.nquads  = 0;
     region.ntriags = 0;
 
     array::ArrayView<int, 3> elemview = array::make_view<int, 3>( *region.elems );
     elemview.assign( -1 );
 
-    bool stagger = options.get<bool>( "stagger" );
-    for ( idx_t jlat = lat_north; jlat < lat_south; ++jlat ) {
-        //    std::stringstream filename; filename << "/tmp/debug/"<<jlat;
+    // Range of longitude indices used by the elements of one row of elements, on one of its two latitudes
+    struct LonRange {
+        idx_t begin = -1;
+        idx_t end   = -1;
+        void add( idx_t b, idx_t e ) {
+            begin = ( begin == -1 ) ? b : std::min( begin, b );
+            end   = std::max( end, e );
+        }
+    };
+    std::vector<LonRange> range_north( std::max<idx_t>( 0, lat_south - lat_north ) );
+    std::vector<LonRange> range_south( std::max<idx_t>( 0, lat_south - lat_north ) );
 
+    // Rows of elements are independent: they are created on separate threads, and merged in order below
+    bool stagger = options.get<bool>( "stagger" );
+    atlas_omp_parallel_for( idx_t jlat = lat_north; jlat < lat_south; ++jlat ) {
         idx_t ilat, latN, latS;
         idx_t ipN1, ipN2, ipS1, ipS2;
         double xN1, xN2, yN, xS1, xS2, yS;
@@ -340,7 +348,10 @@ We need to connect to next region
         bool try_make_triangle_up, try_make_triangle_down, try_make_quad;
         bool add_triag, add_quad;
 
-        ilat = jlat - region.north;
+        ilat = jlat - region.elems_north;
+
+        LonRange& rangeN = range_north[ilat];
+        LonRange& rangeS = range_south[ilat];
 
         auto lat_elems_view = elemview.slice( ilat, Range::all(), Range::all() );
 
@@ -369,7 +380,7 @@ We need to connect to next region
         ipS2 = std::min( ipS1 + 1, endS );
 
         idx_t jelem = 0;
-        int pE      = parts.at( offset.at( latN ) );
+        int pE      = distribution.partition( offset.at( latN ) );
 
 #if DEBUG_OUTPUT
         Log::info() << "=================\n";
@@ -390,29 +401,29 @@ We need to connect to next region
 
             int pN1, pS1, pN2, pS2;
             if ( ipN1 != rg.nx( latN ) ) {
-                pN1 = parts.at( offset.at( latN ) + ipN1 );
+                pN1 = distribution.partition( offset.at( latN ) + ipN1 );
             }
             else {
-                pN1 = parts.at( offset.at( latN ) );
+                pN1 = distribution.partition( offset.at( latN ) );
             }
             if ( ipS1 != rg.nx( latS ) ) {
-                pS1 = parts.at( offset.at( latS ) + ipS1 );
+                pS1 = distribution.partition( offset.at( latS ) + ipS1 );
             }
             else {
-                pS1 = parts.at( offset.at( latS ) );
+                pS1 = distribution.partition( offset.at( latS ) );
             }
 
             if ( ipN2 == rg.nx( latN ) ) {
-                pN2 = parts.at( offset.at( latN ) );
+                pN2 = distribution.partition( offset.at( latN ) );
             }
             else {
-                pN2 = parts.at( offset.at( latN ) + ipN2 );
+                pN2 = distribution.partition( offset.at( latN ) + ipN2 );
             }
             if ( ipS2 == rg.nx( latS ) ) {
-                pS2 = parts.at( offset.at( latS ) );
+                pS2 = distribution.partition( offset.at( latS ) );
             }
             else {
-                pS2 = parts.at( offset.at( latS ) + ipS2 );
+                pS2 = distribution.partition( offset.at( latS ) + ipS2 );
             }
 
             // Log::info()  << ipN1 << "("<<pN1<<") " << ipN2 <<"("<<pN2<<")" <<  std::endl;
@@ -584,20 +595,10 @@ We need to connect to next region
                 }
                 add_quad = ( pE == mypart );
                 if ( add_quad ) {
-                    ++region.nquads;
+                    ++region.nb_lat_quads[jlat];
                     ++jelem;
-                    ++nelems;
-
-                    if ( region.lat_begin.at( latN ) == -1 ) {
-                        region.lat_begin.at( latN ) = ipN1;
-                    }
-                    if ( region.lat_begin.at( latS ) == -1 ) {
-                        region.lat_begin.at( latS ) = ipS1;
-                    }
-                    region.lat_begin.at( latN ) = std::min<int>( region.lat_begin.at( latN ), ipN1 );
-                    region.lat_begin.at( latS ) = std::min<int>( region.lat_begin.at( latS ), ipS1 );
-                    region.lat_end.at( latN )   = std::max<int>( region.lat_end.at( latN ), ipN2 );
-                    region.lat_end.at( latS )   = std::max<int>( region.lat_end.at( latS ), ipS2 );
+                    rangeN.add( ipN1, ipN2 );
+                    rangeS.add( ipS1, ipS2 );
                 }
                 else {
 #if DEBUG_OUTPUT
@@ -626,20 +627,9 @@ We need to connect to next region
                 add_triag = ( mypart == pE );
 
                 if ( add_triag ) {
-                    ++region.ntriags;
                     ++jelem;
-                    ++nelems;
-
-                    if ( region.lat_begin.at( latN ) == -1 ) {
-                        region.lat_begin.at( latN ) = ipN1;
-                    }
-                    if ( region.lat_begin.at( latS ) == -1 ) {
-                        region.lat_begin.at( latS ) = ipS1;
-                    }
-                    region.lat_begin.at( latN ) = std::min<int>( region.lat_begin.at( latN ), ipN1 );
-                    region.lat_begin.at( latS ) = std::min<int>( region.lat_begin.at( latS ), ipS1 );
-                    region.lat_end.at( latN )   = std::max<int>( region.lat_end.at( latN ), ipN2 );
-                    region.lat_end.at( latS )   = std::max<int>( region.lat_end.at( latS ), ipS1 );
+                    rangeN.add( ipN1, ipN2 );
+                    rangeS.add( ipS1, ipS1 );
                 }
                 else {
 #if DEBUG_OUTPUT
@@ -680,20 +670,9 @@ We need to connect to next region
                 add_triag = ( mypart == pE );
 
                 if ( add_triag ) {
-                    ++region.ntriags;
                     ++jelem;
-                    ++nelems;
-
-                    if ( region.lat_begin.at( latN ) == -1 ) {
-                        region.lat_begin.at( latN ) = ipN1;
-                    }
-                    if ( region.lat_begin.at( latS ) == -1 ) {
-                        region.lat_begin.at( latS ) = ipS1;
-                    }
-                    region.lat_begin.at( latN ) = std::min( region.lat_begin.at( latN ), ipN1 );
-                    region.lat_begin.at( latS ) = std::min( region.lat_begin.at( latS ), ipS1 );
-                    region.lat_end.at( latN )   = std::max( region.lat_end.at( latN ), ipN1 );
-                    region.lat_end.at( latS )   = std::max( region.lat_end.at( latS ), ipS2 );
+                    rangeN.add( ipN1, ipN1 );
+                    rangeS.add( ipS1, ipS2 );
                 }
                 else {
 #if DEBUG_OUTPUT
@@ -710,6 +689,28 @@ We need to connect to next region
             ipS2 = std::min( endS, ipS1 + 1 );
         }
         region.nb_lat_elems.at( jlat ) = jelem;
+    }  // for jlat
+
+    // Merge the rows of elements in order, as they depend on the rows before through region.north
+    auto merge_range = [&]( idx_t lat, const LonRange& range ) {
+        if ( range.begin != -1 ) {
+            region.lat_begin.at( lat ) =
+                region.lat_begin.at( lat ) == -1 ? range.begin : std::min( region.lat_begin.at( lat ), range.begin );
+        }
+        region.lat_end.at( lat ) = std::max( region.lat_end.at( lat ), range.end );
+    };
+    for ( idx_t jlat = lat_north; jlat < lat_south; ++jlat ) {
+        const idx_t ilat = jlat - region.elems_north;
+        const idx_t latN = jlat;
+        const idx_t latS = jlat + 1;
+        const double yN  = rg.y( latN );
+        const double yS  = rg.y( latS );
+
+        merge_range( latN, range_north[ilat] );
+        merge_range( latS, range_south[ilat] );
+        region.nquads += region.nb_lat_quads.at( jlat );
+        region.ntriags += region.nb_lat_elems.at( jlat ) - region.nb_lat_quads.at( jlat );
+
 #if DEBUG_OUTPUT
         ATLAS_DEBUG_VAR( region.nb_lat_elems.at( jlat ) );
 #endif
@@ -719,10 +720,6 @@ We need to connect to next region
         if ( region.nb_lat_elems.at( jlat ) == 0 && latS == region.south ) {
             --region.south;
         }
-        //    region.lat_end.at(latN) = std::min(region.lat_end.at(latN),
-        //    int(rg.nx(latN)-1));
-        //    region.lat_end.at(latS) = std::min(region.lat_end.at(latS),
-        //    int(rg.nx(latS)-1));
         if ( yN == 90 && unique_pole ) {
             region.lat_end.at( latN ) = rg.nx( latN ) - 1;
         }
@@ -734,22 +731,20 @@ We need to connect to next region
             region.lat_end.at( latN ) = std::max( region.lat_end.at( latN ), region.lat_begin.at( latN ) );
             region.lat_end.at( latS ) = std::max( region.lat_end.at( latS ), region.lat_begin.at( latS ) );
         }
-    }  // for jlat
+    }
 
     //  Log::info()  << "nb_triags = " << region.ntriags << std::endl;
     //  Log::info()  << "nb_quads = " << region.nquads << std::endl;
-    //  Log::info()  << "nb_elems = " << nelems << std::endl;
 
     int nb_region_nodes = 0;
+    atlas_omp_pragma( omp parallel for schedule( guided ) reduction( + : nb_region_nodes ) )
     for ( int jlat = region.north; jlat <= region.south; ++jlat ) {
-        n                           = offset.at( jlat );
         region.lat_begin.at( jlat ) = std::max( 0, region.lat_begin.at( jlat ) );
         for ( idx_t jlon = 0; jlon < rg.nx( jlat ); ++jlon ) {
-            if ( parts.at( n ) == mypart ) {
+            if ( distribution.partition( offset.at( jlat ) + jlon ) == mypart ) {
                 region.lat_begin.at( jlat ) = std::min( region.lat_begin.at( jlat ), jlon );
                 region.lat_end.at( jlat )   = std::max( region.lat_end.at( jlat ), jlon );
             }
-            ++n;
         }
         nb_region_nodes += region.lat_end.at( jlat ) - region.lat_begin.at( jlat ) + 1;
 
@@ -770,20 +765,7 @@ We need to connect to next region
 #endif
 }
 
-namespace {
-struct GhostNode {
-    GhostNode( int _jlat, int _jlon, int _jnode ) {
-        jlat  = _jlat;
-        jlon  = _jlon;
-        jnode = _jnode;
-    }
-    int jlat;
-    int jlon;
-    int jnode;
-};
-}  // namespace
-
-void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const atlas::vector<int>& parts,
+void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const grid::Distribution& distribution,
                                              const Region& region, Mesh& mesh ) const {
     ATLAS_TRACE();
 
@@ -791,7 +773,7 @@ void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const atl
 
     int mypart = options.get<size_t>( "part" );
     int nparts = options.get<size_t>( "nb_parts" );
-    int n, l;
+    int n;
 
     bool three_dimensional             = options.get<bool>( "3d" );
     bool periodic_east_west            = rg.periodic();
@@ -864,8 +846,10 @@ void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const atl
     ATLAS_DEBUG_VAR( options.get<bool>( "ghost_at_end" ) );
 #endif
 
+    const idx_t nb_region_lats = region.south - region.north + 1;
+
     std::vector<int> offset_glb( rg.ny() );
-    std::vector<int> offset_loc( region.south - region.north + 1, 0 );
+    std::vector<int> offset_loc( nb_region_lats + 1, 0 );
 
     n = 0;
     for ( idx_t jlat = 0; jlat < rg.ny(); ++jlat ) {
@@ -892,6 +876,40 @@ void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const atl
     }
     int max_glb_idx = n;
 
+    // Local offset of the nodes of every latitude of the region (prefix sum), so that latitudes can be
+    // filled independently. Periodic points beyond rg.nx( jlat ) are only included as ghost points.
+    ATLAS_ASSERT( region.south >= region.north );
+    for ( idx_t jlat = region.north; jlat <= region.south; ++jlat ) {
+        idx_t ilat      = jlat - region.north;
+        idx_t nb_nodes  = region.lat_end.at( jlat ) - region.lat_begin.at( jlat ) + 1;
+        idx_t nb_beyond = region.lat_end.at( jlat ) - std::max( region.lat_begin.at( jlat ), rg.nx( jlat ) ) + 1;
+        if ( region.lat_end.at( jlat ) < region.lat_begin.at( jlat ) ) {
+            ATLAS_DEBUG_VAR( jlat );
+            ATLAS_DEBUG_VAR( region.lat_begin[jlat] );
+            ATLAS_DEBUG_VAR( region.lat_end[jlat] );
+        }
+        if ( !include_periodic_ghost_points ) {
+            nb_nodes -= std::max<idx_t>( 0, nb_beyond );
+        }
+        offset_loc.at( ilat + 1 ) = offset_loc.at( ilat ) + std::max<idx_t>( 0, nb_nodes );
+    }
+    const idx_t nb_region_nodes = offset_loc.at( nb_region_lats );
+
+    // Partition of every node of the region, or -1 for periodic ghost points
+    std::vector<int> node_part( nb_region_nodes );
+    atlas_omp_parallel_for( idx_t ilat = 0; ilat < nb_region_lats; ++ilat ) {
+        const idx_t jlat = region.north + ilat;
+        idx_t jnode      = offset_loc[ilat];
+        for ( idx_t jlon = region.lat_begin[jlat]; jlon <= region.lat_end[jlat]; ++jlon ) {
+            if ( jlon < rg.nx( jlat ) ) {
+                node_part[jnode++] = distribution.partition( offset_glb[jlat] + jlon );
+            }
+            else if ( include_periodic_ghost_points ) {
+                node_part[jnode++] = -1;
+            }
+        }
+    }
+
     mesh.nodes().resize( nnodes );
     mesh::Nodes& nodes = mesh.nodes();
 
@@ -907,53 +925,31 @@ void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const atl
 
     std::vector<idx_t> node_numbering( node_numbering_size, -1 );
     if ( options.get<bool>( "ghost_at_end" ) ) {
-        std::vector<GhostNode> ghost_nodes;
-        ghost_nodes.reserve( nnodes );
-        idx_t node_number = 0;
-        idx_t jnode       = 0;
-        l                 = 0;
-        ATLAS_ASSERT( region.south >= region.north );
-        for ( int jlat = region.north; jlat <= region.south; ++jlat ) {
-            int ilat              = jlat - region.north;
-            offset_loc.at( ilat ) = l;
-            l += region.lat_end.at( jlat ) - region.lat_begin.at( jlat ) + 1;
-
-            if ( region.lat_end.at( jlat ) < region.lat_begin.at( jlat ) ) {
-                ATLAS_DEBUG_VAR( jlat );
-                ATLAS_DEBUG_VAR( region.lat_begin[jlat] );
-                ATLAS_DEBUG_VAR( region.lat_end[jlat] );
-            }
-            for ( idx_t jlon = region.lat_begin.at( jlat ); jlon <= region.lat_end.at( jlat ); ++jlon ) {
-                if ( jlon < rg.nx( jlat ) ) {
-                    n = offset_glb.at( jlat ) + jlon;
-                    if ( parts.at( n ) == mypart ) {
-                        node_numbering.at( jnode ) = node_number;
-                        ++node_number;
-                    }
-                    else {
-                        ghost_nodes.emplace_back( jlat, jlon, jnode );
-                    }
-                    ++jnode;
-                }
-                else if ( include_periodic_ghost_points )  // add periodic point
-                {
-                    //#warning TODO: use commented approach
-                    part( jnode ) = mypart;
-                    // part(jnode)      = parts.at( offset_glb.at(jlat) );
-                    ghost( jnode ) = 1;
-                    halo( jnode )  = 0;
-                    ghost_nodes.emplace_back( jlat, rg.nx( jlat ), jnode );
-                    ++jnode;
-                }
-                else {
-                    --l;
-                }
+        // Owned nodes are numbered first and ghost nodes after, both in the order of the latitudes.
+        // With the number of owned and ghost nodes per latitude, every latitude is numbered independently.
+        std::vector<idx_t> owned_offset( nb_region_lats + 1, 0 );
+        std::vector<idx_t> ghost_offset( nb_region_lats + 1, 0 );
+        atlas_omp_parallel_for( idx_t ilat = 0; ilat < nb_region_lats; ++ilat ) {
+            idx_t nb_owned = 0;
+            for ( idx_t jnode = offset_loc[ilat]; jnode < offset_loc[ilat + 1]; ++jnode ) {
+                nb_owned += ( node_part[jnode] == mypart );
             }
+            owned_offset[ilat + 1] = nb_owned;
+            ghost_offset[ilat + 1] = offset_loc[ilat + 1] - offset_loc[ilat] - nb_owned;
         }
-        for ( size_t jghost = 0; jghost < ghost_nodes.size(); ++jghost ) {
-            node_numbering.at( ghost_nodes.at( jghost ).jnode ) = node_number;
-            ++node_number;
+        for ( idx_t ilat = 0; ilat < nb_region_lats; ++ilat ) {
+            owned_offset[ilat + 1] += owned_offset[ilat];
+            ghost_offset[ilat + 1] += ghost_offset[ilat];
         }
+        const idx_t nb_owned = owned_offset[nb_region_lats];
+        atlas_omp_parallel_for( idx_t ilat = 0; ilat < nb_region_lats; ++ilat ) {
+            idx_t owned_number = owned_offset[ilat];
+            idx_t ghost_number = nb_owned + ghost_offset[ilat];
+            for ( idx_t jnode = offset_loc[ilat]; jnode < offset_loc[ilat + 1]; ++jnode ) {
+                node_numbering[jnode] = ( node_part[jnode] == mypart ) ? owned_number++ : ghost_number++;
+            }
+        }
+        idx_t jnode = nb_region_nodes;
         if ( include_north_pole ) {
             node_numbering.at( jnode ) = jnode;
             ++jnode;
@@ -966,27 +962,20 @@ void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const atl
     }
     else  // No renumbering
     {
-        for ( idx_t jnode = 0; jnode < nnodes; ++jnode ) {
-            node_numbering.at( jnode ) = jnode;
-        }
+        atlas_omp_parallel_for( idx_t jnode = 0; jnode < nnodes; ++jnode ) { node_numbering[jnode] = jnode; }
     }
 
-    idx_t jnode = 0;
-    l           = 0;
-    for ( idx_t jlat = region.north; jlat <= region.south; ++jlat ) {
-        idx_t ilat            = jlat - region.north;
-        offset_loc.at( ilat ) = l;
-        l += region.lat_end.at( jlat ) - region.lat_begin.at( jlat ) + 1;
+    atlas_omp_parallel_for( idx_t ilat = 0; ilat < nb_region_lats; ++ilat ) {
+        const idx_t jlat = region.north + ilat;
+        idx_t jnode      = offset_loc[ilat];
 
         double y = rg.y( jlat );
-        for ( idx_t jlon = region.lat_begin.at( jlat ); jlon <= region.lat_end.at( jlat ); ++jlon ) {
+        for ( idx_t jlon = region.lat_begin[jlat]; jlon <= region.lat_end[jlat]; ++jlon ) {
             if ( jlon < rg.nx( jlat ) ) {
-                idx_t inode = node_numbering.at( jnode );
-                n           = offset_glb.at( jlat ) + jlon;
+                idx_t inode = node_numbering[jnode];
+                int n       = offset_glb[jlat] + jlon;
 
                 double x = rg.x( jlon, jlat );
-                // std::cout << "jlat = " << jlat << "; jlon = " << jlon << "; x = " <<
-                // x << std::endl;
                 if ( stagger && ( jlat + 1 ) % 2 == 0 ) {
                     x += 180. / static_cast<double>( rg.nx( jlat ) );
                 }
@@ -1001,7 +990,7 @@ void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const atl
                 lonlat( inode, LAT ) = crd[LAT];
 
                 glb_idx( inode ) = n + 1;
-                part( inode )    = parts.at( n );
+                part( inode )    = node_part[jnode];
                 ghost( inode )   = 0;
                 halo( inode )    = 0;
                 Topology::reset( flags( inode ) );
@@ -1022,9 +1011,8 @@ void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const atl
             }
             else if ( include_periodic_ghost_points )  // add periodic point
             {
-                idx_t inode = node_numbering.at( jnode );
-                // int inode_left = node_numbering.at(jnode-1);
-                double x = rg.x( rg.nx( jlat ), jlat );
+                idx_t inode = node_numbering[jnode];
+                double x    = rg.x( rg.nx( jlat ), jlat );
                 if ( stagger && ( jlat + 1 ) % 2 == 0 ) {
                     x += 180. / static_cast<double>( rg.nx( jlat ) );
                 }
@@ -1038,7 +1026,7 @@ void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const atl
                 lonlat( inode, LON ) = crd[LON];
                 lonlat( inode, LAT ) = crd[LAT];
 
-                glb_idx( inode ) = periodic_glb.at( jlat ) + 1;
+                glb_idx( inode ) = periodic_glb[jlat] + 1;
                 //#warning TODO: use commented approach
                 //        part(inode)      = parts.at( offset_glb.at(jlat) );
                 part( inode )  = mypart;  // The actual part will be fixed later
@@ -1049,12 +1037,10 @@ void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const atl
                 Topology::set( flags( inode ), Topology::GHOST );
                 ++jnode;
             }
-            else {
-                --l;
-            }
         }
-    };
+    }
 
+    idx_t jnode  = nb_region_nodes;
     idx_t jnorth = -1;
     if ( include_north_pole ) {
         idx_t inode     = node_numbering.at( jnode );
@@ -1129,22 +1115,33 @@ void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const atl
     /*
      * Fill in connectivity tables with global node indices first
      */
-    idx_t jcell;
-    idx_t jquad       = 0;
-    idx_t jtriag      = 0;
     idx_t quad_begin  = mesh.cells().elements( 0 ).begin();
     idx_t triag_begin = mesh.cells().elements( 1 ).begin();
-    idx_t quad_nodes[4];
-    idx_t triag_nodes[3];
 
+    // First quadrilateral and triangle of every row of elements (prefix sum), so that rows can be filled independently
+    std::vector<idx_t> lat_quad_offset( nb_region_lats, 0 );
+    std::vector<idx_t> lat_triag_offset( nb_region_lats, 0 );
     for ( idx_t jlat = region.north; jlat < region.south; ++jlat ) {
-        idx_t ilat  = jlat - region.north;
-        idx_t jlatN = jlat;
-        idx_t jlatS = jlat + 1;
-        idx_t ilatN = ilat;
-        idx_t ilatS = ilat + 1;
+        idx_t ilat                 = jlat - region.north;
+        idx_t nb_quads             = region.nb_lat_quads.at( jlat );
+        lat_quad_offset[ilat + 1]  = lat_quad_offset[ilat] + nb_quads;
+        lat_triag_offset[ilat + 1] = lat_triag_offset[ilat] + region.nb_lat_elems.at( jlat ) - nb_quads;
+    }
+
+    const auto elems = array::make_view<int, 3>( *region.elems );
+    atlas_omp_parallel_for( idx_t jlat = region.north; jlat < region.south; ++jlat ) {
+        idx_t ilat   = jlat - region.north;
+        idx_t jlatN  = jlat;
+        idx_t jlatS  = jlat + 1;
+        idx_t ilatN  = ilat;
+        idx_t ilatS  = ilat + 1;
+        idx_t jquad  = lat_quad_offset[ilat];
+        idx_t jtriag = lat_triag_offset[ilat];
+        idx_t jcell;
+        idx_t quad_nodes[4];
+        idx_t triag_nodes[3];
         for ( idx_t jelem = 0; jelem < region.nb_lat_elems.at( jlat ); ++jelem ) {
-            const auto elem = array::make_view<int, 3>( *region.elems ).slice( ilat, jelem, Range::all() );
+            const auto elem = elems.slice( jlat - region.elems_north, jelem, Range::all() );
 
             if ( elem( 2 ) >= 0 && elem( 3 ) >= 0 )  // This is a quad
             {
@@ -1211,6 +1208,11 @@ void StructuredMeshGenerator::generate_mesh( const StructuredGrid& rg, const atl
         }
     }
 
+    // Pole triangles follow the triangles of all rows
+    idx_t jtriag = lat_triag_offset[nb_region_lats - 1];
+    idx_t jcell;
+    idx_t triag_nodes[3];
+
     if ( include_north_pole ) {
         idx_t ilat = 0;
         idx_t ip1  = 0;
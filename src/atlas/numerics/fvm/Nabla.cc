@@ -13,6 +13,7 @@
 #include "atlas/array/ArrayView.h"
 #include "atlas/array/MakeView.h"
 #include "atlas/field/Field.h"
+#include "atlas/functionspace/NodeColumns.h"
 #include "atlas/mesh/HybridElements.h"
 #include "atlas/mesh/Mesh.h"
 #include "atlas/mesh/Nodes.h"
@@ -21,6 +22,7 @@
 #include "atlas/parallel/omp/omp.h"
 #include "atlas/runtime/Exception.h"
 #include "atlas/runtime/Log.h"
+#include "atlas/runtime/Trace.h"
 #include "atlas/util/CoordinateEnums.h"
 
 // =======================================================
@@ -34,7 +36,11 @@ namespace fvm {
 
 namespace {
 static NablaBuilder<Nabla> __fvm_nabla( "fvm" );
+
+bool is_float( const Field& field ) {
+    return field.datatype() == array::DataType::kind<float>();
 }
+}  // namespace
 
 Nabla::Nabla( const numerics::Method& method, const eckit::Parametrisation& p ) :
     atlas::numerics::NablaImpl( method, p ) {
@@ -52,6 +58,7 @@ Nabla::~Nabla() = default;
 
 void Nabla::setup() {
     const mesh::Edges& edges = fvm_->mesh().edges();
+    const mesh::Nodes& nodes = fvm_->mesh().nodes();
 
     const idx_t nedges = fvm_->edge_columns().nb_edges();
 
@@ -71,17 +78,27 @@ void Nabla::setup() {
     for ( idx_t jedge = 0; jedge < c; ++jedge ) {
         pole_edges_.push_back( tmp[jedge] );
     }
+
+    const double deg2rad  = M_PI / 180.;
+    const auto lonlat_deg = array::make_view<double, 2>( nodes.lonlat() );
+    cos_lat_.resize( nodes.size() );
+    atlas_omp_parallel_for( idx_t jnode = 0; jnode < nodes.size(); ++jnode ) {
+        cos_lat_[jnode] = std::cos( lonlat_deg( jnode, LAT ) * deg2rad );
+    }
 }
 
 void Nabla::gradient( const Field& field, Field& grad_field ) const {
     if ( field.variables() > 1 ) {
-        return gradient_of_vector( field, grad_field );
+        return is_float( field ) ? gradient_of_vector<float>( field, grad_field )
+                                 : gradient_of_vector<double>( field, grad_field );
     }
     else {
-        return gradient_of_scalar( field, grad_field );
+        return is_float( field ) ? gradient_of_scalar<float>( field, grad_field )
+                                 : gradient_of_scalar<double>( field, grad_field );
     }
 }
 
+template <typename Value>
 void Nabla::gradient_of_scalar( const Field& scalar_field, Field& grad_field ) const {
     Log::debug() << "Compute gradient of scalar field " << scalar_field.name() << " with fvm method" << std::endl;
     const double radius  = fvm_->radius();
@@ -91,6 +108,7 @@ void Nabla::gradient_of_scalar( const Field& scalar_field, Field& grad_field ) c
     const mesh::Nodes& nodes = fvm_->mesh().nodes();
 
     const idx_t nnodes = fvm_->node_columns().nb_nodes();
+    ATLAS_ASSERT( cos_lat_.size() >= size_t( nodes.size() ), "Mesh nodes were added after setting up the Nabla" );
     const idx_t nedges = fvm_->edge_columns().nb_edges();
     const idx_t nlev   = scalar_field.levels() ? scalar_field.levels() : 1;
     if ( ( grad_field.levels() ? grad_field.levels() : 1 ) != nlev ) {
@@ -98,13 +116,12 @@ void Nabla::gradient_of_scalar( const Field& scalar_field, Field& grad_field ) c
     }
 
     const auto scalar = scalar_field.levels()
-                            ? array::make_view<double, 2>( scalar_field ).slice( Range::all(), Range::all() )
-                            : array::make_view<double, 1>( scalar_field ).slice( Range::all(), Range::dummy() );
+                            ? array::make_view<Value, 2>( scalar_field ).slice( Range::all(), Range::all() )
+                            : array::make_view<Value, 1>( scalar_field ).slice( Range::all(), Range::dummy() );
     auto grad = grad_field.levels()
-                    ? array::make_view<double, 3>( grad_field ).slice( Range::all(), Range::all(), Range::all() )
-                    : array::make_view<double, 2>( grad_field ).slice( Range::all(), Range::dummy(), Range::all() );
+                    ? array::make_view<Value, 3>( grad_field ).slice( Range::all(), Range::all(), Range::all() )
+                    : array::make_view<Value, 2>( grad_field ).slice( Range::all(), Range::dummy(), Range::all() );
 
-    const auto lonlat_deg     = array::make_view<double, 2>( nodes.lonlat() );
     const auto dual_volumes   = array::make_view<double, 1>( nodes.field( "dual_volumes" ) );
     const auto dual_normals   = array::make_view<double, 2>( edges.field( "dual_normals" ) );
     const auto node2edge_sign = array::make_view<double, 2>( nodes.field( "node2edge_sign" ) );
@@ -112,51 +129,41 @@ void Nabla::gradient_of_scalar( const Field& scalar_field, Field& grad_field ) c
     const mesh::Connectivity& node2edge           = nodes.edge_connectivity();
     const mesh::MultiBlockConnectivity& edge2node = edges.node_connectivity();
 
-    array::ArrayT<double> avgS_arr( nedges, nlev, 2ul );
-    auto avgS = array::make_view<double, 3>( avgS_arr );
-
     const double scale = deg2rad * deg2rad * radius;
 
-    atlas_omp_parallel {
-        atlas_omp_for( idx_t jedge = 0; jedge < nedges; ++jedge ) {
-            idx_t ip1 = edge2node( jedge, 0 );
-            idx_t ip2 = edge2node( jedge, 1 );
-
-            for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                double avg               = ( scalar( ip1, jlev ) + scalar( ip2, jlev ) ) * 0.5;
-                avgS( jedge, jlev, LON ) = dual_normals( jedge, LON ) * deg2rad * avg;
-                avgS( jedge, jlev, LAT ) = dual_normals( jedge, LAT ) * deg2rad * avg;
-            }
+    // The flux through every edge is added directly to both its nodes
+    atlas_omp_parallel_for( idx_t jnode = 0; jnode < nnodes; ++jnode ) {
+        for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+            grad( jnode, jlev, LON ) = 0.;
+            grad( jnode, jlev, LAT ) = 0.;
         }
-
-        atlas_omp_for( idx_t jnode = 0; jnode < nnodes; ++jnode ) {
-            for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                grad( jnode, jlev, LON ) = 0.;
-                grad( jnode, jlev, LAT ) = 0.;
-            }
-            for ( idx_t jedge = 0; jedge < node2edge.cols( jnode ); ++jedge ) {
-                const idx_t iedge = node2edge( jnode, jedge );
-                if ( iedge < nedges ) {
-                    const double add = node2edge_sign( jnode, jedge );
-                    for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                        grad( jnode, jlev, LON ) += add * avgS( iedge, jlev, LON );
-                        grad( jnode, jlev, LAT ) += add * avgS( iedge, jlev, LAT );
-                    }
+        for ( idx_t jedge = 0; jedge < node2edge.cols( jnode ); ++jedge ) {
+            const idx_t iedge = node2edge( jnode, jedge );
+            if ( iedge < nedges ) {
+                const double add = node2edge_sign( jnode, jedge );
+                const idx_t ip1  = edge2node( iedge, 0 );
+                const idx_t ip2  = edge2node( iedge, 1 );
+                const double Sx  = dual_normals( iedge, LON ) * deg2rad;
+                const double Sy  = dual_normals( iedge, LAT ) * deg2rad;
+                for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+                    const double avg = ( scalar( ip1, jlev ) + scalar( ip2, jlev ) ) * 0.5;
+                    grad( jnode, jlev, LON ) += add * ( Sx * avg );
+                    grad( jnode, jlev, LAT ) += add * ( Sy * avg );
                 }
             }
-            const double y        = lonlat_deg( jnode, LAT ) * deg2rad;
-            const double metric_y = 1. / ( dual_volumes( jnode ) * scale );
-            const double metric_x = metric_y / std::cos( y );
-            for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                grad( jnode, jlev, LON ) *= metric_x;
-                grad( jnode, jlev, LAT ) *= metric_y;
-            }
+        }
+        const double metric_y = 1. / ( dual_volumes( jnode ) * scale );
+        const double metric_x = metric_y / cos_lat_[jnode];
+        for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+            grad( jnode, jlev, LON ) *= metric_x;
+            grad( jnode, jlev, LAT ) *= metric_y;
         }
     }
 }
 
 // ================================================================================
 
+template <typename Value>
 void Nabla::gradient_of_vector( const Field& vector_field, Field& grad_field ) const {
     Log::debug() << "Compute gradient of vector field " << vector_field.name() << " with fvm method" << std::endl;
     const double radius  = fvm_->radius();
@@ -166,6 +173,7 @@ void Nabla::gradient_of_vector( const Field& vector_field, Field& grad_field ) c
     const mesh::Nodes& nodes = fvm_->mesh().nodes();
 
     const idx_t nnodes = fvm_->node_columns().nb_nodes();
+    ATLAS_ASSERT( cos_lat_.size() >= size_t( nodes.size() ), "Mesh nodes were added after setting up the Nabla" );
     const idx_t nedges = fvm_->edge_columns().nb_edges();
     const idx_t nlev   = vector_field.levels();
     if ( vector_field.levels() != nlev ) {
@@ -174,13 +182,12 @@ void Nabla::gradient_of_vector( const Field& vector_field, Field& grad_field ) c
 
     const auto vector =
         vector_field.levels()
-            ? array::make_view<double, 3>( vector_field ).slice( Range::all(), Range::all(), Range::all() )
-            : array::make_view<double, 2>( vector_field ).slice( Range::all(), Range::dummy(), Range::all() );
+            ? array::make_view<Value, 3>( vector_field ).slice( Range::all(), Range::all(), Range::all() )
+            : array::make_view<Value, 2>( vector_field ).slice( Range::all(), Range::dummy(), Range::all() );
     auto grad = grad_field.levels()
-                    ? array::make_view<double, 3>( grad_field ).slice( Range::all(), Range::all(), Range::all() )
-                    : array::make_view<double, 2>( grad_field ).slice( Range::all(), Range::dummy(), Range::all() );
+                    ? array::make_view<Value, 3>( grad_field ).slice( Range::all(), Range::all(), Range::all() )
+                    : array::make_view<Value, 2>( grad_field ).slice( Range::all(), Range::dummy(), Range::all() );
 
-    const auto lonlat_deg     = array::make_view<double, 2>( nodes.lonlat() );
     const auto dual_volumes   = array::make_view<double, 1>( nodes.field( "dual_volumes" ) );
     const auto dual_normals   = array::make_view<double, 2>( edges.field( "dual_normals" ) );
     const auto node2edge_sign = array::make_view<double, 2>( nodes.field( "node2edge_sign" ) );
@@ -190,9 +197,6 @@ void Nabla::gradient_of_vector( const Field& vector_field, Field& grad_field ) c
     const mesh::Connectivity& node2edge           = nodes.edge_connectivity();
     const mesh::MultiBlockConnectivity& edge2node = edges.node_connectivity();
 
-    array::ArrayT<double> avgS_arr( nedges, nlev, 4ul );
-    array::ArrayView<double, 3> avgS = array::make_view<double, 3>( avgS_arr );
-
     const double scale = deg2rad * deg2rad * radius;
 
     enum
@@ -203,62 +207,60 @@ void Nabla::gradient_of_vector( const Field& vector_field, Field& grad_field ) c
         LATdLAT = 3
     };
 
-    atlas_omp_parallel {
-        atlas_omp_for( idx_t jedge = 0; jedge < nedges; ++jedge ) {
-            idx_t ip1  = edge2node( jedge, 0 );
-            idx_t ip2  = edge2node( jedge, 1 );
-            double pbc = 1. - 2. * is_pole_edge( jedge );
-
-            for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                double avg[2]                = {( vector( ip1, jlev, LON ) + pbc * vector( ip2, jlev, LON ) ) * 0.5,
-                                 ( vector( ip1, jlev, LAT ) + pbc * vector( ip2, jlev, LAT ) ) * 0.5};
-                avgS( jedge, jlev, LONdLON ) = dual_normals( jedge, LON ) * deg2rad * avg[LON];
-                // above = 0 at pole because of dual_normals
-                avgS( jedge, jlev, LONdLAT ) = dual_normals( jedge, LAT ) * deg2rad * avg[LON];
-                avgS( jedge, jlev, LATdLON ) = dual_normals( jedge, LON ) * deg2rad * avg[LAT];
-                // above = 0 at pole because of dual_normals
-                avgS( jedge, jlev, LATdLAT ) = dual_normals( jedge, LAT ) * deg2rad * avg[LAT];
-            }
-        }
+    // Average of the vector over an edge, with sign flip of the second node across the pole
+    auto edge_average = [&]( idx_t iedge, idx_t jlev, double avg[] ) {
+        const idx_t ip1  = edge2node( iedge, 0 );
+        const idx_t ip2  = edge2node( iedge, 1 );
+        const double pbc = 1. - 2. * is_pole_edge( iedge );
+        avg[LON]         = ( vector( ip1, jlev, LON ) + pbc * vector( ip2, jlev, LON ) ) * 0.5;
+        avg[LAT]         = ( vector( ip1, jlev, LAT ) + pbc * vector( ip2, jlev, LAT ) ) * 0.5;
+    };
 
-        atlas_omp_for( idx_t jnode = 0; jnode < nnodes; ++jnode ) {
-            for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                grad( jnode, jlev, LONdLON ) = 0.;
-                grad( jnode, jlev, LONdLAT ) = 0.;
-                grad( jnode, jlev, LATdLON ) = 0.;
-                grad( jnode, jlev, LATdLAT ) = 0.;
-            }
-            for ( idx_t jedge = 0; jedge < node2edge.cols( jnode ); ++jedge ) {
-                const idx_t iedge = node2edge( jnode, jedge );
-                if ( iedge < nedges ) {
-                    double add = node2edge_sign( jnode, jedge );
-                    for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                        grad( jnode, jlev, LONdLON ) += add * avgS( iedge, jlev, LONdLON );
-                        grad( jnode, jlev, LONdLAT ) += add * avgS( iedge, jlev, LONdLAT );
-                        grad( jnode, jlev, LATdLON ) += add * avgS( iedge, jlev, LATdLON );
-                        grad( jnode, jlev, LATdLAT ) += add * avgS( iedge, jlev, LATdLAT );
-                    }
+    // The flux through every edge is added directly to both its nodes
+    atlas_omp_parallel_for( idx_t jnode = 0; jnode < nnodes; ++jnode ) {
+        for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+            grad( jnode, jlev, LONdLON ) = 0.;
+            grad( jnode, jlev, LONdLAT ) = 0.;
+            grad( jnode, jlev, LATdLON ) = 0.;
+            grad( jnode, jlev, LATdLAT ) = 0.;
+        }
+        for ( idx_t jedge = 0; jedge < node2edge.cols( jnode ); ++jedge ) {
+            const idx_t iedge = node2edge( jnode, jedge );
+            if ( iedge < nedges ) {
+                const double add = node2edge_sign( jnode, jedge );
+                const double Sx  = dual_normals( iedge, LON ) * deg2rad;
+                const double Sy  = dual_normals( iedge, LAT ) * deg2rad;
+                for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+                    double avg[2];
+                    edge_average( iedge, jlev, avg );
+                    // LONdLON and LATdLON are 0 at pole because of dual_normals
+                    grad( jnode, jlev, LONdLON ) += add * ( Sx * avg[LON] );
+                    grad( jnode, jlev, LONdLAT ) += add * ( Sy * avg[LON] );
+                    grad( jnode, jlev, LATdLON ) += add * ( Sx * avg[LAT] );
+                    grad( jnode, jlev, LATdLAT ) += add * ( Sy * avg[LAT] );
                 }
             }
-            const double y        = lonlat_deg( jnode, LAT ) * deg2rad;
-            const double metric_y = 1. / ( dual_volumes( jnode ) * scale );
-            const double metric_x = metric_y / std::cos( y );
-            for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                grad( jnode, jlev, LONdLON ) *= metric_x;
-                grad( jnode, jlev, LATdLON ) *= metric_x;
-                grad( jnode, jlev, LONdLAT ) *= metric_y;
-                grad( jnode, jlev, LATdLAT ) *= metric_y;
-            }
+        }
+        const double metric_y = 1. / ( dual_volumes( jnode ) * scale );
+        const double metric_x = metric_y / cos_lat_[jnode];
+        for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+            grad( jnode, jlev, LONdLON ) *= metric_x;
+            grad( jnode, jlev, LATdLON ) *= metric_x;
+            grad( jnode, jlev, LONdLAT ) *= metric_y;
+            grad( jnode, jlev, LATdLAT ) *= metric_y;
         }
     }
     // Fix wrong node2edge_sign for vector quantities
     for ( size_t jedge = 0; jedge < pole_edges_.size(); ++jedge ) {
         const idx_t iedge     = pole_edges_[jedge];
         const idx_t jnode     = edge2node( iedge, 1 );
+        const double Sy       = dual_normals( iedge, LAT ) * deg2rad;
         const double metric_y = 1. / ( dual_volumes( jnode ) * scale );
         for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-            grad( jnode, jlev, LONdLAT ) -= 2. * avgS( iedge, jlev, LONdLAT ) * metric_y;
-            grad( jnode, jlev, LATdLAT ) -= 2. * avgS( iedge, jlev, LATdLAT ) * metric_y;
+            double avg[2];
+            edge_average( iedge, jlev, avg );
+            grad( jnode, jlev, LONdLAT ) -= 2. * ( Sy * avg[LON] ) * metric_y;
+            grad( jnode, jlev, LATdLAT ) -= 2. * ( Sy * avg[LAT] ) * metric_y;
         }
     }
 }
@@ -266,6 +268,12 @@ void Nabla::gradient_of_vector( const Field& vector_field, Field& grad_field ) c
 // ================================================================================
 
 void Nabla::divergence( const Field& vector_field, Field& div_field ) const {
+    return is_float( vector_field ) ? divergence_of_vector<float>( vector_field, div_field )
+                                    : divergence_of_vector<double>( vector_field, div_field );
+}
+
+template <typename Value>
+void Nabla::divergence_of_vector( const Field& vector_field, Field& div_field ) const {
     const double radius  = fvm_->radius();
     const double deg2rad = M_PI / 180.;
 
@@ -273,6 +281,7 @@ void Nabla::divergence( const Field& vector_field, Field& div_field ) const {
     const mesh::Nodes& nodes = fvm_->mesh().nodes();
 
     const idx_t nnodes = fvm_->node_columns().nb_nodes();
+    ATLAS_ASSERT( cos_lat_.size() >= size_t( nodes.size() ), "Mesh nodes were added after setting up the Nabla" );
     const idx_t nedges = fvm_->edge_columns().nb_edges();
     const idx_t nlev   = vector_field.levels();
     if ( div_field.levels() != nlev ) {
@@ -281,12 +290,11 @@ void Nabla::divergence( const Field& vector_field, Field& div_field ) const {
 
     const auto vector =
         vector_field.levels()
-            ? array::make_view<double, 3>( vector_field ).slice( Range::all(), Range::all(), Range::all() )
-            : array::make_view<double, 2>( vector_field ).slice( Range::all(), Range::dummy(), Range::all() );
-    auto div = div_field.levels() ? array::make_view<double, 2>( div_field ).slice( Range::all(), Range::all() )
-                                  : array::make_view<double, 1>( div_field ).slice( Range::all(), Range::dummy() );
+            ? array::make_view<Value, 3>( vector_field ).slice( Range::all(), Range::all(), Range::all() )
+            : array::make_view<Value, 2>( vector_field ).slice( Range::all(), Range::dummy(), Range::all() );
+    auto div = div_field.levels() ? array::make_view<Value, 2>( div_field ).slice( Range::all(), Range::all() )
+                                  : array::make_view<Value, 1>( div_field ).slice( Range::all(), Range::dummy() );
 
-    const auto lonlat_deg     = array::make_view<double, 2>( nodes.lonlat() );
     const auto dual_volumes   = array::make_view<double, 1>( nodes.field( "dual_volumes" ) );
     const auto dual_normals   = array::make_view<double, 2>( edges.field( "dual_normals" ) );
     const auto node2edge_sign = array::make_view<double, 2>( nodes.field( "node2edge_sign" ) );
@@ -296,61 +304,52 @@ void Nabla::divergence( const Field& vector_field, Field& div_field ) const {
     const mesh::Connectivity& node2edge           = nodes.edge_connectivity();
     const mesh::MultiBlockConnectivity& edge2node = edges.node_connectivity();
 
-    array::ArrayT<double> avgS_arr( nedges, nlev, 2ul );
-    array::ArrayView<double, 3> avgS = array::make_view<double, 3>( avgS_arr );
-
     const double scale = deg2rad * deg2rad * radius;
 
-    atlas_omp_parallel {
-        atlas_omp_for( idx_t jedge = 0; jedge < nedges; ++jedge ) {
-            idx_t ip1    = edge2node( jedge, 0 );
-            idx_t ip2    = edge2node( jedge, 1 );
-            double y1    = lonlat_deg( ip1, LAT ) * deg2rad;
-            double y2    = lonlat_deg( ip2, LAT ) * deg2rad;
-            double cosy1 = std::cos( y1 );
-            double cosy2 = std::cos( y2 );
-
-            double pbc = 1. - is_pole_edge( jedge );
-
-            for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                double avg[2] = {
-                    ( vector( ip1, jlev, LON ) + vector( ip2, jlev, LON ) ) * 0.5,
-                    ( cosy1 * vector( ip1, jlev, LAT ) + cosy2 * vector( ip2, jlev, LAT ) ) * 0.5 *
-                        pbc  // (force cos(y)=0 at pole)
-                };
-                avgS( jedge, jlev, LON ) = dual_normals( jedge, LON ) * deg2rad * avg[LON];
-                // above = 0 at pole by construction of S
-                avgS( jedge, jlev, LAT ) = dual_normals( jedge, LAT ) * deg2rad * avg[LAT];
-                // above = 0 at pole by construction of pbc
-                // We don't need the cross terms for divergence,
-                //    i.e.      dual_normals(jedge,LON)*deg2rad*avg[LAT]
-                //        and   dual_normals(jedge,LAT)*deg2rad*avg[LON]
-            }
+    // The flux through every edge is added directly to both its nodes
+    atlas_omp_parallel_for( idx_t jnode = 0; jnode < nnodes; ++jnode ) {
+        for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+            div( jnode, jlev ) = 0.;
         }
-
-        atlas_omp_for( idx_t jnode = 0; jnode < nnodes; ++jnode ) {
-            for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                div( jnode, jlev ) = 0.;
-            }
-            for ( idx_t jedge = 0; jedge < node2edge.cols( jnode ); ++jedge ) {
-                idx_t iedge = node2edge( jnode, jedge );
-                if ( iedge < nedges ) {
-                    double add = node2edge_sign( jnode, jedge );
-                    for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                        div( jnode, jlev ) += add * ( avgS( iedge, jlev, LON ) + avgS( iedge, jlev, LAT ) );
-                    }
+        for ( idx_t jedge = 0; jedge < node2edge.cols( jnode ); ++jedge ) {
+            const idx_t iedge = node2edge( jnode, jedge );
+            if ( iedge < nedges ) {
+                const double add   = node2edge_sign( jnode, jedge );
+                const idx_t ip1    = edge2node( iedge, 0 );
+                const idx_t ip2    = edge2node( iedge, 1 );
+                const double cosy1 = cos_lat_[ip1];
+                const double cosy2 = cos_lat_[ip2];
+                const double pbc   = 1. - is_pole_edge( iedge );
+                const double Sx    = dual_normals( iedge, LON ) * deg2rad;
+                const double Sy    = dual_normals( iedge, LAT ) * deg2rad;
+                for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+                    double avg[2] = {
+                        ( vector( ip1, jlev, LON ) + vector( ip2, jlev, LON ) ) * 0.5,
+                        ( cosy1 * vector( ip1, jlev, LAT ) + cosy2 * vector( ip2, jlev, LAT ) ) * 0.5 *
+                            pbc  // (force cos(y)=0 at pole)
+                    };
+                    // Sx * avg[LON] = 0 at pole by construction of S, Sy * avg[LAT] = 0 at pole by construction of pbc
+                    // We don't need the cross terms for divergence,
+                    //    i.e.      Sx * avg[LAT]
+                    //        and   Sy * avg[LON]
+                    div( jnode, jlev ) += add * ( Sx * avg[LON] + Sy * avg[LAT] );
                 }
             }
-            const double y = lonlat_deg( jnode, LAT ) * deg2rad;
-            double metric  = 1. / ( dual_volumes( jnode ) * scale * std::cos( y ) );
-            for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                div( jnode, jlev ) *= metric;
-            }
+        }
+        const double metric = 1. / ( dual_volumes( jnode ) * scale * cos_lat_[jnode] );
+        for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+            div( jnode, jlev ) *= metric;
         }
     }
 }
 
 void Nabla::curl( const Field& vector_field, Field& curl_field ) const {
+    return is_float( vector_field ) ? curl_of_vector<float>( vector_field, curl_field )
+                                    : curl_of_vector<double>( vector_field, curl_field );
+}
+
+template <typename Value>
+void Nabla::curl_of_vector( const Field& vector_field, Field& curl_field ) const {
     const double radius  = fvm_->radius();
     const double deg2rad = M_PI / 180.;
 
@@ -358,6 +357,7 @@ void Nabla::curl( const Field& vector_field, Field& curl_field ) const {
     const mesh::Nodes& nodes = fvm_->mesh().nodes();
 
     const idx_t nnodes = fvm_->node_columns().nb_nodes();
+    ATLAS_ASSERT( cos_lat_.size() >= size_t( nodes.size() ), "Mesh nodes were added after setting up the Nabla" );
     const idx_t nedges = fvm_->edge_columns().nb_edges();
     const idx_t nlev   = vector_field.levels();
     if ( curl_field.levels() != nlev ) {
@@ -366,12 +366,11 @@ void Nabla::curl( const Field& vector_field, Field& curl_field ) const {
 
     const auto vector =
         vector_field.levels()
-            ? array::make_view<double, 3>( vector_field ).slice( Range::all(), Range::all(), Range::all() )
-            : array::make_view<double, 2>( vector_field ).slice( Range::all(), Range::dummy(), Range::all() );
-    auto curl = curl_field.levels() ? array::make_view<double, 2>( curl_field ).slice( Range::all(), Range::all() )
-                                    : array::make_view<double, 1>( curl_field ).slice( Range::all(), Range::dummy() );
+            ? array::make_view<Value, 3>( vector_field ).slice( Range::all(), Range::all(), Range::all() )
+            : array::make_view<Value, 2>( vector_field ).slice( Range::all(), Range::dummy(), Range::all() );
+    auto curl = curl_field.levels() ? array::make_view<Value, 2>( curl_field ).slice( Range::all(), Range::all() )
+                                    : array::make_view<Value, 1>( curl_field ).slice( Range::all(), Range::dummy() );
 
-    const auto lonlat_deg     = array::make_view<double, 2>( nodes.lonlat() );
     const auto dual_volumes   = array::make_view<double, 1>( nodes.field( "dual_volumes" ) );
     const auto dual_normals   = array::make_view<double, 2>( edges.field( "dual_normals" ) );
     const auto node2edge_sign = array::make_view<double, 2>( nodes.field( "node2edge_sign" ) );
@@ -381,66 +380,57 @@ void Nabla::curl( const Field& vector_field, Field& curl_field ) const {
     const mesh::Connectivity& node2edge           = nodes.edge_connectivity();
     const mesh::MultiBlockConnectivity& edge2node = edges.node_connectivity();
 
-    array::ArrayT<double> avgS_arr( nedges, nlev, 2ul );
-    array::ArrayView<double, 3> avgS = array::make_view<double, 3>( avgS_arr );
-
     const double scale = deg2rad * deg2rad * radius * radius;
 
-    atlas_omp_parallel {
-        atlas_omp_for( idx_t jedge = 0; jedge < nedges; ++jedge ) {
-            idx_t ip1     = edge2node( jedge, 0 );
-            idx_t ip2     = edge2node( jedge, 1 );
-            double y1     = lonlat_deg( ip1, LAT ) * deg2rad;
-            double y2     = lonlat_deg( ip2, LAT ) * deg2rad;
-            double rcosy1 = radius * std::cos( y1 );
-            double rcosy2 = radius * std::cos( y2 );
-
-            double pbc = 1 - is_pole_edge( jedge );
-
-            for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                double avg[2] = {( rcosy1 * vector( ip1, jlev, LON ) + rcosy2 * vector( ip2, jlev, LON ) ) * 0.5 *
-                                     pbc,  // (force R*cos(y)=0 at pole)
-                                 ( radius * vector( ip1, jlev, LAT ) + radius * vector( ip2, jlev, LAT ) ) * 0.5};
-                avgS( jedge, jlev, LON ) = dual_normals( jedge, LAT ) * deg2rad * avg[LON];
-                // above = 0 at pole by construction of pbc
-                avgS( jedge, jlev, LAT ) = dual_normals( jedge, LON ) * deg2rad * avg[LAT];
-                // above = 0 at pole by construction of S
-                // We don't need the non-cross terms for curl, i.e.
-                //          dual_normals(jedge,LON)*deg2rad*avg[LON]
-                //   and    dual_normals(jedge,LAT)*deg2rad*avg[LAT]
-            }
+    // The flux through every edge is added directly to both its nodes
+    atlas_omp_parallel_for( idx_t jnode = 0; jnode < nnodes; ++jnode ) {
+        for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+            curl( jnode, jlev ) = 0.;
         }
-
-        atlas_omp_for( idx_t jnode = 0; jnode < nnodes; ++jnode ) {
-            for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                curl( jnode, jlev ) = 0.;
-            }
-            for ( idx_t jedge = 0; jedge < node2edge.cols( jnode ); ++jedge ) {
-                idx_t iedge = node2edge( jnode, jedge );
-                if ( iedge < nedges ) {
-                    double add = node2edge_sign( jnode, jedge );
-                    for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                        curl( jnode, jlev ) += add * ( avgS( iedge, jlev, LAT ) - avgS( iedge, jlev, LON ) );
-                    }
+        for ( idx_t jedge = 0; jedge < node2edge.cols( jnode ); ++jedge ) {
+            const idx_t iedge = node2edge( jnode, jedge );
+            if ( iedge < nedges ) {
+                const double add    = node2edge_sign( jnode, jedge );
+                const idx_t ip1     = edge2node( iedge, 0 );
+                const idx_t ip2     = edge2node( iedge, 1 );
+                const double rcosy1 = radius * cos_lat_[ip1];
+                const double rcosy2 = radius * cos_lat_[ip2];
+                const double pbc    = 1 - is_pole_edge( iedge );
+                const double Sx     = dual_normals( iedge, LON ) * deg2rad;
+                const double Sy     = dual_normals( iedge, LAT ) * deg2rad;
+                for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+                    double avg[2] = {( rcosy1 * vector( ip1, jlev, LON ) + rcosy2 * vector( ip2, jlev, LON ) ) *
+                                         0.5 * pbc,  // (force R*cos(y)=0 at pole)
+                                     ( radius * vector( ip1, jlev, LAT ) + radius * vector( ip2, jlev, LAT ) ) * 0.5};
+                    // Sy * avg[LON] = 0 at pole by construction of pbc, Sx * avg[LAT] = 0 at pole by construction of S
+                    // We don't need the non-cross terms for curl, i.e.
+                    //          Sx * avg[LON]
+                    //   and    Sy * avg[LAT]
+                    curl( jnode, jlev ) += add * ( Sx * avg[LAT] - Sy * avg[LON] );
                 }
             }
-            double y      = lonlat_deg( jnode, LAT ) * deg2rad;
-            double metric = 1. / ( dual_volumes( jnode ) * scale * std::cos( y ) );
-            for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
-                curl( jnode, jlev ) *= metric;
-            }
+        }
+        const double metric = 1. / ( dual_volumes( jnode ) * scale * cos_lat_[jnode] );
+        for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+            curl( jnode, jlev ) *= metric;
         }
     }
 }
 
 void Nabla::laplacian( const Field& scalar, Field& lapl ) const {
-    Field grad( fvm_->node_columns().createField<double>( option::name( "grad" ) | option::levels( scalar.levels() ) |
-                                                          option::variables( 2 ) ) );
-    gradient( scalar, grad );
+    // The gradient field is kept between calls, as long as levels and datatype do not change
+    std::lock_guard<std::mutex> lock( laplacian_mutex_ );
+    if ( not laplacian_grad_ || laplacian_grad_.levels() != scalar.levels() ||
+         laplacian_grad_.datatype() != scalar.datatype() ) {
+        laplacian_grad_ = fvm_->node_columns().createField(
+            option::name( "grad" ) | option::levels( scalar.levels() ) | option::variables( 2 ) |
+            option::datatype( scalar.datatype() ) );
+    }
+    gradient( scalar, laplacian_grad_ );
     if ( fvm_->node_columns().halo().size() < 2 ) {
-        fvm_->node_columns().haloExchange( grad );
+        fvm_->node_columns().haloExchange( laplacian_grad_ );
     }
-    divergence( grad, lapl );
+    divergence( laplacian_grad_, lapl );
 }
 
 const FunctionSpace& Nabla::functionspace() const {
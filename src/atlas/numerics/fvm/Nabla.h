@@ -10,8 +10,10 @@
 
 #pragma once
 
+#include <mutex>
 #include <vector>
 
+#include "atlas/field/Field.h"
 #include "atlas/library/config.h"
 #include "atlas/numerics/Nabla.h"
 
@@ -23,15 +25,13 @@ class Method;
 }  // namespace numerics
 }  // namespace atlas
 
-namespace atlas {
-class Field;
-}
-
 namespace atlas {
 namespace numerics {
 namespace fvm {
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
+/// Operators accept fields of type double or float. Edge contributions are accumulated directly into
+/// the nodes, without temporary edge arrays, and laplacian() reuses its gradient field between calls.
 class Nabla : public atlas::numerics::NablaImpl {
 public:
     Nabla( const atlas::numerics::Method&, const eckit::Parametrisation& );
@@ -47,12 +47,22 @@ public:
 private:
     void setup();
 
+    template <typename Value>
     void gradient_of_scalar( const Field& scalar, Field& grad ) const;
+    template <typename Value>
     void gradient_of_vector( const Field& vector, Field& grad ) const;
+    template <typename Value>
+    void divergence_of_vector( const Field& vector, Field& div ) const;
+    template <typename Value>
+    void curl_of_vector( const Field& vector, Field& curl ) const;
 
 private:
     fvm::Method const* fvm_;
     std::vector<idx_t> pole_edges_;
+    std::vector<double> cos_lat_;  // cosine of latitude of every node, computed in setup()
+
+    mutable Field laplacian_grad_;  // gradient workspace of laplacian()
+    mutable std::mutex laplacian_mutex_;
 };
 #endif
 // ------------------------------------------------------------------
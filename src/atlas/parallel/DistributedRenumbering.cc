@@ -0,0 +1,122 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "atlas/parallel/DistributedRenumbering.h"
+#include "atlas/parallel/mpi/Statistics.h"
+#include "atlas/parallel/omp/omp.h"
+#include "atlas/parallel/omp/sort.h"
+#include "atlas/runtime/Exception.h"
+#include "atlas/runtime/Trace.h"
+
+namespace atlas {
+namespace parallel {
+
+namespace {
+// Number of samples per task used to choose the splitters of the sample sort
+constexpr size_t nb_samples_per_task = 64;
+
+void sort_unique( std::vector<gidx_t>& v ) {
+    omp::sort( v.begin(), v.end() );
+    v.erase( std::unique( v.begin(), v.end() ), v.end() );
+}
+}  // namespace
+
+gidx_t renumber_distributed( gidx_t values[], size_t size, gidx_t first, const eckit::mpi::Comm& comm ) {
+    ATLAS_TRACE( "renumber_distributed" );
+    const size_t nproc = comm.size();
+
+    // 1) Distinct local values, sorted
+    std::vector<gidx_t> local( values, values + size );
+    ATLAS_TRACE_SCOPE( "sort local values" ) { sort_unique( local ); }
+
+    // 2) Splitters chosen from regular samples of the local values of every task
+    std::vector<gidx_t> splitters;
+    if ( nproc > 1 ) {
+        const size_t nb_samples = std::min( local.size(), std::min( nproc, nb_samples_per_task ) );
+        std::vector<gidx_t> samples( nb_samples );
+        for ( size_t s = 0; s < nb_samples; ++s ) {
+            samples[s] = local[( ( 2 * s + 1 ) * local.size() ) / ( 2 * nb_samples )];
+        }
+        eckit::mpi::Buffer<gidx_t> recv_samples( nproc );
+        ATLAS_TRACE_MPI( ALLGATHER ) { comm.allGatherv( samples.begin(), samples.end(), recv_samples ); }
+        std::vector<gidx_t>& all_samples = recv_samples.buffer;
+        std::sort( all_samples.begin(), all_samples.end() );
+        if ( not all_samples.empty() ) {
+            splitters.resize( nproc - 1 );
+            for ( size_t p = 1; p < nproc; ++p ) {
+                splitters[p - 1] = all_samples[( p * all_samples.size() ) / nproc];
+            }
+        }
+    }
+
+    // 3) Send every distinct value to the task owning its range: values in [ splitters[p-1], splitters[p] )
+    std::vector<size_t> send_begin( nproc + 1, local.size() );
+    send_begin[0] = 0;
+    for ( size_t p = 1; p < nproc && not splitters.empty(); ++p ) {
+        send_begin[p] = size_t( std::lower_bound( local.begin(), local.end(), splitters[p - 1] ) - local.begin() );
+    }
+    std::vector<std::vector<gidx_t>> send_values( nproc );
+    std::vector<std::vector<gidx_t>> recv_values( nproc );
+    for ( size_t p = 0; p < nproc; ++p ) {
+        send_values[p].assign( local.begin() + send_begin[p], local.begin() + send_begin[p + 1] );
+    }
+    ATLAS_TRACE_MPI( ALLTOALL ) { comm.allToAll( send_values, recv_values ); }
+    send_values.clear();
+
+    // 4) Number the distinct values of the owned range, after all values of lower ranges
+    std::vector<gidx_t> owned;
+    for ( const auto& v : recv_values ) {
+        owned.insert( owned.end(), v.begin(), v.end() );
+    }
+    ATLAS_TRACE_SCOPE( "sort owned values" ) { sort_unique( owned ); }
+
+    std::vector<gidx_t> nb_owned( nproc );
+    ATLAS_TRACE_MPI( ALLGATHER ) { comm.allGather( gidx_t( owned.size() ), nb_owned.begin(), nb_owned.end() ); }
+    gidx_t offset = first;
+    for ( size_t p = 0; p < comm.rank(); ++p ) {
+        offset += nb_owned[p];
+    }
+    gidx_t nb_distinct = 0;
+    for ( size_t p = 0; p < nproc; ++p ) {
+        nb_distinct += nb_owned[p];
+    }
+
+    // 5) Reply with the numbers of the received values, in the order they were received
+    std::vector<std::vector<gidx_t>> send_numbers( nproc );
+    std::vector<std::vector<gidx_t>> recv_numbers( nproc );
+    for ( size_t p = 0; p < nproc; ++p ) {
+        send_numbers[p].resize( recv_values[p].size() );
+        for ( size_t n = 0; n < recv_values[p].size(); ++n ) {
+            send_numbers[p][n] =
+                offset + gidx_t( std::lower_bound( owned.begin(), owned.end(), recv_values[p][n] ) - owned.begin() );
+        }
+    }
+    recv_values.clear();
+    ATLAS_TRACE_MPI( ALLTOALL ) { comm.allToAll( send_numbers, recv_numbers ); }
+
+    // 6) Numbers of the local distinct values are received in the order of local
+    std::vector<gidx_t> numbers;
+    numbers.reserve( local.size() );
+    for ( const auto& v : recv_numbers ) {
+        numbers.insert( numbers.end(), v.begin(), v.end() );
+    }
+    ATLAS_ASSERT( numbers.size() == local.size() );
+
+    atlas_omp_parallel_for( size_t n = 0; n < size; ++n ) {
+        values[n] = numbers[std::lower_bound( local.begin(), local.end(), values[n] ) - local.begin()];
+    }
+    return nb_distinct;
+}
+
+}  // namespace parallel
+}  // namespace atlas
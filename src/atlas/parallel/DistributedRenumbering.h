@@ -0,0 +1,33 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "atlas/library/config.h"
+#include "atlas/parallel/mpi/mpi.h"
+
+namespace atlas {
+namespace parallel {
+
+/// @brief Renumber values held by all MPI tasks to consecutive numbers, in the order of the values
+///
+/// Every value is replaced by first + the number of distinct smaller values over all tasks, so that equal
+/// values receive the same number on every task. The values are ordered with a distributed sample sort:
+/// every task sorts and numbers a range of values only, and no task gathers all of them.
+///
+/// This is a collective operation.
+/// @return number of distinct values over all tasks
+gidx_t renumber_distributed( gidx_t values[], size_t size, gidx_t first = 1,
+                             const eckit::mpi::Comm& comm = mpi::comm() );
+
+}  // namespace parallel
+}  // namespace atlas
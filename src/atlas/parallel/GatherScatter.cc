@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <sstream>
 #include <stdexcept>
@@ -49,20 +50,19 @@ struct IsGhostPoint {
 };
 
 struct Node {
+    gidx_t g;
     int p;
     idx_t i;
-    gidx_t g;
 
-    Node() = default;
-    Node( gidx_t gid, int part, idx_t idx ) {
-        g = gid;
-        p = part;
-        i = idx;
+    bool operator<( const Node& other ) const {
+        if ( g != other.g ) {
+            return g < other.g;
+        }
+        if ( p != other.p ) {
+            return p < other.p;
+        }
+        return i < other.i;
     }
-
-    bool operator<( const Node& other ) const { return ( g < other.g ); }
-
-    bool operator==( const Node& other ) const { return ( g == other.g ); }
 };
 
 }  // namespace
@@ -81,90 +81,258 @@ void GatherScatter::setup( const int part[], const idx_t remote_idx[], const int
                            const int mask[], const idx_t parsize ) {
     ATLAS_TRACE( "GatherScatter::setup" );
 
-    parsize_ = parsize;
-
-    glbcounts_.resize( nproc );
-    glbcounts_.assign( nproc, 0 );
-    glbdispls_.resize( nproc );
-    glbdispls_.assign( nproc, 0 );
-    const idx_t nvar = 3;
+    const auto& comm = mpi::comm();
+    parsize_         = parsize;
 
-    std::vector<gidx_t> sendnodes( parsize_ * nvar );
-
-    loccnt_ = 0;
+    /*
+  The global ordering is computed with a distributed sort: every point is sent to the rank
+  that is responsible for its range of global indices (its "bucket"), where duplicates are
+  removed. Each bucket then returns to the owning ranks the local index and global position
+  of their points. No rank ever holds the global list of points.
+*/
+    gidx_t glb_range[2] = {std::numeric_limits<gidx_t>::max(), std::numeric_limits<gidx_t>::min()};
     for ( idx_t n = 0; n < parsize_; ++n ) {
         if ( !mask[n] ) {
-            sendnodes[loccnt_++] = glb_idx[n];
-            sendnodes[loccnt_++] = part[n];
-            sendnodes[loccnt_++] = remote_idx[n] - base;
+            glb_range[0] = std::min( glb_range[0], glb_idx[n] );
+            glb_range[1] = std::max( glb_range[1], glb_idx[n] );
         }
     }
+    ATLAS_TRACE_MPI( ALLREDUCE ) {
+        comm.allReduceInPlace( glb_range[0], eckit::mpi::min() );
+        comm.allReduceInPlace( glb_range[1], eckit::mpi::max() );
+    }
+    const gidx_t glb_min  = glb_range[0];
+    const gidx_t glb_size = glb_range[1] >= glb_range[0] ? glb_range[1] - glb_range[0] + 1 : 1;
+    auto bucket           = [&]( gidx_t g ) -> idx_t {
+        return idx_t( ( static_cast<long long>( g - glb_min ) * nproc ) / glb_size );
+    };
+
+    std::vector<std::vector<gidx_t>> send_nodes( nproc );
+    std::vector<std::vector<gidx_t>> recv_nodes( nproc );
+    for ( idx_t n = 0; n < parsize_; ++n ) {
+        if ( !mask[n] ) {
+            auto& nodes = send_nodes[bucket( glb_idx[n] )];
+            nodes.push_back( glb_idx[n] );
+            nodes.push_back( part[n] );
+            nodes.push_back( remote_idx[n] - base );
+        }
+    }
+    ATLAS_TRACE_MPI( ALLTOALL ) { comm.allToAll( send_nodes, recv_nodes ); }
+    send_nodes.clear();
 
-    ATLAS_TRACE_MPI( ALLGATHER ) { mpi::comm().allGather( loccnt_, glbcounts_.begin(), glbcounts_.end() ); }
-
-    glbcnt_ = std::accumulate( glbcounts_.begin(), glbcounts_.end(), 0 );
-
-    glbdispls_[0] = 0;
-    for ( idx_t jproc = 1; jproc < nproc; ++jproc )  // start at 1
+    // Sort the nodes of this bucket on global index, and remove duplicates
+    std::vector<Node> node_sort;
     {
-        glbdispls_[jproc] = glbcounts_[jproc - 1] + glbdispls_[jproc - 1];
+        size_t nb_recv_nodes = 0;
+        for ( const auto& nodes : recv_nodes ) {
+            nb_recv_nodes += nodes.size() / 3;
+        }
+        node_sort.reserve( nb_recv_nodes );
+        for ( auto& nodes : recv_nodes ) {
+            for ( size_t n = 0; n < nodes.size(); n += 3 ) {
+                node_sort.emplace_back( Node{nodes[n], int( nodes[n + 1] ), idx_t( nodes[n + 2] )} );
+            }
+            std::vector<gidx_t>().swap( nodes );
+        }
+    }
+    ATLAS_TRACE_SCOPE( "sorting" ) {
+        std::sort( node_sort.begin(), node_sort.end() );
+        node_sort.erase( std::unique( node_sort.begin(), node_sort.end(),
+                                      []( const Node& a, const Node& b ) { return a.g == b.g; } ),
+                         node_sort.end() );
     }
-    std::vector<gidx_t> recvnodes( glbcnt_ );
 
+    // Global position of the first node of this bucket
+    std::vector<int> bucket_counts( nproc );
     ATLAS_TRACE_MPI( ALLGATHER ) {
-        mpi::comm().allGatherv( sendnodes.begin(), sendnodes.begin() + loccnt_, recvnodes.data(), glbcounts_.data(),
-                                glbdispls_.data() );
+        comm.allGather( int( node_sort.size() ), bucket_counts.begin(), bucket_counts.end() );
     }
+    glbcnt_ = std::accumulate( bucket_counts.begin(), bucket_counts.end(), 0 );
+    const int bucket_begin = std::accumulate( bucket_counts.begin(), bucket_counts.begin() + myproc, 0 );
 
-    // Load recvnodes in sorting structure
-    idx_t nb_recv_nodes = glbcnt_ / nvar;
-    std::vector<Node> node_sort( nb_recv_nodes );
-    for ( idx_t n = 0; n < nb_recv_nodes; ++n ) {
-        node_sort[n].g = recvnodes[n * nvar + 0];
-        node_sort[n].p = recvnodes[n * nvar + 1];
-        node_sort[n].i = recvnodes[n * nvar + 2];
+    // Return (local index, global position) to the ranks owning the nodes
+    std::vector<std::vector<int>> send_positions( nproc );
+    std::vector<std::vector<int>> recv_positions( nproc );
+    for ( size_t n = 0; n < node_sort.size(); ++n ) {
+        auto& positions = send_positions[node_sort[n].p];
+        positions.push_back( node_sort[n].i );
+        positions.push_back( bucket_begin + int( n ) );
     }
+    node_sort.clear();
+    ATLAS_TRACE_MPI( ALLTOALL ) { comm.allToAll( send_positions, recv_positions ); }
 
-    recvnodes.clear();
-
-    // Sort on "g" member, and remove duplicates
-    ATLAS_TRACE_SCOPE( "sorting" ) {
-        std::sort( node_sort.begin(), node_sort.end() );
-        node_sort.erase( std::unique( node_sort.begin(), node_sort.end() ), node_sort.end() );
+    // Buckets are ordered by global index, so concatenating their contributions keeps the global ordering
+    locmap_.clear();
+    glbpos_.clear();
+    for ( const auto& positions : recv_positions ) {
+        for ( size_t n = 0; n < positions.size(); n += 2 ) {
+            locmap_.push_back( positions[n] );
+            glbpos_.push_back( positions[n + 1] );
+        }
     }
-    glbcounts_.assign( nproc, 0 );
-    glbdispls_.assign( nproc, 0 );
-    for ( size_t n = 0; n < node_sort.size(); ++n ) {
-        ++glbcounts_[node_sort[n].p];
+    loccnt_ = static_cast<int>( locmap_.size() );
+
+    // The mapping to the global ordering is only assembled on the root, on first use
+    glbmap_root_ = -1;
+    glbmap_.clear();
+    glbcounts_.clear();
+    glbdispls_.clear();
+
+    is_setup_ = true;
+}
+
+void GatherScatter::setup_root( const idx_t root ) const {
+    if ( glbmap_root_ == root ) {
+        return;
     }
-    glbdispls_[0] = 0;
+    ATLAS_TRACE( "GatherScatter::setup_root" );
 
+    const auto& comm = mpi::comm();
+
+    std::vector<int> counts( nproc );
+    std::vector<int> displs( nproc );
+    ATLAS_TRACE_MPI( GATHER ) { comm.gather( loccnt_, counts, root ); }
+    displs[0] = 0;
     for ( idx_t jproc = 1; jproc < nproc; ++jproc )  // start at 1
     {
-        glbdispls_[jproc] = glbcounts_[jproc - 1] + glbdispls_[jproc - 1];
+        displs[jproc] = counts[jproc - 1] + displs[jproc - 1];
     }
-    glbcnt_ = std::accumulate( glbcounts_.begin(), glbcounts_.end(), 0 );
-    loccnt_ = glbcounts_[myproc];
 
-    glbmap_.clear();
-    glbmap_.resize( glbcnt_ );
-    locmap_.clear();
-    locmap_.resize( loccnt_ );
-    std::vector<int> idx( nproc, 0 );
+    std::vector<int> glbmap( glb_cnt( root ) );
+    ATLAS_TRACE_MPI( GATHER ) {
+        comm.gatherv( glbpos_.data(), glbpos_.size(), glbmap.data(), counts.data(), displs.data(), root );
+    }
 
-    int n{0};
-    for ( const auto& node : node_sort ) {
-        idx_t jproc                             = node.p;
-        glbmap_[glbdispls_[jproc] + idx[jproc]] = n++;
+    // Only the root keeps the mapping to the global ordering
+    if ( myproc != root ) {
+        counts.clear();
+        displs.clear();
+    }
+    glbmap_.swap( glbmap );
+    glbcounts_.swap( counts );
+    glbdispls_.swap( displs );
+    glbmap_root_ = root;
+}
+
+void GatherScatter::setup_io( const std::vector<idx_t>& io_ranks ) {
+    if ( !is_setup_ ) {
+        throw_Exception( "GatherScatter was not setup", Here() );
+    }
+    ATLAS_TRACE( "GatherScatter::setup_io" );
+    ATLAS_ASSERT( not io_ranks.empty() );
+
+    const auto& comm = mpi::comm();
+    const idx_t nio  = static_cast<idx_t>( io_ranks.size() );
+
+    io_ranks_ = io_ranks;
+    io_slabs_.resize( nio + 1 );
+    io_locs_.resize( nio + 1 );
+    for ( idx_t k = 0; k <= nio; ++k ) {
+        io_slabs_[k] = ( gidx_t( glbcnt_ ) * k ) / nio;
+        // Owned points are in global order, so the points of each slab are contiguous in locmap_
+        io_locs_[k] = int( std::lower_bound( glbpos_.begin(), glbpos_.end(), io_slabs_[k] ) - glbpos_.begin() );
+    }
 
-        if ( jproc == myproc ) {
-            locmap_[idx[jproc]] = node.i;
+    io_index_ = -1;
+    io_counts_.clear();
+    io_displs_.clear();
+    io_map_.clear();
+    for ( idx_t k = 0; k < nio; ++k ) {
+        const idx_t root = io_ranks_[k];
+        ATLAS_ASSERT( std::count( io_ranks_.begin(), io_ranks_.end(), root ) == 1 );
+
+        std::vector<int> counts( nproc );
+        std::vector<int> displs( nproc );
+        ATLAS_TRACE_MPI( GATHER ) { comm.gather( io_locs_[k + 1] - io_locs_[k], counts, root ); }
+        displs[0] = 0;
+        for ( idx_t jproc = 1; jproc < nproc; ++jproc )  // start at 1
+        {
+            displs[jproc] = counts[jproc - 1] + displs[jproc - 1];
         }
 
-        ++idx[jproc];
+        std::vector<int> map( myproc == root ? io_slabs_[k + 1] - io_slabs_[k] : 0 );
+        ATLAS_TRACE_MPI( GATHER ) {
+            comm.gatherv( glbpos_.data() + io_locs_[k], size_t( io_locs_[k + 1] - io_locs_[k] ), map.data(),
+                          counts.data(), displs.data(), root );
+        }
+
+        if ( myproc == root ) {
+            io_index_ = k;
+            for ( auto& position : map ) {
+                position -= int( io_slabs_[k] );
+            }
+            io_counts_.swap( counts );
+            io_displs_.swap( displs );
+            io_map_.swap( map );
+        }
+    }
+}
+
+void GatherScatter::gather_finish( GatherScatterHandle& handle ) const {
+    if ( not handle.active() ) {
+        return;
     }
+    ATLAS_ASSERT( handle.gather_scatter_ == this );
+    ATLAS_TRACE( "GatherScatter::gather_finish" );
 
-    is_setup_ = true;
+    ATLAS_TRACE_MPI( WAIT, "mpi-wait receive" ) {
+        for ( auto& request : handle.recv_req_ ) {
+            mpi::comm().wait( request );
+        }
+    }
+    if ( handle.unpack_ ) {
+        handle.unpack_();
+    }
+    ATLAS_TRACE_MPI( WAIT, "mpi-wait send" ) {
+        for ( auto& request : handle.send_req_ ) {
+            mpi::comm().wait( request );
+        }
+    }
+
+    handle.gather_scatter_ = nullptr;
+    handle.unpack_         = nullptr;
+    handle.send_req_.clear();
+    handle.recv_req_.clear();
+    std::vector<char>().swap( handle.send_buffer_ );
+    std::vector<char>().swap( handle.recv_buffer_ );
+}
+
+GatherScatterHandle::GatherScatterHandle( GatherScatterHandle&& other ) :
+    gather_scatter_( other.gather_scatter_ ),
+    send_buffer_( std::move( other.send_buffer_ ) ),
+    recv_buffer_( std::move( other.recv_buffer_ ) ),
+    send_req_( std::move( other.send_req_ ) ),
+    recv_req_( std::move( other.recv_req_ ) ),
+    unpack_( std::move( other.unpack_ ) ) {
+    other.gather_scatter_ = nullptr;
+}
+
+GatherScatterHandle& GatherScatterHandle::operator=( GatherScatterHandle&& other ) {
+    if ( this != &other ) {
+        if ( active() ) {
+            gather_scatter_->gather_finish( *this );
+        }
+        gather_scatter_       = other.gather_scatter_;
+        send_buffer_          = std::move( other.send_buffer_ );
+        recv_buffer_          = std::move( other.recv_buffer_ );
+        send_req_             = std::move( other.send_req_ );
+        recv_req_             = std::move( other.recv_req_ );
+        unpack_               = std::move( other.unpack_ );
+        other.gather_scatter_ = nullptr;
+    }
+    return *this;
+}
+
+GatherScatterHandle::~GatherScatterHandle() {
+    if ( active() ) {
+        // No exception may escape a destructor, which can also run while unwinding from another exception
+        try {
+            gather_scatter_->gather_finish( *this );
+        }
+        catch ( const std::exception& e ) {
+            Log::error() << "Gather completed by destroying its handle failed: " << e.what() << std::endl;
+        }
+    }
 }
 
 void GatherScatter::setup( const int part[], const idx_t remote_idx[], const int base, const gidx_t glb_idx[],
@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include <numeric>
 #include <stdexcept>
 #include <type_traits>
@@ -17,7 +19,9 @@
 
 #include "atlas/array/ArrayView.h"
 #include "atlas/library/config.h"
+#include "atlas/parallel/Packing.h"
 #include "atlas/parallel/mpi/mpi.h"
+#include "atlas/parallel/omp/omp.h"
 #include "atlas/runtime/Exception.h"
 #include "atlas/util/Object.h"
 
@@ -91,6 +95,23 @@ public:
         }
     }
 
+    /// Number of values per point
+    idx_t var_size() const {
+        return std::accumulate( var_shape.data(), var_shape.data() + var_rank, 1, std::multiplies<idx_t>() );
+    }
+
+    /// True if the values of each point are stored contiguously, so they can be copied as one block
+    bool contiguous() const {
+        idx_t stride = 1;
+        for ( idx_t j = var_rank - 1; j >= 0; --j ) {
+            if ( var_shape[j] != 1 && var_strides[j] != stride ) {
+                return false;
+            }
+            stride *= var_shape[j];
+        }
+        return true;
+    }
+
 public:
     DATA_TYPE* data;
     std::vector<idx_t> var_strides;
@@ -98,6 +119,36 @@ public:
     idx_t var_rank;
 };
 
+class GatherScatter;
+
+/// @brief Handle to a gather onto I/O ranks in progress
+///
+/// Returned by GatherScatter::gather_start(), and completed by GatherScatter::gather_finish().
+/// A handle that is still active when it is destroyed completes the gather itself, but can then only
+/// log errors; call GatherScatter::gather_finish() to have them thrown.
+class GatherScatterHandle {
+public:
+    GatherScatterHandle() = default;
+    GatherScatterHandle( GatherScatterHandle&& );
+    GatherScatterHandle& operator=( GatherScatterHandle&& );
+    GatherScatterHandle( const GatherScatterHandle& ) = delete;
+    GatherScatterHandle& operator=( const GatherScatterHandle& ) = delete;
+    ~GatherScatterHandle();
+
+    /// @brief True while messages are in flight, until GatherScatter::gather_finish() is called
+    bool active() const { return gather_scatter_ != nullptr; }
+
+private:
+    friend class GatherScatter;
+
+    const GatherScatter* gather_scatter_{nullptr};
+    std::vector<char> send_buffer_;
+    std::vector<char> recv_buffer_;
+    std::vector<eckit::mpi::Request> send_req_;
+    std::vector<eckit::mpi::Request> recv_req_;
+    std::function<void()> unpack_;
+};
+
 class GatherScatter : public util::Object {
 public:
     GatherScatter();
@@ -165,11 +216,49 @@ public:  // methods
     void scatter( const array::ArrayView<DATA_TYPE, GRANK>& gdata, array::ArrayView<DATA_TYPE, LRANK>& ldata,
                   const idx_t root = 0 ) const;
 
+    /// @brief Distribute the global ordering over several I/O ranks (collective)
+    ///
+    /// The global ordering is split in contiguous slabs of nearly equal size, one per I/O rank, in the given
+    /// order. Gathering onto the I/O ranks then never requires a single rank to hold a complete global field.
+    void setup_io( const std::vector<idx_t>& io_ranks );
+
+    /// @brief Global position of the first point gathered on this rank by gather_start() (0 if not an I/O rank)
+    gidx_t io_slab_begin() const { return io_index_ < 0 ? 0 : io_slabs_[io_index_]; }
+
+    /// @brief Number of points gathered on this rank by gather_start() (0 if not an I/O rank)
+    idx_t io_slab_size() const { return io_index_ < 0 ? 0 : idx_t( io_slabs_[io_index_ + 1] - io_slabs_[io_index_] ); }
+
+    /// @brief Start gathering a field onto the I/O ranks given to setup_io(), without waiting for completion
+    ///
+    /// On an I/O rank, gfield must hold io_slab_size() points. The local field must not be modified, and the
+    /// global field not be read, until gather_finish() is called. This allows e.g. to write a previously
+    /// gathered field while the next one is being gathered.
+    template <typename DATA_TYPE>
+    GatherScatterHandle gather_start( const parallel::Field<DATA_TYPE const>& lfield,
+                                      const parallel::Field<DATA_TYPE>& gfield ) const;
+
+    /// @brief Wait for completion of a gather started with gather_start(), and unpack the global field
+    void gather_finish( GatherScatterHandle& ) const;
+
+    /// @brief Gather a field onto the I/O ranks in batches of its first variable dimension, e.g. levels
+    ///
+    /// For every batch [var_begin,var_end), the callback is invoked on the I/O ranks with the gathered slab,
+    /// of shape ( io_slab_size(), var_end - var_begin, ... ), while the next batch is already being gathered.
+    /// Buffer memory is bounded by two batches, independently of the number of levels.
+    template <typename DATA_TYPE>
+    void gather_chunked(
+        const parallel::Field<DATA_TYPE const>& lfield, const idx_t batch_size,
+        const std::function<void( idx_t var_begin, idx_t var_end, const parallel::Field<DATA_TYPE>& slab )>& write )
+        const;
+
     gidx_t glb_dof() const { return glbcnt_; }
 
     idx_t loc_dof() const { return loccnt_; }
 
 private:  // methods
+    /// Assemble the mapping to the global ordering on given root, if not yet done (collective)
+    void setup_root( const idx_t root ) const;
+
     template <typename DATA_TYPE>
     void pack_send_buffer( const parallel::Field<DATA_TYPE const>& field, const std::vector<int>& sendmap,
                            DATA_TYPE send_buffer[] ) const;
@@ -186,10 +275,23 @@ private:  // data
     std::string name_;
     int loccnt_;
     int glbcnt_;
-    std::vector<int> glbcounts_;
-    std::vector<int> glbdispls_;
-    std::vector<int> locmap_;
-    std::vector<int> glbmap_;
+    std::vector<int> locmap_;  // local index of owned points, in global order
+    std::vector<int> glbpos_;  // global position of owned points, in global order
+
+    // Distribution of the global ordering over I/O ranks, see setup_io()
+    std::vector<idx_t> io_ranks_;
+    std::vector<gidx_t> io_slabs_;  // first global position of every slab, and glbcnt_
+    std::vector<int> io_locs_;      // first entry of locmap_ in every slab, and loccnt_
+    idx_t io_index_{-1};            // slab gathered on this rank
+    std::vector<int> io_counts_;    // on an I/O rank: number of points of the slab on every rank
+    std::vector<int> io_displs_;
+    std::vector<int> io_map_;  // on an I/O rank: position within the slab of the received points
+
+    // Mapping to the global ordering, only assembled on glbmap_root_
+    mutable idx_t glbmap_root_{-1};
+    mutable std::vector<int> glbcounts_;
+    mutable std::vector<int> glbdispls_;
+    mutable std::vector<int> glbmap_;
 
     idx_t nproc;
     idx_t myproc;
@@ -210,6 +312,7 @@ void GatherScatter::gather( parallel::Field<DATA_TYPE const> lfields[], parallel
     if ( !is_setup_ ) {
         throw_Exception( "GatherScatter was not setup", Here() );
     }
+    setup_root( root );
 
     for ( idx_t jfield = 0; jfield < nb_fields; ++jfield ) {
         const idx_t lvar_size =
@@ -222,12 +325,14 @@ void GatherScatter::gather( parallel::Field<DATA_TYPE const> lfields[], parallel
         const int glb_size = glb_cnt( root ) * gvar_size;
         std::vector<DATA_TYPE> loc_buffer( loc_size );
         std::vector<DATA_TYPE> glb_buffer( glb_size );
-        std::vector<int> glb_displs( nproc );
-        std::vector<int> glb_counts( nproc );
+        std::vector<int> glb_displs( nproc, 0 );
+        std::vector<int> glb_counts( nproc, 0 );
 
-        for ( idx_t jproc = 0; jproc < nproc; ++jproc ) {
-            glb_counts[jproc] = glbcounts_[jproc] * gvar_size;
-            glb_displs[jproc] = glbdispls_[jproc] * gvar_size;
+        if ( myproc == root ) {
+            for ( idx_t jproc = 0; jproc < nproc; ++jproc ) {
+                glb_counts[jproc] = glbcounts_[jproc] * gvar_size;
+                glb_displs[jproc] = glbdispls_[jproc] * gvar_size;
+            }
         }
 
         /// Pack
@@ -259,6 +364,7 @@ void GatherScatter::scatter( parallel::Field<DATA_TYPE const> gfields[], paralle
     if ( !is_setup_ ) {
         throw_Exception( "GatherScatter was not setup", Here() );
     }
+    setup_root( root );
 
     for ( idx_t jfield = 0; jfield < nb_fields; ++jfield ) {
         const int lvar_size =
@@ -271,12 +377,14 @@ void GatherScatter::scatter( parallel::Field<DATA_TYPE const> gfields[], paralle
         const int glb_size = glb_cnt( root ) * gvar_size;
         std::vector<DATA_TYPE> loc_buffer( loc_size );
         std::vector<DATA_TYPE> glb_buffer( glb_size );
-        std::vector<int> glb_displs( nproc );
-        std::vector<int> glb_counts( nproc );
+        std::vector<int> glb_displs( nproc, 0 );
+        std::vector<int> glb_counts( nproc, 0 );
 
-        for ( idx_t jproc = 0; jproc < nproc; ++jproc ) {
-            glb_counts[jproc] = glbcounts_[jproc] * gvar_size;
-            glb_displs[jproc] = glbdispls_[jproc] * gvar_size;
+        if ( myproc == root ) {
+            for ( idx_t jproc = 0; jproc < nproc; ++jproc ) {
+                glb_counts[jproc] = glbcounts_[jproc] * gvar_size;
+                glb_displs[jproc] = glbdispls_[jproc] * gvar_size;
+            }
         }
 
         /// Pack
@@ -309,22 +417,35 @@ void GatherScatter::pack_send_buffer( const parallel::Field<DATA_TYPE const>& fi
                                       DATA_TYPE send_buffer[] ) const {
     const idx_t sendcnt = static_cast<idx_t>( sendmap.size() );
 
-    idx_t ibuf              = 0;
+    const idx_t var_size    = field.var_size();
     const idx_t send_stride = field.var_strides[0] * field.var_shape[0];
+    const bool threaded     = sendcnt * var_size >= pack_omp_threshold();
+
+    if ( field.contiguous() ) {
+        atlas_omp_pragma( omp parallel for schedule( static ) if( threaded ) )
+        for ( idx_t p = 0; p < sendcnt; ++p ) {
+            const DATA_TYPE* column = field.data + send_stride * sendmap[p];
+            std::copy( column, column + var_size, send_buffer + p * var_size );
+        }
+        return;
+    }
 
     switch ( field.var_rank ) {
         case 1:
+            atlas_omp_pragma( omp parallel for schedule( static ) if( threaded ) )
             for ( idx_t p = 0; p < sendcnt; ++p ) {
                 const idx_t pp = send_stride * sendmap[p];
+                idx_t ibuf     = p * var_size;
                 for ( idx_t i = 0; i < field.var_shape[0]; ++i ) {
-                    DATA_TYPE tmp       = field.data[pp + i * field.var_strides[0]];
-                    send_buffer[ibuf++] = tmp;
+                    send_buffer[ibuf++] = field.data[pp + i * field.var_strides[0]];
                 }
             }
             break;
         case 2:
+            atlas_omp_pragma( omp parallel for schedule( static ) if( threaded ) )
             for ( idx_t p = 0; p < sendcnt; ++p ) {
                 const idx_t pp = send_stride * sendmap[p];
+                idx_t ibuf     = p * var_size;
                 for ( idx_t i = 0; i < field.var_shape[0]; ++i ) {
                     const idx_t ii = pp + i * field.var_strides[0];
                     for ( idx_t j = 0; j < field.var_shape[1]; ++j ) {
@@ -334,8 +455,10 @@ void GatherScatter::pack_send_buffer( const parallel::Field<DATA_TYPE const>& fi
             }
             break;
         case 3:
+            atlas_omp_pragma( omp parallel for schedule( static ) if( threaded ) )
             for ( idx_t p = 0; p < sendcnt; ++p ) {
                 const idx_t pp = send_stride * sendmap[p];
+                idx_t ibuf     = p * var_size;
                 for ( idx_t i = 0; i < field.var_shape[0]; ++i ) {
                     const idx_t ii = pp + i * field.var_strides[0];
                     for ( idx_t j = 0; j < field.var_shape[1]; ++j ) {
@@ -357,21 +480,35 @@ void GatherScatter::unpack_recv_buffer( const std::vector<int>& recvmap, const D
                                         const parallel::Field<DATA_TYPE>& field ) const {
     const idx_t recvcnt = static_cast<idx_t>( recvmap.size() );
 
-    int ibuf                = 0;
+    const idx_t var_size    = field.var_size();
     const idx_t recv_stride = field.var_strides[0] * field.var_shape[0];
+    const bool threaded     = recvcnt * var_size >= pack_omp_threshold();
+
+    if ( field.contiguous() ) {
+        atlas_omp_pragma( omp parallel for schedule( static ) if( threaded ) )
+        for ( idx_t p = 0; p < recvcnt; ++p ) {
+            const DATA_TYPE* column = recv_buffer + p * var_size;
+            std::copy( column, column + var_size, field.data + recv_stride * recvmap[p] );
+        }
+        return;
+    }
 
     switch ( field.var_rank ) {
         case 1:
+            atlas_omp_pragma( omp parallel for schedule( static ) if( threaded ) )
             for ( idx_t p = 0; p < recvcnt; ++p ) {
                 const idx_t pp = recv_stride * recvmap[p];
+                idx_t ibuf     = p * var_size;
                 for ( idx_t i = 0; i < field.var_shape[0]; ++i ) {
                     field.data[pp + i * field.var_strides[0]] = recv_buffer[ibuf++];
                 }
             }
             break;
         case 2:
+            atlas_omp_pragma( omp parallel for schedule( static ) if( threaded ) )
             for ( idx_t p = 0; p < recvcnt; ++p ) {
                 const idx_t pp = recv_stride * recvmap[p];
+                idx_t ibuf     = p * var_size;
                 for ( idx_t i = 0; i < field.var_shape[0]; ++i ) {
                     const idx_t ii = pp + i * field.var_strides[0];
                     for ( idx_t j = 0; j < field.var_shape[1]; ++j ) {
@@ -381,8 +518,10 @@ void GatherScatter::unpack_recv_buffer( const std::vector<int>& recvmap, const D
             }
             break;
         case 3:
+            atlas_omp_pragma( omp parallel for schedule( static ) if( threaded ) )
             for ( idx_t p = 0; p < recvcnt; ++p ) {
                 const idx_t pp = recv_stride * recvmap[p];
+                idx_t ibuf     = p * var_size;
                 for ( idx_t i = 0; i < field.var_shape[0]; ++i ) {
                     const idx_t ii = pp + i * field.var_strides[0];
                     for ( idx_t j = 0; j < field.var_shape[1]; ++j ) {
@@ -399,6 +538,117 @@ void GatherScatter::unpack_recv_buffer( const std::vector<int>& recvmap, const D
     }
 }
 
+template <typename DATA_TYPE>
+GatherScatterHandle GatherScatter::gather_start( const parallel::Field<DATA_TYPE const>& lfield,
+                                                 const parallel::Field<DATA_TYPE>& gfield ) const {
+    if ( io_ranks_.empty() ) {
+        throw_Exception( "GatherScatter::setup_io() was not called", Here() );
+    }
+    ATLAS_TRACE( "GatherScatter::gather_start" );
+
+    const auto& comm     = mpi::comm();
+    const idx_t var_size = lfield.var_size();
+    const int tag        = 2;
+
+    GatherScatterHandle handle;
+    handle.gather_scatter_ = this;
+    handle.send_buffer_.resize( sizeof( DATA_TYPE ) * size_t( loccnt_ ) * var_size );
+    DATA_TYPE* send_buffer = reinterpret_cast<DATA_TYPE*>( handle.send_buffer_.data() );
+
+    if ( io_index_ >= 0 ) {
+        ATLAS_ASSERT( gfield.var_size() == var_size );
+        handle.recv_buffer_.resize( sizeof( DATA_TYPE ) * size_t( io_slab_size() ) * var_size );
+        DATA_TYPE* recv_buffer = reinterpret_cast<DATA_TYPE*>( handle.recv_buffer_.data() );
+        ATLAS_TRACE_MPI( IRECEIVE ) {
+            for ( idx_t jproc = 0; jproc < nproc; ++jproc ) {
+                if ( io_counts_[jproc] > 0 ) {
+                    handle.recv_req_.emplace_back( comm.iReceive( recv_buffer + size_t( io_displs_[jproc] ) * var_size,
+                                                                  size_t( io_counts_[jproc] ) * var_size, jproc, tag ) );
+                }
+            }
+        }
+        handle.unpack_ = [this, recv_buffer, gfield]() { unpack_recv_buffer( io_map_, recv_buffer, gfield ); };
+    }
+
+    pack_send_buffer( lfield, locmap_, send_buffer );
+
+    ATLAS_TRACE_MPI( ISEND ) {
+        for ( size_t k = 0; k < io_ranks_.size(); ++k ) {
+            const int count = io_locs_[k + 1] - io_locs_[k];
+            if ( count > 0 ) {
+                handle.send_req_.emplace_back( comm.iSend( send_buffer + size_t( io_locs_[k] ) * var_size,
+                                                           size_t( count ) * var_size, io_ranks_[k], tag ) );
+            }
+        }
+    }
+    return handle;
+}
+
+template <typename DATA_TYPE>
+void GatherScatter::gather_chunked(
+    const parallel::Field<DATA_TYPE const>& lfield, const idx_t batch_size,
+    const std::function<void( idx_t var_begin, idx_t var_end, const parallel::Field<DATA_TYPE>& slab )>& write ) const {
+    ATLAS_TRACE( "GatherScatter::gather_chunked" );
+    ATLAS_ASSERT( batch_size > 0 );
+
+    // Batches are cut along the first variable dimension that follows the point dimension. Fields created from
+    // an ArrayView start with a dimension of extent 1 that carries the stride between points; add it otherwise,
+    // so that slicing the batched dimension does not change the stride between points.
+    parallel::Field<DATA_TYPE const> field( lfield );
+    if ( not( field.var_rank > 1 && field.var_shape[0] == 1 ) ) {
+        field.var_strides.insert( field.var_strides.begin(), lfield.var_strides[0] * lfield.var_shape[0] );
+        field.var_shape.insert( field.var_shape.begin(), 1 );
+        field.var_rank += 1;
+    }
+    const idx_t nb_vars = field.var_shape[1];
+
+    // Slice of the local field, and contiguous slab of the global field, for a batch of variables
+    auto local_batch = [&]( idx_t var_begin, idx_t var_end ) {
+        parallel::Field<DATA_TYPE const> batch( field );
+        batch.data         = field.data + var_begin * field.var_strides[1];
+        batch.var_shape[1] = var_end - var_begin;
+        return batch;
+    };
+    auto global_batch = [&]( std::vector<DATA_TYPE>& buffer, idx_t var_begin, idx_t var_end ) {
+        std::vector<idx_t> shape( field.var_shape );
+        std::vector<idx_t> strides( field.var_rank );
+        shape[1]     = var_end - var_begin;
+        idx_t stride = 1;
+        for ( idx_t j = field.var_rank - 1; j >= 0; --j ) {
+            strides[j] = stride;
+            stride *= shape[j];
+        }
+        buffer.resize( size_t( io_slab_size() ) * stride );
+        return parallel::Field<DATA_TYPE>( buffer.data(), strides.data(), shape.data(), field.var_rank );
+    };
+
+    // Double buffering: batch b+1 is in flight while batch b is written
+    std::vector<DATA_TYPE> buffers[2];
+    std::vector<parallel::Field<DATA_TYPE>> slabs( 2 );
+    GatherScatterHandle handles[2];
+    auto start = [&]( idx_t var_begin ) {
+        const idx_t var_end = std::min( var_begin + batch_size, nb_vars );
+        const int b         = ( var_begin / batch_size ) % 2;
+        slabs[b]            = global_batch( buffers[b], var_begin, var_end );
+        handles[b]          = gather_start( local_batch( var_begin, var_end ), slabs[b] );
+    };
+
+    if ( nb_vars > 0 ) {
+        start( 0 );
+    }
+    for ( idx_t var_begin = 0; var_begin < nb_vars; var_begin += batch_size ) {
+        const idx_t var_end = std::min( var_begin + batch_size, nb_vars );
+        const int b         = ( var_begin / batch_size ) % 2;
+        if ( var_end < nb_vars ) {
+            start( var_end );
+        }
+        gather_finish( handles[b] );
+        if ( io_index_ >= 0 ) {
+            write( var_begin, var_end, slabs[b] );
+        }
+    }
+}
+
 template <typename DATA_TYPE, int RANK>
 void GatherScatter::var_info( const array::ArrayView<DATA_TYPE, RANK>& arr, std::vector<idx_t>& varstrides,
                               std::vector<idx_t>& varshape ) const {
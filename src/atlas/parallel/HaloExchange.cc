@@ -12,6 +12,7 @@
 /// @author Willem Deconinck
 /// @date   Nov 2013
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 #include <sstream>
@@ -20,6 +21,8 @@
 #include "atlas/array/Array.h"
 #include "atlas/parallel/HaloExchange.h"
 #include "atlas/parallel/mpi/Statistics.h"
+#include "atlas/runtime/Exception.h"
+#include "atlas/runtime/Log.h"
 #include "atlas/util/vector.h"
 
 namespace atlas {
@@ -48,8 +51,96 @@ struct IsGhostPoint {
     const idx_t* ridx_;
     idx_t base_;
 };
+
+template <int RANK, typename Operation>
+void dispatch_datatype( array::Array& array, const Operation& operation ) {
+    switch ( array.datatype().kind() ) {
+        case array::DataType::KIND_INT32:
+            operation.template apply<int, RANK>( array );
+            break;
+        case array::DataType::KIND_INT64:
+            operation.template apply<long, RANK>( array );
+            break;
+        case array::DataType::KIND_REAL32:
+            operation.template apply<float, RANK>( array );
+            break;
+        case array::DataType::KIND_REAL64:
+            operation.template apply<double, RANK>( array );
+            break;
+        default:
+            throw_Exception( "datatype not supported", Here() );
+    }
+}
+
+template <typename Operation>
+void dispatch( array::Array& array, const Operation& operation ) {
+    switch ( array.rank() ) {
+        case 1:
+            dispatch_datatype<1>( array, operation );
+            break;
+        case 2:
+            dispatch_datatype<2>( array, operation );
+            break;
+        case 3:
+            dispatch_datatype<3>( array, operation );
+            break;
+        case 4:
+            dispatch_datatype<4>( array, operation );
+            break;
+        default:
+            throw_NotImplemented( "Rank not supported in halo exchange", Here() );
+    }
+}
+
+struct ExecuteArray {
+    const HaloExchange& halo_exchange;
+    bool on_device;
+    template <typename DATA_TYPE, int RANK>
+    void apply( array::Array& array ) const {
+        halo_exchange.execute<DATA_TYPE, RANK>( array, on_device );
+    }
+};
+
 }  // namespace
 
+/// Packs an array into its segment of the message for each neighbouring rank
+struct HaloExchange::FusedPack {
+    const HaloExchange& halo_exchange;
+    Buffer<char>& buffer;
+    idx_t offset;
+    template <typename DATA_TYPE, int RANK>
+    void apply( array::Array& array ) const {
+        auto field           = array::make_host_view<DATA_TYPE, RANK>( array );
+        const idx_t var_size = array::get_var_size<0>( field );
+        for ( size_t j = 0; j < halo_exchange.send_procs_.size(); ++j ) {
+            const int count = halo_exchange.sendcounts_[j];
+            const int begin = halo_exchange.senddispls_[j];
+            char* segment   = buffer.send.data() + buffer.send_displs[j] + count * offset;
+            array::SVector<DATA_TYPE> send_buffer( reinterpret_cast<DATA_TYPE*>( segment ), count * var_size );
+            halo_packer<0, RANK>::pack( begin, begin + count, halo_exchange.sendmap_, field, send_buffer );
+        }
+    }
+};
+
+/// Unpacks an array from its segment of the message of each neighbouring rank
+struct HaloExchange::FusedUnpack {
+    const HaloExchange& halo_exchange;
+    Buffer<char>& buffer;
+    idx_t offset;
+    template <typename DATA_TYPE, int RANK>
+    void apply( array::Array& array ) const {
+        auto field           = array::make_host_view<DATA_TYPE, RANK>( array );
+        const idx_t var_size = array::get_var_size<0>( field );
+        for ( size_t j = 0; j < halo_exchange.recv_procs_.size(); ++j ) {
+            const int count = halo_exchange.recvcounts_[j];
+            const int begin = halo_exchange.recvdispls_[j];
+            char* segment   = buffer.recv.data() + buffer.recv_displs[j] + count * offset;
+            const array::SVector<DATA_TYPE> recv_buffer( reinterpret_cast<DATA_TYPE*>( segment ), count * var_size );
+            halo_packer<0, RANK>::unpack( begin, begin + count, halo_exchange.recvmap_, recv_buffer, field );
+        }
+    }
+};
+
 HaloExchange::HaloExchange() : name_(), is_setup_( false ) {
     myproc = mpi::comm().rank();
     nproc  = mpi::comm().size();
@@ -70,92 +161,343 @@ void HaloExchange::setup( const int part[], const idx_t remote_idx[], const int
                           idx_t halo_begin ) {
     ATLAS_TRACE( "HaloExchange::setup" );
 
-    parsize_ = parsize;
-    sendcounts_.resize( nproc );
-    sendcounts_.assign( nproc, 0 );
-    recvcounts_.resize( nproc );
-    recvcounts_.assign( nproc, 0 );
-    senddispls_.resize( nproc );
-    senddispls_.assign( nproc, 0 );
-    recvdispls_.resize( nproc );
-    recvdispls_.assign( nproc, 0 );
+    const auto& comm = mpi::comm();
+    parsize_         = parsize;
 
     /*
-  Find the amount of nodes this proc has to receive from each other proc
+  Find the ghost points. Every thread collects the ghost points of its own contiguous
+  chunk of points, so that no synchronisation is needed, and concatenating the chunks
+  in thread order keeps the ghost points sorted.
 */
-
     IsGhostPoint is_ghost( part, remote_idx, base, parsize_ );
 
-    atlas::vector<idx_t> ghost_points( parsize_ );
-    idx_t nghost = 0;
-    atlas_omp_parallel_for( int jj = halo_begin; jj < parsize_; ++jj ) {
-        if ( is_ghost( jj ) ) {
-            idx_t p = part[jj];
-            atlas_omp_critical {
-                ++recvcounts_[p];
-                ghost_points[nghost] = jj;
-                nghost++;
+    std::vector<idx_t> ghost_points;
+    {
+        std::vector<std::vector<idx_t>> thread_ghost_points( atlas_omp_get_max_threads() );
+        atlas_omp_parallel {
+            auto& thread_ghosts = thread_ghost_points[atlas_omp_get_thread_num()];
+            atlas_omp_pragma( omp for schedule( static ) )
+            for ( idx_t jj = halo_begin; jj < parsize_; ++jj ) {
+                if ( is_ghost( jj ) ) {
+                    thread_ghosts.push_back( jj );
+                }
             }
         }
+        size_t nghost = 0;
+        for ( const auto& thread_ghosts : thread_ghost_points ) {
+            nghost += thread_ghosts.size();
+        }
+        ghost_points.reserve( nghost );
+        for ( const auto& thread_ghosts : thread_ghost_points ) {
+            ghost_points.insert( ghost_points.end(), thread_ghosts.begin(), thread_ghosts.end() );
+        }
     }
-    recvcnt_ = std::accumulate( recvcounts_.begin(), recvcounts_.end(), 0 );
-
-    /*
-  Find the amount of nodes this proc has to send to each other proc
-*/
-    ATLAS_TRACE_MPI( ALLTOALL ) { mpi::comm().allToAll( recvcounts_, sendcounts_ ); }
+    std::stable_sort( ghost_points.begin(), ghost_points.end(),
+                      [part]( idx_t a, idx_t b ) { return part[a] < part[b]; } );
 
-    sendcnt_ = std::accumulate( sendcounts_.begin(), sendcounts_.end(), 0 );
-
-    recvdispls_[0] = 0;
-    senddispls_[0] = 0;
-    for ( int jproc = 1; jproc < nproc; ++jproc )  // start at 1
-    {
-        recvdispls_[jproc] = recvcounts_[jproc - 1] + recvdispls_[jproc - 1];
-        senddispls_[jproc] = sendcounts_[jproc - 1] + senddispls_[jproc - 1];
-    }
     /*
+  Ranks to receive from, and the amount of nodes to receive from each of them.
   Fill vector "send_requests" with remote index of nodes needed, but are on
-  other procs
-  We can also fill in the vector "recvmap_" which holds local indices of
+  other procs. We can also fill in the vector "recvmap_" which holds local indices of
   requested nodes
 */
-
+    recv_procs_.clear();
+    recvcounts_.clear();
+    recvdispls_.clear();
+    recvcnt_ = static_cast<int>( ghost_points.size() );
     std::vector<int> send_requests( recvcnt_ );
-
     recvmap_.resize( recvcnt_ );
-    std::vector<int> cnt( nproc, 0 );
-    for ( idx_t jghost = 0; jghost < nghost; ++jghost ) {
-        const auto jj          = ghost_points[jghost];
-        const int req_idx      = recvdispls_[part[jj]] + cnt[part[jj]];
-        send_requests[req_idx] = remote_idx[jj] - base;
-        recvmap_[req_idx]      = jj;
-        ++cnt[part[jj]];
+    for ( int jghost = 0; jghost < recvcnt_; ++jghost ) {
+        const auto jj = ghost_points[jghost];
+        if ( recv_procs_.empty() || recv_procs_.back() != part[jj] ) {
+            recv_procs_.push_back( part[jj] );
+            recvcounts_.push_back( 0 );
+            recvdispls_.push_back( jghost );
+        }
+        ++recvcounts_.back();
+        send_requests[jghost] = remote_idx[jj] - base;
+        recvmap_[jghost]      = jj;
     }
 
     /*
-  Fill vector "recv_requests" with what is needed by other procs
+  Find the ranks that will request nodes from this proc. Only the number of requesting ranks
+  is reduced over all procs; the requests themselves are only exchanged between neighbours.
 */
-
-    std::vector<int> recv_requests( sendcnt_ );
-    ATLAS_TRACE_MPI( ALLTOALL ) {
-        mpi::comm().allToAllv( send_requests.data(), recvcounts_.data(), recvdispls_.data(), recv_requests.data(),
-                               sendcounts_.data(), senddispls_.data() );
+    int nb_requesters;
+    {
+        std::vector<int> requesters( nproc, 0 );
+        for ( int jproc : recv_procs_ ) {
+            requesters[jproc] = 1;
+        }
+        ATLAS_TRACE_MPI( ALLREDUCE ) { comm.allReduceInPlace( requesters.data(), nproc, eckit::mpi::sum() ); }
+        nb_requesters = requesters[myproc];
     }
 
     /*
-  What needs to be sent to other procs is asked by remote_idx, which is local
-  here
+  Send requests to the ranks owning our ghost points, and receive the requests of other procs,
+  i.e. what needs to be sent to them, expressed in remote_idx which is local here
 */
+    const int tag = 0;
+    std::vector<eckit::mpi::Request> send_req( recv_procs_.size() );
+    ATLAS_TRACE_MPI( ISEND ) {
+        for ( size_t j = 0; j < recv_procs_.size(); ++j ) {
+            send_req[j] = comm.iSend( send_requests.data() + recvdispls_[j], recvcounts_[j], recv_procs_[j], tag );
+        }
+    }
+
+    std::vector<std::pair<int, std::vector<int>>> recv_requests( nb_requesters );
+    ATLAS_TRACE_MPI( SENDRECEIVE, "mpi-receive requests" ) {
+        for ( auto& request : recv_requests ) {
+            eckit::mpi::Status status = comm.probe( comm.anySource(), tag );
+            request.first             = status.source();
+            request.second.resize( comm.getCount<int>( status ) );
+            comm.receive( request.second.data(), request.second.size(), request.first, tag );
+        }
+    }
+    std::sort( recv_requests.begin(), recv_requests.end(),
+               []( const std::pair<int, std::vector<int>>& a, const std::pair<int, std::vector<int>>& b ) {
+                   return a.first < b.first;
+               } );
+
+    ATLAS_TRACE_MPI( WAIT ) {
+        for ( auto& request : send_req ) {
+            comm.wait( request );
+        }
+    }
+
+    send_procs_.clear();
+    sendcounts_.clear();
+    senddispls_.clear();
+    sendcnt_ = 0;
+    for ( const auto& request : recv_requests ) {
+        send_procs_.push_back( request.first );
+        sendcounts_.push_back( static_cast<int>( request.second.size() ) );
+        senddispls_.push_back( sendcnt_ );
+        sendcnt_ += sendcounts_.back();
+    }
     sendmap_.resize( sendcnt_ );
-    for ( int jj = 0; jj < sendcnt_; ++jj ) {
-        sendmap_[jj] = recv_requests[jj];
+    for ( size_t j = 0; j < recv_requests.size(); ++j ) {
+        std::copy( recv_requests[j].second.begin(), recv_requests[j].second.end(),
+                   sendmap_.data() + senddispls_[j] );
     }
 
+    // Buffers from a previous setup no longer match the communication pattern
+    clear_buffers();
+
     is_setup_        = true;
     backdoor.parsize = parsize_;
 }
 
+void HaloExchange::setup( const Pattern& pattern ) {
+    ATLAS_TRACE( "HaloExchange::setup" );
+    ATLAS_ASSERT( pattern.send_procs.size() == pattern.send_counts.size() );
+    ATLAS_ASSERT( pattern.recv_procs.size() == pattern.recv_counts.size() );
+
+    parsize_    = pattern.parsize;
+    send_procs_ = pattern.send_procs;
+    sendcounts_ = pattern.send_counts;
+    recv_procs_ = pattern.recv_procs;
+    recvcounts_ = pattern.recv_counts;
+
+    auto displacements = []( const std::vector<int>& counts, std::vector<int>& displs ) {
+        displs.resize( counts.size() );
+        int count = 0;
+        for ( size_t j = 0; j < counts.size(); ++j ) {
+            displs[j] = count;
+            count += counts[j];
+        }
+        return count;
+    };
+    sendcnt_ = displacements( sendcounts_, senddispls_ );
+    recvcnt_ = displacements( recvcounts_, recvdispls_ );
+    ATLAS_ASSERT( size_t( sendcnt_ ) == pattern.send_map.size() );
+    ATLAS_ASSERT( size_t( recvcnt_ ) == pattern.recv_map.size() );
+
+    sendmap_.resize( sendcnt_ );
+    recvmap_.resize( recvcnt_ );
+    std::copy( pattern.send_map.begin(), pattern.send_map.end(), sendmap_.data() );
+    std::copy( pattern.recv_map.begin(), pattern.recv_map.end(), recvmap_.data() );
+
+    clear_buffers();
+
+    is_setup_        = true;
+    backdoor.parsize = parsize_;
+}
+
+HaloExchange::Pattern HaloExchange::pattern() const {
+    if ( !is_setup_ ) {
+        throw_Exception( "HaloExchange was not setup", Here() );
+    }
+    Pattern pattern;
+    pattern.parsize     = parsize_;
+    pattern.send_procs  = send_procs_;
+    pattern.send_counts = sendcounts_;
+    pattern.send_map.assign( sendmap_.data(), sendmap_.data() + sendcnt_ );
+    pattern.recv_procs  = recv_procs_;
+    pattern.recv_counts = recvcounts_;
+    pattern.recv_map.assign( recvmap_.data(), recvmap_.data() + recvcnt_ );
+    return pattern;
+}
+
+void HaloExchange::execute( const std::vector<array::Array*>& arrays, bool on_device ) const {
+    HaloExchangeHandle handle = start( arrays, on_device );
+    finish( handle );
+}
+
+HaloExchangeHandle HaloExchange::start( const std::vector<array::Array*>& arrays, bool on_device ) const {
+    if ( !is_setup_ ) {
+        throw_Exception( "HaloExchange was not setup", Here() );
+    }
+
+    HaloExchangeHandle handle;
+
+#if ATLAS_GRIDTOOLS_STORAGE_BACKEND_CUDA
+    if ( on_device ) {
+        // Packing on device is only implemented per array, so complete the exchange here
+        for ( array::Array* array : arrays ) {
+            dispatch( *array, ExecuteArray{*this, on_device} );
+        }
+        return handle;
+    }
+#endif
+
+    ATLAS_TRACE( "HaloExchange::start", {"halo-exchange"} );
+
+    // Order arrays by decreasing size of datatype, so that each segment is aligned for its datatype
+    auto& segments = handle.segments_;
+    segments.reserve( arrays.size() );
+    for ( array::Array* array : arrays ) {
+        segments.emplace_back( HaloExchangeHandle::Segment{array, 0} );
+    }
+    std::stable_sort( segments.begin(), segments.end(),
+                      []( const HaloExchangeHandle::Segment& a, const HaloExchangeHandle::Segment& b ) {
+                          return a.array->datatype().size() > b.array->datatype().size();
+                      } );
+
+    // Number of bytes per point, over all arrays
+    idx_t bytes = 0;
+    for ( auto& segment : segments ) {
+        idx_t var_size = 1;
+        for ( idx_t jdim = 1; jdim < segment.array->rank(); ++jdim ) {
+            var_size *= segment.array->shape( jdim );
+        }
+        segment.offset = bytes;
+        bytes += var_size * static_cast<idx_t>( segment.array->datatype().size() );
+    }
+    if ( bytes == 0 ) {
+        return handle;
+    }
+
+    int tag              = 1;
+    Buffer<char>& buffer = acquire_buffer<char>( KIND_BYTES, bytes );
+    BufferGuard buffer_guard( *this, buffer );
+
+    ATLAS_TRACE_MPI( IRECEIVE ) {
+        for ( size_t j = 0; j < recv_procs_.size(); ++j ) {
+            const int jproc = recv_procs_[j];
+            buffer.recv_req[j] =
+                mpi::comm().iReceive( &buffer.recv[buffer.recv_displs[j]], buffer.recv_counts[j], jproc, tag );
+        }
+    }
+
+    ATLAS_TRACE_SCOPE( "pack" ) {
+        for ( auto& segment : segments ) {
+            dispatch( *segment.array, FusedPack{*this, buffer, segment.offset} );
+        }
+    }
+
+    ATLAS_TRACE_MPI( ISEND ) {
+        for ( size_t j = 0; j < send_procs_.size(); ++j ) {
+            const int jproc = send_procs_[j];
+            buffer.send_req[j] =
+                mpi::comm().iSend( &buffer.send[buffer.send_displs[j]], buffer.send_counts[j], jproc, tag );
+        }
+    }
+
+    buffer_guard.keep();
+    handle.halo_exchange_ = this;
+    handle.buffer_        = static_cast<BufferBase*>( &buffer );
+    return handle;
+}
+
+void HaloExchange::finish( HaloExchangeHandle& handle ) const {
+    if ( not handle.active() ) {
+        return;
+    }
+    ATLAS_ASSERT( handle.halo_exchange_ == this );
+
+    ATLAS_TRACE( "HaloExchange::finish", {"halo-exchange"} );
+
+    Buffer<char>& buffer = static_cast<Buffer<char>&>( *static_cast<BufferBase*>( handle.buffer_ ) );
+    BufferGuard buffer_guard( *this, buffer );
+
+    // The handle is completed even if the exchange fails, so that it is not finished again
+    const std::vector<HaloExchangeHandle::Segment> segments = std::move( handle.segments_ );
+    handle.halo_exchange_ = nullptr;
+    handle.buffer_        = nullptr;
+    handle.segments_.clear();
+
+    ATLAS_TRACE_MPI( WAIT, "mpi-wait receive" ) {
+        for ( auto& request : buffer.recv_req ) {
+            mpi::comm().wait( request );
+        }
+    }
+
+    ATLAS_TRACE_SCOPE( "unpack" ) {
+        for ( auto& segment : segments ) {
+            dispatch( *segment.array, FusedUnpack{*this, buffer, segment.offset} );
+        }
+    }
+
+    ATLAS_TRACE_MPI( WAIT, "mpi-wait send" ) {
+        for ( auto& request : buffer.send_req ) {
+            mpi::comm().wait( request );
+        }
+    }
+}
+
+HaloExchangeHandle::HaloExchangeHandle( HaloExchangeHandle&& other ) :
+    halo_exchange_( other.halo_exchange_ ),
+    buffer_( other.buffer_ ),
+    segments_( std::move( other.segments_ ) ) {
+    other.halo_exchange_ = nullptr;
+    other.buffer_        = nullptr;
+}
+
+HaloExchangeHandle& HaloExchangeHandle::operator=( HaloExchangeHandle&& other ) {
+    if ( this != &other ) {
+        if ( active() ) {
+            halo_exchange_->finish( *this );
+        }
+        halo_exchange_       = other.halo_exchange_;
+        buffer_              = other.buffer_;
+        segments_            = std::move( other.segments_ );
+        other.halo_exchange_ = nullptr;
+        other.buffer_        = nullptr;
+    }
+    return *this;
+}
+
+HaloExchangeHandle::~HaloExchangeHandle() {
+    if ( active() ) {
+        // No exception may escape a destructor, which can also run while unwinding from another exception
+        try {
+            halo_exchange_->finish( *this );
+        }
+        catch ( const std::exception& e ) {
+            Log::error() << "Halo exchange completed by destroying its handle failed: " << e.what() << std::endl;
+        }
+    }
+}
+
+void HaloExchange::clear_buffers() const {
+    buffers_.clear();
+}
+
+void HaloExchange::release_buffer( BufferBase& buffer ) const {
+    buffer.in_use = false;
+}
+
 /////////////////////
 
 namespace {
@@ -14,18 +14,26 @@
 
 #pragma once
 
+#include <algorithm>
+#include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "atlas/parallel/HaloExchangeHandle.h"
 #include "atlas/parallel/HaloExchangeImpl.h"
+#include "atlas/parallel/Packing.h"
 #include "atlas/parallel/mpi/Statistics.h"
 #include "atlas/parallel/mpi/mpi.h"
+#include "atlas/parallel/omp/omp.h"
 
 
 #include "atlas/array/ArrayView.h"
 #include "atlas/array/ArrayViewDefs.h"
 #include "atlas/array/ArrayViewUtil.h"
+#include "atlas/array/DataType.h"
 #include "atlas/array/SVector.h"
 #include "atlas/array_fwd.h"
 #include "atlas/library/config.h"
@@ -52,13 +60,112 @@ public:  // methods
 
     void setup( const int part[], const idx_t remote_idx[], const int base, idx_t size, idx_t halo_begin );
 
+    /// @brief Communication pattern computed by setup(), per neighbouring rank
+    ///
+    /// A pattern can be stored, e.g. in a mesh::MeshCheckpoint, and later given to setup( const Pattern& ),
+    /// which requires no communication.
+    struct Pattern {
+        idx_t parsize{0};
+        std::vector<int> send_procs;   // neighbouring ranks to send to, in ascending order
+        std::vector<int> send_counts;  // per rank in send_procs
+        std::vector<int> send_map;     // local indices of points to send
+        std::vector<int> recv_procs;   // neighbouring ranks to receive from, in ascending order
+        std::vector<int> recv_counts;  // per rank in recv_procs
+        std::vector<int> recv_map;     // local indices of ghost points to receive
+    };
+
+    void setup( const Pattern& );
+
+    /// @brief Communication pattern of the last setup()
+    Pattern pattern() const;
+
+    /// @brief Free the communication buffers that are kept alive between executions
+    ///
+    /// Buffers are allocated on first use for each (datatype, number of variables) combination,
+    /// and are reused by subsequent executions, avoiding any heap allocation in the exchange itself.
+    /// This must not be called while an exchange started with start() is still active.
+    void clear_buffers() const;
+
     //  template <typename DATA_TYPE>
     //  void execute( DATA_TYPE field[], idx_t nb_vars ) const;
 
     template <typename DATA_TYPE, int RANK, typename ParallelDim = array::FirstDim>
     void execute( array::Array& field, bool on_device = false ) const;
 
+    /// @brief Exchange the halos of multiple arrays in a single round of messages
+    ///
+    /// All arrays are packed into one contiguous buffer per neighbouring rank, so that only one message
+    /// per neighbour is sent, independently of the number of arrays. The arrays may differ in datatype
+    /// and rank, but their parallel dimension must be the first dimension.
+    void execute( const std::vector<array::Array*>& arrays, bool on_device = false ) const;
+
+    /// @brief Start exchanging the halos of multiple arrays, without waiting for completion
+    ///
+    /// Receives are posted and the send buffers packed and sent, after which control returns to the caller.
+    /// Computations that do not involve halo values of the arrays, e.g. on interior points, can then
+    /// overlap with the communication. The arrays must not be modified until finish() is called.
+    HaloExchangeHandle start( const std::vector<array::Array*>& arrays, bool on_device = false ) const;
+
+    /// @brief Wait for completion of an exchange started with start(), and unpack the halos
+    void finish( HaloExchangeHandle& ) const;
+
+private:  // types
+    struct BufferBase {
+        virtual ~BufferBase() = default;
+        bool in_use{false};
+    };
+
+    /// Send/receive buffers, counts, displacements and MPI requests matching the setup of this
+    /// HaloExchange, for a given number of values per point. Counts and displacements are
+    /// stored per neighbouring rank, in the order of send_procs_ and recv_procs_.
+    template <typename DATA_TYPE>
+    struct Buffer : BufferBase {
+        Buffer( const HaloExchange&, idx_t var_size, idx_t alignment = 1 );
+        array::SVector<DATA_TYPE> send;
+        array::SVector<DATA_TYPE> recv;
+        std::vector<int> send_counts;
+        std::vector<int> send_displs;
+        std::vector<int> recv_counts;
+        std::vector<int> recv_displs;
+        std::vector<eckit::mpi::Request> send_req;  // one per rank in send_procs_
+        std::vector<eckit::mpi::Request> recv_req;  // one per rank in recv_procs_
+    };
+
+    using BufferKey = std::pair<long, idx_t>;
+
+    // Buffer kind used for multiple arrays packed together as bytes
+    static constexpr long KIND_BYTES = 0;
+
+    struct FusedPack;
+    struct FusedUnpack;
+
 private:  // methods
+    template <typename DATA_TYPE>
+    Buffer<DATA_TYPE>& acquire_buffer( long kind, idx_t var_size ) const;
+
+    void release_buffer( BufferBase& ) const;
+
+    /// Releases an acquired buffer when it goes out of scope, also when an exception is thrown
+    class BufferGuard {
+    public:
+        BufferGuard( const HaloExchange& halo_exchange, BufferBase& buffer ) :
+            halo_exchange_( halo_exchange ),
+            buffer_( &buffer ) {}
+        BufferGuard( const BufferGuard& ) = delete;
+        BufferGuard& operator=( const BufferGuard& ) = delete;
+        ~BufferGuard() {
+            if ( buffer_ ) {
+                halo_exchange_.release_buffer( *buffer_ );
+            }
+        }
+        /// Keep the buffer in use after the scope, for an exchange that is finished later
+        void keep() { buffer_ = nullptr; }
+
+    private:
+        const HaloExchange& halo_exchange_;
+        BufferBase* buffer_;
+    };
+
     void create_mappings( std::vector<int>& send_map, std::vector<int>& recv_map, idx_t nb_vars ) const;
 
     template <int N, int P>
@@ -88,14 +195,18 @@ private:  // data
 
     int sendcnt_;
     int recvcnt_;
-    std::vector<int> sendcounts_;
-    std::vector<int> senddispls_;
-    std::vector<int> recvcounts_;
-    std::vector<int> recvdispls_;
+    std::vector<int> send_procs_;  // neighbouring ranks to send to, in ascending order
+    std::vector<int> recv_procs_;  // neighbouring ranks to receive from, in ascending order
+    std::vector<int> sendcounts_;  // per rank in send_procs_
+    std::vector<int> senddispls_;  // per rank in send_procs_
+    std::vector<int> recvcounts_;  // per rank in recv_procs_
+    std::vector<int> recvdispls_;  // per rank in recv_procs_
     array::SVector<int> sendmap_;
     array::SVector<int> recvmap_;
     int parsize_;
 
+    mutable std::map<BufferKey, std::vector<std::unique_ptr<BufferBase>>> buffers_;
+
     int nproc;
     int myproc;
 
@@ -105,6 +216,49 @@ public:
     } backdoor;
 };
 
+template <typename DATA_TYPE>
+HaloExchange::Buffer<DATA_TYPE>::Buffer( const HaloExchange& halo_exchange, idx_t var_size, idx_t alignment ) :
+    send_counts( halo_exchange.send_procs_.size() ),
+    send_displs( halo_exchange.send_procs_.size() ),
+    recv_counts( halo_exchange.recv_procs_.size() ),
+    recv_displs( halo_exchange.recv_procs_.size() ),
+    send_req( halo_exchange.send_procs_.size() ),
+    recv_req( halo_exchange.recv_procs_.size() ) {
+    // Counts are rounded up to a multiple of alignment, so that every message starts aligned
+    auto aligned = [alignment]( idx_t count ) { return ( ( count + alignment - 1 ) / alignment ) * alignment; };
+    int send_size = 0;
+    int recv_size = 0;
+    for ( size_t j = 0; j < send_counts.size(); ++j ) {
+        send_counts[j] = aligned( halo_exchange.sendcounts_[j] * var_size );
+        send_displs[j] = send_size;
+        send_size += send_counts[j];
+    }
+    for ( size_t j = 0; j < recv_counts.size(); ++j ) {
+        recv_counts[j] = aligned( halo_exchange.recvcounts_[j] * var_size );
+        recv_displs[j] = recv_size;
+        recv_size += recv_counts[j];
+    }
+    send.resize( send_size );
+    recv.resize( recv_size );
+}
+
+template <typename DATA_TYPE>
+HaloExchange::Buffer<DATA_TYPE>& HaloExchange::acquire_buffer( long kind, idx_t var_size ) const {
+    auto& candidates = buffers_[BufferKey( kind, var_size )];
+    for ( auto& candidate : candidates ) {
+        if ( not candidate->in_use ) {
+            candidate->in_use = true;
+            return static_cast<Buffer<DATA_TYPE>&>( *candidate );
+        }
+    }
+    ATLAS_TRACE( "HaloExchange::allocate_buffer" );
+    // Byte buffers hold several datatypes; keep each message aligned for the largest of them
+    const idx_t alignment = ( kind == KIND_BYTES ) ? sizeof( double ) : 1;
+    candidates.emplace_back( new Buffer<DATA_TYPE>( *this, var_size, alignment ) );
+    candidates.back()->in_use = true;
+    return static_cast<Buffer<DATA_TYPE>&>( *candidates.back() );
+}
+
 template <typename DATA_TYPE, int RANK, typename ParallelDim>
 void HaloExchange::execute( array::Array& field, bool on_device ) const {
     if ( !is_setup_ ) {
@@ -118,69 +272,48 @@ void HaloExchange::execute( array::Array& field, bool on_device ) const {
     int tag                   = 1;
     constexpr int parallelDim = array::get_parallel_dim<ParallelDim>( field_hv );
     idx_t var_size            = array::get_var_size<parallelDim>( field_hv );
-    int send_size             = sendcnt_ * var_size;
-    int recv_size             = recvcnt_ * var_size;
-
-    array::SVector<DATA_TYPE> send_buffer( send_size );
-    array::SVector<DATA_TYPE> recv_buffer( recv_size );
-    std::vector<int> send_displs( nproc );
-    std::vector<int> recv_displs( nproc );
-    std::vector<int> send_counts( nproc );
-    std::vector<int> recv_counts( nproc );
-
-    std::vector<eckit::mpi::Request> send_req( nproc );
-    std::vector<eckit::mpi::Request> recv_req( nproc );
-
-    for ( int jproc = 0; jproc < nproc; ++jproc ) {
-        send_counts[jproc] = sendcounts_[jproc] * var_size;
-        recv_counts[jproc] = recvcounts_[jproc] * var_size;
-        send_displs[jproc] = senddispls_[jproc] * var_size;
-        recv_displs[jproc] = recvdispls_[jproc] * var_size;
-    }
+
+    Buffer<DATA_TYPE>& buffer = acquire_buffer<DATA_TYPE>( array::DataType::kind<DATA_TYPE>(), var_size );
+    BufferGuard buffer_guard( *this, buffer );
 
     auto field_dv =
         on_device ? array::make_device_view<DATA_TYPE, RANK>( field ) : array::make_host_view<DATA_TYPE, RANK>( field );
 
     ATLAS_TRACE_MPI( IRECEIVE ) {
         /// Let MPI know what we like to receive
-        for ( int jproc = 0; jproc < nproc; ++jproc ) {
-            if ( recv_counts[jproc] > 0 ) {
-                recv_req[jproc] =
-                    mpi::comm().iReceive( &recv_buffer[recv_displs[jproc]], recv_counts[jproc], jproc, tag );
-            }
+        for ( size_t j = 0; j < recv_procs_.size(); ++j ) {
+            const int jproc = recv_procs_[j];
+            buffer.recv_req[j] =
+                mpi::comm().iReceive( &buffer.recv[buffer.recv_displs[j]], buffer.recv_counts[j], jproc, tag );
         }
     }
 
     /// Pack
-    pack_send_buffer<parallelDim>( field_hv, field_dv, send_buffer, on_device );
+    pack_send_buffer<parallelDim>( field_hv, field_dv, buffer.send, on_device );
 
     /// Send
     ATLAS_TRACE_MPI( ISEND ) {
-        for ( int jproc = 0; jproc < nproc; ++jproc ) {
-            if ( send_counts[jproc] > 0 ) {
-                send_req[jproc] = mpi::comm().iSend( &send_buffer[send_displs[jproc]], send_counts[jproc], jproc, tag );
-            }
+        for ( size_t j = 0; j < send_procs_.size(); ++j ) {
+            const int jproc = send_procs_[j];
+            buffer.send_req[j] =
+                mpi::comm().iSend( &buffer.send[buffer.send_displs[j]], buffer.send_counts[j], jproc, tag );
         }
     }
 
     /// Wait for receiving to finish
     ATLAS_TRACE_MPI( WAIT, "mpi-wait receive" ) {
-        for ( int jproc = 0; jproc < nproc; ++jproc ) {
-            if ( recvcounts_[jproc] > 0 ) {
-                mpi::comm().wait( recv_req[jproc] );
-            }
+        for ( auto& request : buffer.recv_req ) {
+            mpi::comm().wait( request );
         }
     }
 
     /// Unpack
-    unpack_recv_buffer<parallelDim>( recv_buffer, field_hv, field_dv, on_device );
+    unpack_recv_buffer<parallelDim>( buffer.recv, field_hv, field_dv, on_device );
 
     /// Wait for sending to finish
     ATLAS_TRACE_MPI( WAIT, "mpi-wait send" ) {
-        for ( int jproc = 0; jproc < nproc; ++jproc ) {
-            if ( sendcounts_[jproc] > 0 ) {
-                mpi::comm().wait( send_req[jproc] );
-            }
+        for ( auto& request : buffer.send_req ) {
+            mpi::comm().wait( request );
         }
     }
 }
@@ -191,21 +324,93 @@ struct halo_packer {
     static void pack( const int sendcnt, array::SVector<int> const& sendmap,
                       const array::ArrayView<DATA_TYPE, RANK, array::Intent::ReadWrite>& field,
                       array::SVector<DATA_TYPE>& send_buffer ) {
-        idx_t ibuf = 0;
-        for ( int node_cnt = 0; node_cnt < sendcnt; ++node_cnt ) {
-            const idx_t node_idx = sendmap[node_cnt];
-            halo_packer_impl<ParallelDim, RANK, 0>::apply( ibuf, node_idx, field, send_buffer );
+        pack( 0, sendcnt, sendmap, field, send_buffer );
+    }
+
+    /// Pack the entries [begin,end) of sendmap, starting at the beginning of send_buffer
+    template <typename DATA_TYPE>
+    static void pack( const int begin, const int end, array::SVector<int> const& sendmap,
+                      const array::ArrayView<DATA_TYPE, RANK, array::Intent::ReadWrite>& field,
+                      array::SVector<DATA_TYPE>& send_buffer ) {
+        const idx_t nvar    = var_size( field );
+        const bool threaded = idx_t( end - begin ) * nvar >= pack_omp_threshold();
+        DATA_TYPE* buffer   = send_buffer.data();
+        if ( contiguous_columns( field ) ) {
+            const DATA_TYPE* data = field.data();
+            const idx_t stride    = field.stride( 0 );
+            atlas_omp_pragma( omp parallel for schedule( static ) if( threaded ) )
+            for ( int node_cnt = begin; node_cnt < end; ++node_cnt ) {
+                const DATA_TYPE* column = data + stride * sendmap[node_cnt];
+                std::copy( column, column + nvar, buffer + idx_t( node_cnt - begin ) * nvar );
+            }
+        }
+        else {
+            atlas_omp_pragma( omp parallel for schedule( static ) if( threaded ) )
+            for ( int node_cnt = begin; node_cnt < end; ++node_cnt ) {
+                idx_t ibuf = idx_t( node_cnt - begin ) * nvar;
+                halo_packer_impl<ParallelDim, RANK, 0>::apply( ibuf, sendmap[node_cnt], field, send_buffer );
+            }
         }
     }
 
     template <typename DATA_TYPE>
     static void unpack( const int recvcnt, array::SVector<int> const& recvmap,
                         array::SVector<DATA_TYPE> const& recv_buffer, array::ArrayView<DATA_TYPE, RANK>& field ) {
-        idx_t ibuf = 0;
-        for ( int node_cnt = 0; node_cnt < recvcnt; ++node_cnt ) {
-            const idx_t node_idx = recvmap[node_cnt];
-            halo_unpacker_impl<ParallelDim, RANK, 0>::apply( ibuf, node_idx, recv_buffer, field );
+        unpack( 0, recvcnt, recvmap, recv_buffer, field );
+    }
+
+    /// Unpack the entries [begin,end) of recvmap, starting at the beginning of recv_buffer
+    template <typename DATA_TYPE>
+    static void unpack( const int begin, const int end, array::SVector<int> const& recvmap,
+                        array::SVector<DATA_TYPE> const& recv_buffer, array::ArrayView<DATA_TYPE, RANK>& field ) {
+        const idx_t nvar        = var_size( field );
+        const bool threaded     = idx_t( end - begin ) * nvar >= pack_omp_threshold();
+        const DATA_TYPE* buffer = recv_buffer.data();
+        if ( contiguous_columns( field ) ) {
+            DATA_TYPE* data    = field.data();
+            const idx_t stride = field.stride( 0 );
+            atlas_omp_pragma( omp parallel for schedule( static ) if( threaded ) )
+            for ( int node_cnt = begin; node_cnt < end; ++node_cnt ) {
+                const DATA_TYPE* column = buffer + idx_t( node_cnt - begin ) * nvar;
+                std::copy( column, column + nvar, data + stride * recvmap[node_cnt] );
+            }
+        }
+        else {
+            atlas_omp_pragma( omp parallel for schedule( static ) if( threaded ) )
+            for ( int node_cnt = begin; node_cnt < end; ++node_cnt ) {
+                idx_t ibuf = idx_t( node_cnt - begin ) * nvar;
+                halo_unpacker_impl<ParallelDim, RANK, 0>::apply( ibuf, recvmap[node_cnt], recv_buffer, field );
+            }
+        }
+    }
+
+private:
+    /// Number of values per point, i.e. the product of all dimensions but the parallel one
+    template <typename View>
+    static idx_t var_size( const View& field ) {
+        idx_t size = 1;
+        for ( int d = 0; d < RANK; ++d ) {
+            if ( d != ParallelDim ) {
+                size *= field.shape( d );
+            }
+        }
+        return size;
+    }
+
+    /// True if the values of each point are stored contiguously, so they can be copied as one block
+    template <typename View>
+    static bool contiguous_columns( const View& field ) {
+        if ( ParallelDim != 0 ) {
+            return false;
+        }
+        idx_t stride = 1;
+        for ( int d = RANK - 1; d > 0; --d ) {
+            if ( field.stride( d ) != stride ) {
+                return false;
+            }
+            stride *= field.shape( d );
         }
+        return true;
     }
 };
 
@@ -0,0 +1,55 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "atlas/array_fwd.h"
+#include "atlas/library/config.h"
+
+namespace atlas {
+namespace parallel {
+
+class HaloExchange;
+
+/// @brief Handle to a halo exchange in progress
+///
+/// Returned by HaloExchange::start(), and completed by HaloExchange::finish().
+/// A handle that is still active when it is destroyed completes the exchange itself, but can then only
+/// log errors; call HaloExchange::finish() to have them thrown.
+class HaloExchangeHandle {
+public:
+    HaloExchangeHandle() = default;
+    HaloExchangeHandle( HaloExchangeHandle&& );
+    HaloExchangeHandle& operator=( HaloExchangeHandle&& );
+    HaloExchangeHandle( const HaloExchangeHandle& ) = delete;
+    HaloExchangeHandle& operator=( const HaloExchangeHandle& ) = delete;
+    ~HaloExchangeHandle();
+
+    /// @brief True while messages are in flight, until HaloExchange::finish() is called
+    bool active() const { return halo_exchange_ != nullptr; }
+
+private:
+    friend class HaloExchange;
+
+    /// An array taking part in the exchange, with its byte offset within the data of one point
+    struct Segment {
+        array::Array* array;
+        idx_t offset;
+    };
+
+    const HaloExchange* halo_exchange_{nullptr};
+    void* buffer_{nullptr};  // buffer owned by halo_exchange_, in use until finish()
+    std::vector<Segment> segments_;
+};
+
+}  // namespace parallel
+}  // namespace atlas
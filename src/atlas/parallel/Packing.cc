@@ -0,0 +1,41 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include "atlas/parallel/Packing.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+
+#include "eckit/utils/Translator.h"
+
+namespace atlas {
+namespace parallel {
+
+namespace {
+std::atomic<idx_t>& threshold_value() {
+    static std::atomic<idx_t> value{[] {
+        const char* env = ::getenv( "ATLAS_PACK_OMP_THRESHOLD" );
+        return env ? idx_t( eckit::Translator<std::string, long>()( env ) ) : idx_t( 16384 );
+    }()};
+    return value;
+}
+}  // namespace
+
+idx_t pack_omp_threshold() {
+    return threshold_value();
+}
+
+void pack_omp_threshold( idx_t threshold ) {
+    threshold_value() = threshold;
+}
+
+}  // namespace parallel
+}  // namespace atlas
@@ -0,0 +1,27 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#pragma once
+
+#include "atlas/library/config.h"
+
+namespace atlas {
+namespace parallel {
+
+/// Buffers of halo exchanges and gather/scatter with fewer values than this are packed serially,
+/// as threading them costs more than it gains.
+/// Default is 16384, or the environment variable ATLAS_PACK_OMP_THRESHOLD
+idx_t pack_omp_threshold();
+
+/// Change the threshold, e.g. to 0 to exercise the threaded packing with small buffers
+void pack_omp_threshold( idx_t threshold );
+
+}  // namespace parallel
+}  // namespace atlas
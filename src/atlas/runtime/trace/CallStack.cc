@@ -10,20 +10,35 @@
 
 #include "CallStack.h"
 
-#include <functional>
-
 #include "atlas/runtime/trace/CodeLocation.h"
 
 namespace atlas {
 namespace runtime {
 namespace trace {
 
+namespace {
+// FNV-1a hash of a C string, so that no string needs to be formatted to identify a code location
+size_t hash_combine( size_t hash, const char* str ) {
+    if ( str ) {
+        for ( ; *str; ++str ) {
+            hash = ( hash ^ static_cast<unsigned char>( *str ) ) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+}  // namespace
+
 void CallStack::push_front( const CodeLocation& loc, const std::string& id ) {
-    stack_.push_front( std::hash<std::string>{}( loc.asString() + id ) );
+    size_t hash = hash_combine( 14695981039346656037ull, loc.file() );
+    hash        = hash_combine( hash, loc.func() );
+    hash        = hash_combine( hash ^ size_t( loc.line() ), id.c_str() );
+    stack_.push_front( hash );
+    hash_ = 0;
 }
 
 void CallStack::pop_front() {
     stack_.pop_front();
+    hash_ = 0;
 }
 
 size_t CallStack::hash() const {
@@ -39,6 +39,9 @@ public:
     const_reverse_iterator rbegin() const { return stack_.rbegin(); }
     const_reverse_iterator rend() const { return stack_.rend(); }
 
+    /// Hash of the innermost call site
+    size_t front() const { return stack_.front(); }
+
     size_t hash() const;
     size_t size() const { return stack_.size(); }
 
@@ -26,7 +26,8 @@ namespace trace {
 //-----------------------------------------------------------------------------------------------------------
 
 bool Control::enabled() {
-    return atlas_omp_get_thread_num() == 0;
+    // Timings and call stacks are per thread, so that all threads can be traced
+    return true;
 }
 
 class LoggingState {
@@ -76,7 +77,9 @@ std::ostream& Logging::channel() {
 }
 
 bool Logging::enabled() {
-    return LoggingState::instance();
+    // only the master thread prints, to not interleave output
+    std::ostream* channel = LoggingState::instance();
+    return channel && atlas_omp_get_thread_num() == 0;
 }
 
 void Logging::start( const std::string& title ) {
@@ -14,6 +14,12 @@
 
 namespace atlas {
 namespace runtime {
-namespace trace {}  // namespace trace
+namespace trace {
+
+size_t CurrentCallStack::intern( size_t enclosing, size_t call_site ) {
+    return interned_.emplace( std::make_pair( enclosing, call_site ), interned_.size() + 1 ).first->second;
+}
+
+}  // namespace trace
 }  // namespace runtime
 }  // namespace atlas
@@ -10,6 +10,12 @@
 
 #pragma once
 
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "atlas/runtime/trace/CallStack.h"
 #include "atlas/runtime/trace/CodeLocation.h"
 #include "atlas/runtime/trace/Logging.h"
@@ -24,23 +30,42 @@ class CurrentCallStack {
 private:
     CurrentCallStack() {}
     CallStack stack_;
+    std::vector<size_t> ids_;  // interned identifier of each nested call stack, innermost last
+    struct KeyHash {
+        size_t operator()( const std::pair<size_t, size_t>& key ) const {
+            return key.second ^ ( key.first * 0x9e3779b97f4a7c15ull );
+        }
+    };
+    std::unordered_map<std::pair<size_t, size_t>, size_t, KeyHash> interned_;  // (enclosing id, call site) -> id
+
+    size_t intern( size_t enclosing, size_t call_site );
 
 public:
     CurrentCallStack( CurrentCallStack const& ) = delete;
     CurrentCallStack& operator=( CurrentCallStack const& ) = delete;
+    /// Each thread keeps its own call stack
     static CurrentCallStack& instance() {
-        static CurrentCallStack state;
+        static thread_local CurrentCallStack state;
         return state;
     }
-    operator CallStack() const { return stack_; }
-    CallStack& push( const CodeLocation& loc, const std::string& id ) {
-        if ( Control::enabled() )
+    const CallStack& stack() const { return stack_; }
+
+    /// Identifier of the current call stack, unique within the calling thread; 0 for an empty stack
+    size_t id() const { return ids_.empty() ? 0 : ids_.back(); }
+
+    /// Push a call site, and return the identifier of the resulting call stack
+    size_t push( const CodeLocation& loc, const std::string& id ) {
+        if ( Control::enabled() ) {
             stack_.push_front( loc, id );
-        return stack_;
+            ids_.push_back( intern( this->id(), stack_.front() ) );
+        }
+        return this->id();
     }
     void pop() {
-        if ( Control::enabled() )
+        if ( Control::enabled() ) {
             stack_.pop_front();
+            ids_.pop_back();
+        }
     }
 };
 
@@ -11,10 +11,17 @@
 
 #include "Timings.h"
 
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <fstream>
 #include <iomanip>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <regex>
+#include <set>
 #include <sstream>
 #include <string>
 
@@ -22,6 +29,8 @@
 #include "eckit/filesystem/PathName.h"
 
 #include "atlas/parallel/mpi/mpi.h"
+#include "atlas/parallel/omp/omp.h"
+#include "atlas/runtime/Exception.h"
 #include "atlas/runtime/Log.h"
 #include "atlas/runtime/trace/CallStack.h"
 #include "atlas/runtime/trace/CodeLocation.h"
@@ -33,6 +42,70 @@ namespace atlas {
 namespace runtime {
 namespace trace {
 
+namespace {
+
+struct TimingEvent {
+    size_t id;
+    double start;
+    double seconds;
+};
+
+/// Fixed-capacity ring of the timings recorded for export. When full, the oldest timing is overwritten
+/// and counted as dropped, so that recording stays bounded in memory however long it is enabled.
+class EventRing {
+public:
+    static constexpr size_t capacity = 65536;
+
+    void push( const TimingEvent& event ) {
+        if ( events_.size() < capacity ) {
+            if ( events_.empty() ) {
+                events_.reserve( capacity );
+            }
+            events_.push_back( event );
+        }
+        else {
+            events_[next_] = event;
+            next_          = ( next_ + 1 ) % capacity;
+            ++dropped_;
+        }
+    }
+
+    /// Apply f to the events, from oldest to most recent
+    template <typename Function>
+    void for_each( const Function& f ) const {
+        for ( size_t i = 0; i < events_.size(); ++i ) {
+            f( events_[( next_ + i ) % events_.size()] );
+        }
+    }
+
+    size_t dropped() const { return dropped_; }
+
+private:
+    std::vector<TimingEvent> events_;
+    size_t next_{0};
+    size_t dropped_{0};
+};
+
+/// Timings recorded by one thread. They are only consolidated into the TimingsRegistry when
+/// the buffer is full or when a report is made, so that recording a timing needs no lock.
+struct ThreadTimings {
+    static constexpr size_t capacity     = 1024;
+    static constexpr size_t unregistered = std::numeric_limits<size_t>::max();
+    ThreadTimings( int _thread ) : thread( _thread ) { events.reserve( capacity ); }
+    int thread;
+    std::vector<TimingEvent> events;
+    std::vector<size_t> timers;  // timer of each call stack identifier of this thread
+    EventRing recorded;          // timings kept for exportChromeTrace()
+};
+constexpr size_t ThreadTimings::unregistered;
+
+/// Timers of different threads with the same call stack are kept apart
+size_t timer_key( const CallStack& stack, int thread ) {
+    return thread == 0 ? stack.hash() : stack.hash() ^ ( size_t( thread ) * 0x9e3779b97f4a7c15ull );
+}
+
+}  // namespace
+
 class TimingsRegistry {
 private:
     std::vector<long> counts_;
@@ -48,6 +121,11 @@ private:
 
     std::map<std::string, std::vector<size_t>> labels_;
 
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadTimings>> threads_;
+    std::atomic<bool> record_events_{false};
+    const std::chrono::steady_clock::time_point epoch_{std::chrono::steady_clock::now()};
+
     TimingsRegistry() = default;
 
 public:
@@ -56,22 +134,66 @@ public:
         return registry;
     }
 
-    size_t add( const CodeLocation&, const CallStack& stack, const std::string& title, const Timings::Labels& );
+    ThreadTimings& thread();
+
+    bool find( size_t stack_id, size_t& idx );
+
+    size_t add( const CodeLocation&, const CallStack& stack, size_t stack_id, const std::string& title,
+                const Timings::Labels& );
 
-    void update( size_t idx, double seconds );
+    void update( size_t idx, double start, double seconds );
+
+    double time() const;
 
     size_t size() const;
 
+    void recordEvents( bool record );
+
+    size_t droppedEvents();
+
     void report( std::ostream& out, const eckit::Configuration& config );
 
+    void exportChromeTrace( const std::string& path );
+
 private:
+    void accumulate( size_t idx, double seconds );
+
+    // The following require mutex_ to be locked
+    void flush( ThreadTimings& );
+
+    void flush();
+
     std::string filter_filepath( const std::string& filepath ) const;
 };
 
-size_t TimingsRegistry::add( const CodeLocation& loc, const CallStack& stack, const std::string& title,
-                             const Timings::Labels& labels ) {
-    size_t key = stack.hash();
-    auto it    = index_.find( key );
+ThreadTimings& TimingsRegistry::thread() {
+    static thread_local ThreadTimings* thread_timings = nullptr;
+    if ( not thread_timings ) {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        threads_.emplace_back( new ThreadTimings( atlas_omp_get_thread_num() ) );
+        thread_timings = threads_.back().get();
+    }
+    return *thread_timings;
+}
+
+bool TimingsRegistry::find( size_t stack_id, size_t& idx ) {
+    auto& t = thread();
+    if ( stack_id >= t.timers.size() || t.timers[stack_id] == ThreadTimings::unregistered ) {
+        return false;
+    }
+    idx = t.timers[stack_id];
+    return true;
+}
+
+size_t TimingsRegistry::add( const CodeLocation& loc, const CallStack& stack, size_t stack_id,
+                             const std::string& title, const Timings::Labels& labels ) {
+    auto& t    = thread();
+    size_t key = timer_key( stack, t.thread );
+    if ( stack_id >= t.timers.size() ) {
+        t.timers.resize( stack_id + 1, ThreadTimings::unregistered );
+    }
+    std::lock_guard<std::mutex> lock( mutex_ );
+    auto it = index_.find( key );
     if ( it == index_.end() ) {
         size_t idx  = size();
         index_[key] = idx;
@@ -89,14 +211,58 @@ size_t TimingsRegistry::add( const CodeLocation& loc, const CallStack& stack, co
             labels_[label].emplace_back( idx );
         }
 
+        t.timers[stack_id] = idx;
         return idx;
     }
     else {
+        t.timers[stack_id] = it->second;
         return it->second;
     }
 }
 
-void TimingsRegistry::update( size_t idx, double seconds ) {
+void TimingsRegistry::update( size_t idx, double start, double seconds ) {
+    auto& t = thread();
+    t.events.push_back( {idx, start, seconds} );
+    if ( record_events_.load( std::memory_order_relaxed ) ) {
+        t.recorded.push( t.events.back() );
+    }
+    if ( t.events.size() == ThreadTimings::capacity ) {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        flush( t );
+    }
+}
+
+double TimingsRegistry::time() const {
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() - epoch_ ).count();
+}
+
+void TimingsRegistry::recordEvents( bool record ) {
+    record_events_ = record;
+}
+
+size_t TimingsRegistry::droppedEvents() {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    size_t dropped = 0;
+    for ( const auto& t : threads_ ) {
+        dropped += t->recorded.dropped();
+    }
+    return dropped;
+}
+
+void TimingsRegistry::flush( ThreadTimings& t ) {
+    for ( const auto& event : t.events ) {
+        accumulate( event.id, event.seconds );
+    }
+    t.events.clear();
+}
+
+void TimingsRegistry::flush() {
+    for ( auto& t : threads_ ) {
+        flush( *t );
+    }
+}
+
+void TimingsRegistry::accumulate( size_t idx, double seconds ) {
     auto sqr          = []( double x ) { return x * x; };
     double n          = counts_[idx] + 1;
     double avg_nm1    = tot_timings_[idx] / std::max( n, 1. );
@@ -113,6 +279,9 @@ size_t TimingsRegistry::size() const {
 }
 
 void TimingsRegistry::report( std::ostream& out, const eckit::Configuration& config ) {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    flush();
+
     auto box_horizontal = []( int n ) {
         std::string s;
         s.reserve( 2 * n );
@@ -358,6 +527,82 @@ void TimingsRegistry::report( std::ostream& out, const eckit::Configuration& con
     out << std::left << box_horizontal( 40 ) << sepf << box_horizontal( 5 ) << sepf << box_horizontal( 12 ) << "\n";
 }
 
+void TimingsRegistry::exportChromeTrace( const std::string& path ) {
+    auto json_string = []( const std::string& str ) {
+        std::stringstream out;
+        out << '"';
+        for ( char c : str ) {
+            if ( c == '"' || c == '\\' ) {
+                out << '\\' << c;
+            }
+            else if ( static_cast<unsigned char>( c ) < 0x20 ) {
+                out << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << int( c ) << std::dec;
+            }
+            else {
+                out << c;
+            }
+        }
+        out << '"';
+        return out.str();
+    };
+
+    const auto& comm = mpi::comm();
+    const int rank   = static_cast<int>( comm.rank() );
+
+    std::stringstream out;
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        flush();
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"args\":{\"name\":\"MPI task "
+            << rank << "\"}}";
+        size_t dropped = 0;
+        for ( const auto& t : threads_ ) {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"tid\":" << t->thread
+                << ",\"args\":{\"name\":\"thread " << t->thread << "\",\"dropped_events\":" << t->recorded.dropped()
+                << "}}";
+            dropped += t->recorded.dropped();
+        }
+        out << std::fixed << std::setprecision( 3 );
+        for ( const auto& t : threads_ ) {
+            t->recorded.for_each( [&]( const TimingEvent& event ) {
+                // timestamps and durations in microseconds
+                out << ",\n{\"name\":" << json_string( titles_[event.id] )
+                    << ",\"cat\":\"atlas\",\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":" << t->thread
+                    << ",\"ts\":" << 1.e6 * event.start << ",\"dur\":" << 1.e6 * event.seconds << "}";
+            } );
+        }
+        if ( dropped ) {
+            Log::warning() << "Chrome trace of MPI task " << rank << " misses the " << dropped
+                           << " oldest timings, beyond " << EventRing::capacity << " per thread" << std::endl;
+        }
+    }
+    std::string events = out.str();
+
+    std::vector<int> sizes( comm.size() );
+    std::vector<int> displs( comm.size() );
+    comm.allGather( static_cast<int>( events.size() ), sizes.begin(), sizes.end() );
+    size_t total = 0;
+    for ( size_t p = 0; p < sizes.size(); ++p ) {
+        displs[p] = static_cast<int>( total );
+        total += sizes[p];
+    }
+    std::vector<char> all_events( rank == 0 ? total : 0 );
+    comm.gatherv( events.data(), events.size(), all_events.data(), sizes.data(), displs.data(), 0 );
+
+    if ( rank == 0 ) {
+        std::ofstream file( path );
+        if ( not file ) {
+            throw_Exception( "Could not open " + path + " for writing the Chrome trace", Here() );
+        }
+        file << "{\"traceEvents\":[\n";
+        for ( size_t p = 0; p < sizes.size(); ++p ) {
+            file << ( p ? ",\n" : "" );
+            file.write( all_events.data() + displs[p], sizes[p] );
+        }
+        file << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+    }
+}
+
 std::string TimingsRegistry::filter_filepath( const std::string& filepath ) const {
     std::regex filepath_re( "(.*)?/atlas/src/(.*)" );
     std::smatch matches;
@@ -373,13 +618,37 @@ std::string TimingsRegistry::filter_filepath( const std::string& filepath ) cons
     // return filepath;
 }
 
-Timings::Identifier Timings::add( const CodeLocation& loc, const CallStack& stack, const std::string& title,
-                                  const Labels& labels ) {
-    return TimingsRegistry::instance().add( loc, stack, title, labels );
+bool Timings::find( CallStackId stack_id, Identifier& id ) {
+    return TimingsRegistry::instance().find( stack_id, id );
+}
+
+Timings::Identifier Timings::add( const CodeLocation& loc, const CallStack& stack, CallStackId stack_id,
+                                  const std::string& title, const Labels& labels ) {
+    return TimingsRegistry::instance().add( loc, stack, stack_id, title, labels );
 }
 
 void Timings::update( const Identifier& id, double seconds ) {
-    TimingsRegistry::instance().update( id, seconds );
+    update( id, time() - seconds, seconds );
+}
+
+void Timings::update( const Identifier& id, double start, double seconds ) {
+    TimingsRegistry::instance().update( id, start, seconds );
+}
+
+double Timings::time() {
+    return TimingsRegistry::instance().time();
+}
+
+void Timings::recordEvents( bool record ) {
+    TimingsRegistry::instance().recordEvents( record );
+}
+
+size_t Timings::droppedEvents() {
+    return TimingsRegistry::instance().droppedEvents();
+}
+
+void Timings::exportChromeTrace( const std::string& path ) {
+    TimingsRegistry::instance().exportChromeTrace( path );
 }
 
 std::string Timings::report() {
@@ -33,16 +33,40 @@ public:
     using Configuration = eckit::Configuration;
     using CodeLocation  = atlas::CodeLocation;
     using Identifier    = size_t;
+    using CallStackId   = size_t;
     using Labels        = std::vector<std::string>;
 
 public:  // static methods
-    static Identifier add( const CodeLocation&, const CallStack&, const std::string& title, const Labels& );
+    /// Find the timer registered for a call stack in the calling thread, without locking.
+    /// The call stack is identified by CurrentCallStack::id() of the calling thread.
+    static bool find( CallStackId, Identifier& );
+
+    static Identifier add( const CodeLocation&, const CallStack&, CallStackId, const std::string& title,
+                           const Labels& );
 
     static void update( const Identifier& id, double seconds );
 
+    /// Record a timing that started at given time(), in a buffer of the calling thread
+    static void update( const Identifier& id, double start, double seconds );
+
+    /// Seconds elapsed since the timings were first used
+    static double time();
+
+    /// Report of all recorded timings. Must not be called while other threads are tracing.
     static std::string report();
 
     static std::string report( const Configuration& );
+
+    /// Keep the recorded timings, to be exported with exportChromeTrace().
+    /// Each thread keeps its most recent timings in a ring of fixed capacity.
+    static void recordEvents( bool );
+
+    /// Number of recorded timings overwritten in full rings
+    static size_t droppedEvents();
+
+    /// Write the recorded timings of all MPI tasks as Chrome trace events (chrome://tracing, Perfetto),
+    /// with one process per MPI task and one lane per thread. Collective; only MPI task 0 writes the file.
+    static void exportChromeTrace( const std::string& path );
 };
 
 }  // namespace trace
@@ -46,6 +46,7 @@ public:
 public:  // static methods
     static std::string report();
     static std::string report( const eckit::Configuration& config );
+    static void exportChromeTrace( const std::string& path );
 
 public:
     TraceT( const CodeLocation& );
@@ -67,7 +68,8 @@ public:
     double elapsed() const;
 
 private:  // types
-    using Identifier = Timings::Identifier;
+    using Identifier  = Timings::Identifier;
+    using CallStackId = Timings::CallStackId;
 
 private:  // member functions
     void barrier() const;
@@ -81,10 +83,11 @@ private:  // member functions
 private:  // member data
     bool running_{false};
     StopWatch stopwatch_;
+    double start_time_{0.};
     CodeLocation loc_;
     std::string title_;
     Identifier id_;
-    CallStack callstack_;
+    CallStackId callstack_{0};
     Labels labels_;
 };
 
@@ -131,15 +134,19 @@ inline void TraceT<TraceTraits>::barrier() const {
 
 template <typename TraceTraits>
 inline void TraceT<TraceTraits>::registerTimer() {
-    std::string title =
-        title_ + ( Barriers::state() ? " [b]" : "" ) +
-        ( atlas_omp_get_num_threads() > 1 ? " @thread[" + std::to_string( atlas_omp_get_thread_num() ) + "]" : "" );
-    id_ = Timings::add( loc_, callstack_, title, labels_ );
+    // The title is only formatted when the timer is registered for the first time in this thread
+    if ( not Timings::find( callstack_, id_ ) ) {
+        std::string title =
+            title_ + ( Barriers::state() ? " [b]" : "" ) +
+            ( atlas_omp_get_num_threads() > 1 ? " @thread[" + std::to_string( atlas_omp_get_thread_num() ) + "]"
+                                              : "" );
+        id_ = Timings::add( loc_, CurrentCallStack::instance().stack(), callstack_, title, labels_ );
+    }
 }
 
 template <typename TraceTraits>
 inline void TraceT<TraceTraits>::updateTimings() const {
-    Timings::update( id_, stopwatch_.elapsed() );
+    Timings::update( id_, start_time_, stopwatch_.elapsed() );
 }
 
 template <typename TraceTraits>
@@ -157,6 +164,7 @@ inline void TraceT<TraceTraits>::start() {
         registerTimer();
         Tracing::start( title_ );
         barrier();
+        start_time_ = Timings::time();
         stopwatch_.start();
     }
 }
@@ -206,6 +214,11 @@ inline std::string TraceT<TraceTraits>::report( const eckit::Configuration& conf
     return Timings::report( config ) + Barriers::report();
 }
 
+template <typename TraceTraits>
+inline void TraceT<TraceTraits>::exportChromeTrace( const std::string& path ) {
+    Timings::exportChromeTrace( path );
+}
+
 //-----------------------------------------------------------------------------------------------------------
 
 }  // namespace trace
@@ -206,6 +206,66 @@ void compute_legendre_polynomials(
     }
 }
 
+void compute_legendre_polynomials_m( const int truncation,  // truncation (in)
+                                     const int jm,          // zonal wave number (in)
+                                     const int nlats,       // number of latitudes
+                                     const double lats[],   // latitudes in radians (in)
+                                     double leg_sym[],      // values of associated Legendre functions, symmetric part
+                                     double leg_asym[] )    // values of associated Legendre functions, asymmetric part
+{
+    const int trc  = truncation;
+    const int nsym = ( trc - jm + 2 ) / 2;
+    const int nasy = ( trc - jm + 1 ) / 2;
+    std::vector<double> eps( trc + 2 );
+    for ( int jn = jm + 1; jn <= trc; ++jn ) {
+        eps[jn] = std::sqrt( double( jn * jn - jm * jm ) / ( 4. * jn * jn - 1. ) );
+    }
+    std::vector<double> legpol( trc + 1 );
+
+    for ( int jlat = 0; jlat < nlats; ++jlat ) {
+        double zdlx    = std::cos( M_PI_2 - lats[jlat] );  // cos(theta)
+        double zdlsita = std::sqrt( 1. - zdlx * zdlx );    // sin(theta) (this is how trans library does it)
+        double zdls    = 0.;
+        // if we are less than 1 meter from the pole,
+        if ( std::abs( zdlsita ) <= std::sqrt( std::numeric_limits<double>::epsilon() ) ) {
+            zdlx    = 1.;
+            zdlsita = 0.;
+        }
+        else {
+            zdls = std::numeric_limits<double>::min() / zdlsita;
+        }
+
+        // sectoral polynomial (Belousov, equation 23)
+        double pmm = 1.;
+        for ( int jn = 1; jn <= jm; ++jn ) {
+            pmm *= zdlsita * std::sqrt( ( 2. * jn + 1. ) / ( 2. * jn ) );
+            if ( std::abs( pmm ) < zdls ) {
+                pmm = 0.;
+            }
+        }
+
+        // three-term recurrence in the total wave number
+        legpol[jm] = pmm;
+        if ( jm < trc ) {
+            legpol[jm + 1] = std::sqrt( 2. * jm + 3. ) * zdlx * pmm;
+        }
+        for ( int jn = jm + 2; jn <= trc; ++jn ) {
+            legpol[jn] = ( zdlx * legpol[jn - 1] - eps[jn - 1] * legpol[jn - 2] ) / eps[jn];
+        }
+
+        // split polynomials into symmetric and antisymmetric parts, in descending order of the total wave number
+        int is = 0, ia = 0;
+        for ( int jn = trc; jn >= jm; jn-- ) {
+            if ( ( jn - jm ) % 2 == 0 ) {
+                leg_sym[nsym * jlat + is++] = legpol[jn];
+            }
+            else {
+                leg_asym[nasy * jlat + ia++] = legpol[jn];
+            }
+        }
+    }
+}
+
 void compute_legendre_polynomials_all( const int truncation,  // truncation (in)
                                        const int nlats,       // number of latitudes
                                        const double lats[],   // latitudes in radians (in)
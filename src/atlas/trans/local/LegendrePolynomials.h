@@ -48,6 +48,16 @@ void compute_legendre_polynomials(
     size_t leg_start_sym[],     // start indices for different zonal wave numbers, symmetric part
     size_t leg_start_asym[] );  // start indices for different zonal wave numbers, asymmetric part
 
+// Compute the Legendre polynomials of a single zonal wave number jm, laid out as the block of jm in
+// compute_legendre_polynomials. Uses the three-term recurrence in the total wave number starting from the
+// sectoral polynomial, so that no polynomials of other zonal wave numbers are needed.
+void compute_legendre_polynomials_m( const int trc,             // truncation (in)
+                                     const int jm,              // zonal wave number (in)
+                                     const int nlats,           // number of latitudes
+                                     const double lats[],       // latitudes in radians (in)
+                                     double legendre_sym[],     // values of associated Legendre functions, symmetric
+                                     double legendre_asym[] );  // values of associated Legendre functions, asymmetric
+
 void compute_legendre_polynomials_all( const int trc,        // truncation (in)
                                        const int nlats,      // number of latitudes
                                        const double lats[],  // latitudes in radians (in)
@@ -10,9 +10,12 @@
 
 #include "atlas/trans/local/TransLocal.h"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdlib>
 #include <fstream>
+#include <numeric>
 
 #include "eckit/config/YAMLConfiguration.h"
 #include "eckit/eckit.h"
@@ -33,6 +36,7 @@
 #include "atlas/grid/StructuredGrid.h"
 #include "atlas/option.h"
 #include "atlas/parallel/mpi/mpi.h"
+#include "atlas/parallel/omp/omp.h"
 #include "atlas/runtime/Exception.h"
 #include "atlas/runtime/Log.h"
 #include "atlas/trans/Trans.h"
@@ -40,6 +44,8 @@
 #include "atlas/trans/detail/TransFactory.h"
 #include "atlas/trans/local/LegendrePolynomials.h"
 #include "atlas/util/Constants.h"
+#include "atlas/util/Earth.h"
+#include "atlas/util/GaussianLatitudes.h"
 
 #include "atlas/library/defines.h"
 #if ATLAS_HAVE_FFTW
@@ -87,6 +93,8 @@ public:
 
     bool export_legendre() const { return config_.getBool( "export_legendre", false ); }
 
+    bool legendre_precompute() const { return config_.getBool( "legendre_precompute", true ); }
+
     int warning() const { return config_.getInt( "warning", 1 ); }
 
     int fft() const {
@@ -218,6 +226,29 @@ size_t add_padding( size_t n ) {
     return size_t( std::ceil( n / 8. ) ) * 8;
 }
 
+/// Scratch arrays of one thread for the Legendre transform of any zonal wavenumber, allocated before the parallel
+/// loop over wavenumbers, so that no allocation can fail inside it
+struct LegendreWorkspace {
+    LegendreWorkspace( const std::array<size_t, 4>& sizes, size_t size_legendre_sym, size_t size_legendre_asym ) {
+        for ( size_t j = 0; j < sizes.size(); ++j ) {
+            alloc_aligned( arrays[j], sizes[j] );
+        }
+        legendre_sym.reserve( size_legendre_sym );
+        legendre_asym.reserve( size_legendre_asym );
+    }
+    ~LegendreWorkspace() {
+        for ( double*& array : arrays ) {
+            free_aligned( array );
+        }
+    }
+    LegendreWorkspace( const LegendreWorkspace& ) = delete;
+    LegendreWorkspace& operator=( const LegendreWorkspace& ) = delete;
+
+    std::array<double*, 4> arrays{};
+    std::vector<double> legendre_sym;
+    std::vector<double> legendre_asym;
+};
+
 }  // namespace
 
 int fourier_truncation( const int truncation,    // truncation
@@ -256,6 +287,7 @@ struct FFTW_Data {
     fftw_complex* in;
     double* out;
     std::vector<fftw_plan> plans;
+    std::vector<fftw_plan> plans_dir;  // real-to-complex plans for direct transforms
 #endif
 };
 }  // namespace detail
@@ -284,6 +316,7 @@ TransLocal::TransLocal( const Cache& cache, const Grid& grid, const Domain& doma
     grid_( grid, domain ),
     truncation_( static_cast<int>( truncation ) ),
     precompute_( config.getBool( "precompute", true ) ),
+    legendre_precompute_( TransParameters( config ).legendre_precompute() ),
     cache_( cache ),
     legendre_cache_( cache.legendre().data() ),
     legendre_cachesize_( cache.legendre().size() ),
@@ -521,7 +554,20 @@ TransLocal::TransLocal( const Cache& cache, const Grid& grid, const Domain& doma
                 legendre_asym_begin_[jm + 1] = size_asym;
             }
 
-            if ( legendre_cache_ ) {
+            // tables that are read from or written to a cache are always precomputed
+            if ( legendre_cache_ || TransParameters( config ).export_legendre() ||
+                 TransParameters( config ).write_legendre().size() ) {
+                legendre_precompute_ = true;
+            }
+
+            if ( not legendre_precompute_ ) {
+                Log::debug() << "TransLocal: Legendre polynomials are computed on the fly, saving "
+                             << eckit::Bytes( sizeof( double ) * ( size_sym + size_asym ) ) << std::endl;
+                legendre_sym_  = nullptr;
+                legendre_asym_ = nullptr;
+                legendre_lats_ = lats;
+            }
+            else if ( legendre_cache_ ) {
                 ReadCache legendre( legendre_cache_ );
                 legendre_sym_  = legendre.read<double>( size_sym );
                 legendre_asym_ = legendre.read<double>( size_asym );
@@ -565,6 +611,21 @@ TransLocal::TransLocal( const Cache& cache, const Grid& grid, const Domain& doma
             }
         }
 
+        // quadrature weights for direct transforms, which are only possible on global Gaussian grids:
+        if ( grid_.domain().global() && GaussianGrid( grid_ ) && not grid_.projection() ) {
+            ATLAS_TRACE( "Gaussian quadrature weights" );
+            const size_t N = size_t( nlatsGlobal_ / 2 );
+            std::vector<double> gaussian_lats( 2 * N );
+            std::vector<double> gaussian_weights( 2 * N );
+            util::gaussian_quadrature_npole_spole( N, gaussian_lats.data(), gaussian_weights.data() );
+            // normalise weights to sum up to 1, consistent with the normalisation of the Legendre polynomials
+            const double sum = std::accumulate( gaussian_weights.begin(), gaussian_weights.end(), 0. );
+            gaussian_weights_.resize( nlatsLeg_ );
+            for ( idx_t j = 0; j < nlatsLeg_; ++j ) {
+                gaussian_weights_[j] = gaussian_weights[j] / sum;
+            }
+        }
+
         // precomputations for Fourier transformations:
         if ( useFFT_ ) {
 #if ATLAS_HAVE_FFTW && !TRANSLOCAL_DGEMM2
@@ -604,6 +665,22 @@ TransLocal::TransLocal( const Cache& cache, const Grid& grid, const Domain& doma
                         fftw_->plans[j] = fftw_plan_dft_c2r_1d( nlonsGlobalj, fftw_->in, fftw_->out, FFTW_ESTIMATE );
                     }
                 }
+                if ( not gaussian_weights_.empty() ) {
+                    if ( RegularGrid( gridGlobal_ ) ) {
+                        fftw_->plans_dir.resize( 1 );
+                        fftw_->plans_dir[0] =
+                            fftw_plan_many_dft_r2c( 1, &nlonsMaxGlobal_, nlats, fftw_->out, nullptr, 1, nlonsMaxGlobal_,
+                                                    fftw_->in, nullptr, 1, num_complex, FFTW_ESTIMATE );
+                    }
+                    else {
+                        fftw_->plans_dir.resize( nlatsLegDomain_ );
+                        for ( int j = 0; j < nlatsLegDomain_; j++ ) {
+                            int nlonsGlobalj = gs_global.nx( jlatMinLeg_ + j );
+                            fftw_->plans_dir[j] =
+                                fftw_plan_dft_r2c_1d( nlonsGlobalj, fftw_->out, fftw_->in, FFTW_ESTIMATE );
+                        }
+                    }
+                }
                 std::string file_path = TransParameters( config ).write_fft();
                 if ( file_path.size() ) {
                     Log::debug() << "Write FFTW wisdom to file " << file_path << std::endl;
@@ -725,7 +802,7 @@ TransLocal::TransLocal( const Cache& cache, const Grid& grid, const long truncat
 
 TransLocal::~TransLocal() {
     if ( StructuredGrid( grid_ ) && not grid_.projection() ) {
-        if ( not legendre_cache_ ) {
+        if ( legendre_precompute_ && not legendre_cache_ ) {
             free_aligned( legendre_sym_, "symmetric" );
             free_aligned( legendre_asym_, "asymmetric" );
         }
@@ -734,6 +811,9 @@ TransLocal::~TransLocal() {
             for ( idx_t j = 0, size = static_cast<idx_t>( fftw_->plans.size() ); j < size; j++ ) {
                 fftw_destroy_plan( fftw_->plans[j] );
             }
+            for ( idx_t j = 0, size = static_cast<idx_t>( fftw_->plans_dir.size() ); j < size; j++ ) {
+                fftw_destroy_plan( fftw_->plans_dir[j] );
+            }
             fftw_free( fftw_->in );
             fftw_free( fftw_->out );
 #endif
@@ -841,6 +921,28 @@ void TransLocal::invtrans( const int nb_scalar_fields, const double scalar_spect
 }
 
 
+// --------------------------------------------------------------------------------------------------------------------
+
+void TransLocal::legendre_polynomials( const int jm, double*& legendre_sym, double*& legendre_asym,
+                                       std::vector<double>& buffer_sym, std::vector<double>& buffer_asym ) const {
+    // Legendre polynomials of zonal wavenumber jm, for the Legendre latitudes from nlat0_[jm] on
+    const size_t size_sym  = num_n( truncation_ + 1, jm, true );
+    const size_t size_asym = num_n( truncation_ + 1, jm, false );
+    if ( legendre_precompute_ ) {
+        legendre_sym  = legendre_sym_ + legendre_sym_begin_[jm] + nlat0_[jm] * size_sym;
+        legendre_asym = legendre_asym_ + legendre_asym_begin_[jm] + nlat0_[jm] * size_asym;
+    }
+    else {
+        const int nlats = nlatsLegReduced_ - nlat0_[jm];
+        buffer_sym.resize( size_sym * nlats );
+        buffer_asym.resize( size_asym * nlats );
+        compute_legendre_polynomials_m( truncation_ + 1, jm, nlats, legendre_lats_.data() + nlat0_[jm],
+                                        buffer_sym.data(), buffer_asym.data() );
+        legendre_sym  = buffer_sym.data();
+        legendre_asym = buffer_asym.data();
+    }
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 
 void TransLocal::invtrans_legendre( const int truncation, const int nlats, const int nb_fields,
@@ -851,6 +953,33 @@ void TransLocal::invtrans_legendre( const int truncation, const int nlats, const
         Log::debug() << "Legendre dgemm: using " << nlatsLegReduced_ - nlat0_[0] << " latitudes out of "
                      << nlatsGlobal_ / 2 << std::endl;
         ATLAS_TRACE( "Inverse Legendre Transform (GEMM)" );
+
+        // zonal wavenumbers are independent; only worth threading when the polynomials are recomputed
+        std::array<size_t, 4> sizes{0, 0, 0, 0};
+        size_t size_legendre_sym{0};
+        size_t size_legendre_asym{0};
+        for ( int jm = 0; jm <= truncation_; jm++ ) {
+            const size_t n_imag = ( jm ? 2 : 1 );
+            const size_t nlatsL = size_t( std::max( 0, nlatsLegReduced_ - nlat0_[jm] ) );
+            sizes[0]            = std::max( sizes[0], n_imag * nb_fields * num_n( truncation_ + 1, jm, true ) );
+            sizes[1]            = std::max( sizes[1], n_imag * nb_fields * num_n( truncation_ + 1, jm, false ) );
+            sizes[2]            = std::max( sizes[2], n_imag * nb_fields * nlatsL );
+            sizes[3]            = sizes[2];
+            if ( not legendre_precompute_ ) {
+                size_legendre_sym  = std::max( size_legendre_sym, num_n( truncation_ + 1, jm, true ) * nlatsL );
+                size_legendre_asym = std::max( size_legendre_asym, num_n( truncation_ + 1, jm, false ) * nlatsL );
+            }
+        }
+        const int nb_workspaces = legendre_precompute_ ? 1 : atlas_omp_get_max_threads();
+        std::vector<std::unique_ptr<LegendreWorkspace>> workspaces( nb_workspaces );
+        for ( auto& workspace : workspaces ) {
+            workspace.reset( new LegendreWorkspace( sizes, size_legendre_sym, size_legendre_asym ) );
+        }
+
+        // Errors are counted inside the parallel loop, and reported after it
+        int nb_split_errors = 0;
+        atlas_omp_pragma( omp parallel for schedule( dynamic, 1 ) reduction( + : nb_split_errors )
+                          if( not legendre_precompute_ ) )
         for ( int jm = 0; jm <= truncation_; jm++ ) {
             size_t size_sym  = num_n( truncation_ + 1, jm, true );
             size_t size_asym = num_n( truncation_ + 1, jm, false );
@@ -860,14 +989,11 @@ void TransLocal::invtrans_legendre( const int truncation, const int nlats, const
                 auto posFourier = [&]( int jfld, int imag, int jlat, int jm, int nlatsH ) {
                     return jfld + nb_fields * ( imag + n_imag * ( nlatsLegReduced_ - nlat0_[jm] - nlatsH + jlat ) );
                 };
-                double* scalar_sym;
-                double* scalar_asym;
-                double* scl_fourier_sym;
-                double* scl_fourier_asym;
-                alloc_aligned( scalar_sym, n_imag * nb_fields * size_sym );
-                alloc_aligned( scalar_asym, n_imag * nb_fields * size_asym );
-                alloc_aligned( scl_fourier_sym, size_fourier );
-                alloc_aligned( scl_fourier_asym, size_fourier );
+                LegendreWorkspace& workspace = *workspaces[atlas_omp_get_thread_num()];
+                double* scalar_sym           = workspace.arrays[0];
+                double* scalar_asym          = workspace.arrays[1];
+                double* scl_fourier_sym      = workspace.arrays[2];
+                double* scl_fourier_asym     = workspace.arrays[3];
                 {
                     //ATLAS_TRACE( "Legendre split" );
                     idx_t idx = 0, is = 0, ia = 0, ioff = ( 2 * truncation + 3 - jm ) * jm / 2 * nb_fields * 2;
@@ -901,33 +1027,44 @@ void TransLocal::invtrans_legendre( const int truncation, const int nlats, const
                             }
                         }
                     }
-                    ATLAS_ASSERT( size_t( ia ) == n_imag * nb_fields * size_asym &&
-                                  size_t( is ) == n_imag * nb_fields * size_sym );
+                    if ( size_t( ia ) != n_imag * nb_fields * size_asym ||
+                         size_t( is ) != n_imag * nb_fields * size_sym ) {
+                        ++nb_split_errors;
+                    }
                 }
                 if ( nlatsLegReduced_ - nlat0_[jm] > 0 ) {
-                    {
-                        eckit::linalg::Matrix A( scalar_sym, nb_fields * n_imag, size_sym );
-                        eckit::linalg::Matrix B( legendre_sym_ + legendre_sym_begin_[jm] + nlat0_[jm] * size_sym,
-                                                 size_sym, nlatsLegReduced_ - nlat0_[jm] );
-                        eckit::linalg::Matrix C( scl_fourier_sym, nb_fields * n_imag, nlatsLegReduced_ - nlat0_[jm] );
-                        linalg_.gemm( A, B, C );
-                        /*Log::info() << "sym: ";
-                        for ( int j = 0; j < size_sym * ( nlatsLegReduced_ - nlat0_[jm] ); j++ ) {
-                            Log::info() << legendre_sym_[j + legendre_sym_begin_[jm] + nlat0_[jm] * size_sym] << " ";
+                    double* leg_sym;
+                    double* leg_asym;
+                    legendre_polynomials( jm, leg_sym, leg_asym, workspace.legendre_sym, workspace.legendre_asym );
+
+                    // The eckit linalg backends are not known to be reentrant, so only the polynomials are computed
+                    // concurrently
+                    const int nlatsL = nlatsLegReduced_ - nlat0_[jm];
+                    atlas_omp_critical {
+                        {
+                            eckit::linalg::Matrix A( scalar_sym, nb_fields * n_imag, size_sym );
+                            eckit::linalg::Matrix B( leg_sym, size_sym, nlatsL );
+                            eckit::linalg::Matrix C( scl_fourier_sym, nb_fields * n_imag, nlatsL );
+                            linalg_.gemm( A, B, C );
+                            /*Log::info() << "sym: ";
+                            for ( int j = 0; j < size_sym * nlatsL; j++ ) {
+                                Log::info() << legendre_sym_[j + legendre_sym_begin_[jm] + nlat0_[jm] * size_sym]
+                                            << " ";
+                            }
+                            Log::info() << std::endl;*/
                         }
-                        Log::info() << std::endl;*/
-                    }
-                    if ( size_asym > 0 ) {
-                        eckit::linalg::Matrix A( scalar_asym, nb_fields * n_imag, size_asym );
-                        eckit::linalg::Matrix B( legendre_asym_ + legendre_asym_begin_[jm] + nlat0_[jm] * size_asym,
-                                                 size_asym, nlatsLegReduced_ - nlat0_[jm] );
-                        eckit::linalg::Matrix C( scl_fourier_asym, nb_fields * n_imag, nlatsLegReduced_ - nlat0_[jm] );
-                        linalg_.gemm( A, B, C );
-                        /*Log::info() << "asym: ";
-                        for ( int j = 0; j < size_asym * ( nlatsLegReduced_ - nlat0_[jm] ); j++ ) {
-                            Log::info() << legendre_asym_[j + legendre_asym_begin_[jm] + nlat0_[jm] * size_asym] << " ";
+                        if ( size_asym > 0 ) {
+                            eckit::linalg::Matrix A( scalar_asym, nb_fields * n_imag, size_asym );
+                            eckit::linalg::Matrix B( leg_asym, size_asym, nlatsL );
+                            eckit::linalg::Matrix C( scl_fourier_asym, nb_fields * n_imag, nlatsL );
+                            linalg_.gemm( A, B, C );
+                            /*Log::info() << "asym: ";
+                            for ( int j = 0; j < size_asym * nlatsL; j++ ) {
+                                Log::info() << legendre_asym_[j + legendre_asym_begin_[jm] + nlat0_[jm] * size_asym]
+                                            << " ";
+                            }
+                            Log::info() << std::endl;*/
                         }
-                        Log::info() << std::endl;*/
                     }
                 }
                 {
@@ -980,10 +1117,6 @@ void TransLocal::invtrans_legendre( const int truncation, const int nlats, const
                         }
                     }
                 }
-                free_aligned( scalar_sym );
-                free_aligned( scalar_asym );
-                free_aligned( scl_fourier_sym );
-                free_aligned( scl_fourier_asym );
             }
             else {
                 for ( int jlat = 0; jlat < nlats; jlat++ ) {
@@ -995,6 +1128,7 @@ void TransLocal::invtrans_legendre( const int truncation, const int nlats, const
                 }
             }
         }
+        ATLAS_ASSERT( nb_split_errors == 0, "Legendre split of spectral data" );
     }
 }
 
@@ -1538,44 +1672,351 @@ void TransLocal::invtrans( const int nb_scalar_fields, const double scalar_spect
 // --------------------------------------------------------------------------------------------------------------------
 
 void TransLocal::dirtrans( const Field& gpfield, Field& spfield, const eckit::Configuration& config ) const {
-    ATLAS_NOTIMPLEMENTED;
-    // Not implemented and not planned.
-    // Use the TransIFS implementation instead.
+    // VERY PRELIMINARY IMPLEMENTATION WITHOUT ANY GUARANTEES
+    int nb_scalar_fields = 1;
+    const auto gp_fields = array::make_view<double, 1>( gpfield );
+    auto scalar_spectra  = array::make_view<double, 1>( spfield );
+
+    ATLAS_ASSERT( gp_fields.shape( 0 ) >= grid().size() );
+    ATLAS_ASSERT( scalar_spectra.shape( 0 ) >= idx_t( nb_spectral_coefficients() ) );
+
+    dirtrans( nb_scalar_fields, gp_fields.data(), scalar_spectra.data(), config );
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
 void TransLocal::dirtrans( const FieldSet& gpfields, FieldSet& spfields, const eckit::Configuration& config ) const {
-    ATLAS_NOTIMPLEMENTED;
-    // Not implemented and not planned.
-    // Use the TransIFS implementation instead.
+    // VERY PRELIMINARY IMPLEMENTATION WITHOUT ANY GUARANTEES
+    ATLAS_ASSERT( gpfields.size() == spfields.size() );
+    for ( idx_t f = 0; f < gpfields.size(); ++f ) {
+        dirtrans( gpfields[f], spfields[f], config );
+    }
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
 void TransLocal::dirtrans_wind2vordiv( const Field& gpwind, Field& spvor, Field& spdiv,
                                        const eckit::Configuration& config ) const {
-    ATLAS_NOTIMPLEMENTED;
-    // Not implemented and not planned.
-    // Use the TransIFS implementation instead.
+    // VERY PRELIMINARY IMPLEMENTATION WITHOUT ANY GUARANTEES
+    int nb_vordiv_fields    = 1;
+    const auto gp_fields    = array::make_view<double, 2>( gpwind );
+    auto vorticity_spectra  = array::make_view<double, 1>( spvor );
+    auto divergence_spectra = array::make_view<double, 1>( spdiv );
+
+    if ( gp_fields.shape( 1 ) == grid().size() && gp_fields.shape( 0 ) == 2 ) {
+        dirtrans( nb_vordiv_fields, gp_fields.data(), vorticity_spectra.data(), divergence_spectra.data(), config );
+    }
+    else if ( gp_fields.shape( 0 ) == grid().size() && gp_fields.shape( 1 ) == 2 ) {
+        std::vector<double> gpwind_t( 2 * grid().size() );
+        gp_transpose( grid().size(), 2, gp_fields.data(), gpwind_t.data() );
+        dirtrans( nb_vordiv_fields, gpwind_t.data(), vorticity_spectra.data(), divergence_spectra.data(), config );
+    }
+    else {
+        ATLAS_NOTIMPLEMENTED;
+    }
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
 void TransLocal::dirtrans( const int nb_fields, const double scalar_fields[], double scalar_spectra[],
-                           const eckit::Configuration& ) const {
-    ATLAS_NOTIMPLEMENTED;
-    // Not implemented and not planned.
-    // Use the TransIFS implementation instead.
+                           const eckit::Configuration& config ) const {
+    dirtrans_uv( truncation_, nb_fields, 0, scalar_fields, scalar_spectra, config );
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Routine to compute spectral vorticity and divergence out of the spectral coefficients of U/(1-mu^2) and
+// V/(1-mu^2), i.e. u/cos(latitude) and v/cos(latitude), given up to truncation+1.
+// This is the inverse of vd2uv, and follows from
+//     (1-mu^2) dP(n,m)/dmu = -n*eps(n+1,m)*P(n+1,m) + (n+1)*eps(n,m)*P(n-1,m)
+// Reference:
+//        Temperton, 1991, MWR 119 p1303
+void uv2vd( const int truncation,     // truncation of vorticity and divergence
+            const int nb_vordiv_fields,  // number of vorticity and divergence fields
+            const double UV_spectra[],   // spectral data of U and V fields, truncated at truncation+1
+            double vorticity_spectra[],  // spectral data of vorticity
+            double divergence_spectra[] ) {
+    const int nb_all_fields = 2 * nb_vordiv_fields;
+    const double za_r       = 1. / util::Earth::radius();
+    auto eps                = []( int jn, int jm ) {
+        return jn > jm ? std::sqrt( ( jn * jn - jm * jm ) / ( 4. * jn * jn - 1. ) ) : 0.;
+    };
+    auto pos_UV = [&]( int jfld, int imag, int jn, int jm ) {
+        return jfld + nb_all_fields * ( imag + 2 * ( jn - jm ) ) + ( 2 * truncation + 5 - jm ) * jm * nb_all_fields;
+    };
+    auto pos = [&]( int jfld, int imag, int jn, int jm ) {
+        return jfld + nb_vordiv_fields * ( imag + 2 * ( jn - jm ) ) + ( 2 * truncation + 3 - jm ) * jm * nb_vordiv_fields;
+    };
+    for ( int jm = 0; jm <= truncation; ++jm ) {
+        for ( int jn = jm; jn <= truncation; ++jn ) {
+            const double cP1 = jn * eps( jn + 1, jm );
+            const double cM1 = ( jn + 1 ) * eps( jn, jm );
+            for ( int jfld = 0; jfld < nb_vordiv_fields; ++jfld ) {
+                const int jU = jfld;
+                const int jV = nb_vordiv_fields + jfld;
+                for ( int imag = 0; imag < 2; ++imag ) {
+                    // real part of i*m*X is -m*Im(X), imaginary part is m*Re(X)
+                    const double sign = imag ? 1. : -1.;
+                    double vor        = sign * jm * UV_spectra[pos_UV( jV, 1 - imag, jn, jm )] -
+                                 cP1 * UV_spectra[pos_UV( jU, imag, jn + 1, jm )];
+                    double div = sign * jm * UV_spectra[pos_UV( jU, 1 - imag, jn, jm )] +
+                                 cP1 * UV_spectra[pos_UV( jV, imag, jn + 1, jm )];
+                    if ( jn > jm ) {
+                        vor += cM1 * UV_spectra[pos_UV( jU, imag, jn - 1, jm )];
+                        div -= cM1 * UV_spectra[pos_UV( jV, imag, jn - 1, jm )];
+                    }
+                    vorticity_spectra[pos( jfld, imag, jn, jm )]  = vor * za_r;
+                    divergence_spectra[pos( jfld, imag, jn, jm )] = div * za_r;
+                }
+            }
+        }
+    }
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
 void TransLocal::dirtrans( const int nb_fields, const double wind_fields[], double vorticity_spectra[],
-                           double divergence_spectra[], const eckit::Configuration& ) const {
-    ATLAS_NOTIMPLEMENTED;
-    // Not implemented and not planned.
-    // Use the TransIFS implementation instead.
+                           double divergence_spectra[], const eckit::Configuration& config ) const {
+    ATLAS_TRACE( "TransLocal::dirtrans" );
+    // spectral data of u/cos(latitude) and v/cos(latitude) up to truncation_+1:
+    int nb_all_fields = 2 * nb_fields;
+    std::vector<double> UV_ext( 2 * legendre_size( truncation_ + 1 ) * nb_all_fields );
+    dirtrans_uv( truncation_ + 1, nb_all_fields, nb_fields, wind_fields, UV_ext.data(), config );
+    {
+        ATLAS_TRACE( "UV to vordiv" );
+        uv2vd( truncation_, nb_fields, UV_ext.data(), vorticity_spectra, divergence_spectra );
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void TransLocal::dirtrans_fourier( const int nlats, const StructuredGrid& g, const int nb_fields,
+                                   const double gp_fields[], double scl_fourier[],
+                                   const eckit::Configuration& ) const {
+    // Fourier coefficients are scaled such that the inverse transform is a plain sum over zonal wavenumbers
+    if ( useFFT_ ) {
+#if ATLAS_HAVE_FFTW && !TRANSLOCAL_DGEMM2
+        int num_complex = ( nlonsMaxGlobal_ / 2 ) + 1;
+        if ( RegularGrid( gridGlobal_ ) ) {
+            ATLAS_TRACE( "Direct Fourier Transform (FFTW, RegularGrid)" );
+            const int nlons = nlonsMaxGlobal_;
+            const int trcFT = std::min( truncation_, ( nlons - 1 ) / 2 );
+            for ( int jfld = 0; jfld < nb_fields; jfld++ ) {
+                std::copy( gp_fields + nlons * nlats * jfld, gp_fields + nlons * nlats * ( jfld + 1 ), fftw_->out );
+                fftw_execute_dft_r2c( fftw_->plans_dir[0], fftw_->out, fftw_->in );
+                for ( int jlat = 0; jlat < nlats; jlat++ ) {
+                    for ( int jm = 0; jm <= trcFT; jm++ ) {
+                        for ( int imag = 0; imag < 2; imag++ ) {
+                            scl_fourier[posMethod( jfld, imag, jlat, jm, nb_fields, nlats )] =
+                                fftw_->in[jm + num_complex * jlat][imag] / nlons;
+                        }
+                    }
+                }
+            }
+        }
+        else {
+            ATLAS_TRACE( "Direct Fourier Transform (FFTW, ReducedGrid)" );
+            int jgp = 0;
+            for ( int jfld = 0; jfld < nb_fields; jfld++ ) {
+                for ( int jlat = 0; jlat < nlats; jlat++ ) {
+                    const int nlons = g.nx( jlat );
+                    const int trcFT = std::min( truncation_, ( nlons - 1 ) / 2 );
+                    std::copy( gp_fields + jgp, gp_fields + jgp + nlons, fftw_->out );
+                    jgp += nlons;
+                    int jplan = nlatsLegDomain_ - nlatsNH_ + jlat;
+                    if ( jplan >= nlatsLegDomain_ ) {
+                        jplan = nlats - 1 + nlatsLegDomain_ - nlatsSH_ - jlat;
+                    };
+                    fftw_execute_dft_r2c( fftw_->plans_dir[jplan], fftw_->out, fftw_->in );
+                    for ( int jm = 0; jm <= trcFT; jm++ ) {
+                        for ( int imag = 0; imag < 2; imag++ ) {
+                            scl_fourier[posMethod( jfld, imag, jlat, jm, nb_fields, nlats )] =
+                                fftw_->in[jm][imag] / nlons;
+                        }
+                    }
+                }
+            }
+        }
+#endif
+    }
+    else {
+        ATLAS_TRACE( "Direct Fourier Transform (NoFFT)" );
+        int jgp0 = 0;
+        for ( int jlat = 0; jlat < nlats; jlat++ ) {
+            const int nlons = g.nx( jlat );
+            const int trcFT = std::min( truncation_, ( nlons - 1 ) / 2 );
+            for ( int jm = 0; jm <= trcFT; jm++ ) {
+                for ( int jfld = 0; jfld < nb_fields; jfld++ ) {
+                    const double* gp = gp_fields + jfld * grid_.size() + jgp0;
+                    double real = 0.;
+                    double imag = 0.;
+                    for ( int jlon = 0; jlon < nlons; jlon++ ) {
+                        const double lon = jm * g.x( jlon, jlat ) * util::Constants::degreesToRadians();
+                        real += gp[jlon] * std::cos( lon );
+                        imag -= gp[jlon] * std::sin( lon );
+                    }
+                    scl_fourier[posMethod( jfld, 0, jlat, jm, nb_fields, nlats )] = real / nlons;
+                    scl_fourier[posMethod( jfld, 1, jlat, jm, nb_fields, nlats )] = imag / nlons;
+                }
+            }
+            jgp0 += nlons;
+        }
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void TransLocal::dirtrans_legendre( const int truncation, const int nlats, const int nb_fields,
+                                    const double scl_fourier[], double scalar_spectra[],
+                                    const eckit::Configuration& ) const {
+    ATLAS_TRACE( "Direct Legendre Transform (GEMM)" );
+    const int nb_spec = 2 * legendre_size( truncation ) * nb_fields;
+    std::fill( scalar_spectra, scalar_spectra + nb_spec, 0. );
+
+    // zonal wavenumbers are independent; only worth threading when the polynomials are recomputed
+    const int nb_m = std::min( truncation, truncation_ ) + 1;
+    std::array<size_t, 4> sizes{0, 0, 0, 0};
+    size_t size_legendre_sym{0};
+    size_t size_legendre_asym{0};
+    for ( int jm = 0; jm < nb_m; jm++ ) {
+        const size_t n_imag = ( jm ? 2 : 1 );
+        const size_t nlatsL = size_t( std::max( 0, nlatsLegReduced_ - nlat0_[jm] ) );
+        sizes[0]            = std::max( sizes[0], nlatsL * nb_fields * n_imag );
+        sizes[1]            = sizes[0];
+        sizes[2]            = std::max( sizes[2], num_n( truncation_ + 1, jm, true ) * nb_fields * n_imag );
+        sizes[3]            = std::max( sizes[3], num_n( truncation_ + 1, jm, false ) * nb_fields * n_imag );
+        if ( not legendre_precompute_ ) {
+            size_legendre_sym  = std::max( size_legendre_sym, num_n( truncation_ + 1, jm, true ) * nlatsL );
+            size_legendre_asym = std::max( size_legendre_asym, num_n( truncation_ + 1, jm, false ) * nlatsL );
+        }
+    }
+    const int nb_workspaces = legendre_precompute_ ? 1 : atlas_omp_get_max_threads();
+    std::vector<std::unique_ptr<LegendreWorkspace>> workspaces( nb_workspaces );
+    for ( auto& workspace : workspaces ) {
+        workspace.reset( new LegendreWorkspace( sizes, size_legendre_sym, size_legendre_asym ) );
+    }
+
+    atlas_omp_pragma( omp parallel for schedule( dynamic, 1 ) if( not legendre_precompute_ ) )
+    for ( int jm = 0; jm < nb_m; jm++ ) {
+        const size_t size_sym  = num_n( truncation_ + 1, jm, true );
+        const size_t size_asym = num_n( truncation_ + 1, jm, false );
+        const int n_imag       = ( jm ? 2 : 1 );
+        const int nlatsL       = nlatsLegReduced_ - nlat0_[jm];
+        if ( nlatsL <= 0 ) {
+            continue;
+        }
+        // weighted sums and differences of the Fourier coefficients of both hemispheres, laid out as
+        // (latitude, field) matrices so that the transposed Legendre polynomials are not needed
+        LegendreWorkspace& workspace = *workspaces[atlas_omp_get_thread_num()];
+        double* fourier_sym          = workspace.arrays[0];
+        double* fourier_asym         = workspace.arrays[1];
+        double* scalar_sym           = workspace.arrays[2];
+        double* scalar_asym          = workspace.arrays[3];
+        for ( int jlat = 0; jlat < nlatsL; jlat++ ) {
+            const int jlatN = nlat0_[jm] + jlat;
+            const int jlatS     = nlats - 1 - jlatN;
+            const double weight = gaussian_weights_[jlatN];
+            for ( int imag = 0; imag < n_imag; imag++ ) {
+                for ( int jfld = 0; jfld < nb_fields; jfld++ ) {
+                    const double north = scl_fourier[posMethod( jfld, imag, jlatN, jm, nb_fields, nlats )];
+                    const double south = scl_fourier[posMethod( jfld, imag, jlatS, jm, nb_fields, nlats )];
+                    const int idx      = jlat + nlatsL * ( jfld + nb_fields * imag );
+                    fourier_sym[idx]   = weight * ( north + south );
+                    fourier_asym[idx]  = weight * ( north - south );
+                }
+            }
+        }
+        double* leg_sym;
+        double* leg_asym;
+        legendre_polynomials( jm, leg_sym, leg_asym, workspace.legendre_sym, workspace.legendre_asym );
+
+        // The eckit linalg backends are not known to be reentrant, so only the polynomials are computed concurrently
+        atlas_omp_critical {
+            {
+                eckit::linalg::Matrix A( leg_sym, size_sym, nlatsL );
+                eckit::linalg::Matrix B( fourier_sym, nlatsL, nb_fields * n_imag );
+                eckit::linalg::Matrix C( scalar_sym, size_sym, nb_fields * n_imag );
+                linalg_.gemm( A, B, C );
+            }
+            if ( size_asym > 0 ) {
+                eckit::linalg::Matrix A( leg_asym, size_asym, nlatsL );
+                eckit::linalg::Matrix B( fourier_asym, nlatsL, nb_fields * n_imag );
+                eckit::linalg::Matrix C( scalar_asym, size_asym, nb_fields * n_imag );
+                linalg_.gemm( A, B, C );
+            }
+        }
+        {
+            // merge symmetric and antisymmetric parts, in the same order as in invtrans_legendre
+            const int ioff = ( 2 * truncation + 3 - jm ) * jm / 2 * nb_fields * 2;
+            size_t is = 0, ia = 0;
+            for ( int jn = truncation_ + 1; jn >= jm; jn-- ) {
+                const bool sym       = ( jn - jm ) % 2 == 0;
+                const double* coeffs = sym ? scalar_sym + is++ : scalar_asym + ia++;
+                const size_t size    = sym ? size_sym : size_asym;
+                if ( jn <= truncation ) {
+                    for ( int imag = 0; imag < n_imag; imag++ ) {
+                        for ( int jfld = 0; jfld < nb_fields; jfld++ ) {
+                            scalar_spectra[jfld + nb_fields * ( imag + 2 * ( jn - jm ) ) + ioff] =
+                                coeffs[size * ( jfld + nb_fields * imag )];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Routine to compute the direct spectral transform on a global Gaussian grid, reusing the Legendre polynomials and
+// the FFT plans of the inverse transform. U and v components are divided by cos(latitude) for nb_vordiv_fields > 0,
+// so that the resulting spectral data can be converted to vorticity and divergence with uv2vd.
+//
+// The parameter truncation is the truncation of the computed spectral data scalar_spectra, and can be truncation_
+// or truncation_+1.
+//
+void TransLocal::dirtrans_uv( const int truncation, const int nb_scalar_fields, const int nb_vordiv_fields,
+                              const double gp_fields[], double scalar_spectra[],
+                              const eckit::Configuration& config ) const {
+    if ( gaussian_weights_.empty() ) {
+        throw_NotImplemented( "Direct transforms with TransLocal are only supported for global Gaussian grids", Here() );
+    }
+    ATLAS_ASSERT( truncation <= truncation_ + 1 );
+    if ( nb_scalar_fields > 0 ) {
+        const int nb_fields = nb_scalar_fields;
+
+        auto g = StructuredGrid( grid_ );
+        ATLAS_TRACE( "dirtrans_uv structured" );
+        const int nlats = g.ny();
+
+        // Computing u/cos(lat),v/cos(lat) from u,v:
+        std::vector<double> gp_uv;
+        if ( nb_vordiv_fields > 0 ) {
+            ATLAS_TRACE( "compute u/cos(lat),v/cos(lat) from u,v" );
+            gp_uv.assign( gp_fields, gp_fields + nb_fields * grid_.size() );
+            int idx = 0;
+            for ( idx_t jfld = 0; jfld < 2 * nb_vordiv_fields && jfld < nb_fields; jfld++ ) {
+                for ( idx_t jlat = 0; jlat < nlats; jlat++ ) {
+                    const double coslatinv = 1. / std::cos( g.y( jlat ) * util::Constants::degreesToRadians() );
+                    for ( idx_t jlon = 0; jlon < g.nx( jlat ); jlon++ ) {
+                        gp_uv[idx++] *= coslatinv;
+                    }
+                }
+            }
+            gp_fields = gp_uv.data();
+        }
+
+        const int size_fourier_max = nb_fields * 2 * nlats;
+        double* scl_fourier;
+        alloc_aligned( scl_fourier, size_fourier_max * ( truncation_ + 1 ) );
+        std::fill( scl_fourier, scl_fourier + size_fourier_max * ( truncation_ + 1 ), 0. );
+
+        // Fourier transformation:
+        dirtrans_fourier( nlats, g, nb_fields, gp_fields, scl_fourier, config );
+
+        // Legendre transformation:
+        dirtrans_legendre( truncation, nlats, nb_fields, scl_fourier, scalar_spectra, config );
+
+        free_aligned( scl_fourier );
+    }
 }
 
 // --------------------------------------------------------------------------------------------------------------------
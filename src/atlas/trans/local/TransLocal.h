@@ -64,8 +64,12 @@ int fourier_truncation( const int truncation,  // truncation
 ///  - support multiple fields
 ///  - support atlas::Field and atlas::FieldSet based on function spaces
 ///
-/// @note: Direct transforms are not implemented and cannot be unless
-///        the grid is global. There are no plans to support this at the moment.
+/// @note: Direct transforms are only implemented for global Gaussian grids,
+///        as they rely on Gaussian quadrature.
+///
+/// @note: With the option "legendre_precompute" = false the Legendre polynomials of structured grids
+///        are not stored, but recomputed for each zonal wavenumber during the transforms. This trades
+///        O(T^3) memory for computations, and parallelises the Legendre transform over zonal wavenumbers.
 class TransLocal : public trans::TransImpl {
 public:
     TransLocal( const Grid&, const long truncation, const eckit::Configuration& = util::NoConfig() );
@@ -114,8 +118,6 @@ public:
                            const double divergence_spectra[], double gp_fields[],
                            const eckit::Configuration& = util::NoConfig() ) const override;
 
-    // -- NOT SUPPORTED -- //
-
     virtual void dirtrans( const Field& gpfield, Field& spfield,
                            const eckit::Configuration& = util::NoConfig() ) const override;
 
@@ -141,6 +143,9 @@ private:
 #endif
     }
 
+    void legendre_polynomials( const int jm, double*& legendre_sym, double*& legendre_asym,
+                               std::vector<double>& buffer_sym, std::vector<double>& buffer_asym ) const;
+
     void invtrans_legendre( const int truncation, const int nlats, const int nb_fields, const int nb_vordiv_fields,
                             const double scalar_spectra[], double scl_fourier[],
                             const eckit::Configuration& config ) const;
@@ -163,6 +168,16 @@ private:
                       const double scalar_spectra[], double gp_fields[],
                       const eckit::Configuration& = util::NoConfig() ) const;
 
+    void dirtrans_fourier( const int nlats, const StructuredGrid& g, const int nb_fields, const double gp_fields[],
+                           double scl_fourier[], const eckit::Configuration& config ) const;
+
+    void dirtrans_legendre( const int truncation, const int nlats, const int nb_fields, const double scl_fourier[],
+                            double scalar_spectra[], const eckit::Configuration& config ) const;
+
+    void dirtrans_uv( const int truncation, const int nb_scalar_fields, const int nb_vordiv_fields,
+                      const double gp_fields[], double scalar_spectra[],
+                      const eckit::Configuration& = util::NoConfig() ) const;
+
     bool warning( const eckit::Configuration& = util::NoConfig() ) const;
 
     friend class LegendreCacheCreatorLocal;
@@ -189,6 +204,7 @@ private:
     std::vector<idx_t> nlat0_;
     idx_t nlatsGlobal_;
     bool precompute_;
+    bool legendre_precompute_;
     double* legendre_;
     double* legendre_sym_;
     double* legendre_asym_;
@@ -197,6 +213,8 @@ private:
     std::vector<size_t> legendre_begin_;
     std::vector<size_t> legendre_sym_begin_;
     std::vector<size_t> legendre_asym_begin_;
+    std::vector<double> legendre_lats_;    // Legendre latitudes in radians, to recompute Legendre polynomials
+    std::vector<double> gaussian_weights_;  // quadrature weights of Legendre latitudes, for direct transforms
 
     Cache cache_;
     Cache export_legendre_;
@@ -84,6 +84,7 @@ LonLatPolygon::LonLatPolygon( const Polygon& poly, const atlas::Field& coordinat
     PolygonCoordinates( poly, coordinates, removeAlignedPoints ) {
     centroid_             = compute_centroid( coordinates_ );
     inner_radius_squared_ = compute_inner_radius_squared( coordinates_, centroid_ );
+    setup( true );
 }
 
 template <typename PointContainer, LonLatPolygon::enable_if_not_polygon<PointContainer> >
@@ -91,6 +92,7 @@ LonLatPolygon::LonLatPolygon( const PointContainer& points, bool removeAlignedPo
     PolygonCoordinates( points, removeAlignedPoints ) {
     centroid_             = compute_centroid( coordinates_ );
     inner_radius_squared_ = compute_inner_radius_squared( coordinates_, centroid_ );
+    setup( true );
 
     ATLAS_ASSERT( contains( centroid_ ) );
 }
@@ -101,47 +103,126 @@ LonLatPolygon::LonLatPolygon( const PartitionPolygon& partition_polygon ) :
     if ( inscribed ) {
         inner_coordinatesMin_ = {inscribed.xmin(), inscribed.ymin()};
         inner_coordinatesMax_ = {inscribed.xmax(), inscribed.ymax()};
+        setup( false );
     }
     else {
         centroid_             = compute_centroid( coordinates_ );
         inner_radius_squared_ = compute_inner_radius_squared( coordinates_, centroid_ );
+        setup( true );
 
         ATLAS_ASSERT( contains( centroid_ ) );
     }
 }
 
-bool LonLatPolygon::contains( const Point2& P ) const {
-    auto distance2 = []( const Point2& p, const Point2& centroid ) {
-        double dx = ( p[0] - centroid[0] );
-        double dy = ( p[1] - centroid[1] );
-        return dx * dx + dy * dy;
-    };
+void LonLatPolygon::setup( bool compute_inscribed_rectangle ) {
+    const idx_t nb_edges = idx_t( coordinates_.size() ) - 1;
+
+    // Uniform latitude bands, about one edge per band for typical partition polygons. The number of bands is
+    // bounded, as edges spanning many bands are stored in each of them.
+    nb_bands_         = std::max<idx_t>( 1, std::min<idx_t>( nb_edges, 4096 ) );
+    band_lat_min_     = coordinatesMin_[LAT];
+    const double dlat = ( coordinatesMax_[LAT] - coordinatesMin_[LAT] ) / nb_bands_;
+    band_inv_dlat_    = dlat > 0. ? 1. / dlat : 0.;
+
+    band_begin_.assign( nb_bands_ + 1, 0 );
+    for ( idx_t i = 1; i <= nb_edges; ++i ) {
+        const idx_t b_end = band( std::max( coordinates_[i - 1][LAT], coordinates_[i][LAT] ) );
+        for ( idx_t b = band( std::min( coordinates_[i - 1][LAT], coordinates_[i][LAT] ) ); b <= b_end; ++b ) {
+            ++band_begin_[b + 1];
+        }
+    }
+    for ( idx_t b = 0; b < nb_bands_; ++b ) {
+        band_begin_[b + 1] += band_begin_[b];
+    }
+    band_edges_.resize( band_begin_[nb_bands_] );
+    std::vector<idx_t> band_end( band_begin_.begin(), band_begin_.end() - 1 );
+    for ( idx_t i = 1; i <= nb_edges; ++i ) {
+        const idx_t b_end = band( std::max( coordinates_[i - 1][LAT], coordinates_[i][LAT] ) );
+        for ( idx_t b = band( std::min( coordinates_[i - 1][LAT], coordinates_[i][LAT] ) ); b <= b_end; ++b ) {
+            band_edges_[band_end[b]++] = i;
+        }
+    }
 
-    // check first bounding box
-    if ( coordinatesMax_[LAT] < P[LAT] || P[LAT] < coordinatesMin_[LAT] || coordinatesMax_[LON] < P[LON] ||
-         P[LON] < coordinatesMin_[LON] ) {
-        return false;
+    if ( not compute_inscribed_rectangle ) {
+        return;
     }
 
-    if ( inner_radius_squared_ == 0 ) {  // check inner bounding box
-        if ( inner_coordinatesMin_[LON] <= P[LON] && inner_coordinatesMax_[LON] >= P[LON] &&
-             inner_coordinatesMin_[LAT] <= P[LAT] && inner_coordinatesMax_[LAT] >= P[LAT] ) {
-            return true;
+    // Start from the square inscribed in the inscribed circle, and push its sides outwards with a bisection
+    // for as long as no edge crosses it. Being connected and not crossed by any edge, the rectangle has the
+    // winding number of the centroid.
+    inner_coordinatesMin_ = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    inner_coordinatesMax_ = {std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+    if ( inner_radius_squared_ <= 0. || winding_number( centroid_ ) == 0 ) {
+        return;
+    }
+    const double h = std::sqrt( 0.5 * inner_radius_squared_ );
+    Point2 min( centroid_[LON] - h, centroid_[LAT] - h );
+    Point2 max( centroid_[LON] + h, centroid_[LAT] + h );
+    if ( intersects( min, max ) ) {
+        return;
+    }
+    for ( int sweep = 0; sweep < 2; ++sweep ) {
+        for ( int side = 0; side < 4; ++side ) {
+            const size_t dim = ( side % 2 == 0 ) ? LON : LAT;
+            const bool upper = ( side >= 2 );
+            double inside    = upper ? max[dim] : min[dim];
+            double outside   = upper ? coordinatesMax_[dim] : coordinatesMin_[dim];
+            for ( int k = 0; k < 20; ++k ) {
+                const double mid = 0.5 * ( inside + outside );
+                Point2 trial_min = min;
+                Point2 trial_max = max;
+                ( upper ? trial_max : trial_min )[dim] = mid;
+                ( intersects( trial_min, trial_max ) ? outside : inside ) = mid;
+            }
+            ( upper ? max : min )[dim] = inside;
         }
     }
-    else {  // check inscribed circle
-        if ( distance2( P, centroid_ ) < inner_radius_squared_ ) {
+    inner_coordinatesMin_ = {min[LON], min[LAT]};
+    inner_coordinatesMax_ = {max[LON], max[LAT]};
+}
+
+bool LonLatPolygon::intersects( const Point2& min, const Point2& max ) const {
+    // Liang-Barsky clipping of every edge against the rectangle
+    for ( size_t i = 1; i < coordinates_.size(); ++i ) {
+        const Point2& A = coordinates_[i - 1];
+        const Point2& B = coordinates_[i];
+        const double d[2]{B[LON] - A[LON], B[LAT] - A[LAT]};
+        double t0    = 0.;
+        double t1    = 1.;
+        bool clipped = false;
+        for ( size_t dim = 0; dim < 2 && not clipped; ++dim ) {
+            const double p[2]{-d[dim], d[dim]};
+            const double q[2]{A[dim] - min[dim], max[dim] - A[dim]};
+            for ( int k = 0; k < 2; ++k ) {
+                if ( p[k] == 0. ) {
+                    clipped = clipped || q[k] < 0.;
+                }
+                else {
+                    const double r = q[k] / p[k];
+                    if ( p[k] < 0. ) {
+                        t0 = std::max( t0, r );
+                    }
+                    else {
+                        t1 = std::min( t1, r );
+                    }
+                }
+            }
+        }
+        if ( not clipped && t0 <= t1 ) {
             return true;
         }
     }
+    return false;
+}
 
-    // winding number
+int LonLatPolygon::winding_number( const Point2& P ) const {
     int wn = 0;
 
-    // loop on polygon edges
-    for ( size_t i = 1; i < coordinates_.size(); ++i ) {
-        const Point2& A = coordinates_[i - 1];
-        const Point2& B = coordinates_[i];
+    // loop on polygon edges overlapping the latitude band of P, other edges cannot be crossed
+    const idx_t b = band( P[LAT] );
+    for ( idx_t k = band_begin_[b]; k < band_begin_[b + 1]; ++k ) {
+        const Point2& A = coordinates_[band_edges_[k] - 1];
+        const Point2& B = coordinates_[band_edges_[k]];
 
         // check point-edge side and direction, using 2D-analog cross-product;
         // tests if P is left|on|right of a directed A-B infinite line, by
@@ -161,9 +242,35 @@ bool LonLatPolygon::contains( const Point2& P ) const {
             }
         }
     }
+    return wn;
+}
+
+bool LonLatPolygon::contains( const Point2& P ) const {
+    auto distance2 = []( const Point2& p, const Point2& centroid ) {
+        double dx = ( p[0] - centroid[0] );
+        double dy = ( p[1] - centroid[1] );
+        return dx * dx + dy * dy;
+    };
+
+    // check first bounding box
+    if ( coordinatesMax_[LAT] < P[LAT] || P[LAT] < coordinatesMin_[LAT] || coordinatesMax_[LON] < P[LON] ||
+         P[LON] < coordinatesMin_[LON] ) {
+        return false;
+    }
+
+    // check inner bounding box
+    if ( inner_coordinatesMin_[LON] <= P[LON] && inner_coordinatesMax_[LON] >= P[LON] &&
+         inner_coordinatesMin_[LAT] <= P[LAT] && inner_coordinatesMax_[LAT] >= P[LAT] ) {
+        return true;
+    }
+
+    // check inscribed circle
+    if ( inner_radius_squared_ > 0 && distance2( P, centroid_ ) < inner_radius_squared_ ) {
+        return true;
+    }
 
     // wn == 0 only when P is outside
-    return wn != 0;
+    return winding_number( P ) != 0;
 }
 
 //------------------------------------------------------------------------------------------------------
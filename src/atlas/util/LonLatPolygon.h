@@ -10,7 +10,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 
 #include "atlas/util/Polygon.h"
 
@@ -46,11 +48,37 @@ public:
    */
     bool contains( const Point2& P ) const;
 
+    /// @brief Inscribed rectangle (not rotated) in which every point is contained, empty if none was found
+    const Point2& innerCoordinatesMin() const { return inner_coordinatesMin_; }
+    const Point2& innerCoordinatesMax() const { return inner_coordinatesMax_; }
+
+private:
+    /// Index edges in latitude bands, and grow an inscribed rectangle around the centroid if none was given
+    void setup( bool compute_inscribed_rectangle );
+
+    /// Latitude band of a latitude, clamped to the bounding box
+    idx_t band( double lat ) const {
+        return std::min( nb_bands_ - 1, std::max<idx_t>( 0, idx_t( ( lat - band_lat_min_ ) * band_inv_dlat_ ) ) );
+    }
+
+    /// Winding number of the polygon around P, counting only the edges of the latitude band of P
+    int winding_number( const Point2& P ) const;
+
+    /// True if any polygon edge intersects the closed rectangle [min,max]
+    bool intersects( const Point2& min, const Point2& max ) const;
+
 private:
     PointLonLat centroid_;
     double inner_radius_squared_{0};
     PointLonLat inner_coordinatesMin_;
     PointLonLat inner_coordinatesMax_;
+
+    // Uniform latitude bands, each with the edges (index of end point in coordinates_) overlapping it
+    double band_lat_min_{0};
+    double band_inv_dlat_{0};
+    idx_t nb_bands_{0};
+    std::vector<idx_t> band_begin_;
+    std::vector<idx_t> band_edges_;
 };
 
 //------------------------------------------------------------------------------------------------------
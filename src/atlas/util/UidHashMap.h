@@ -0,0 +1,330 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "atlas/library/config.h"
+#include "atlas/parallel/omp/omp.h"
+#include "atlas/runtime/Exception.h"
+
+namespace atlas {
+namespace util {
+
+namespace detail {
+/// Finaliser of splitmix64: unique indices of neighbouring points differ in few bits only
+inline std::uint64_t hash_uid( uidx_t uid ) {
+    std::uint64_t x = static_cast<std::uint64_t>( uid );
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+}  // namespace detail
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// @brief Hash map from unique indices (uidx_t) to values, stored in one flat array
+///
+/// Collisions are resolved with linear probing, so that a lookup touches one or two cache lines instead of
+/// a path of tree nodes as with std::map. The table is divided in shards chosen by the high bits of the hash,
+/// which allows build() to fill the shards on separate OpenMP threads.
+/// Iteration order is unspecified. The key std::numeric_limits<uidx_t>::min() is reserved for empty slots.
+template <typename Value>
+class UidHashMap {
+public:
+    using key_type    = uidx_t;
+    using mapped_type = Value;
+    using value_type  = std::pair<uidx_t, Value>;
+
+    template <typename Slot>
+    class basic_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename std::remove_const<Slot>::type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = Slot*;
+        using reference         = Slot&;
+
+        basic_iterator() = default;
+        basic_iterator( Slot* slot, Slot* end ) : slot_( slot ), end_( end ) { skip_empty(); }
+        template <typename Other>
+        basic_iterator( const basic_iterator<Other>& other ) : slot_( other.slot_ ), end_( other.end_ ) {}
+
+        reference operator*() const { return *slot_; }
+        pointer operator->() const { return slot_; }
+        basic_iterator& operator++() {
+            ++slot_;
+            skip_empty();
+            return *this;
+        }
+        basic_iterator operator++( int ) {
+            basic_iterator it( *this );
+            ++( *this );
+            return it;
+        }
+        bool operator==( const basic_iterator& other ) const { return slot_ == other.slot_; }
+        bool operator!=( const basic_iterator& other ) const { return slot_ != other.slot_; }
+
+    private:
+        template <typename>
+        friend class basic_iterator;
+        void skip_empty() {
+            while ( slot_ != end_ && slot_->first == empty_key() ) {
+                ++slot_;
+            }
+        }
+        Slot* slot_{nullptr};
+        Slot* end_{nullptr};
+    };
+
+    using iterator       = basic_iterator<value_type>;
+    using const_iterator = basic_iterator<const value_type>;
+
+public:
+    UidHashMap() = default;
+
+    /// @brief Empty map with room for n entries
+    explicit UidHashMap( size_t n ) { reserve( n ); }
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    void clear() {
+        std::fill( slots_.begin(), slots_.end(), value_type( empty_key(), Value() ) );
+        std::fill( shard_size_.begin(), shard_size_.end(), 0 );
+        size_ = 0;
+    }
+
+    /// @brief Make room for n entries without further rehashing
+    void reserve( size_t n ) {
+        const size_t nb_shards = size_t( 1 ) << shard_bits_;
+        const size_t required  = shard_capacity( ( n + nb_shards - 1 ) / nb_shards );
+        if ( slots_.empty() || required > shard_mask_ + 1 ) {
+            rehash( required );
+        }
+    }
+
+    iterator begin() { return iterator( slots_.data(), slots_.data() + slots_.size() ); }
+    iterator end() { return iterator( slots_.data() + slots_.size(), slots_.data() + slots_.size() ); }
+    const_iterator begin() const { return const_iterator( slots_.data(), slots_.data() + slots_.size() ); }
+    const_iterator end() const {
+        return const_iterator( slots_.data() + slots_.size(), slots_.data() + slots_.size() );
+    }
+
+    iterator find( uidx_t key ) {
+        if ( slots_.empty() || key == empty_key() ) {
+            return end();
+        }
+        value_type* slot = &slots_[locate( key, detail::hash_uid( key ) )];
+        return slot->first == key ? iterator( slot, slots_.data() + slots_.size() ) : end();
+    }
+
+    const_iterator find( uidx_t key ) const { return const_cast<UidHashMap&>( *this ).find( key ); }
+
+    size_t count( uidx_t key ) const { return find( key ) != end() ? 1 : 0; }
+
+    /// @brief Insert entry, unless its key is already present
+    /// @return iterator to the entry with this key, and true if the entry was inserted
+    std::pair<iterator, bool> insert( const value_type& entry ) {
+        ATLAS_ASSERT( entry.first != empty_key() );
+        if ( slots_.empty() ) {
+            reserve( 1 );
+        }
+        const std::uint64_t hash = detail::hash_uid( entry.first );
+        size_t s                 = locate( entry.first, hash );
+        if ( slots_[s].first == entry.first ) {
+            return std::make_pair( iterator( &slots_[s], slots_.data() + slots_.size() ), false );
+        }
+        if ( 2 * ( shard_size_[shard( hash )] + 1 ) > shard_mask_ + 1 ) {
+            rehash( 2 * ( shard_mask_ + 1 ) );
+            s = locate( entry.first, hash );
+        }
+        slots_[s] = entry;
+        ++shard_size_[shard( hash )];
+        ++size_;
+        return std::make_pair( iterator( &slots_[s], slots_.data() + slots_.size() ), true );
+    }
+
+    Value& operator[]( uidx_t key ) { return insert( value_type( key, Value() ) ).first->second; }
+
+    /// @brief Replace the contents with the n entries { key_of( i ), value_of( i ) }, i = 0, ..., n-1
+    ///
+    /// For large n the entries are inserted on OpenMP threads. As with insert(), the first of several
+    /// entries with the same key is kept. key_of and value_of may be called concurrently and more than once.
+    template <typename KeyOf, typename ValueOf>
+    void build( size_t n, const KeyOf& key_of, const ValueOf& value_of ) {
+        shard_bits_ = 0;
+        if ( n >= min_size_threaded && atlas_omp_get_max_threads() > 1 ) {
+            while ( ( 1 << shard_bits_ ) < 4 * atlas_omp_get_max_threads() && shard_bits_ < max_shard_bits ) {
+                ++shard_bits_;
+            }
+        }
+        const size_t nb_shards = size_t( 1 ) << shard_bits_;
+        const size_t nb_chunks = nb_shards;
+
+        std::vector<std::uint64_t> hash( n );
+        size_t nb_empty_keys = 0;
+        atlas_omp_pragma( omp parallel for reduction( + : nb_empty_keys ) )
+        for ( size_t i = 0; i < n; ++i ) {
+            const uidx_t key = key_of( i );
+            hash[i]          = detail::hash_uid( key );
+            if ( key == empty_key() ) {
+                ++nb_empty_keys;
+            }
+        }
+        ATLAS_ASSERT( nb_empty_keys == 0 );
+
+        // Counting sort of the entries on shard, keeping their order within each shard
+        auto chunk_begin = [&]( size_t c ) { return ( c * n ) / nb_chunks; };
+        std::vector<size_t> offset( nb_chunks * nb_shards, 0 );
+        atlas_omp_parallel_for( size_t c = 0; c < nb_chunks; ++c ) {
+            for ( size_t i = chunk_begin( c ); i < chunk_begin( c + 1 ); ++i ) {
+                ++offset[c * nb_shards + shard( hash[i] )];
+            }
+        }
+        std::vector<size_t> shard_begin( nb_shards + 1 );
+        size_t max_shard_size = 0;
+        for ( size_t s = 0, o = 0; s < nb_shards; ++s ) {
+            shard_begin[s] = o;
+            for ( size_t c = 0; c < nb_chunks; ++c ) {
+                const size_t cnt          = offset[c * nb_shards + s];
+                offset[c * nb_shards + s] = o;
+                o += cnt;
+            }
+            shard_begin[s + 1] = o;
+            max_shard_size     = std::max( max_shard_size, o - shard_begin[s] );
+        }
+        std::vector<size_t> order( n );
+        atlas_omp_parallel_for( size_t c = 0; c < nb_chunks; ++c ) {
+            for ( size_t i = chunk_begin( c ); i < chunk_begin( c + 1 ); ++i ) {
+                order[offset[c * nb_shards + shard( hash[i] )]++] = i;
+            }
+        }
+
+        shard_mask_ = shard_capacity( max_shard_size ) - 1;
+        slots_.assign( nb_shards * ( shard_mask_ + 1 ), value_type( empty_key(), Value() ) );
+        shard_size_.assign( nb_shards, 0 );
+        atlas_omp_parallel_for( size_t s = 0; s < nb_shards; ++s ) {
+            for ( size_t j = shard_begin[s]; j < shard_begin[s + 1]; ++j ) {
+                const size_t i   = order[j];
+                const uidx_t key = key_of( i );
+                value_type& slot = slots_[locate( key, hash[i] )];
+                if ( slot.first != key ) {
+                    slot = value_type( key, value_of( i ) );
+                    ++shard_size_[s];
+                }
+            }
+        }
+        size_ = 0;
+        for ( size_t s = 0; s < nb_shards; ++s ) {
+            size_ += shard_size_[s];
+        }
+    }
+
+private:
+    static constexpr size_t min_size_threaded = 4096;
+    static constexpr int max_shard_bits       = 8;
+
+    static uidx_t empty_key() { return std::numeric_limits<uidx_t>::min(); }
+
+    /// Power of two with at least twice as many slots as entries
+    static size_t shard_capacity( size_t nb_entries ) {
+        size_t capacity = 8;
+        while ( capacity < 2 * nb_entries ) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    size_t shard( std::uint64_t hash ) const { return shard_bits_ ? size_t( hash >> ( 64 - shard_bits_ ) ) : 0; }
+
+    /// Slot holding key, or else the empty slot where key is to be inserted
+    size_t locate( uidx_t key, std::uint64_t hash ) const {
+        const size_t base = shard( hash ) * ( shard_mask_ + 1 );
+        size_t pos        = size_t( hash ) & shard_mask_;
+        while ( slots_[base + pos].first != key && slots_[base + pos].first != empty_key() ) {
+            pos = ( pos + 1 ) & shard_mask_;
+        }
+        return base + pos;
+    }
+
+    void rehash( size_t capacity_per_shard ) {
+        std::vector<value_type> entries;
+        entries.reserve( size_ );
+        for ( const auto& slot : slots_ ) {
+            if ( slot.first != empty_key() ) {
+                entries.push_back( slot );
+            }
+        }
+        shard_mask_ = capacity_per_shard - 1;
+        slots_.assign( ( size_t( 1 ) << shard_bits_ ) * capacity_per_shard, value_type( empty_key(), Value() ) );
+        shard_size_.assign( size_t( 1 ) << shard_bits_, 0 );
+        for ( const auto& entry : entries ) {
+            const std::uint64_t hash            = detail::hash_uid( entry.first );
+            slots_[locate( entry.first, hash )] = entry;
+            ++shard_size_[shard( hash )];
+        }
+    }
+
+    std::vector<value_type> slots_;
+    std::vector<size_t> shard_size_;  // number of entries in every shard
+    size_t size_{0};
+    size_t shard_mask_{0};  // number of slots per shard, minus one
+    int shard_bits_{0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// @brief Set of unique indices (uidx_t), stored in one flat array. See UidHashMap.
+class UidHashSet {
+public:
+    UidHashSet() = default;
+
+    /// @brief Empty set with room for n entries
+    explicit UidHashSet( size_t n ) : map_( n ) {}
+
+    size_t size() const { return map_.size(); }
+
+    bool empty() const { return map_.empty(); }
+
+    void clear() { map_.clear(); }
+
+    void reserve( size_t n ) { map_.reserve( n ); }
+
+    /// @return true if uid was not yet in the set
+    bool insert( uidx_t uid ) { return map_.insert( std::make_pair( uid, None() ) ).second; }
+
+    size_t count( uidx_t uid ) const { return map_.count( uid ); }
+
+    /// @brief Replace the contents with the n entries key_of( i ), i = 0, ..., n-1. See UidHashMap::build
+    template <typename KeyOf>
+    void build( size_t n, const KeyOf& key_of ) {
+        map_.build( n, key_of, []( size_t ) { return None(); } );
+    }
+
+private:
+    struct None {};
+    UidHashMap<None> map_;
+};
+
+}  // namespace util
+}  // namespace atlas
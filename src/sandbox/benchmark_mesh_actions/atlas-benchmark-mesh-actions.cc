@@ -0,0 +1,154 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+
+#include "atlas/grid.h"
+#include "atlas/mesh.h"
+#include "atlas/mesh/actions/BuildCellCentres.h"
+#include "atlas/mesh/actions/BuildDualMesh.h"
+#include "atlas/mesh/actions/BuildEdges.h"
+#include "atlas/mesh/actions/BuildHalo.h"
+#include "atlas/mesh/actions/BuildNode2CellConnectivity.h"
+#include "atlas/mesh/actions/BuildParallelFields.h"
+#include "atlas/mesh/actions/BuildPeriodicBoundaries.h"
+#include "atlas/meshgenerator.h"
+#include "atlas/parallel/mpi/mpi.h"
+#include "atlas/parallel/omp/omp.h"
+#include "atlas/runtime/AtlasTool.h"
+#include "atlas/runtime/Log.h"
+#include "atlas/runtime/Trace.h"
+#include "atlas/util/Config.h"
+
+//------------------------------------------------------------------------------
+
+using namespace atlas;
+using namespace atlas::mesh::actions;
+
+//------------------------------------------------------------------------------
+
+class Tool : public AtlasTool {
+    int execute( const Args& args ) override;
+    std::string briefDescription() override {
+        return "Benchmark of the mesh actions BuildEdges, BuildNode2CellConnectivity, BuildCellCentres "
+               "and BuildDualMesh for an increasing number of OpenMP threads";
+    }
+    std::string usage() override { return name() + " --grid=name [OPTION]... [--help]"; }
+
+public:
+    Tool( int argc, char** argv );
+};
+
+//-----------------------------------------------------------------------------
+
+Tool::Tool( int argc, char** argv ) : AtlasTool( argc, argv ) {
+    add_option( new SimpleOption<std::string>(
+        "grid", "Grid unique identifier (default=O1280)\n" + indent() + "     Example values: N80, F40, O24, L32" ) );
+    add_option( new SimpleOption<long>( "halo", "Number of halos (default=1)" ) );
+    add_option( new SimpleOption<long>( "iterations", "Number of iterations per thread count (default=1)" ) );
+}
+
+//-----------------------------------------------------------------------------
+
+int Tool::execute( const Args& args ) {
+    Trace timer( Here(), displayName() );
+
+    std::string key = args.getString( "grid", "O1280" );
+    StructuredGrid grid;
+    try {
+        grid = Grid( key );
+    }
+    catch ( eckit::Exception& e ) {
+    }
+    if ( !grid ) {
+        Log::error() << "Grid " << key << " is not a structured grid." << std::endl;
+        return failed();
+    }
+
+    const int halo        = static_cast<int>( args.getLong( "halo", 1 ) );
+    const int iterations  = static_cast<int>( args.getLong( "iterations", 1 ) );
+    const int max_threads = atlas_omp_get_max_threads();
+
+    Log::info() << "Configuration" << std::endl;
+    Log::info() << "~~~~~~~~~~~~~" << std::endl;
+    Log::info() << "  Grid       : " << grid.name() << std::endl;
+    Log::info() << "  Halo       : " << halo << std::endl;
+    Log::info() << "  Iterations : " << iterations << std::endl;
+    Log::info() << "  MPI        : " << mpi::comm().size() << std::endl;
+    Log::info() << "  OpenMP     : " << max_threads << std::endl;
+
+    MeshGenerator meshgenerator( "structured", util::Config( "partitioner", "equal_regions" ) );
+
+    const std::vector<std::string> actions{"BuildEdges", "BuildNode2CellConnectivity", "BuildCellCentres",
+                                           "BuildDualMesh"};
+
+    std::vector<int> threads;
+    for ( int t = 1; t < max_threads; t *= 2 ) {
+        threads.push_back( t );
+    }
+    threads.push_back( max_threads );
+
+    // Every action is timed on its own; the mesh is generated anew for every iteration as actions are cached
+    std::vector<std::vector<double>> seconds( threads.size(), std::vector<double>( actions.size(), 0. ) );
+    for ( size_t t = 0; t < threads.size(); ++t ) {
+        atlas_omp_set_num_threads( threads[t] );
+        for ( int i = 0; i < iterations; ++i ) {
+            Mesh mesh = meshgenerator.generate( grid );
+            build_nodes_parallel_fields( mesh.nodes() );
+            build_periodic_boundaries( mesh );
+            build_halo( mesh, halo );
+
+            auto time = [&]( size_t a, const std::function<void()>& action ) {
+                mpi::comm().barrier();
+                Trace trace( Here(), actions[a] );
+                action();
+                mpi::comm().barrier();
+                trace.stop();
+                seconds[t][a] += trace.elapsed() / double( iterations );
+            };
+            time( 0, [&]() { build_edges( mesh ); } );
+            time( 1, [&]() { BuildNode2CellConnectivity{mesh}(); } );
+            time( 2, [&]() { BuildCellCentres( "centre", true )( mesh ); } );
+            time( 3, [&]() { build_median_dual_mesh( mesh ); } );
+        }
+    }
+    atlas_omp_set_num_threads( max_threads );
+
+    Log::info() << "\nSeconds per action" << std::endl;
+    Log::info() << std::setw( 28 ) << std::left << "threads";
+    for ( int nb_threads : threads ) {
+        Log::info() << std::setw( 12 ) << std::right << nb_threads;
+    }
+    Log::info() << std::endl;
+    for ( size_t a = 0; a < actions.size(); ++a ) {
+        Log::info() << std::setw( 28 ) << std::left << actions[a];
+        for ( size_t t = 0; t < threads.size(); ++t ) {
+            Log::info() << std::setw( 12 ) << std::right << std::fixed << std::setprecision( 4 ) << seconds[t][a];
+        }
+        Log::info() << std::endl;
+    }
+
+    timer.stop();
+    Log::info() << Trace::report() << std::endl;
+    return success();
+}
+
+//------------------------------------------------------------------------------
+
+int main( int argc, char** argv ) {
+    Tool tool( argc, argv );
+    return tool.start();
+}
@@ -0,0 +1,65 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+
+#include "atlas/array/Array.h"
+#include "atlas/field/Field.h"
+#include "atlas/library/config.h"
+#include "atlas/parallel/omp/omp.h"
+
+namespace atlas {
+namespace test {
+
+/// Fields with the same datatype and shape, and bitwise identical values
+inline bool equal_fields( const Field& a, const Field& b ) {
+    return a.datatype() == b.datatype() && a.shape() == b.shape() &&
+           std::memcmp( a.array().storage(), b.array().storage(), size_t( a.size() ) * a.datatype().size() ) == 0;
+}
+
+/// Connectivities (or BlockConnectivities) with the same rows and values
+template <typename Connectivity>
+bool equal_connectivities( const Connectivity& a, const Connectivity& b ) {
+    if ( a.rows() != b.rows() ) {
+        return false;
+    }
+    for ( idx_t r = 0; r < a.rows(); ++r ) {
+        if ( a.cols( r ) != b.cols( r ) ) {
+            return false;
+        }
+        for ( idx_t c = 0; c < a.cols( r ); ++c ) {
+            if ( a( r, c ) != b( r, c ) ) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// Result of f() computed with the given number of OpenMP threads, e.g. to compare serial and threaded meshes
+template <typename Function>
+auto with_omp_threads( int nb_threads, const Function& f ) -> decltype( f() ) {
+    const int max_threads = atlas_omp_get_max_threads();
+    atlas_omp_set_num_threads( nb_threads );
+    auto result = f();
+    atlas_omp_set_num_threads( max_threads );
+    return result;
+}
+
+/// Number of threads to compare against a serial result, using several threads even on a single core
+inline int nb_omp_threads_to_compare() {
+    return std::max( 4, atlas_omp_get_max_threads() );
+}
+
+}  // namespace test
+}  // namespace atlas
@@ -0,0 +1,213 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <cmath>
+
+#include "eckit/linalg/SparseMatrix.h"
+#include "eckit/linalg/Triplet.h"
+
+#include "atlas/array.h"
+#include "atlas/field.h"
+#include "atlas/functionspace.h"
+#include "atlas/grid.h"
+#include "atlas/interpolation.h"
+#include "atlas/interpolation/Cache.h"
+#include "atlas/mesh/Nodes.h"
+#include "atlas/meshgenerator.h"
+#include "atlas/option.h"
+#include "atlas/parallel/mpi/mpi.h"
+#include "atlas/util/CoordinateEnums.h"
+
+#include "tests/AtlasTestEnvironment.h"
+
+using atlas::interpolation::Cache;
+using eckit::linalg::Triplet;
+
+namespace atlas {
+namespace test {
+
+//-----------------------------------------------------------------------------
+
+Field interpolate( const Interpolation& interpolation, const functionspace::NodeColumns& fs, idx_t target_size ) {
+    Field field_source = fs.createField<double>( option::name( "source" ) );
+    Field field_target( "target", array::make_datatype<double>(), array::make_shape( target_size ) );
+
+    auto lonlat = array::make_view<double, 2>( fs.nodes().lonlat() );
+    auto source = array::make_view<double, 1>( field_source );
+    for ( idx_t j = 0; j < fs.nodes().size(); ++j ) {
+        source( j ) = std::sin( lonlat( j, LON ) * M_PI / 180. ) * std::cos( lonlat( j, LAT ) * M_PI / 180. );
+    }
+    interpolation.execute( field_source, field_target );
+    return field_target;
+}
+
+bool equal_fields( const Field& a, const Field& b ) {
+    auto va = array::make_view<double, 1>( a );
+    auto vb = array::make_view<double, 1>( b );
+    if ( va.shape( 0 ) != vb.shape( 0 ) ) {
+        return false;
+    }
+    for ( idx_t j = 0; j < va.shape( 0 ); ++j ) {
+        if ( va( j ) != vb( j ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+CASE( "test_interpolation_cache_key" ) {
+    Grid O16( "O16" );
+    Grid O32( "O32" );
+    auto fe = option::type( "finite-element" );
+    auto nn = option::type( "nearest-neighbour" );
+
+    EXPECT( not Cache::key( fe, O16, O32 ).empty() );
+    EXPECT( Cache::key( fe, O16, O32 ) == Cache::key( fe, Grid( "O16" ), Grid( "O32" ) ) );
+    EXPECT( Cache::key( fe, O16, O32 ) != Cache::key( fe, O32, O16 ) );
+    EXPECT( Cache::key( fe, O16, O32 ) != Cache::key( nn, O16, O32 ) );
+
+    functionspace::NodeColumns fs( MeshGenerator( "structured" ).generate( O16 ) );
+    functionspace::PointCloud pointcloud( {{0., 0.}, {10., 10.}, {20., 20.}} );
+    functionspace::PointCloud other( {{0., 0.}, {10., 10.}, {20., 21.}} );
+    EXPECT( not Cache::key( fe, fs, pointcloud ).empty() );
+    EXPECT( Cache::key( fe, fs, pointcloud ) != Cache::key( fe, fs, other ) );
+
+    // Same nodes, different elements
+    functionspace::NodeColumns triangulated(
+        MeshGenerator( "structured", util::Config( "triangulate", true ) ).generate( O16 ) );
+    EXPECT( Cache::key( fe, fs, pointcloud ) != Cache::key( fe, triangulated, pointcloud ) );
+}
+
+CASE( "test_interpolation_cache_lru" ) {
+    std::vector<Triplet> triplets{{0, 0, 0.5}, {0, 1, 0.5}, {1, 1, 1.}};
+    eckit::linalg::SparseMatrix matrix( 2, 2, triplets );
+    const size_t matrix_footprint = 5 * sizeof( std::int32_t ) + 3 * sizeof( double );
+
+    Cache cache( 2 * matrix_footprint );
+    cache.insert( "a", matrix );
+    cache.insert( "b", matrix );
+    EXPECT( cache.footprint() == 2 * matrix_footprint );
+
+    // "a" becomes most recently used, so "b" is evicted
+    EXPECT( cache.get( "a" ) );
+    cache.insert( "c", matrix );
+    EXPECT( cache.footprint() == 2 * matrix_footprint );
+    EXPECT( cache.get( "a" ) );
+    EXPECT( not cache.get( "b" ) );
+
+    auto entry = cache.get( "c" );
+    EXPECT( entry );
+    EXPECT( entry->rows() == 2 );
+    EXPECT( entry->nonZeros() == 3 );
+    EXPECT( entry->outer()[1] == 2 );
+    EXPECT( entry->inner()[2] == 1 );
+    EXPECT( entry->data()[2] == 1. );
+
+    cache.clear();
+    EXPECT( cache.footprint() == 0 );
+    EXPECT( not cache.get( "a" ) );
+}
+
+CASE( "test_interpolation_cache_finite_element" ) {
+    functionspace::NodeColumns fs( MeshGenerator( "structured" ).generate( Grid( "O32" ) ) );
+    functionspace::PointCloud pointcloud(
+        {{0., 0.}, {10., 10.}, {20., 20.}, {30., 30.}, {40., 40.}, {50., -50.}, {355., 89.}} );
+    auto config = option::type( "finite-element" );
+
+    Field reference = interpolate( Interpolation( config, fs, pointcloud ), fs, pointcloud.size() );
+
+    Cache cache( "atlas_test_interpolation_cache" );
+    const std::string key = Cache::key( config, fs, pointcloud );
+
+    SECTION( "memory" ) {
+        Field computed = interpolate( Interpolation( config, fs, pointcloud, cache ), fs, pointcloud.size() );
+        EXPECT( cache.get( key ) );
+        Field cached = interpolate( Interpolation( config, fs, pointcloud, cache ), fs, pointcloud.size() );
+        EXPECT( equal_fields( computed, reference ) );
+        EXPECT( equal_fields( cached, reference ) );
+    }
+
+    SECTION( "disk" ) {
+        Interpolation stored( config, fs, pointcloud, cache );
+
+        // A new cache in the same directory finds the matrix on disk
+        Cache restored( cache.directory() );
+        EXPECT( restored.footprint() == 0 );
+        EXPECT( restored.get( key ) );
+        Field cached = interpolate( Interpolation( config, fs, pointcloud, restored ), fs, pointcloud.size() );
+        EXPECT( equal_fields( cached, reference ) );
+    }
+
+    SECTION( "hit does not recompute" ) {
+        // A matrix stored under the key, which the finite-element method would never compute,
+        // copying the value of the first node to every target point. Kept in memory only, so that it
+        // does not replace the matrix on disk used by the other sections.
+        Cache memory_cache;
+        const idx_t first = 0;
+        std::vector<Triplet> triplets;
+        for ( idx_t r = 0; r < pointcloud.size(); ++r ) {
+            triplets.emplace_back( r, first, 1. );
+        }
+        memory_cache.insert( key, eckit::linalg::SparseMatrix( pointcloud.size(), fs.nodes().size(), triplets ) );
+
+        Field cached = interpolate( Interpolation( config, fs, pointcloud, memory_cache ), fs, pointcloud.size() );
+        auto lonlat  = array::make_view<double, 2>( fs.nodes().lonlat() );
+        auto values  = array::make_view<double, 1>( cached );
+        const double expected =
+            std::sin( lonlat( first, LON ) * M_PI / 180. ) * std::cos( lonlat( first, LAT ) * M_PI / 180. );
+        for ( idx_t j = 0; j < values.shape( 0 ); ++j ) {
+            EXPECT( values( j ) == expected );
+        }
+    }
+
+    SECTION( "single precision weights" ) {
+        auto config_real32 = option::type( "finite-element" ) | util::Config( "weights_datatype", "real32" );
+        Field computed     = interpolate( Interpolation( config_real32, fs, pointcloud ), fs, pointcloud.size() );
+        Interpolation stored( config_real32, fs, pointcloud, cache );
+        Field cached = interpolate( Interpolation( config_real32, fs, pointcloud, cache ), fs, pointcloud.size() );
+        EXPECT( equal_fields( cached, computed ) );
+    }
+}
+
+CASE( "test_interpolation_cache_grids" ) {
+    if ( mpi::comm().size() > 1 ) {
+        return;
+    }
+    Grid source( "O32" );
+    Grid target( "F16" );
+    auto config = option::type( "nearest-neighbour" );
+
+    Cache cache;
+    Interpolation computed( config, source, target, cache );
+    EXPECT( cache.get( Cache::key( config, source, target ) ) );
+    Interpolation cached( config, source, target, cache );
+
+    Field field_source = computed.source().createField<double>( option::name( "source" ) );
+    auto src           = array::make_view<double, 1>( field_source );
+    for ( idx_t n = 0; n < src.shape( 0 ); ++n ) {
+        src( n ) = n;
+    }
+    Field a = computed.target().createField<double>( option::name( "a" ) );
+    Field b = cached.target().createField<double>( option::name( "b" ) );
+    computed.execute( field_source, a );
+    cached.execute( field_source, b );
+    EXPECT( equal_fields( a, b ) );
+}
+
+//-----------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace atlas
+
+int main( int argc, char** argv ) {
+    return atlas::test::run( argc, argv );
+}
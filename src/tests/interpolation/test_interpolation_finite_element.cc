@@ -8,6 +8,7 @@
  * nor does it submit to any jurisdiction.
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include "eckit/types/FloatCompare.h"
@@ -19,6 +20,7 @@
 #include "atlas/interpolation.h"
 #include "atlas/mesh.h"
 #include "atlas/meshgenerator.h"
+#include "atlas/parallel/omp/omp.h"
 #include "atlas/util/CoordinateEnums.h"
 
 #include "tests/AtlasTestEnvironment.h"
@@ -79,6 +81,181 @@ CASE( "test_interpolation_finite_element" ) {
 
 //-----------------------------------------------------------------------------
 
+CASE( "test_interpolation_finite_element_fieldset" ) {
+    Grid grid( "O32" );
+    MeshGenerator meshgen( "structured" );
+    Mesh mesh = meshgen.generate( grid );
+    NodeColumns fs( mesh );
+
+    PointCloud pointcloud( {{00., 0.}, {10., 10.}, {20., 20.}, {30., 30.}, {40., 40.}, {50., -50.}} );
+
+    Interpolation interpolation( option::type( "finite-element" ), fs, pointcloud );
+
+    const idx_t nlev = 4;
+    const idx_t npts = pointcloud.size();
+
+    auto lonlat = array::make_view<double, 2>( fs.nodes().lonlat() );
+
+    // Fields of different precision and rank are interpolated together
+    FieldSet sources;
+    sources.add( fs.createField<double>( option::name( "d1" ) ) );
+    sources.add( fs.createField<float>( option::name( "f2" ) | option::levels( nlev ) ) );
+    sources.add( fs.createField<double>( option::name( "d2" ) | option::levels( nlev ) ) );
+
+    auto d1 = array::make_view<double, 1>( sources[0] );
+    auto f2 = array::make_view<float, 2>( sources[1] );
+    auto d2 = array::make_view<double, 2>( sources[2] );
+    for ( idx_t j = 0; j < fs.nodes().size(); ++j ) {
+        d1( j ) = std::sin( lonlat( j, LON ) * M_PI / 180. );
+        for ( idx_t k = 0; k < nlev; ++k ) {
+            f2( j, k ) = static_cast<float>( k + std::cos( lonlat( j, LAT ) * M_PI / 180. ) );
+            d2( j, k ) = k * lonlat( j, LAT );
+        }
+    }
+
+    auto make_targets = [&]() {
+        FieldSet targets;
+        targets.add( Field( "d1", array::make_datatype<double>(), array::make_shape( npts ) ) );
+        targets.add( Field( "f2", array::make_datatype<float>(), array::make_shape( npts, nlev ) ) );
+        targets.add( Field( "d2", array::make_datatype<double>(), array::make_shape( npts, nlev ) ) );
+        return targets;
+    };
+
+    FieldSet batched = make_targets();
+    interpolation.execute( sources, batched );
+
+    FieldSet single = make_targets();
+    for ( idx_t f = 0; f < sources.size(); ++f ) {
+        interpolation.execute( sources[f], single[f] );
+    }
+
+    auto bd1 = array::make_view<double, 1>( batched[0] );
+    auto sd1 = array::make_view<double, 1>( single[0] );
+    auto bf2 = array::make_view<float, 2>( batched[1] );
+    auto sf2 = array::make_view<float, 2>( single[1] );
+    auto bd2 = array::make_view<double, 2>( batched[2] );
+    auto sd2 = array::make_view<double, 2>( single[2] );
+    for ( idx_t j = 0; j < npts; ++j ) {
+        EXPECT( eckit::types::is_approximately_equal( bd1( j ), sd1( j ), 1.e-12 ) );
+        for ( idx_t k = 0; k < nlev; ++k ) {
+            EXPECT( eckit::types::is_approximately_equal( bf2( j, k ), sf2( j, k ), 1.e-5f ) );
+            EXPECT( eckit::types::is_approximately_equal( bd2( j, k ), sd2( j, k ), 1.e-12 ) );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+CASE( "test_interpolation_finite_element_single_precision_weights" ) {
+    Grid grid( "O32" );
+    MeshGenerator meshgen( "structured" );
+    Mesh mesh = meshgen.generate( grid );
+    NodeColumns fs( mesh );
+
+    PointCloud pointcloud( {{00., 0.}, {10., 10.}, {20., 20.}, {30., 30.}, {40., 40.}, {50., -50.}} );
+
+    Interpolation interpolation_double( option::type( "finite-element" ), fs, pointcloud );
+
+    auto lonlat = array::make_view<double, 2>( fs.nodes().lonlat() );
+
+    auto check = [&]( Field& source, const std::string& spmv ) {
+        auto config = option::type( "finite-element" ) | util::Config( "weights_datatype", "real32" );
+        Interpolation interpolation( config | util::Config( "spmv", spmv ), fs, pointcloud );
+        Field target_single( "single", source.datatype(), array::make_shape( pointcloud.size() ) );
+        Field target_double( "double", source.datatype(), array::make_shape( pointcloud.size() ) );
+        interpolation.execute( source, target_single );
+        interpolation_double.execute( source, target_double );
+        return std::make_pair( target_single, target_double );
+    };
+
+    SECTION( "double fields" ) {
+        Field source = fs.createField<double>( option::name( "source" ) );
+        auto view    = array::make_view<double, 1>( source );
+        for ( idx_t j = 0; j < fs.nodes().size(); ++j ) {
+            view( j ) = std::sin( lonlat( j, LON ) * M_PI / 180. );
+        }
+        for ( std::string spmv : {"", "eckit"} ) {
+            auto targets = check( source, spmv );
+            auto single  = array::make_view<double, 1>( targets.first );
+            auto dble    = array::make_view<double, 1>( targets.second );
+            for ( idx_t j = 0; j < pointcloud.size(); ++j ) {
+                EXPECT( eckit::types::is_approximately_equal( single( j ), dble( j ), 1.e-6 ) );
+            }
+        }
+    }
+
+    SECTION( "float fields" ) {
+        Field source = fs.createField<float>( option::name( "source" ) );
+        auto view    = array::make_view<float, 1>( source );
+        for ( idx_t j = 0; j < fs.nodes().size(); ++j ) {
+            view( j ) = static_cast<float>( std::sin( lonlat( j, LON ) * M_PI / 180. ) );
+        }
+        for ( std::string spmv : {"", "eckit"} ) {
+            auto targets = check( source, spmv );
+            auto single  = array::make_view<float, 1>( targets.first );
+            auto dble    = array::make_view<float, 1>( targets.second );
+            for ( idx_t j = 0; j < pointcloud.size(); ++j ) {
+                EXPECT( eckit::types::is_approximately_equal( single( j ), dble( j ), 1.e-5f ) );
+            }
+        }
+    }
+
+    SECTION( "float fields with eckit backend and double precision weights" ) {
+        Field source = fs.createField<float>( option::name( "source" ) );
+        auto view    = array::make_view<float, 1>( source );
+        for ( idx_t j = 0; j < fs.nodes().size(); ++j ) {
+            view( j ) = static_cast<float>( std::sin( lonlat( j, LON ) * M_PI / 180. ) );
+        }
+        Interpolation interpolation( option::type( "finite-element" ) | util::Config( "spmv", "eckit" ), fs,
+                                     pointcloud );
+        Field target_eckit( "eckit", source.datatype(), array::make_shape( pointcloud.size() ) );
+        Field target_native( "native", source.datatype(), array::make_shape( pointcloud.size() ) );
+        interpolation.execute( source, target_eckit );
+        interpolation_double.execute( source, target_native );
+        auto eckit_view  = array::make_view<float, 1>( target_eckit );
+        auto native_view = array::make_view<float, 1>( target_native );
+        for ( idx_t j = 0; j < pointcloud.size(); ++j ) {
+            EXPECT( eckit::types::is_approximately_equal( eckit_view( j ), native_view( j ), 1.e-5f ) );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+CASE( "test_interpolation_finite_element_threads" ) {
+    MeshGenerator meshgen( "structured" );
+    NodeColumns fs( meshgen.generate( Grid( "O32" ) ) );
+    NodeColumns target( meshgen.generate( Grid( "F24" ) ) );
+
+    Field source = fs.createField<double>( option::name( "source" ) );
+    auto lonlat  = array::make_view<double, 2>( fs.nodes().lonlat() );
+    auto view    = array::make_view<double, 1>( source );
+    for ( idx_t j = 0; j < fs.nodes().size(); ++j ) {
+        view( j ) = std::sin( lonlat( j, LON ) * M_PI / 180. ) * std::cos( lonlat( j, LAT ) * M_PI / 180. );
+    }
+
+    // The matrix must not depend on the number of threads that computed it
+    auto interpolate = [&]( int nb_threads ) {
+        const int max_threads = atlas_omp_get_max_threads();
+        atlas_omp_set_num_threads( nb_threads );
+        Interpolation interpolation( option::type( "finite-element" ), fs, target );
+        atlas_omp_set_num_threads( max_threads );
+        Field result = target.createField<double>( option::name( "target" ) );
+        interpolation.execute( source, result );
+        return result;
+    };
+    Field serial   = interpolate( 1 );
+    Field threaded = interpolate( std::max( 4, atlas_omp_get_max_threads() ) );
+
+    auto s = array::make_view<double, 1>( serial );
+    auto t = array::make_view<double, 1>( threaded );
+    for ( idx_t j = 0; j < target.nodes().size(); ++j ) {
+        EXPECT( s( j ) == t( j ) );
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 }  // namespace test
 }  // namespace atlas
 
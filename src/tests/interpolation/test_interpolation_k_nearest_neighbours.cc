@@ -0,0 +1,97 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "atlas/array.h"
+#include "atlas/field.h"
+#include "atlas/functionspace.h"
+#include "atlas/grid.h"
+#include "atlas/interpolation.h"
+#include "atlas/interpolation/method/knn/StructuredNeighbourSearch.h"
+#include "atlas/option.h"
+#include "atlas/util/Earth.h"
+
+#include "tests/AtlasTestEnvironment.h"
+
+using atlas::interpolation::method::StructuredNeighbourSearch;
+
+namespace atlas {
+namespace test {
+
+//-----------------------------------------------------------------------------
+
+CASE( "test_structured_neighbour_search" ) {
+    StructuredGrid grid( "O16" );
+    EXPECT( StructuredNeighbourSearch::supports( grid ) );
+    EXPECT( not StructuredNeighbourSearch::supports( Grid( "O16", RectangularDomain( {0, 90}, {0, 90} ) ) ) );
+
+    StructuredNeighbourSearch search( grid );
+
+    const size_t k = 4;
+    std::vector<std::pair<double, gidx_t>> nearest;
+    for ( const PointLonLat& P : std::vector<PointLonLat>{
+              {0., 0.}, {359.9, 0.1}, {-10., 45.}, {123.4, -67.8}, {45., 89.9}, {200., -89.9}, {5.625, 2.7}} ) {
+        search.kNearestNeighbours( P, k, nearest );
+        EXPECT( nearest.size() == k );
+
+        // Brute force over all grid points
+        PointXYZ Pxyz;
+        util::Earth::convertSphericalToCartesian( P, Pxyz );
+        std::vector<std::pair<double, gidx_t>> all;
+        gidx_t n = 0;
+        for ( const PointLonLat& Q : grid.lonlat() ) {
+            PointXYZ Qxyz;
+            util::Earth::convertSphericalToCartesian( Q, Qxyz );
+            all.emplace_back( PointXYZ::distance2( Pxyz, Qxyz ), n++ );
+        }
+        std::sort( all.begin(), all.end() );
+        for ( size_t j = 0; j < k; ++j ) {
+            EXPECT( nearest[j] == all[j] );
+        }
+    }
+}
+
+CASE( "test_interpolation_nearest_neighbour_structured" ) {
+    Grid source( "O32" );
+    Grid target( "F16" );
+
+    Interpolation interpolation( option::type( "nearest-neighbour" ), source, target );
+
+    Field field_source = interpolation.source().createField<double>( option::name( "source" ) );
+    Field field_target = interpolation.target().createField<double>( option::name( "target" ) );
+
+    // The source field holds the global index, recovered at the target
+    auto src = array::make_view<double, 1>( field_source );
+    for ( idx_t n = 0; n < src.shape( 0 ); ++n ) {
+        src( n ) = n;
+    }
+    interpolation.execute( field_source, field_target );
+
+    StructuredNeighbourSearch search( source );
+    std::vector<std::pair<double, gidx_t>> nearest;
+    auto tgt = array::make_view<double, 1>( field_target );
+    idx_t n  = 0;
+    for ( const PointLonLat& P : target.lonlat() ) {
+        search.kNearestNeighbours( P, 1, nearest );
+        EXPECT( tgt( n++ ) == nearest[0].second );
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace atlas
+
+int main( int argc, char** argv ) {
+    return atlas::test::run( argc, argv );
+}
@@ -8,18 +8,27 @@
  * nor does it submit to any jurisdiction.
  */
 
+#include "atlas/array.h"
+#include "atlas/field/Field.h"
+#include "atlas/functionspace/EdgeColumns.h"
+#include "atlas/functionspace/NodeColumns.h"
 #include "atlas/grid/Grid.h"
 #include "atlas/library/Library.h"
 #include "atlas/library/config.h"
 #include "atlas/mesh/HybridElements.h"
 #include "atlas/mesh/Mesh.h"
+#include "atlas/mesh/Nodes.h"
+#include "atlas/mesh/actions/BuildCellCentres.h"
+#include "atlas/mesh/actions/BuildDualMesh.h"
 #include "atlas/mesh/actions/BuildEdges.h"
+#include "atlas/mesh/actions/BuildNode2CellConnectivity.h"
 #include "atlas/mesh/detail/AccumulateFacets.h"
 #include "atlas/meshgenerator.h"
 #include "atlas/option.h"
 #include "atlas/util/Unique.h"
 
 #include "tests/AtlasTestEnvironment.h"
+#include "tests/TestMeshComparison.h"
 
 using namespace atlas::mesh;
 using namespace atlas::util;
@@ -511,6 +520,38 @@ CASE( "test_build_edges_triangles_only" ) {
 
 //-----------------------------------------------------------------------------
 
+CASE( "test_mesh_actions_threads" ) {
+    // Mesh actions run with one or more OpenMP threads must give identical results
+    auto build = []() {
+        Mesh mesh = StructuredMeshGenerator().generate( Grid( "O32" ) );
+        functionspace::NodeColumns nodes_fs( mesh, option::halo( 1 ) );
+        functionspace::EdgeColumns edges_fs( mesh, option::halo( 1 ) );
+        actions::build_median_dual_mesh( mesh );
+        actions::build_node_to_edge_connectivity( mesh );
+        actions::BuildNode2CellConnectivity{mesh}();
+        actions::BuildCellCentres()( mesh );
+        return mesh;
+    };
+    Mesh serial   = with_omp_threads( 1, build );
+    Mesh threaded = with_omp_threads( nb_omp_threads_to_compare(), build );
+
+    EXPECT( serial.edges().size() == threaded.edges().size() );
+    for ( const std::string name : {"glb_idx", "partition", "halo", "flags", "dual_normals", "centroids_xy"} ) {
+        EXPECT( equal_fields( serial.edges().field( name ), threaded.edges().field( name ) ) );
+    }
+    EXPECT( equal_fields( serial.nodes().field( "dual_volumes" ), threaded.nodes().field( "dual_volumes" ) ) );
+    EXPECT( equal_fields( serial.cells().field( "centre" ), threaded.cells().field( "centre" ) ) );
+    EXPECT( equal_fields( serial.cells().field( "centroids_xy" ), threaded.cells().field( "centroids_xy" ) ) );
+
+    EXPECT( equal_connectivities( serial.edges().node_connectivity(), threaded.edges().node_connectivity() ) );
+    EXPECT( equal_connectivities( serial.edges().cell_connectivity(), threaded.edges().cell_connectivity() ) );
+    EXPECT( equal_connectivities( serial.cells().edge_connectivity(), threaded.cells().edge_connectivity() ) );
+    EXPECT( equal_connectivities( serial.nodes().edge_connectivity(), threaded.nodes().edge_connectivity() ) );
+    EXPECT( equal_connectivities( serial.nodes().cell_connectivity(), threaded.nodes().cell_connectivity() ) );
+}
+
+//-----------------------------------------------------------------------------
+
 }  // namespace test
 }  // namespace atlas
 
@@ -0,0 +1,135 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include "atlas/array.h"
+#include "atlas/field/Field.h"
+#include "atlas/functionspace/NodeColumns.h"
+#include "atlas/grid/Distribution.h"
+#include "atlas/grid/Grid.h"
+#include "atlas/grid/Partitioner.h"
+#include "atlas/mesh/HybridElements.h"
+#include "atlas/mesh/Mesh.h"
+#include "atlas/mesh/MeshCheckpoint.h"
+#include "atlas/mesh/Nodes.h"
+#include "atlas/mesh/actions/BuildEdges.h"
+#include "atlas/mesh/actions/BuildHalo.h"
+#include "atlas/meshgenerator.h"
+#include "atlas/option.h"
+#include "atlas/parallel/mpi/mpi.h"
+
+#include "tests/AtlasTestEnvironment.h"
+#include "tests/TestMeshComparison.h"
+
+using namespace atlas::mesh;
+
+namespace atlas {
+namespace test {
+
+//-----------------------------------------------------------------------------
+
+void check_elements( const HybridElements& a, const HybridElements& b ) {
+    EXPECT( a.size() == b.size() );
+    EXPECT( a.nb_types() == b.nb_types() );
+    EXPECT( a.nb_fields() == b.nb_fields() );
+    for ( idx_t f = 0; f < a.nb_fields(); ++f ) {
+        EXPECT( equal_fields( a.field( f ), b.field( f ) ) );
+    }
+    EXPECT( equal_connectivities( a.node_connectivity(), b.node_connectivity() ) );
+    EXPECT( equal_connectivities( a.edge_connectivity(), b.edge_connectivity() ) );
+    EXPECT( equal_connectivities( a.cell_connectivity(), b.cell_connectivity() ) );
+}
+
+//-----------------------------------------------------------------------------
+
+CASE( "test_mesh_checkpoint" ) {
+    Grid grid( "O16" );
+    grid::Partitioner partitioner( "equal_regions" );
+    StructuredMeshGenerator meshgenerator;
+
+    MeshCheckpoint checkpoint( "atlas_test_mesh_checkpoint",
+                               MeshCheckpoint::key( grid, partitioner, meshgenerator, util::Config( "halo", 2 ) ) );
+
+    Mesh original = meshgenerator.generate( grid, grid::Distribution( grid, partitioner ) );
+    actions::build_halo( original, 2 );
+    actions::build_edges( original );
+    actions::build_node_to_edge_connectivity( original );
+
+    checkpoint.write( original );
+    EXPECT( checkpoint.exists() );
+
+    Mesh restored = checkpoint.read( grid );
+
+    SECTION( "nodes" ) {
+        const Nodes& a = original.nodes();
+        const Nodes& b = restored.nodes();
+        EXPECT( a.size() == b.size() );
+        EXPECT( a.nb_fields() == b.nb_fields() );
+        for ( idx_t f = 0; f < a.nb_fields(); ++f ) {
+            EXPECT( a.field( f ).name() == b.field( f ).name() );
+            EXPECT( equal_fields( a.field( f ), b.field( f ) ) );
+        }
+        EXPECT( equal_connectivities( a.edge_connectivity(), b.edge_connectivity() ) );
+        EXPECT( equal_connectivities( a.cell_connectivity(), b.cell_connectivity() ) );
+    }
+
+    SECTION( "elements" ) {
+        check_elements( original.cells(), restored.cells() );
+        check_elements( original.edges(), restored.edges() );
+    }
+
+    SECTION( "metadata" ) {
+        EXPECT( restored.metadata().getInt( "halo" ) == 2 );
+        EXPECT( restored.metadata().getInt( "nb_nodes_including_halo[2]" ) ==
+                original.metadata().getInt( "nb_nodes_including_halo[2]" ) );
+    }
+
+    SECTION( "halo exchange" ) {
+        // The halo exchange restored from the checkpoint must give the same result as the one set up originally
+        auto exchanged = []( const Mesh& mesh ) {
+            functionspace::NodeColumns fs( mesh, option::halo( 2 ) );
+            Field field = fs.createField<gidx_t>( option::name( "glb_idx" ) );
+
+            auto glb_idx = array::make_view<gidx_t, 1>( mesh.nodes().global_index() );
+            auto ghost   = array::make_view<int, 1>( mesh.nodes().ghost() );
+            auto values  = array::make_view<gidx_t, 1>( field );
+            for ( idx_t n = 0; n < fs.nb_nodes(); ++n ) {
+                values( n ) = ghost( n ) ? -1 : glb_idx( n );
+            }
+            fs.haloExchange( field );
+            return field;
+        };
+        Field a = exchanged( original );
+        Field b = exchanged( restored );
+        EXPECT( equal_fields( a, b ) );
+        auto values = array::make_view<gidx_t, 1>( b );
+        for ( idx_t n = 0; n < b.shape( 0 ); ++n ) {
+            EXPECT( values( n ) != -1 );
+        }
+    }
+
+    SECTION( "read_or_create" ) {
+        bool created = false;
+        Mesh mesh    = checkpoint.read_or_create( grid, [&]() {
+            created = true;
+            return Mesh();
+        } );
+        EXPECT( not created );
+        EXPECT( mesh.nodes().size() == original.nodes().size() );
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace atlas
+
+int main( int argc, char** argv ) {
+    return atlas::test::run( argc, argv );
+}
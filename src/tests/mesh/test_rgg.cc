@@ -36,6 +36,7 @@
 #include "atlas/util/Metadata.h"
 
 #include "tests/AtlasTestEnvironment.h"
+#include "tests/TestMeshComparison.h"
 
 namespace atlas {
 namespace grid {
@@ -173,12 +174,44 @@ CASE( "test_partitioner" ) {
     }
 }
 
+CASE( "test_equal_regions_distribution" ) {
+    for ( std::string gridname : {"O32", "N24", "L36x19", "S4x2"} ) {
+        Grid g( gridname );
+        for ( int nb_parts : {2, 7, 12, 48, 96} ) {
+            SECTION( gridname + " with " + std::to_string( nb_parts ) + " partitions" ) {
+                grid::Partitioner partitioner( "equal_regions", nb_parts );
+                std::vector<int> part( g.size() );
+                partitioner.partition( g, part.data() );
+
+                grid::Distribution distribution = partitioner.partition( g );
+                EXPECT( distribution.functional() );
+                EXPECT( distribution.size() == g.size() );
+
+                std::vector<idx_t> nb_pts( nb_parts, 0 );
+                size_t nb_mismatch = 0;
+                for ( gidx_t n = 0; n < g.size(); ++n ) {
+                    if ( distribution.partition( n ) != part[n] ) {
+                        ++nb_mismatch;
+                    }
+                    ++nb_pts[part[n]];
+                }
+                EXPECT( nb_mismatch == 0 );
+                EXPECT( distribution.nb_pts() == nb_pts );
+
+                const auto& materialised = distribution.partition();
+                EXPECT( std::equal( part.begin(), part.end(), materialised.begin() ) );
+            }
+        }
+    }
+}
+
 CASE( "test_gaussian_latitudes" ) {
     std::vector<double> factory_latitudes;
     std::vector<double> computed_latitudes;
     std::vector<double> computed_weights;
 
-    size_t size_test_N = 19;
+    // N=8000 is left out as it takes a few seconds to compute
+    size_t size_test_N = 22;
 
     size_t test_N[] = {16,  24,  32,  48,  64,  80,   96,   128,  160,  200,  256, 320,
                        400, 512, 576, 640, 800, 1024, 1280, 1600, 2000, 4000, 8000};
@@ -446,6 +479,30 @@ CASE( "test_meshgen_ghost_at_end" ) {
     Log::info() << "]" << std::endl;
 }
 
+CASE( "test_meshgen_threads" ) {
+    // Meshes generated with one or more OpenMP threads must be identical
+
+    std::vector<util::Config> configs;
+    configs.push_back( util::Config( "part", 3 )( "nb_parts", 8 ) );
+    configs.push_back( util::Config( "part", 0 )( "nb_parts", 8 )( "include_pole", true ) );
+    configs.push_back( util::Config( "part", 5 )( "nb_parts", 8 )( "ghost_at_end", false ) );
+    configs.push_back( util::Config( "part", 0 )( "nb_parts", 1 )( "3d", true ) );
+
+    for ( const auto& cfg : configs ) {
+        auto generate = [&cfg]() { return StructuredMeshGenerator( cfg ).generate( Grid( "O32" ) ); };
+        Mesh serial   = with_omp_threads( 1, generate );
+        Mesh threaded = with_omp_threads( nb_omp_threads_to_compare(), generate );
+
+        EXPECT( serial.nodes().size() == threaded.nodes().size() );
+        for ( const std::string name : {"xy", "lonlat", "glb_idx", "partition", "ghost", "flags"} ) {
+            EXPECT( equal_fields( serial.nodes().field( name ), threaded.nodes().field( name ) ) );
+        }
+
+        EXPECT( serial.cells().size() == threaded.cells().size() );
+        EXPECT( equal_connectivities( serial.cells().node_connectivity(), threaded.cells().node_connectivity() ) );
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 }  // namespace test
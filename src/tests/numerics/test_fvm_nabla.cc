@@ -327,6 +327,62 @@ CASE( "test_lapl" ) {
     }
 }
 
+CASE( "test_lapl_float" ) {
+    Log::info() << "test_lapl_float" << std::endl;
+    size_t nlev         = 2;
+    const double radius = util::Earth::radius();
+    Grid grid( griduid() );
+    MeshGenerator meshgenerator( "structured" );
+    Mesh mesh = meshgenerator.generate( grid, Distribution( grid, Partitioner( "equal_regions" ) ) );
+    fvm::Method fvm( mesh, util::Config( "radius", radius ) | option::levels( nlev ) );
+    Nabla nabla( fvm );
+
+    FieldSet fields;
+    fields.add( fvm.node_columns().createField<double>( option::name( "scal" ) ) );
+    fields.add( fvm.node_columns().createField<double>( option::name( "lapl" ) ) );
+    fields.add( fvm.node_columns().createField<float>( option::name( "scal_sp" ) ) );
+    fields.add( fvm.node_columns().createField<float>( option::name( "lapl_sp" ) ) );
+    fields.add( fvm.node_columns().createField<float>( option::name( "lapl_sp_2" ) ) );
+
+    rotated_flow_magnitude( fvm, fields["scal"], M_PI_2 * 0.75 );
+    {
+        auto scal    = array::make_view<double, 2>( fields["scal"] );
+        auto scal_sp = array::make_view<float, 2>( fields["scal_sp"] );
+        for ( idx_t jnode = 0; jnode < scal.shape( 0 ); ++jnode ) {
+            for ( idx_t jlev = 0; jlev < scal.shape( 1 ); ++jlev ) {
+                scal_sp( jnode, jlev ) = scal( jnode, jlev );
+            }
+        }
+    }
+
+    nabla.laplacian( fields["scal"], fields["lapl"] );
+    nabla.laplacian( fields["scal_sp"], fields["lapl_sp"] );
+    // Second call reuses the gradient workspace of the first
+    nabla.laplacian( fields["scal_sp"], fields["lapl_sp_2"] );
+
+    auto lapl      = array::make_view<double, 2>( fields["lapl"] );
+    auto lapl_sp   = array::make_view<float, 2>( fields["lapl_sp"] );
+    auto lapl_sp_2 = array::make_view<float, 2>( fields["lapl_sp_2"] );
+    auto is_ghost  = array::make_view<int, 1>( mesh.nodes().ghost() );
+
+    double max_lapl( 0 );
+    for ( idx_t jnode = 0; jnode < fvm.node_columns().nb_nodes(); ++jnode ) {
+        for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+            max_lapl = std::max( max_lapl, std::abs( lapl( jnode, jlev ) ) );
+        }
+    }
+    for ( idx_t jnode = 0; jnode < fvm.node_columns().nb_nodes(); ++jnode ) {
+        if ( is_ghost( jnode ) ) {
+            continue;
+        }
+        for ( idx_t jlev = 0; jlev < nlev; ++jlev ) {
+            EXPECT( lapl_sp( jnode, jlev ) == lapl_sp_2( jnode, jlev ) );
+            EXPECT( eckit::types::is_approximately_equal( double( lapl_sp( jnode, jlev ) ), lapl( jnode, jlev ),
+                                                          1.e-3 * max_lapl ) );
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 }  // namespace test
@@ -93,6 +93,76 @@ CASE( "test_gather" ) {
     SETUP( "Fixture" ) {
         Fixture f;
 
+        SECTION( "test_setup" ) {
+            // Every rank knows the global size, but only its own share of the global ordering
+            EXPECT( f.gather_scatter.glb_dof() == 9 );
+            int loc_dof = f.gather_scatter.loc_dof();
+            mpi::comm().allReduceInPlace( loc_dof, eckit::mpi::sum() );
+            EXPECT( loc_dof == 9 );
+        }
+
+        SECTION( "test_gather_io_ranks" ) {
+            // Global ordering split in two slabs [0,4) and [4,9), gathered on the last and the first rank
+            f.gather_scatter.setup_io( {f.comm_size - 1, 0} );
+            if ( f.rank == f.comm_size - 1 ) {
+                EXPECT( f.gather_scatter.io_slab_begin() == 0 );
+                EXPECT( f.gather_scatter.io_slab_size() == 4 );
+            }
+            else if ( f.rank == 0 ) {
+                EXPECT( f.gather_scatter.io_slab_begin() == 4 );
+                EXPECT( f.gather_scatter.io_slab_size() == 5 );
+            }
+            else {
+                EXPECT( f.gather_scatter.io_slab_size() == 0 );
+            }
+
+            const idx_t slab_size   = f.gather_scatter.io_slab_size();
+            const gidx_t slab_begin = f.gather_scatter.io_slab_begin();
+
+            std::vector<POD> loc( f.Nl );
+            std::vector<POD> glb( slab_size );
+            for ( int j = 0; j < f.Nl; ++j ) {
+                loc[j] = ( idx_t( f.part[j] ) != f.rank ? 0 : f.gidx[j] * 10 );
+            }
+            {
+                auto handle = f.gather_scatter.gather_start( parallel::Field<POD const>( loc.data(), 1 ),
+                                                             parallel::Field<POD>( glb.data(), 1 ) );
+                EXPECT( handle.active() );
+                f.gather_scatter.gather_finish( handle );
+                EXPECT( not handle.active() );
+            }
+            for ( idx_t s = 0; s < slab_size; ++s ) {
+                EXPECT( glb[s] == ( slab_begin + s + 1 ) * 10 );
+            }
+
+            // Three levels, gathered in batches of two levels
+            array::ArrayT<POD> loc3( f.Nl, 3 );
+            auto locv = array::make_view<POD, 2>( loc3 );
+            for ( int j = 0; j < f.Nl; ++j ) {
+                for ( idx_t k = 0; k < 3; ++k ) {
+                    locv( j, k ) = ( idx_t( f.part[j] ) != f.rank ? 0 : f.gidx[j] * 10 + k );
+                }
+            }
+            std::vector<idx_t> batches;
+            f.gather_scatter.gather_chunked<POD>(
+                parallel::Field<POD const>( locv ), 2,
+                [&]( idx_t var_begin, idx_t var_end, const parallel::Field<POD>& slab ) {
+                    batches.push_back( var_begin );
+                    const idx_t nb_levels = var_end - var_begin;
+                    for ( idx_t s = 0; s < slab_size; ++s ) {
+                        for ( idx_t k = 0; k < nb_levels; ++k ) {
+                            EXPECT( slab.data[s * nb_levels + k] == ( slab_begin + s + 1 ) * 10 + var_begin + k );
+                        }
+                    }
+                } );
+            if ( slab_size > 0 ) {
+                EXPECT( batches == std::vector<idx_t>( {0, 2} ) );
+            }
+            else {
+                EXPECT( batches.empty() );
+            }
+        }
+
         SECTION( "test_gather_rank0" ) {
             for ( f.root = 0; f.root < f.comm_size; ++f.root ) {
                 std::vector<POD> loc( f.Nl );
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <memory>
 #include <sstream>
 
@@ -18,6 +19,7 @@
 #include "atlas/array/MakeView.h"
 #include "atlas/library/config.h"
 #include "atlas/parallel/HaloExchange.h"
+#include "atlas/parallel/Packing.h"
 #include "atlas/parallel/mpi/mpi.h"
 
 #include "tests/AtlasTestEnvironment.h"
@@ -628,6 +630,129 @@ void test_rank2_paralleldim2( Fixture& f ) {
     }
 }
 
+void test_rank1_repeated( Fixture& f ) {
+    // Repeated executions reuse the buffers kept alive in the HaloExchange
+    array::ArrayT<POD> arr( f.N, 2 );
+    array::ArrayView<POD, 2> arrv = array::make_host_view<POD, 2>( arr );
+    for ( int iter = 1; iter <= 3; ++iter ) {
+        for ( int j = 0; j < f.N; ++j ) {
+            arrv( j, 0 ) = ( size_t( f.part[j] ) != mpi::comm().rank() ? 0 : f.gidx[j] * 10 * iter );
+            arrv( j, 1 ) = ( size_t( f.part[j] ) != mpi::comm().rank() ? 0 : f.gidx[j] * 100 * iter );
+        }
+
+        f.halo_exchange.execute<POD, 2>( arr, false );
+
+        for ( int j = 0; j < f.N; ++j ) {
+            EXPECT( arrv( j, 0 ) == arrv( j, 1 ) / 10. );
+            EXPECT( arrv( j, 0 ) != 0. );
+            EXPECT( std::fmod( arrv( j, 0 ), 10. * iter ) == 0. );
+        }
+    }
+    f.halo_exchange.clear_buffers();
+    f.halo_exchange.execute<POD, 2>( arr, false );
+    switch ( mpi::comm().rank() ) {
+        case 0: {
+            POD arr_c[] = {270, 2700, 30, 300, 60, 600, 90, 900, 120, 1200};
+            validate<POD, 2>::apply( arrv, arr_c );
+            break;
+        }
+        case 1: {
+            POD arr_c[] = {90, 900, 120, 1200, 150, 1500, 180, 1800, 210, 2100, 240, 2400};
+            validate<POD, 2>::apply( arrv, arr_c );
+            break;
+        }
+        case 2: {
+            POD arr_c[] = {150, 1500, 180, 1800, 210, 2100, 240, 2400, 270, 2700, 30, 300, 60, 600};
+            validate<POD, 2>::apply( arrv, arr_c );
+            break;
+        }
+    }
+}
+
+void test_fused( Fixture& f ) {
+    // Arrays of different datatypes and ranks, exchanged in one message per neighbour
+    array::ArrayT<int> arr_i( f.N );
+    array::ArrayT<float> arr_f( f.N, 3 );
+    array::ArrayT<POD> arr_d( f.N, 2 );
+    auto arrv_i = array::make_host_view<int, 1>( arr_i );
+    auto arrv_f = array::make_host_view<float, 2>( arr_f );
+    auto arrv_d = array::make_host_view<POD, 2>( arr_d );
+    for ( int j = 0; j < f.N; ++j ) {
+        bool ghost     = size_t( f.part[j] ) != mpi::comm().rank();
+        arrv_i( j )    = ghost ? 0 : int( f.gidx[j] );
+        arrv_d( j, 0 ) = ghost ? 0 : f.gidx[j] * 10;
+        arrv_d( j, 1 ) = ghost ? 0 : f.gidx[j] * 100;
+        for ( int v = 0; v < 3; ++v ) {
+            arrv_f( j, v ) = ghost ? 0 : -float( f.gidx[j] ) * ( v + 1 );
+        }
+    }
+
+    f.halo_exchange.execute( {&arr_i, &arr_f, &arr_d} );
+
+    std::vector<int> expected;
+    switch ( mpi::comm().rank() ) {
+        case 0:
+            expected = {9, 1, 2, 3, 4};
+            break;
+        case 1:
+            expected = {3, 4, 5, 6, 7, 8};
+            break;
+        case 2:
+            expected = {5, 6, 7, 8, 9, 1, 2};
+            break;
+    }
+    for ( int j = 0; j < f.N; ++j ) {
+        EXPECT( arrv_i( j ) == expected[j] );
+        EXPECT( arrv_d( j, 0 ) == expected[j] * 10 );
+        EXPECT( arrv_d( j, 1 ) == expected[j] * 100 );
+        for ( int v = 0; v < 3; ++v ) {
+            EXPECT( arrv_f( j, v ) == -float( expected[j] ) * ( v + 1 ) );
+        }
+    }
+}
+
+void test_split_phase( Fixture& f ) {
+    array::ArrayT<POD> arr( f.N, 2 );
+    array::ArrayView<POD, 2> arrv = array::make_host_view<POD, 2>( arr );
+    for ( int j = 0; j < f.N; ++j ) {
+        arrv( j, 0 ) = ( size_t( f.part[j] ) != mpi::comm().rank() ? 0 : f.gidx[j] * 10 );
+        arrv( j, 1 ) = ( size_t( f.part[j] ) != mpi::comm().rank() ? 0 : f.gidx[j] * 100 );
+    }
+
+    parallel::HaloExchangeHandle handle = f.halo_exchange.start( {&arr} );
+    EXPECT( handle.active() );
+
+    // Owned points are not modified by the exchange and may be read while it is in progress
+    POD sum = 0;
+    for ( int j = 0; j < f.N; ++j ) {
+        if ( size_t( f.part[j] ) == mpi::comm().rank() ) {
+            sum += arrv( j, 0 );
+        }
+    }
+    EXPECT( sum > 0 );
+
+    f.halo_exchange.finish( handle );
+    EXPECT( not handle.active() );
+
+    switch ( mpi::comm().rank() ) {
+        case 0: {
+            POD arr_c[] = {90, 900, 10, 100, 20, 200, 30, 300, 40, 400};
+            validate<POD, 2>::apply( arrv, arr_c );
+            break;
+        }
+        case 1: {
+            POD arr_c[] = {30, 300, 40, 400, 50, 500, 60, 600, 70, 700, 80, 800};
+            validate<POD, 2>::apply( arrv, arr_c );
+            break;
+        }
+        case 2: {
+            POD arr_c[] = {50, 500, 60, 600, 70, 700, 80, 800, 90, 900, 10, 100, 20, 200};
+            validate<POD, 2>::apply( arrv, arr_c );
+            break;
+        }
+    }
+}
+
 void test_rank1_cinterface( Fixture& f ) {
 #if ATLAS_GRIDTOOLS_STORAGE_BACKEND_HOST
     array::ArrayT<POD> arr( f.N, 2 );
@@ -665,6 +790,37 @@ void test_rank1_cinterface( Fixture& f ) {
 #endif
 }
 
+void test_threaded_packing( Fixture& f ) {
+    // Enough levels that every message crosses the default threshold for threaded packing
+    const idx_t nlev = 20000;
+    EXPECT( nlev >= parallel::pack_omp_threshold() );
+
+    auto exchange = [&]( idx_t threshold ) {
+        array::ArrayT<POD> arr( f.N, nlev );
+        array::ArrayView<POD, 2> arrv = array::make_host_view<POD, 2>( arr );
+        for ( int j = 0; j < f.N; ++j ) {
+            for ( idx_t k = 0; k < nlev; ++k ) {
+                arrv( j, k ) = ( size_t( f.part[j] ) != mpi::comm().rank() ? 0 : f.gidx[j] * 100000 + k );
+            }
+        }
+        const idx_t default_threshold = parallel::pack_omp_threshold();
+        parallel::pack_omp_threshold( threshold );
+        f.halo_exchange.execute<POD, 2>( arr, false );
+        parallel::pack_omp_threshold( default_threshold );
+        return std::vector<POD>( arrv.data(), arrv.data() + arrv.size() );
+    };
+
+    std::vector<POD> threaded = exchange( parallel::pack_omp_threshold() );
+    std::vector<POD> serial   = exchange( std::numeric_limits<idx_t>::max() );
+    EXPECT( threaded == serial );
+
+    // Every halo point received the levels of its owner
+    for ( int j = 0; j < f.N; ++j ) {
+        EXPECT( threaded[j * nlev + nlev - 1] == threaded[j * nlev] + nlev - 1 );
+        EXPECT( threaded[j * nlev] > 0 );
+    }
+}
+
 CASE( "test_haloexchange" ) {
     SETUP( "HaloExchanges_cpu" ) {
         Fixture f( false );
@@ -692,6 +848,14 @@ CASE( "test_haloexchange" ) {
         SECTION( "test_rank2_paralleldim_2" ) { test_rank2_paralleldim2( f ); }
         SECTION( "test_rank1_cinterface" ) { test_rank1_cinterface( f ); }
 
+        SECTION( "test_rank1_repeated" ) { test_rank1_repeated( f ); }
+
+        SECTION( "test_fused" ) { test_fused( f ); }
+
+        SECTION( "test_split_phase" ) { test_split_phase( f ); }
+
+        SECTION( "test_threaded_packing" ) { test_threaded_packing( f ); }
+
 #if ATLAS_GRIDTOOLS_STORAGE_BACKEND_CUDA
         f.on_device_ = true;
 
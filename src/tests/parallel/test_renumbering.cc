@@ -0,0 +1,77 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "atlas/library/config.h"
+#include "atlas/parallel/DistributedRenumbering.h"
+#include "atlas/parallel/mpi/mpi.h"
+
+#include "tests/AtlasTestEnvironment.h"
+
+namespace atlas {
+namespace test {
+
+//-----------------------------------------------------------------------------
+
+CASE( "test_renumber_distributed" ) {
+    const gidx_t rank  = static_cast<gidx_t>( mpi::comm().rank() );
+    const gidx_t nproc = static_cast<gidx_t>( mpi::comm().size() );
+
+    // Values shared by all tasks, values shared by two tasks, values repeated on one task, and
+    // a range of values that only exists on the last task
+    std::vector<gidx_t> values{3, 10 * rank + 5, 1000 - rank, 10 * rank + 5, 1000 - ( rank + 1 ) % nproc};
+    if ( rank == nproc - 1 ) {
+        for ( gidx_t v = 0; v < 100; ++v ) {
+            values.push_back( 100000 + 7 * v );
+        }
+    }
+
+    // Reference: all values gathered on every task
+    eckit::mpi::Buffer<gidx_t> all( mpi::comm().size() );
+    mpi::comm().allGatherv( values.begin(), values.end(), all );
+    std::vector<gidx_t> distinct( all.buffer );
+    std::sort( distinct.begin(), distinct.end() );
+    distinct.erase( std::unique( distinct.begin(), distinct.end() ), distinct.end() );
+
+    const gidx_t first = 11;
+    std::vector<gidx_t> renumbered( values );
+    gidx_t nb_distinct = parallel::renumber_distributed( renumbered.data(), renumbered.size(), first );
+
+    EXPECT( nb_distinct == gidx_t( distinct.size() ) );
+    for ( size_t n = 0; n < values.size(); ++n ) {
+        gidx_t expected =
+            first + gidx_t( std::lower_bound( distinct.begin(), distinct.end(), values[n] ) - distinct.begin() );
+        EXPECT( renumbered[n] == expected );
+    }
+}
+
+CASE( "test_renumber_distributed_empty" ) {
+    // Tasks without values still take part in the collective operation
+    std::vector<gidx_t> values;
+    if ( mpi::comm().rank() == 0 ) {
+        values = {42, 7, 42};
+    }
+    gidx_t nb_distinct = parallel::renumber_distributed( values.data(), values.size() );
+    EXPECT( nb_distinct == 2 );
+    if ( mpi::comm().rank() == 0 ) {
+        EXPECT( values == std::vector<gidx_t>( {2, 1, 2} ) );
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace atlas
+
+int main( int argc, char** argv ) {
+    return atlas::test::run( argc, argv );
+}
@@ -8,6 +8,10 @@
  * nor does it submit to any jurisdiction.
  */
 
+#include <fstream>
+#include <sstream>
+
+#include "atlas/parallel/mpi/mpi.h"
 #include "atlas/parallel/omp/omp.h"
 #include "atlas/runtime/Trace.h"
 #include "tests/AtlasTestEnvironment.h"
@@ -43,16 +47,42 @@ CASE( "test elapsed" ) {
 CASE( "test trace OpenMP" ) {
     atlas_omp_parallel_for( int i = 0; i < 10; ++i ) {
         auto trace = Trace( Here(), "loop" );
-        if ( ATLAS_HAVE_OMP ) {
-            trace.stop();
-            if ( atlas_omp_get_thread_num() > 0 ) {
-                EXPECT( trace.elapsed() == 0. );
-            }
-            else {
-                EXPECT( trace.elapsed() != 0. );
-            }
-        }
+        trace.stop();
+        EXPECT( trace.elapsed() != 0. );
+    }
+    EXPECT( Trace::report().find( "loop" ) != std::string::npos );
+}
+
+CASE( "test chrome trace" ) {
+    runtime::trace::Timings::recordEvents( true );
+    {
+        auto trace = Trace( Here(), "chrome" );
+        atlas_omp_parallel_for( int i = 0; i < 4; ++i ) { auto trace = Trace( Here(), "chrome loop" ); }
+    }
+    runtime::trace::Timings::recordEvents( false );
+
+    std::string path = "atlas_test_trace_chrome.json";
+    Trace::exportChromeTrace( path );
+    if ( mpi::comm().rank() == 0 ) {
+        std::ifstream file( path );
+        std::stringstream content;
+        content << file.rdbuf();
+        EXPECT( content.str().find( "\"traceEvents\"" ) != std::string::npos );
+        EXPECT( content.str().find( "{\"name\":\"chrome\",\"cat\":\"atlas\",\"ph\":\"X\"" ) != std::string::npos );
+        EXPECT( content.str().find( "\"name\":\"thread_name\"" ) != std::string::npos );
+    }
+}
+
+CASE( "test recorded events are bounded" ) {
+    using runtime::trace::Timings;
+    const size_t dropped = Timings::droppedEvents();
+    Timings::recordEvents( true );
+    // More timings than the 65536 kept per thread
+    for ( int i = 0; i < 65536 + 10; ++i ) {
+        auto trace = Trace( Here(), "bounded" );
     }
+    Timings::recordEvents( false );
+    EXPECT( Timings::droppedEvents() >= dropped + 10 );
 }
 
 CASE( "test barrier" ) {
@@ -1459,6 +1459,123 @@ CASE( "test_trans_unstructured" ) {
 }
 #endif
 
+//-----------------------------------------------------------------------------
+#if 1
+CASE( "test_trans_dirtrans" ) {
+    Log::info() << "test_trans_dirtrans" << std::endl;
+    // test direct transforms of TransLocal by transforming back the result of an inverse transform
+
+    Grid g( "F16" );
+    int trc = 31;  // linear truncation: Gaussian quadrature is exact
+    trans::Trans transLocal( g, trc, option::type( "local" ) );
+
+    int nb_scalar = 2, nb_vordiv = 1;
+    int N = ( trc + 2 ) * ( trc + 1 ) / 2;
+    std::vector<double> sp( 2 * N * nb_scalar, 0. );
+    std::vector<double> vor( 2 * N * nb_vordiv, 0. );
+    std::vector<double> div( 2 * N * nb_vordiv, 0. );
+    int k = 0;
+    for ( int m = 0; m <= trc; m++ ) {                 // zonal wavenumber
+        for ( int n = m; n <= trc; n++ ) {             // total wavenumber
+            for ( int imag = 0; imag <= 1; imag++ ) {  // real and imaginary part
+                if ( m < trc && ( m > 0 || imag == 0 ) ) {
+                    for ( int jfld = 0; jfld < nb_scalar; jfld++ ) {
+                        sp[k * nb_scalar + jfld] = std::sin( 1. + k + 0.5 * jfld );
+                    }
+                    if ( n > 0 ) {
+                        for ( int jfld = 0; jfld < nb_vordiv; jfld++ ) {
+                            vor[k * nb_vordiv + jfld] = std::cos( 2. + k + 0.5 * jfld );
+                            div[k * nb_vordiv + jfld] = std::sin( 3. + 0.5 * k + jfld );
+                        }
+                    }
+                }
+                k++;
+            }
+        }
+    }
+
+    auto max_diff = []( const std::vector<double>& a, const std::vector<double>& b ) {
+        double diff = 0., norm = 0.;
+        for ( size_t j = 0; j < a.size(); ++j ) {
+            diff = std::max( diff, std::abs( a[j] - b[j] ) );
+            norm = std::max( norm, std::abs( a[j] ) );
+        }
+        return diff / norm;
+    };
+
+    SECTION( "scalar" ) {
+        std::vector<double> gp( nb_scalar * g.size() );
+        std::vector<double> sp_dir( sp.size() );
+        EXPECT_NO_THROW( transLocal.invtrans( nb_scalar, sp.data(), gp.data() ) );
+        EXPECT_NO_THROW( transLocal.dirtrans( nb_scalar, gp.data(), sp_dir.data() ) );
+        ATLAS_DEBUG_VAR( max_diff( sp, sp_dir ) );
+        EXPECT( max_diff( sp, sp_dir ) < 1.e-10 );
+    }
+
+    SECTION( "vordiv" ) {
+        std::vector<double> gp( 2 * nb_vordiv * g.size() );
+        std::vector<double> vor_dir( vor.size() );
+        std::vector<double> div_dir( div.size() );
+        EXPECT_NO_THROW( transLocal.invtrans( nb_vordiv, vor.data(), div.data(), gp.data() ) );
+        EXPECT_NO_THROW( transLocal.dirtrans( nb_vordiv, gp.data(), vor_dir.data(), div_dir.data() ) );
+        ATLAS_DEBUG_VAR( max_diff( vor, vor_dir ) );
+        ATLAS_DEBUG_VAR( max_diff( div, div_dir ) );
+        EXPECT( max_diff( vor, vor_dir ) < 1.e-10 );
+        EXPECT( max_diff( div, div_dir ) < 1.e-10 );
+    }
+
+    SECTION( "limited area domain is not supported" ) {
+        Grid g_lam( g, RectangularDomain( {0., 90.}, {0., 90.} ) );
+        trans::Trans transLAM( g, g_lam.domain(), trc, option::type( "local" ) );
+        std::vector<double> gp( g_lam.size() );
+        std::vector<double> sp_dir( 2 * N );
+        EXPECT_THROWS( transLAM.dirtrans( 1, gp.data(), sp_dir.data() ) );
+    }
+}
+#endif
+//-----------------------------------------------------------------------------
+#if 1
+CASE( "test_trans_legendre_on_the_fly" ) {
+    Log::info() << "test_trans_legendre_on_the_fly" << std::endl;
+    // test that recomputing the Legendre polynomials during the transforms gives the same results as
+    // precomputing them
+
+    int trc = 47;
+    for ( std::string gridname : {"F24", "O24"} ) {
+        for ( Domain domain : std::vector<Domain>{GlobalDomain(), RectangularDomain( {0., 90.}, {-30., 60.} )} ) {
+            Grid g( Grid( gridname ), domain );
+            Log::info() << "grid " << gridname << ", domain " << domain << std::endl;
+            trans::Trans transPrecomp( Grid( gridname ), domain, trc, option::type( "local" ) );
+            trans::Trans transOnTheFly( Grid( gridname ), domain, trc,
+                                        option::type( "local" ) | util::Config( "legendre_precompute", false ) );
+
+            int nb_scalar = 3;
+            int N         = ( trc + 2 ) * ( trc + 1 ) / 2;
+            std::vector<double> sp( 2 * N * nb_scalar );
+            for ( size_t j = 0; j < sp.size(); ++j ) {
+                sp[j] = std::sin( 1. + j );
+            }
+            std::vector<double> gp1( nb_scalar * g.size() );
+            std::vector<double> gp2( nb_scalar * g.size() );
+            EXPECT_NO_THROW( transPrecomp.invtrans( nb_scalar, sp.data(), gp1.data() ) );
+            EXPECT_NO_THROW( transOnTheFly.invtrans( nb_scalar, sp.data(), gp2.data() ) );
+            double rms = compute_rms( gp1.size(), gp1.data(), gp2.data() );
+            ATLAS_DEBUG_VAR( rms );
+            EXPECT( rms < 1.e-11 );
+
+            if ( domain.global() ) {
+                std::vector<double> sp1( sp.size() );
+                std::vector<double> sp2( sp.size() );
+                EXPECT_NO_THROW( transPrecomp.dirtrans( nb_scalar, gp1.data(), sp1.data() ) );
+                EXPECT_NO_THROW( transOnTheFly.dirtrans( nb_scalar, gp1.data(), sp2.data() ) );
+                double rms_sp = compute_rms( sp1.size(), sp1.data(), sp2.data() );
+                ATLAS_DEBUG_VAR( rms_sp );
+                EXPECT( rms_sp < 1.e-11 );
+            }
+        }
+    }
+}
+#endif
 //-----------------------------------------------------------------------------
 
 #if 0
@@ -12,6 +12,7 @@
 #include <cmath>
 #include <utility>
 
+#include "atlas/util/LonLatPolygon.h"
 #include "atlas/util/Point.h"
 #include "atlas/util/SphericalPolygon.h"
 
@@ -59,6 +60,31 @@ CASE( "test_polygon_something" ) {
     }
 }
 
+CASE( "test_lonlat_polygon" ) {
+    using util::LonLatPolygon;
+    using p = PointLonLat;
+
+    // L-shaped, so that the inscribed rectangle can only grow to part of it
+    LonLatPolygon poly( std::vector<PointLonLat>{p( 0, 0 ), p( 10, 0 ), p( 10, 5 ), p( 5, 5 ), p( 5, 10 ), p( 0, 10 ),
+                                                 p( 0, 0 )} );
+
+    const auto& inner_min = poly.innerCoordinatesMin();
+    const auto& inner_max = poly.innerCoordinatesMax();
+    EXPECT( inner_min[0] < inner_max[0] );
+    EXPECT( inner_min[1] < inner_max[1] );
+    EXPECT( inner_min[0] >= 0. );
+    EXPECT( inner_min[1] >= 0. );
+    EXPECT( inner_max[0] <= 10. );
+    EXPECT( inner_max[1] <= 10. );
+    EXPECT( not( inner_max[0] > 5. && inner_max[1] > 5. ) );
+
+    for ( auto P : std::vector<std::pair<p, bool>>{
+              {p( 2, 8 ), true},  {p( 8, 2 ), true},      {p( 4.9, 9.9 ), true}, {p( 9.9, 4.9 ), true},
+              {p( 7, 7 ), false}, {p( 5.1, 5.1 ), false}, {p( 11, 2 ), false},   {p( 2, -1 ), false}} ) {
+        EXPECT( poly.contains( P.first ) == P.second );
+    }
+}
+
 }  // namespace test
 }  // namespace atlas
 
@@ -0,0 +1,102 @@
+/*
+ * (C) Copyright 2013 ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <map>
+#include <vector>
+
+#include "atlas/library/config.h"
+#include "atlas/util/UidHashMap.h"
+
+#include "tests/AtlasTestEnvironment.h"
+
+namespace atlas {
+namespace test {
+
+//-----------------------------------------------------------------------------
+
+namespace {
+// Keys with duplicates and negative values, as for unique indices of elements
+std::vector<uidx_t> make_keys( size_t n ) {
+    std::vector<uidx_t> keys( n );
+    for ( size_t i = 0; i < n; ++i ) {
+        keys[i] = uidx_t( ( i * 7919 ) % ( n / 2 + 1 ) ) - uidx_t( n / 4 );
+    }
+    return keys;
+}
+}  // namespace
+
+CASE( "test_uid_hash_map_insert" ) {
+    for ( size_t n : {size_t( 0 ), size_t( 10 ), size_t( 10000 )} ) {
+        std::vector<uidx_t> keys = make_keys( n );
+        std::map<uidx_t, int> reference;
+        util::UidHashMap<int> map;
+        for ( size_t i = 0; i < n; ++i ) {
+            bool inserted = map.insert( std::make_pair( keys[i], int( i ) ) ).second;
+            EXPECT( inserted == reference.insert( std::make_pair( keys[i], int( i ) ) ).second );
+        }
+        EXPECT( map.size() == reference.size() );
+        for ( const auto& entry : reference ) {
+            auto found = map.find( entry.first );
+            EXPECT( found != map.end() );
+            EXPECT( found->second == entry.second );
+        }
+        EXPECT( map.count( uidx_t( n ) ) == 0 );
+
+        size_t nb_iterated = 0;
+        for ( const auto& entry : map ) {
+            EXPECT( reference.at( entry.first ) == entry.second );
+            ++nb_iterated;
+        }
+        EXPECT( nb_iterated == reference.size() );
+
+        map[uidx_t( n )] = -1;
+        EXPECT( map.count( uidx_t( n ) ) == 1 );
+        map.clear();
+        EXPECT( map.empty() );
+    }
+}
+
+CASE( "test_uid_hash_map_build" ) {
+    // Large enough to be built on several threads
+    const size_t n           = 100000;
+    std::vector<uidx_t> keys = make_keys( n );
+    std::map<uidx_t, idx_t> reference;
+    for ( size_t i = 0; i < n; ++i ) {
+        reference.insert( std::make_pair( keys[i], idx_t( i ) ) );
+    }
+
+    util::UidHashMap<idx_t> map;
+    map.build( n, [&]( size_t i ) { return keys[i]; }, []( size_t i ) { return idx_t( i ); } );
+    EXPECT( map.size() == reference.size() );
+    for ( const auto& entry : reference ) {
+        // The first of several entries with the same key is kept
+        EXPECT( map.find( entry.first )->second == entry.second );
+    }
+
+    // Entries inserted after build
+    map[-uidx_t( n )] = 1;
+    EXPECT( map.size() == reference.size() + 1 );
+    EXPECT( map.find( -uidx_t( n ) )->second == 1 );
+
+    util::UidHashSet set;
+    set.build( n, [&]( size_t i ) { return keys[i]; } );
+    EXPECT( set.size() == reference.size() );
+    EXPECT( not set.insert( keys[0] ) );
+    EXPECT( set.insert( -uidx_t( n ) ) );
+}
+
+//-----------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace atlas
+
+int main( int argc, char** argv ) {
+    return atlas::test::run( argc, argv );
+}